@@ -1,22 +1,26 @@
-from libcpp.set cimport set as cpp_set
+from libc.stdint cimport uint64_t
 from libcpp.string cimport string
 from libcpp.unordered_map cimport unordered_map
 from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 
-from hummingbot.core.data_type.LimitOrder cimport LimitOrder as CPPLimitOrder
+from hummingbot.core.data_type.LimitOrder cimport LimitOrder as CPPLimitOrder, LimitOrderSet
+from hummingbot.core.data_type.MatchingEngine cimport MatchFill, MatchingEngine
 from hummingbot.core.data_type.OrderExpirationEntry cimport OrderExpirationEntry as CPPOrderExpirationEntry
+from hummingbot.core.data_type.OrderExpirationWheel cimport OrderExpirationWheel
+from hummingbot.core.data_type.SymbolTable cimport SymbolHandle
 from hummingbot.core.data_type.order_book_tracker import OrderBookTracker
 from hummingbot.connector.exchange_base cimport ExchangeBase
 
 
-ctypedef cpp_set[CPPLimitOrder] SingleTradingPairLimitOrders
-ctypedef unordered_map[string, SingleTradingPairLimitOrders].iterator LimitOrdersIterator
-ctypedef pair[string, SingleTradingPairLimitOrders] LimitOrdersPair
-ctypedef unordered_map[string, SingleTradingPairLimitOrders] LimitOrders
-ctypedef cpp_set[CPPLimitOrder].iterator SingleTradingPairLimitOrdersIterator
-ctypedef cpp_set[CPPLimitOrder].reverse_iterator SingleTradingPairLimitOrdersRIterator
-ctypedef cpp_set[CPPOrderExpirationEntry] LimitOrderExpirationSet
-ctypedef cpp_set[CPPOrderExpirationEntry].iterator LimitOrderExpirationSetIterator
+ctypedef LimitOrderSet SingleTradingPairLimitOrders
+ctypedef unordered_map[SymbolHandle, SingleTradingPairLimitOrders].iterator LimitOrdersIterator
+ctypedef pair[SymbolHandle, SingleTradingPairLimitOrders] LimitOrdersPair
+ctypedef unordered_map[SymbolHandle, SingleTradingPairLimitOrders] LimitOrders
+ctypedef LimitOrderSet.iterator SingleTradingPairLimitOrdersIterator
+ctypedef LimitOrderSet.reverse_iterator SingleTradingPairLimitOrdersRIterator
+ctypedef unordered_map[SymbolHandle, SingleTradingPairLimitOrdersIterator] LimitOrderIterators
+ctypedef unordered_map[SymbolHandle, SingleTradingPairLimitOrdersIterator].iterator LimitOrderIteratorsIterator
 
 cdef class QuantizationParams:
     cdef:
@@ -31,16 +35,23 @@ cdef class PaperTradeExchange(ExchangeBase):
     cdef:
         LimitOrders _bid_limit_orders
         LimitOrders _ask_limit_orders
+        LimitOrderIterators _limit_order_iterators
         bint _paper_trade_market_initialized
         dict _trading_pairs
+        dict _trading_pair_handles
         object _queued_orders
         dict _quantization_params
         object _order_book_trade_listener
         object _market_order_filled_listener
-        LimitOrderExpirationSet _limit_order_expiration_set
+        OrderExpirationWheel _limit_order_expiration_wheel
+        MatchingEngine _matching_engine
+        dict _limit_order_fills
+        bint _limit_orders_added
+        uint64_t _crossed_check_book_version
         object _target_market
         str _exchange_name
 
+    cdef SymbolHandle c_get_trading_pair_handle(self, str trading_pair)
     cdef c_execute_buy(self, str order_id, str trading_pair, object amount)
     cdef c_execute_sell(self, str order_id, str trading_pair, object amount)
     cdef c_process_market_orders(self)
@@ -53,6 +64,8 @@ cdef class PaperTradeExchange(ExchangeBase):
                           object amount,
                           object price,
                           object is_maker=*)
+    cdef c_add_limit_order_to_matching_engine(self, const CPPLimitOrder *cpp_limit_order_ptr, double quantity)
+    cdef c_untrack_queue_position(self, const CPPLimitOrder *cpp_limit_order_ptr)
     cdef c_delete_limit_order(self,
                               LimitOrders *limit_orders_map_ptr,
                               LimitOrdersIterator *map_it_ptr,
@@ -61,23 +74,35 @@ cdef class PaperTradeExchange(ExchangeBase):
                                bint is_buy,
                                LimitOrders *limit_orders_map_ptr,
                                LimitOrdersIterator *map_it_ptr,
-                               SingleTradingPairLimitOrdersIterator orders_it)
+                               SingleTradingPairLimitOrdersIterator orders_it,
+                               object fill_amount=*)
     cdef c_process_limit_bid_order(self,
                                    LimitOrders *limit_orders_map_ptr,
                                    LimitOrdersIterator *map_it_ptr,
-                                   SingleTradingPairLimitOrdersIterator orders_it)
+                                   SingleTradingPairLimitOrdersIterator orders_it,
+                                   object fill_amount)
     cdef c_process_limit_ask_order(self,
                                    LimitOrders *limit_orders_map_ptr,
                                    LimitOrdersIterator *map_it_ptr,
-                                   SingleTradingPairLimitOrdersIterator orders_it)
+                                   SingleTradingPairLimitOrdersIterator orders_it,
+                                   object fill_amount)
+    cdef c_process_fills(self,
+                         bint is_buy,
+                         LimitOrders *limit_orders_map_ptr,
+                         LimitOrdersIterator *map_it_ptr,
+                         vector[MatchFill] *fills)
     cdef c_process_crossed_limit_orders_for_trading_pair(self,
                                                          bint is_buy,
                                                          LimitOrders *limit_orders_map_ptr,
                                                          LimitOrdersIterator *map_it_ptr)
     cdef c_process_crossed_limit_orders(self)
+    cdef uint64_t c_get_order_books_version(self)
+    cdef c_process_expired_orders(self, double timestamp)
     cdef c_match_trade_to_limit_orders(self, object order_book_trade_event)
     cdef object c_cancel_order_from_orders_map(self,
                                                LimitOrders *orders_map,
                                                str trading_pair_str,
                                                bint cancel_all=*,
-                                               str client_order_id=*)
+                                               str client_order_id=*,
+                                               bint expired=*)
+    cdef object c_cancel_limit_order(self, SymbolHandle client_order_handle, bint expired)
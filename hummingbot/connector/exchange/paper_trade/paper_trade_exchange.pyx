@@ -1,4 +1,4 @@
-# distutils: sources=['hummingbot/core/cpp/Utils.cpp', 'hummingbot/core/cpp/LimitOrder.cpp', 'hummingbot/core/cpp/OrderExpirationEntry.cpp']
+# distutils: sources=['hummingbot/core/cpp/Utils.cpp', 'hummingbot/core/cpp/LimitOrder.cpp', 'hummingbot/core/cpp/MatchingEngine.cpp', 'hummingbot/core/cpp/OrderBookEntry.cpp', 'hummingbot/core/cpp/OrderBookSide.cpp', 'hummingbot/core/cpp/OrderExpirationEntry.cpp', 'hummingbot/core/cpp/OrderExpirationWheel.cpp', 'hummingbot/core/cpp/PoolAllocator.cpp', 'hummingbot/core/cpp/SymbolTable.cpp']
 
 import asyncio
 import math
@@ -9,6 +9,8 @@ from typing import Callable, Dict, List, Optional, Tuple, TYPE_CHECKING
 
 from cpython cimport PyObject
 from cython.operator cimport address, dereference as deref, postincrement as inc
+from libc.math cimport INFINITY, isnan
+from libc.stdint cimport UINT64_MAX, uint64_t
 from libcpp cimport bool as cppbool
 from libcpp.vector cimport vector
 
@@ -24,6 +26,8 @@ from hummingbot.core.data_type.composite_order_book import CompositeOrderBook
 from hummingbot.core.data_type.composite_order_book cimport CompositeOrderBook
 from hummingbot.core.data_type.limit_order import LimitOrder
 from hummingbot.core.data_type.limit_order cimport c_create_limit_order_from_cpp_limit_order
+from hummingbot.core.data_type.LimitOrder cimport emplaceLimitOrder
+from hummingbot.core.data_type.SymbolTable cimport findSymbol, getSymbolName, internSymbol
 from hummingbot.core.data_type.order_book cimport OrderBook
 from hummingbot.core.data_type.order_book_tracker import OrderBookTracker
 from hummingbot.core.data_type.order_candidate import OrderCandidate
@@ -36,12 +40,12 @@ from hummingbot.core.event.events import (
     OrderBookEvent,
     OrderBookTradeEvent,
     OrderCancelledEvent,
+    OrderExpiredEvent,
     OrderFilledEvent,
     SellOrderCompletedEvent,
     SellOrderCreatedEvent,
 )
 from hummingbot.core.network_iterator import NetworkStatus
-from hummingbot.core.Utils cimport getIteratorFromReverseIterator, reverse_iterator
 from hummingbot.core.utils.async_utils import safe_ensure_future
 from hummingbot.core.utils.estimate_fee import build_trade_fee
 
@@ -146,6 +150,7 @@ cdef class PaperTradeExchange(ExchangeBase):
     SELL_ORDER_COMPLETED_EVENT_TAG = MarketEvent.SellOrderCompleted.value
     BUY_ORDER_COMPLETED_EVENT_TAG = MarketEvent.BuyOrderCompleted.value
     MARKET_ORDER_CANCELED_EVENT_TAG = MarketEvent.OrderCancelled.value
+    MARKET_ORDER_EXPIRED_EVENT_TAG = MarketEvent.OrderExpired.value
     MARKET_ORDER_FAILURE_EVENT_TAG = MarketEvent.OrderFailure.value
     ORDER_BOOK_TRADE_EVENT_TAG = OrderBookEvent.TradeEvent.value
     MARKET_SELL_ORDER_CREATED_EVENT_TAG = MarketEvent.SellOrderCreated.value
@@ -167,6 +172,10 @@ cdef class PaperTradeExchange(ExchangeBase):
         self._account_available_balances = {}
         self._paper_trade_market_initialized = False
         self._trading_pairs = {}
+        self._trading_pair_handles = {}
+        self._limit_order_fills = {}
+        self._limit_orders_added = False
+        self._crossed_check_book_version = UINT64_MAX
         self._queued_orders = deque()
         self._quantization_params = {}
         self._order_book_trade_listener = OrderBookTradeListener(self)
@@ -216,6 +225,31 @@ cdef class PaperTradeExchange(ExchangeBase):
     def display_name(self) -> str:
         return f"{self._exchange_name}_PaperTrade"
 
+    @property
+    def partial_fills_enabled(self) -> bool:
+        """
+        When enabled, a trade through a resting limit order only fills it up to the trade amount, shared out between
+        the resting orders in price-time priority. Otherwise any trade through the order price fills it completely.
+        """
+        return self._matching_engine.getPartialFillsEnabled()
+
+    @partial_fills_enabled.setter
+    def partial_fills_enabled(self, bint enabled):
+        self._matching_engine.setPartialFillsEnabled(enabled)
+
+    @property
+    def queue_positions_enabled(self) -> bool:
+        """
+        When enabled, limit orders placed from then on join the back of the queue at their price level of the order
+        book. Trades at the order price only fill it once the volume queued ahead of it has been traded or cancelled,
+        which the order book keeps track of natively as diffs are applied.
+        """
+        return self._matching_engine.getQueuePositionsEnabled()
+
+    @queue_positions_enabled.setter
+    def queue_positions_enabled(self, bint enabled):
+        self._matching_engine.setQueuePositionsEnabled(enabled)
+
     @property
     def order_books(self) -> Dict[str, CompositeOrderBook]:
         return self.order_book_tracker.order_books
@@ -317,9 +351,32 @@ cdef class PaperTradeExchange(ExchangeBase):
 
     cdef c_tick(self, double timestamp):
         ExchangeBase.c_tick(self, timestamp)
+        self.c_process_expired_orders(timestamp)
         self.c_process_market_orders()
         self.c_process_crossed_limit_orders()
 
+    cdef double c_next_wakeup_timestamp(self):
+        """
+        Wakes up for the next queued market order to execute and the next limit order to expire. Resting limit orders
+        are checked against the books right away when a limit order was added since the last check, or a book changed.
+        """
+        cdef:
+            double next_wakeup = INFINITY
+            double next_expiration
+            QueuedOrder front_order
+
+        if not self._bid_limit_orders.empty() or not self._ask_limit_orders.empty():
+            if self._limit_orders_added or self.c_get_order_books_version() != self._crossed_check_book_version:
+                return self._current_timestamp
+        if len(self._queued_orders) > 0:
+            front_order = self._queued_orders[0]
+            next_wakeup = front_order.create_timestamp + self.TRADE_EXECUTION_DELAY
+        if not self._limit_order_expiration_wheel.empty():
+            next_expiration = self._limit_order_expiration_wheel.getNextExpirationTimestamp()
+            if next_expiration < next_wakeup:
+                next_wakeup = next_expiration
+        return next_wakeup
+
     cdef str c_buy(self,
                    str trading_pair_str,
                    object amount,
@@ -337,9 +394,11 @@ cdef class PaperTradeExchange(ExchangeBase):
             string cpp_base_asset = self._trading_pairs[trading_pair_str].base_asset.encode("utf8")
             string cpp_quote_asset = quote_asset.encode("utf8")
             string cpp_position = "NIL".encode("utf8")
+            SymbolHandle trading_pair_handle
             LimitOrdersIterator map_it
             SingleTradingPairLimitOrders *limit_orders_collection_ptr = NULL
             pair[LimitOrders.iterator, cppbool] insert_result
+            pair[SingleTradingPairLimitOrdersIterator, cppbool] order_insert_result
 
         quantized_price = (self.c_quantize_order_price(trading_pair_str, price)
                            if order_type is OrderType.LIMIT
@@ -350,14 +409,16 @@ cdef class PaperTradeExchange(ExchangeBase):
                                                    quantized_amount))
         elif order_type is OrderType.LIMIT:
 
-            map_it = self._bid_limit_orders.find(cpp_trading_pair_str)
+            trading_pair_handle = self.c_get_trading_pair_handle(trading_pair_str)
+            map_it = self._bid_limit_orders.find(trading_pair_handle)
 
             if map_it == self._bid_limit_orders.end():
-                insert_result = self._bid_limit_orders.insert(LimitOrdersPair(cpp_trading_pair_str,
+                insert_result = self._bid_limit_orders.insert(LimitOrdersPair(trading_pair_handle,
                                                                               SingleTradingPairLimitOrders()))
                 map_it = insert_result.first
             limit_orders_collection_ptr = address(deref(map_it).second)
-            limit_orders_collection_ptr.insert(CPPLimitOrder(
+            order_insert_result = emplaceLimitOrder(
+                deref(limit_orders_collection_ptr),
                 cpp_order_id,
                 cpp_trading_pair_str,
                 True,
@@ -369,7 +430,16 @@ cdef class PaperTradeExchange(ExchangeBase):
                 int(self._current_timestamp * 1e6),
                 0,
                 cpp_position,
-            ))
+            )
+            self._limit_order_iterators[deref(order_insert_result.first).getClientOrderHandle()] = \
+                order_insert_result.first
+            self.c_add_limit_order_to_matching_engine(address(deref(order_insert_result.first)),
+                                                      float(quantized_amount))
+            self._limit_order_expiration_wheel.insert(cpp_trading_pair_str,
+                                                      cpp_order_id,
+                                                      self._current_timestamp,
+                                                      kwargs.get("expiration_ts", math.nan))
+            self._limit_orders_added = True
         safe_ensure_future(self.trigger_event_async(
             self.MARKET_BUY_ORDER_CREATED_EVENT_TAG,
             BuyOrderCreatedEvent(self._current_timestamp,
@@ -398,9 +468,11 @@ cdef class PaperTradeExchange(ExchangeBase):
             string cpp_base_asset = base_asset.encode("utf8")
             string cpp_quote_asset = self._trading_pairs[trading_pair_str].quote_asset.encode("utf8")
             string cpp_position = "NIL".encode("utf8")
+            SymbolHandle trading_pair_handle
             LimitOrdersIterator map_it
             SingleTradingPairLimitOrders *limit_orders_collection_ptr = NULL
             pair[LimitOrders.iterator, cppbool] insert_result
+            pair[SingleTradingPairLimitOrdersIterator, cppbool] order_insert_result
 
         quantized_price = (self.c_quantize_order_price(trading_pair_str, price)
                            if order_type is OrderType.LIMIT
@@ -410,14 +482,16 @@ cdef class PaperTradeExchange(ExchangeBase):
             self._queued_orders.append(QueuedOrder(self._current_timestamp, order_id, False, trading_pair_str,
                                                    quantized_amount))
         elif order_type is OrderType.LIMIT:
-            map_it = self._ask_limit_orders.find(cpp_trading_pair_str)
+            trading_pair_handle = self.c_get_trading_pair_handle(trading_pair_str)
+            map_it = self._ask_limit_orders.find(trading_pair_handle)
 
             if map_it == self._ask_limit_orders.end():
-                insert_result = self._ask_limit_orders.insert(LimitOrdersPair(cpp_trading_pair_str,
+                insert_result = self._ask_limit_orders.insert(LimitOrdersPair(trading_pair_handle,
                                                                               SingleTradingPairLimitOrders()))
                 map_it = insert_result.first
             limit_orders_collection_ptr = address(deref(map_it).second)
-            limit_orders_collection_ptr.insert(CPPLimitOrder(
+            order_insert_result = emplaceLimitOrder(
+                deref(limit_orders_collection_ptr),
                 cpp_order_id,
                 cpp_trading_pair_str,
                 False,
@@ -429,7 +503,16 @@ cdef class PaperTradeExchange(ExchangeBase):
                 int(self._current_timestamp * 1e6),
                 0,
                 cpp_position,
-            ))
+            )
+            self._limit_order_iterators[deref(order_insert_result.first).getClientOrderHandle()] = \
+                order_insert_result.first
+            self.c_add_limit_order_to_matching_engine(address(deref(order_insert_result.first)),
+                                                      float(quantized_amount))
+            self._limit_order_expiration_wheel.insert(cpp_trading_pair_str,
+                                                      cpp_order_id,
+                                                      self._current_timestamp,
+                                                      kwargs.get("expiration_ts", math.nan))
+            self._limit_orders_added = True
         safe_ensure_future(self.trigger_event_async(
             self.MARKET_SELL_ORDER_CREATED_EVENT_TAG,
             SellOrderCreatedEvent(self._current_timestamp,
@@ -441,6 +524,16 @@ cdef class PaperTradeExchange(ExchangeBase):
                                   self._current_timestamp)))
         return order_id
 
+    cdef SymbolHandle c_get_trading_pair_handle(self, str trading_pair):
+        """
+        Returns the interned handle of a trading pair, encoding the name only the first time it is seen.
+        """
+        handle = self._trading_pair_handles.get(trading_pair)
+        if handle is None:
+            handle = internSymbol(trading_pair.encode("utf8"))
+            self._trading_pair_handles[trading_pair] = handle
+        return handle
+
     cdef c_execute_buy(self, str order_id, str trading_pair_str, object amount):
         cdef:
             str quote_asset = self._trading_pairs[trading_pair_str].quote_asset
@@ -622,6 +715,37 @@ cdef class PaperTradeExchange(ExchangeBase):
             else:
                 return
 
+    cdef c_add_limit_order_to_matching_engine(self, const CPPLimitOrder *cpp_limit_order_ptr, double quantity):
+        cdef:
+            OrderBook order_book
+
+        if not self._matching_engine.getQueuePositionsEnabled():
+            self._matching_engine.addOrder(deref(cpp_limit_order_ptr), quantity)
+            return
+        # The queue positions live in the book sides, which an OrderBookWorkerPool may be applying diffs to.
+        order_book = self.c_get_order_book(cpp_limit_order_ptr.getTradingPair().decode("utf8"))
+        order_book.c_lock_book()
+        try:
+            if cpp_limit_order_ptr.getIsBuy():
+                self._matching_engine.addOrder(deref(cpp_limit_order_ptr), quantity, order_book._bid_book)
+            else:
+                self._matching_engine.addOrder(deref(cpp_limit_order_ptr), quantity, order_book._ask_book)
+        finally:
+            order_book.c_unlock_book()
+
+    cdef c_untrack_queue_position(self, const CPPLimitOrder *cpp_limit_order_ptr):
+        cdef:
+            OrderBook order_book = self.c_get_order_book(cpp_limit_order_ptr.getTradingPair().decode("utf8"))
+
+        order_book.c_lock_book()
+        try:
+            if cpp_limit_order_ptr.getIsBuy():
+                order_book._bid_book.untrackQueuePosition(cpp_limit_order_ptr.getClientOrderHandle())
+            else:
+                order_book._ask_book.untrackQueuePosition(cpp_limit_order_ptr.getClientOrderHandle())
+        finally:
+            order_book.c_unlock_book()
+
     cdef c_delete_limit_order(self,
                               LimitOrders *limit_orders_map_ptr,
                               LimitOrdersIterator *map_it_ptr,
@@ -629,6 +753,13 @@ cdef class PaperTradeExchange(ExchangeBase):
         cdef:
             SingleTradingPairLimitOrders *orders_collection_ptr = address(deref(deref(map_it_ptr)).second)
         try:
+            self._limit_order_expiration_wheel.cancel(deref(orders_it).getClientOrderHandle())
+            if self._matching_engine.isQueuePositionTracked(deref(orders_it).getClientOrderHandle()):
+                self.c_untrack_queue_position(address(deref(orders_it)))
+            self._matching_engine.removeOrder(deref(orders_it).getClientOrderHandle())
+            if len(self._limit_order_fills) > 0:
+                self._limit_order_fills.pop(deref(orders_it).getClientOrderID().decode("utf8"), None)
+            self._limit_order_iterators.erase(deref(orders_it).getClientOrderHandle())
             orders_collection_ptr.erase(orders_it)
             if orders_collection_ptr.empty():
                 map_it_ptr[0] = limit_orders_map_ptr.erase(deref(map_it_ptr))
@@ -640,7 +771,8 @@ cdef class PaperTradeExchange(ExchangeBase):
     cdef c_process_limit_bid_order(self,
                                    LimitOrders *limit_orders_map_ptr,
                                    LimitOrdersIterator *map_it_ptr,
-                                   SingleTradingPairLimitOrdersIterator orders_it):
+                                   SingleTradingPairLimitOrdersIterator orders_it,
+                                   object fill_amount):
         cdef:
             const CPPLimitOrder *cpp_limit_order_ptr = address(deref(orders_it))
             str trading_pair_str = cpp_limit_order_ptr.getTradingPair().decode("utf8")
@@ -651,6 +783,15 @@ cdef class PaperTradeExchange(ExchangeBase):
             object price = <object> cpp_limit_order_ptr.getPrice()
             object quote_balance = self.c_get_balance(quote_asset)
             object base_balance = self.c_get_balance(base_asset)
+            list fill_totals = self._limit_order_fills.get(order_id)
+            bint is_complete = True
+
+        # Partially filled orders only have the rest of their amount left to fill.
+        if fill_totals is not None:
+            amount -= fill_totals[0]
+        if fill_amount is not None and fill_amount < amount:
+            amount = fill_amount
+            is_complete = False
 
         order_candidate = OrderCandidate(
             trading_pair=trading_pair_str,
@@ -687,6 +828,9 @@ cdef class PaperTradeExchange(ExchangeBase):
                            quote_balance - paid_amount)
         self.c_set_balance(base_asset,
                            base_balance + acquired_amount)
+        if fill_totals is not None:
+            acquired_amount += fill_totals[1]
+            paid_amount += fill_totals[2]
 
         # add fee
         fees = build_trade_fee(
@@ -710,11 +854,16 @@ cdef class PaperTradeExchange(ExchangeBase):
                 TradeType.BUY,
                 OrderType.LIMIT,
                 <object> cpp_limit_order_ptr.getPrice(),
-                <object> cpp_limit_order_ptr.getQuantity(),
+                amount,
                 fees,
                 exchange_trade_id=str(int(self._time() * 1e6))
             ))
 
+        if not is_complete:
+            filled_amount = amount if fill_totals is None else fill_totals[0] + amount
+            self._limit_order_fills[order_id] = [filled_amount, acquired_amount, paid_amount]
+            return
+
         self.c_trigger_event(
             self.BUY_ORDER_COMPLETED_EVENT_TAG,
             BuyOrderCompletedEvent(
@@ -731,7 +880,8 @@ cdef class PaperTradeExchange(ExchangeBase):
     cdef c_process_limit_ask_order(self,
                                    LimitOrders *limit_orders_map_ptr,
                                    LimitOrdersIterator *map_it_ptr,
-                                   SingleTradingPairLimitOrdersIterator orders_it):
+                                   SingleTradingPairLimitOrdersIterator orders_it,
+                                   object fill_amount):
         cdef:
             const CPPLimitOrder *cpp_limit_order_ptr = address(deref(orders_it))
             str trading_pair_str = cpp_limit_order_ptr.getTradingPair().decode("utf8")
@@ -742,6 +892,15 @@ cdef class PaperTradeExchange(ExchangeBase):
             object price = <object> cpp_limit_order_ptr.getPrice()
             object quote_balance = self.c_get_balance(quote_asset)
             object base_balance = self.c_get_balance(base_asset)
+            list fill_totals = self._limit_order_fills.get(order_id)
+            bint is_complete = True
+
+        # Partially filled orders only have the rest of their amount left to fill.
+        if fill_totals is not None:
+            amount -= fill_totals[0]
+        if fill_amount is not None and fill_amount < amount:
+            amount = fill_amount
+            is_complete = False
 
         order_candidate = OrderCandidate(
             trading_pair=trading_pair_str,
@@ -778,6 +937,9 @@ cdef class PaperTradeExchange(ExchangeBase):
                            quote_balance + acquired_amount)
         self.c_set_balance(base_asset,
                            base_balance - sold_amount)
+        if fill_totals is not None:
+            acquired_amount += fill_totals[1]
+            sold_amount += fill_totals[2]
 
         # add fee
         fees = build_trade_fee(
@@ -801,11 +963,16 @@ cdef class PaperTradeExchange(ExchangeBase):
                 TradeType.SELL,
                 OrderType.LIMIT,
                 <object> cpp_limit_order_ptr.getPrice(),
-                <object> cpp_limit_order_ptr.getQuantity(),
+                amount,
                 fees,
                 exchange_trade_id=str(int(self._time() * 1e6))
             ))
 
+        if not is_complete:
+            filled_amount = amount if fill_totals is None else fill_totals[0] + amount
+            self._limit_order_fills[order_id] = [filled_amount, sold_amount, acquired_amount]
+            return
+
         self.c_trigger_event(
             self.SELL_ORDER_COMPLETED_EVENT_TAG,
             SellOrderCompletedEvent(
@@ -823,15 +990,53 @@ cdef class PaperTradeExchange(ExchangeBase):
                                bint is_buy,
                                LimitOrders *limit_orders_map_ptr,
                                LimitOrdersIterator *map_it_ptr,
-                               SingleTradingPairLimitOrdersIterator orders_it):
+                               SingleTradingPairLimitOrdersIterator orders_it,
+                               object fill_amount=None):
+        """
+        Fill a limit order, either completely or by fill_amount.
+
+        :param fill_amount: amount to fill, or None to fill whatever is left of the order
+        """
         try:
             if is_buy:
-                self.c_process_limit_bid_order(limit_orders_map_ptr, map_it_ptr, orders_it)
+                self.c_process_limit_bid_order(limit_orders_map_ptr, map_it_ptr, orders_it, fill_amount)
             else:
-                self.c_process_limit_ask_order(limit_orders_map_ptr, map_it_ptr, orders_it)
+                self.c_process_limit_ask_order(limit_orders_map_ptr, map_it_ptr, orders_it, fill_amount)
         except Exception as e:
             self.logger().error(f"Error processing limit order.", exc_info=True)
 
+    cdef c_process_fills(self,
+                         bint is_buy,
+                         LimitOrders *limit_orders_map_ptr,
+                         LimitOrdersIterator *map_it_ptr,
+                         vector[MatchFill] *fills):
+        """
+        Apply a batch of fills from the matching engine, in the order the engine produced them.
+
+        :param is_buy: are the filled limit orders on the bid side?
+        :param limit_orders_map_ptr: pointer to the limit orders map
+        :param map_it_ptr: limit orders map iterator, which implies the trading pair being processed
+        :param fills: fills returned by the matching engine
+        """
+        cdef:
+            const MatchFill *fill_ptr = NULL
+            object fill_amount
+            size_t i
+
+        for i in range(fills.size()):
+            fill_ptr = address(deref(fills)[i])
+            fill_amount = None
+            if fill_ptr.remainingQuantity > 0:
+                fill_amount = self.c_quantize_order_amount(deref(fill_ptr.order).getTradingPair().decode("utf8"),
+                                                           Decimal(repr(fill_ptr.quantity)))
+                # The engine has taken the whole fill off the order. What the rounding leaves out is given back, so
+                # that the engine keeps the remaining quantity of the order, and dust fills never add up to a fill.
+                self._matching_engine.restoreQuantity(deref(fill_ptr.order).getClientOrderHandle(),
+                                                      fill_ptr.quantity - float(fill_amount))
+                if fill_amount <= s_decimal_0:
+                    continue
+            self.c_process_limit_order(is_buy, limit_orders_map_ptr, map_it_ptr, fill_ptr.order, fill_amount)
+
     cdef c_process_crossed_limit_orders_for_trading_pair(self,
                                                          bint is_buy,
                                                          LimitOrders *limit_orders_map_ptr,
@@ -845,32 +1050,17 @@ cdef class PaperTradeExchange(ExchangeBase):
         :param map_it_ptr: limit orders map iterator, which implies the trading pair being processed
         """
         cdef:
-            str trading_pair = deref(deref(map_it_ptr)).first.decode("utf8")
-            object opposite_order_book_price = self.c_get_price(trading_pair, is_buy)
+            str trading_pair = getSymbolName(deref(deref(map_it_ptr)).first).decode("utf8")
+            double opposite_order_book_price = float(self.c_get_price(trading_pair, is_buy))
             SingleTradingPairLimitOrders *orders_collection_ptr = address(deref(deref(map_it_ptr)).second)
-            SingleTradingPairLimitOrdersIterator orders_it = orders_collection_ptr.begin()
-            SingleTradingPairLimitOrdersRIterator orders_rit = orders_collection_ptr.rbegin()
-            vector[SingleTradingPairLimitOrdersIterator] process_order_its
-            const CPPLimitOrder *cpp_limit_order_ptr = NULL
-
-        if is_buy:
-            while orders_rit != orders_collection_ptr.rend():
-                cpp_limit_order_ptr = address(deref(orders_rit))
-                if opposite_order_book_price > <object>cpp_limit_order_ptr.getPrice():
-                    break
-                process_order_its.push_back(getIteratorFromReverseIterator(
-                    <reverse_iterator[SingleTradingPairLimitOrdersIterator]>orders_rit))
-                inc(orders_rit)
-        else:
-            while orders_it != orders_collection_ptr.end():
-                cpp_limit_order_ptr = address(deref(orders_it))
-                if opposite_order_book_price < <object>cpp_limit_order_ptr.getPrice():
-                    break
-                process_order_its.push_back(orders_it)
-                inc(orders_it)
+            vector[MatchFill] fills
 
-        for orders_it in process_order_its:
-            self.c_process_limit_order(is_buy, limit_orders_map_ptr, map_it_ptr, orders_it)
+        # An empty opposite side has no price that could cross any of the limit orders.
+        if isnan(opposite_order_book_price):
+            return
+
+        self._matching_engine.matchCrossedBook(deref(orders_collection_ptr), is_buy, opposite_order_book_price, fills)
+        self.c_process_fills(is_buy, limit_orders_map_ptr, map_it_ptr, address(fills))
 
     cdef c_process_crossed_limit_orders(self):
         cdef:
@@ -890,6 +1080,41 @@ cdef class PaperTradeExchange(ExchangeBase):
             if map_it != limit_orders_ptr.end():
                 inc(map_it)
 
+        self._limit_orders_added = False
+        self._crossed_check_book_version = self.c_get_order_books_version()
+
+    cdef uint64_t c_get_order_books_version(self):
+        """
+        Changes whenever any of the order books is updated. Book versions only ever grow, so their sum does too.
+
+        This runs on every tick, so it adds up the versions natively. Books maintained by a worker pool give theirs
+        from the book's sync without taking the book lock.
+        """
+        cdef:
+            uint64_t version = 0
+            OrderBook order_book
+
+        for order_book in self.order_book_tracker.order_books.values():
+            version += order_book.c_get_version()
+        return version
+
+    cdef c_process_expired_orders(self, double timestamp):
+        """
+        Cancel the limit orders whose expiration timestamp has passed, and emit an order expired event for each of them.
+
+        :param timestamp: current timestamp
+        """
+        cdef:
+            vector[CPPOrderExpirationEntry] expired_entries
+            size_t i
+
+        if self._limit_order_expiration_wheel.empty():
+            return
+
+        self._limit_order_expiration_wheel.popExpired(timestamp, expired_entries)
+        for i in range(expired_entries.size()):
+            self.c_cancel_limit_order(expired_entries[i].getClientOrderHandle(), True)
+
     # <editor-fold desc="Event listener functions">
     cdef c_match_trade_to_limit_orders(self, object order_book_trade_event):
         """
@@ -898,44 +1123,35 @@ cdef class PaperTradeExchange(ExchangeBase):
         :param order_book_trade_event: trade event from order book
         """
         cdef:
-            string cpp_trading_pair = order_book_trade_event.trading_pair.encode("utf8")
+            SymbolHandle trading_pair_handle = self.c_get_trading_pair_handle(order_book_trade_event.trading_pair)
             bint is_maker_buy = order_book_trade_event.type is TradeType.SELL
-            object trade_price = order_book_trade_event.price
-            object trade_quantity = order_book_trade_event.amount
+            double trade_price = float(order_book_trade_event.price)
+            double trade_quantity = float(order_book_trade_event.amount)
             LimitOrders *limit_orders_map_ptr = (address(self._bid_limit_orders)
                                                  if is_maker_buy
                                                  else address(self._ask_limit_orders))
-            LimitOrdersIterator map_it = limit_orders_map_ptr.find(cpp_trading_pair)
-            SingleTradingPairLimitOrders *orders_collection_ptr = NULL
-            SingleTradingPairLimitOrdersIterator orders_it
-            SingleTradingPairLimitOrdersRIterator orders_rit
-            vector[SingleTradingPairLimitOrdersIterator] process_order_its
-            const CPPLimitOrder *cpp_limit_order_ptr = NULL
+            LimitOrdersIterator map_it = limit_orders_map_ptr.find(trading_pair_handle)
+            vector[MatchFill] fills
+            OrderBook order_book
 
         if map_it == limit_orders_map_ptr.end():
             return
 
-        orders_collection_ptr = address(deref(map_it).second)
-        if is_maker_buy:
-            orders_rit = orders_collection_ptr.rbegin()
-            while orders_rit != orders_collection_ptr.rend():
-                cpp_limit_order_ptr = address(deref(orders_rit))
-                if <object>cpp_limit_order_ptr.getPrice() <= trade_price:
-                    break
-                process_order_its.push_back(getIteratorFromReverseIterator(
-                    <reverse_iterator[SingleTradingPairLimitOrdersIterator]>orders_rit))
-                inc(orders_rit)
+        if self._matching_engine.getQueuePositionsEnabled():
+            order_book = self.c_get_order_book(order_book_trade_event.trading_pair)
+            order_book.c_lock_book()
+            try:
+                if is_maker_buy:
+                    self._matching_engine.matchTrade(deref(map_it).second, is_maker_buy, trade_price, trade_quantity,
+                                                     order_book._bid_book, fills)
+                else:
+                    self._matching_engine.matchTrade(deref(map_it).second, is_maker_buy, trade_price, trade_quantity,
+                                                     order_book._ask_book, fills)
+            finally:
+                order_book.c_unlock_book()
         else:
-            orders_it = orders_collection_ptr.begin()
-            while orders_it != orders_collection_ptr.end():
-                cpp_limit_order_ptr = address(deref(orders_it))
-                if <object>cpp_limit_order_ptr.getPrice() >= trade_price:
-                    break
-                process_order_its.push_back(orders_it)
-                inc(orders_it)
-
-        for orders_it in process_order_its:
-            self.c_process_limit_order(is_maker_buy, limit_orders_map_ptr, address(map_it), orders_it)
+            self._matching_engine.matchTrade(deref(map_it).second, is_maker_buy, trade_price, trade_quantity, fills)
+        self.c_process_fills(is_maker_buy, limit_orders_map_ptr, address(map_it), address(fills))
 
     # </editor-fold>
 
@@ -961,43 +1177,77 @@ cdef class PaperTradeExchange(ExchangeBase):
                                                LimitOrders *orders_map,
                                                str trading_pair_str,
                                                bint cancel_all=False,
-                                               str client_order_id=None):
+                                               str client_order_id=None,
+                                               bint expired=False):
         cdef:
-            string cpp_trading_pair = trading_pair_str.encode("utf8")
-            LimitOrdersIterator map_it = orders_map.find(cpp_trading_pair)
+            LimitOrdersIterator map_it = orders_map.find(self.c_get_trading_pair_handle(trading_pair_str))
             SingleTradingPairLimitOrders *limit_orders_collection_ptr = NULL
             SingleTradingPairLimitOrdersIterator orders_it
-            vector[SingleTradingPairLimitOrdersIterator] process_order_its
-            const CPPLimitOrder *limit_order_ptr = NULL
-            str limit_order_cid
+            LimitOrderIteratorsIterator order_it
+            vector[SymbolHandle] process_order_handles
+            SymbolHandle client_order_handle = 0
             list cancellation_results = []
         try:
             if map_it == orders_map.end():
                 return []
-
-            limit_orders_collection_ptr = address(deref(map_it).second)
-            orders_it = limit_orders_collection_ptr.begin()
-            while orders_it != limit_orders_collection_ptr.end():
-                limit_order_ptr = address(deref(orders_it))
-                limit_order_cid = limit_order_ptr.getClientOrderID().decode("utf8")
-                if (not cancel_all and limit_order_cid == client_order_id) or cancel_all:
-                    process_order_its.push_back(orders_it)
-                inc(orders_it)
-
-            for orders_it in process_order_its:
-                limit_order_ptr = address(deref(orders_it))
-                limit_order_cid = limit_order_ptr.getClientOrderID().decode("utf8")
-                delete_success = self.c_delete_limit_order(orders_map, address(map_it), orders_it)
-                cancellation_results.append(CancellationResult(limit_order_cid,
-                                                               delete_success))
-                self.c_trigger_event(self.MARKET_ORDER_CANCELED_EVENT_TAG,
-                                     OrderCancelledEvent(self._current_timestamp,
-                                                         limit_order_cid)
-                                     )
+            if not cancel_all:
+                # An order ID without a handle is not held by any live order.
+                if not findSymbol(client_order_id.encode("utf8"), client_order_handle):
+                    return []
+                order_it = self._limit_order_iterators.find(client_order_handle)
+                if (order_it == self._limit_order_iterators.end() or
+                        deref(deref(order_it).second).getTradingPairHandle() != deref(map_it).first or
+                        deref(deref(order_it).second).getIsBuy() != (orders_map == address(self._bid_limit_orders))):
+                    return []
+                process_order_handles.push_back(client_order_handle)
+            else:
+                limit_orders_collection_ptr = address(deref(map_it).second)
+                orders_it = limit_orders_collection_ptr.begin()
+                while orders_it != limit_orders_collection_ptr.end():
+                    process_order_handles.push_back(deref(orders_it).getClientOrderHandle())
+                    inc(orders_it)
+
+            for client_order_handle in process_order_handles:
+                cancellation_results.append(self.c_cancel_limit_order(client_order_handle, expired))
             return cancellation_results
         except Exception as err:
             self.logger().error(f"Error canceling order.", exc_info=True)
 
+    cdef object c_cancel_limit_order(self, SymbolHandle client_order_handle, bint expired):
+        """
+        Removes the resting limit order with the given client order handle, found through its set iterator rather than
+        by scanning its trading pair's orders, and emits its cancelled or expired event.
+
+        :return: the cancellation result, or None if no resting limit order has the handle
+        """
+        cdef:
+            LimitOrderIteratorsIterator order_it = self._limit_order_iterators.find(client_order_handle)
+            SingleTradingPairLimitOrdersIterator orders_it
+            LimitOrders *limit_orders_map_ptr = NULL
+            LimitOrdersIterator map_it
+            str limit_order_cid
+
+        if order_it == self._limit_order_iterators.end():
+            return None
+        orders_it = deref(order_it).second
+        limit_orders_map_ptr = (address(self._bid_limit_orders)
+                                if deref(orders_it).getIsBuy()
+                                else address(self._ask_limit_orders))
+        map_it = limit_orders_map_ptr.find(deref(orders_it).getTradingPairHandle())
+        limit_order_cid = deref(orders_it).getClientOrderID().decode("utf8")
+        delete_success = self.c_delete_limit_order(limit_orders_map_ptr, address(map_it), orders_it)
+        if expired:
+            self.c_trigger_event(self.MARKET_ORDER_EXPIRED_EVENT_TAG,
+                                 OrderExpiredEvent(self._current_timestamp,
+                                                   limit_order_cid)
+                                 )
+        else:
+            self.c_trigger_event(self.MARKET_ORDER_CANCELED_EVENT_TAG,
+                                 OrderCancelledEvent(self._current_timestamp,
+                                                     limit_order_cid)
+                                 )
+        return CancellationResult(limit_order_cid, delete_success)
+
     cdef c_cancel(self, str trading_pair_str, str client_order_id):
         cdef:
             string cpp_trading_pair = trading_pair_str.encode("utf8")
@@ -0,0 +1,113 @@
+import math
+import os
+from concurrent.futures import ProcessPoolExecutor
+from typing import Any, Callable, List, NamedTuple, Optional, Sequence
+
+from hummingbot.core.clock import Clock
+from hummingbot.core.clock_mode import ClockMode
+from hummingbot.core.data_type.l2_capture import L2Replay, L2ReplayIterator
+from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.time_iterator import TimeIterator
+
+
+class BacktestScenario(NamedTuple):
+    """
+    One backtest instance built by a scenario factory: the order books to feed from the market data, the iterators to
+    put on the clock after the market data (usually the exchange, then the strategy), and a callable returning the
+    scenario's result once the backtest is over. The result must be picklable.
+    """
+    order_books: List[OrderBook]
+    iterators: List[TimeIterator]
+    result: Callable[[], Any]
+
+
+class BacktestScenarioRunner:
+    """
+    Runs many backtest scenarios, such as a parameter sweep of one strategy, over the same recorded market data.
+
+    The market data is an L2 capture file (see L2Recorder). Each worker process maps it read-only, so every worker
+    shares the same pages of the page cache and nothing is parsed. Inside a worker, one pass over the file feeds the
+    order books of all the worker's scenarios in lockstep, under a single fast forwarding clock.
+
+    The scenario factory is called in the worker with one entry of scenario_params, and returns a BacktestScenario.
+    With more than one process, the factory and its parameters are pickled, so the factory has to be a module level
+    function.
+    """
+
+    def __init__(self,
+                 capture_path: str,
+                 scenario_factory: Callable[[Any], BacktestScenario],
+                 start_time: float,
+                 end_time: float = float("nan"),
+                 tick_size: float = 1.0,
+                 fast_forward: bool = True,
+                 num_processes: Optional[int] = None):
+        """
+        :param capture_path: L2 capture file holding the market data
+        :param scenario_factory: builds one scenario from its parameters
+        :param start_time: start of the backtests in UNIX timestamp
+        :param end_time: end of the backtests in UNIX timestamp. NaN to run to the last record of the data.
+        :param tick_size: the tick size of the backtest clocks
+        :param fast_forward: skip the ticks at which no iterator has anything to do
+        :param num_processes: number of worker processes, the number of CPUs by default. 1 runs everything in the
+                              calling process.
+        """
+        self._capture_path = capture_path
+        self._scenario_factory = scenario_factory
+        self._start_time = start_time
+        self._end_time = end_time
+        self._tick_size = tick_size
+        self._fast_forward = fast_forward
+        self._num_processes = num_processes or os.cpu_count() or 1
+
+    @property
+    def num_processes(self) -> int:
+        return self._num_processes
+
+    def run(self, scenario_params: Sequence[Any]) -> List[Any]:
+        """
+        Runs one scenario for each entry of scenario_params, and returns their results in the same order.
+        """
+        scenario_params = list(scenario_params)
+        if len(scenario_params) == 0:
+            return []
+        num_processes = min(self._num_processes, len(scenario_params))
+        if num_processes == 1:
+            return self._run_scenarios(scenario_params)
+
+        # Contiguous chunks, one per process, so each process builds its scenarios once and replays the data once.
+        chunk_size = math.ceil(len(scenario_params) / num_processes)
+        chunks = [scenario_params[i:i + chunk_size] for i in range(0, len(scenario_params), chunk_size)]
+        results = []
+        with ProcessPoolExecutor(max_workers=len(chunks)) as executor:
+            for chunk_results in executor.map(self._run_scenarios, chunks):
+                results.extend(chunk_results)
+        return results
+
+    def _run_scenarios(self, scenario_params: List[Any]) -> List[Any]:
+        scenarios = [self._scenario_factory(params) for params in scenario_params]
+        replay = L2Replay(self._capture_path)
+        replay_iterator = L2ReplayIterator(replay)
+        # The clock only stops by itself once no iterator will ever wake up again, which an iterator needing every tick
+        # never says, so a run to the end of the data ends at the last record.
+        end_time = self._end_time
+        if math.isnan(end_time):
+            end_time = replay.last_timestamp
+            if math.isnan(end_time):
+                end_time = self._start_time
+        clock = Clock(ClockMode.BACKTEST,
+                      tick_size=self._tick_size,
+                      start_time=self._start_time,
+                      end_time=end_time,
+                      fast_forward=self._fast_forward)
+
+        # The market data goes first, so every scenario sees the same book state on each tick.
+        clock.add_iterator(replay_iterator)
+        for scenario in scenarios:
+            for order_book in scenario.order_books:
+                replay_iterator.add_order_book(order_book)
+            for iterator in scenario.iterators:
+                clock.add_iterator(iterator)
+        with clock:
+            clock.backtest()
+        return [scenario.result() for scenario in scenarios]
@@ -10,3 +10,7 @@ cdef class Clock:
         list _current_context
         double _current_tick
         bint _started
+        bint _fast_forward
+
+    cdef double c_next_wakeup_timestamp(self)
+    cdef double c_next_backtest_tick(self, double timestamp)
@@ -5,6 +5,8 @@ import logging
 import time
 from typing import List
 
+from libc.math cimport INFINITY, NAN, ceil, isnan
+
 from hummingbot.core.time_iterator import TimeIterator
 from hummingbot.core.time_iterator cimport TimeIterator
 from hummingbot.core.clock_mode import ClockMode
@@ -21,12 +23,14 @@ cdef class Clock:
             s_logger = logging.getLogger(__name__)
         return s_logger
 
-    def __init__(self, clock_mode: ClockMode, tick_size: float = 1.0, start_time: float = 0.0, end_time: float = 0.0):
+    def __init__(self, clock_mode: ClockMode, tick_size: float = 1.0, start_time: float = 0.0, end_time: float = 0.0,
+                 fast_forward: bool = False):
         """
         :param clock_mode: either real time mode or back testing mode
         :param tick_size: time interval of each tick
         :param start_time: (back testing mode only) start of simulation in UNIX timestamp
         :param end_time: (back testing mode only) end of simulation in UNIX timestamp. NaN to simulate to end of data.
+        :param fast_forward: (back testing mode only) skip the ticks at which no child iterator has anything to do
         """
         self._clock_mode = clock_mode
         self._tick_size = tick_size
@@ -36,6 +40,7 @@ cdef class Clock:
         self._child_iterators = []
         self._current_context = None
         self._started = False
+        self._fast_forward = fast_forward
 
     @property
     def clock_mode(self) -> ClockMode:
@@ -49,6 +54,14 @@ cdef class Clock:
     def tick_size(self) -> float:
         return self._tick_size
 
+    @property
+    def fast_forward(self) -> bool:
+        return self._fast_forward
+
+    @fast_forward.setter
+    def fast_forward(self, value: bool):
+        self._fast_forward = value
+
     @property
     def child_iterators(self) -> List[TimeIterator]:
         return self._child_iterators
@@ -127,8 +140,46 @@ cdef class Clock:
                 child_iterator = ci
                 child_iterator._clock = None
 
+    cdef double c_next_wakeup_timestamp(self):
+        """
+        The earliest wake-up timestamp published by the child iterators. NaN if any of them needs every tick.
+        """
+        cdef:
+            TimeIterator child_iterator
+            double next_wakeup = INFINITY
+            double wakeup
+
+        for ci in self._child_iterators:
+            child_iterator = ci
+            wakeup = child_iterator.c_next_wakeup_timestamp()
+            if isnan(wakeup):
+                return wakeup
+            if wakeup < next_wakeup:
+                next_wakeup = wakeup
+        return next_wakeup
+
+    cdef double c_next_backtest_tick(self, double timestamp):
+        """
+        The tick a fast forwarding backtest goes to next: the first tick at or after the earliest wake-up, but not past
+        the first tick at or after timestamp. NaN if no child iterator will ever wake up and there is no end timestamp.
+        """
+        cdef:
+            double next_tick = self._current_tick + self._tick_size
+            double wakeup = self.c_next_wakeup_timestamp()
+
+        if isnan(wakeup) or wakeup <= next_tick:
+            return next_tick
+        if isnan(timestamp):
+            if wakeup == INFINITY:
+                return NAN
+        elif wakeup > timestamp:
+            wakeup = timestamp
+        return self._current_tick + ceil((wakeup - self._current_tick) / self._tick_size) * self._tick_size
+
     def backtest_til(self, timestamp: float):
-        cdef TimeIterator child_iterator
+        cdef:
+            TimeIterator child_iterator
+            double next_tick
 
         if not self._started:
             for ci in self._child_iterators:
@@ -138,7 +189,13 @@ cdef class Clock:
 
         try:
             while not (self._current_tick >= timestamp):
-                self._current_tick += self._tick_size
+                if self._fast_forward:
+                    next_tick = self.c_next_backtest_tick(timestamp)
+                    if isnan(next_tick):
+                        return
+                    self._current_tick = next_tick
+                else:
+                    self._current_tick += self._tick_size
                 for ci in self._child_iterators:
                     child_iterator = ci
                     try:
@@ -0,0 +1,321 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <time.h>
+
+BenchmarkState::BenchmarkState(uint64_t maxIterations) {
+    this->maxIterations = maxIterations;
+    this->iterations = 0;
+    this->startNanoseconds = this->startCpuNanoseconds = 0;
+    this->elapsedNanoseconds = this->elapsedCpuNanoseconds = 0;
+    this->running = false;
+    this->itemsProcessed = 0;
+}
+
+int64_t BenchmarkState::getWallNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t BenchmarkState::getCpuNanoseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Starts the clocks on the first call, and stops them once the iterations are done.
+bool BenchmarkState::keepRunning() {
+    if (!this->running && this->iterations == 0) {
+        this->running = true;
+        this->startNanoseconds = getWallNanoseconds();
+        this->startCpuNanoseconds = getCpuNanoseconds();
+    }
+    if (this->iterations < this->maxIterations) {
+        this->iterations++;
+        return true;
+    }
+    if (this->running) {
+        this->elapsedNanoseconds += getWallNanoseconds() - this->startNanoseconds;
+        this->elapsedCpuNanoseconds += getCpuNanoseconds() - this->startCpuNanoseconds;
+        this->running = false;
+    }
+    return false;
+}
+
+void BenchmarkState::pauseTiming() {
+    if (this->running) {
+        this->elapsedNanoseconds += getWallNanoseconds() - this->startNanoseconds;
+        this->elapsedCpuNanoseconds += getCpuNanoseconds() - this->startCpuNanoseconds;
+        this->running = false;
+    }
+}
+
+void BenchmarkState::resumeTiming() {
+    if (!this->running) {
+        this->running = true;
+        this->startNanoseconds = getWallNanoseconds();
+        this->startCpuNanoseconds = getCpuNanoseconds();
+    }
+}
+
+uint64_t BenchmarkState::getIterations() const {
+    return this->iterations;
+}
+
+int64_t BenchmarkState::getElapsedNanoseconds() const {
+    return this->elapsedNanoseconds;
+}
+
+int64_t BenchmarkState::getElapsedCpuNanoseconds() const {
+    return this->elapsedCpuNanoseconds;
+}
+
+void BenchmarkState::setItemsProcessed(uint64_t itemsProcessed) {
+    this->itemsProcessed = itemsProcessed;
+}
+
+uint64_t BenchmarkState::getItemsProcessed() const {
+    return this->itemsProcessed;
+}
+
+void BenchmarkState::setLabel(const std::string &label) {
+    this->label = label;
+}
+
+const std::string &BenchmarkState::getLabel() const {
+    return this->label;
+}
+
+namespace {
+
+std::string escapeJson(const std::string &value) {
+    std::string escaped;
+    for (size_t i = 0; i < value.size(); i++) {
+        char c = value[i];
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)c);
+            escaped += buffer;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+BenchmarkResult aggregate(const std::vector<BenchmarkResult> &runs, const std::string &aggregateName) {
+    BenchmarkResult result = runs[0];
+    result.name = runs[0].runName + "_" + aggregateName;
+    result.runType = "aggregate";
+    result.aggregateName = aggregateName;
+    result.iterations = runs.size();
+    std::vector<double> realTimes, cpuTimes, itemRates;
+    for (size_t i = 0; i < runs.size(); i++) {
+        realTimes.push_back(runs[i].realTime);
+        cpuTimes.push_back(runs[i].cpuTime);
+        itemRates.push_back(runs[i].itemsPerSecond);
+    }
+    std::vector<double> *series[3] = {&realTimes, &cpuTimes, &itemRates};
+    double values[3];
+    for (size_t s = 0; s < 3; s++) {
+        std::vector<double> &v = *series[s];
+        double mean = 0;
+        for (size_t i = 0; i < v.size(); i++) {
+            mean += v[i] / v.size();
+        }
+        if (aggregateName == "mean") {
+            values[s] = mean;
+        } else if (aggregateName == "median") {
+            std::sort(v.begin(), v.end());
+            values[s] = v.size() % 2 == 1 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+        } else {
+            double squares = 0;
+            for (size_t i = 0; i < v.size(); i++) {
+                squares += (v[i] - mean) * (v[i] - mean);
+            }
+            values[s] = v.size() > 1 ? std::sqrt(squares / (v.size() - 1)) : 0;
+        }
+    }
+    result.realTime = values[0];
+    result.cpuTime = values[1];
+    result.itemsPerSecond = values[2];
+    return result;
+}
+
+}
+
+BenchmarkRunner::BenchmarkRunner() {
+    this->filterValid = true;
+    this->minTime = 0.5;
+    this->repetitions = 1;
+    this->jsonFormat = false;
+    this->listOnly = false;
+}
+
+void BenchmarkRunner::add(const std::string &name, const BenchmarkFunction &function) {
+    this->benchmarks.push_back(std::make_pair(name, function));
+}
+
+// Context entries are reported in the order they were added.
+void BenchmarkRunner::addContext(const std::string &key, const std::string &value) {
+    this->context.push_back(std::make_pair(key, value));
+}
+
+// Returns the arguments that are not benchmark flags.
+std::vector<std::string> BenchmarkRunner::parseArguments(int argc, char **argv) {
+    std::vector<std::string> remaining;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        std::string value = argument.substr(argument.find('=') + 1);
+        if (argument.compare(0, 19, "--benchmark_filter=") == 0) {
+            this->filter = value == "all" ? "" : value;
+            try {
+                this->filterPattern = std::regex(this->filter);
+                this->filterValid = true;
+            } catch (const std::regex_error &) {
+                this->filterValid = false;
+            }
+        } else if (argument.compare(0, 21, "--benchmark_min_time=") == 0) {
+            this->minTime = std::atof(value.c_str());
+        } else if (argument.compare(0, 24, "--benchmark_repetitions=") == 0) {
+            this->repetitions = std::max(std::atoi(value.c_str()), 1);
+        } else if (argument.compare(0, 19, "--benchmark_format=") == 0) {
+            this->jsonFormat = value == "json";
+        } else if (argument.compare(0, 16, "--benchmark_out=") == 0) {
+            this->outputPath = value;
+        } else if (argument == "--benchmark_list_tests" || argument == "--benchmark_list_tests=true") {
+            this->listOnly = true;
+        } else if (argument == "--benchmark_list_tests=false") {
+            this->listOnly = false;
+        } else {
+            remaining.push_back(argument);
+        }
+    }
+    return remaining;
+}
+
+bool BenchmarkRunner::matches(const std::string &name) const {
+    return this->filter.empty() || std::regex_search(name, this->filterPattern);
+}
+
+BenchmarkResult BenchmarkRunner::runOne(const std::string &name, const BenchmarkFunction &function) const {
+    uint64_t iterations = 1;
+    BenchmarkState state(iterations);
+    while (true) {
+        state = BenchmarkState(iterations);
+        function(state);
+        double seconds = state.getElapsedNanoseconds() * 1e-9;
+        if (seconds >= this->minTime || iterations >= 1000000000) {
+            break;
+        }
+        // Aim a little past the minimum time, growing by at most 10x per run like Google Benchmark does.
+        double multiplier = seconds <= this->minTime / 10 ? 10 : this->minTime * 1.4 / seconds;
+        iterations = std::max((uint64_t)(iterations * multiplier), iterations + 1);
+    }
+
+    BenchmarkResult result;
+    result.name = result.runName = name;
+    result.runType = "iteration";
+    result.iterations = state.getIterations();
+    result.realTime = (double)state.getElapsedNanoseconds() / state.getIterations();
+    result.cpuTime = (double)state.getElapsedCpuNanoseconds() / state.getIterations();
+    result.itemsPerSecond = state.getElapsedCpuNanoseconds() > 0
+                            ? state.getItemsProcessed() * 1e9 / state.getElapsedCpuNanoseconds() : 0;
+    result.label = state.getLabel();
+    return result;
+}
+
+void BenchmarkRunner::writeConsole(FILE *file, const std::vector<BenchmarkResult> &results) const {
+    fprintf(file, "%-60s %15s %15s %12s %s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations", "Items/s");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &result = results[i];
+        fprintf(file, "%-60s %15.1f %15.1f %12llu %.4g %s\n", result.name.c_str(), result.realTime, result.cpuTime,
+                (unsigned long long)result.iterations, result.itemsPerSecond, result.label.c_str());
+    }
+}
+
+void BenchmarkRunner::writeJson(FILE *file, const std::vector<BenchmarkResult> &results) const {
+    fprintf(file, "{\n  \"context\": {\n");
+    for (size_t i = 0; i < this->context.size(); i++) {
+        fprintf(file, "    \"%s\": \"%s\",\n", escapeJson(this->context[i].first).c_str(),
+                escapeJson(this->context[i].second).c_str());
+    }
+#ifdef NDEBUG
+    fprintf(file, "    \"library_build_type\": \"release\"\n");
+#else
+    fprintf(file, "    \"library_build_type\": \"debug\"\n");
+#endif
+    fprintf(file, "  },\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &result = results[i];
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", escapeJson(result.name).c_str());
+        fprintf(file, "      \"run_name\": \"%s\",\n", escapeJson(result.runName).c_str());
+        fprintf(file, "      \"run_type\": \"%s\",\n", result.runType.c_str());
+        if (!result.aggregateName.empty()) {
+            fprintf(file, "      \"aggregate_name\": \"%s\",\n", result.aggregateName.c_str());
+        }
+        fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)result.iterations);
+        fprintf(file, "      \"real_time\": %.6e,\n", result.realTime);
+        fprintf(file, "      \"cpu_time\": %.6e,\n", result.cpuTime);
+        fprintf(file, "      \"time_unit\": \"ns\",\n");
+        fprintf(file, "      \"items_per_second\": %.6e,\n", result.itemsPerSecond);
+        fprintf(file, "      \"label\": \"%s\"\n", escapeJson(result.label).c_str());
+        fprintf(file, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+// Runs the matching benchmarks and writes the report to stdout, and as JSON to the output path if there is one.
+// Returns a process exit code.
+int BenchmarkRunner::run() {
+    if (!this->filterValid) {
+        fprintf(stderr, "Invalid --benchmark_filter pattern %s\n", this->filter.c_str());
+        return 2;
+    }
+    std::vector<BenchmarkResult> results;
+    for (size_t i = 0; i < this->benchmarks.size(); i++) {
+        const std::string &name = this->benchmarks[i].first;
+        if (!this->matches(name)) {
+            continue;
+        }
+        if (this->listOnly) {
+            printf("%s\n", name.c_str());
+            continue;
+        }
+        std::vector<BenchmarkResult> runs;
+        for (size_t r = 0; r < this->repetitions; r++) {
+            runs.push_back(this->runOne(name, this->benchmarks[i].second));
+        }
+        results.insert(results.end(), runs.begin(), runs.end());
+        if (runs.size() > 1) {
+            results.push_back(aggregate(runs, "mean"));
+            results.push_back(aggregate(runs, "median"));
+            results.push_back(aggregate(runs, "stddev"));
+        }
+    }
+    if (this->listOnly) {
+        return 0;
+    }
+
+    if (this->jsonFormat) {
+        this->writeJson(stdout, results);
+    } else {
+        this->writeConsole(stdout, results);
+    }
+    if (!this->outputPath.empty()) {
+        FILE *file = fopen(this->outputPath.c_str(), "w");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot write %s\n", this->outputPath.c_str());
+            return 1;
+        }
+        this->writeJson(file, results);
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Passed to every benchmark function, in the style of Google Benchmark's benchmark::State. The function loops on
+// keepRunning() and does one iteration of its work per turn. Setup that must not be timed goes between pauseTiming()
+// and resumeTiming().
+class BenchmarkState {
+    uint64_t maxIterations;
+    uint64_t iterations;
+    int64_t startNanoseconds;
+    int64_t startCpuNanoseconds;
+    int64_t elapsedNanoseconds;
+    int64_t elapsedCpuNanoseconds;
+    bool running;
+    uint64_t itemsProcessed;
+    std::string label;
+
+    public:
+        BenchmarkState(uint64_t maxIterations);
+
+        bool keepRunning();
+        void pauseTiming();
+        void resumeTiming();
+
+        uint64_t getIterations() const;
+        int64_t getElapsedNanoseconds() const;
+        int64_t getElapsedCpuNanoseconds() const;
+        void setItemsProcessed(uint64_t itemsProcessed);
+        uint64_t getItemsProcessed() const;
+        void setLabel(const std::string &label);
+        const std::string &getLabel() const;
+
+        static int64_t getWallNanoseconds();
+        static int64_t getCpuNanoseconds();
+};
+
+typedef std::function<void(BenchmarkState &)> BenchmarkFunction;
+
+// Keeps the compiler from optimising away a result that the benchmark never uses.
+template <typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// The timing of one run of a benchmark, per iteration. Aggregates over repetitions are named after the benchmark with
+// a _mean, _median or _stddev suffix.
+struct BenchmarkResult {
+    std::string name;
+    std::string runName;
+    std::string runType;
+    std::string aggregateName;
+    uint64_t iterations;
+    double realTime;
+    double cpuTime;
+    double itemsPerSecond;
+    std::string label;
+};
+
+// Registers and runs benchmarks, and reports them on the console or as JSON.
+//
+// Each benchmark is first run with one iteration, then with more and more until a run lasts at least the minimum
+// time, in the same way as Google Benchmark. Only that last run is reported. The JSON report uses the Google Benchmark
+// schema, so its tools can compare two reports. Benchmarks are reported in the order they were registered, and the
+// report carries no date, so reports of the same build and workloads differ only in their timings.
+//
+// Recognised flags: --benchmark_filter=<regex> (or "all"), matched anywhere in the benchmark name like Google Benchmark
+// does, --benchmark_min_time=<seconds>, --benchmark_repetitions=<n>, --benchmark_format=<console|json> for stdout,
+// --benchmark_out=<path> for a JSON copy, and --benchmark_list_tests[=<true|false>]. Any other argument is left for
+// the caller.
+class BenchmarkRunner {
+    std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+    std::vector<std::pair<std::string, std::string>> context;
+    std::string filter;
+    std::regex filterPattern;
+    bool filterValid;
+    double minTime;
+    size_t repetitions;
+    bool jsonFormat;
+    bool listOnly;
+    std::string outputPath;
+
+    BenchmarkResult runOne(const std::string &name, const BenchmarkFunction &function) const;
+    void writeConsole(FILE *file, const std::vector<BenchmarkResult> &results) const;
+    void writeJson(FILE *file, const std::vector<BenchmarkResult> &results) const;
+
+    public:
+        BenchmarkRunner();
+
+        void add(const std::string &name, const BenchmarkFunction &function);
+        void addContext(const std::string &key, const std::string &value);
+        std::vector<std::string> parseArguments(int argc, char **argv);
+        bool matches(const std::string &name) const;
+        int run();
+};
+
+#endif
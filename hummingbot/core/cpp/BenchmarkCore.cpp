@@ -0,0 +1,492 @@
+// Benchmarks of the native order book path: the legacy std::set books, OrderBookSide, overlap truncation, limit order
+// and expiration sets, PyRef hashing and the L3 order table, replayed over the workloads of BenchmarkWorkloads.h.
+//
+// Besides the flags of BenchmarkRunner, it takes --workload_seed=<n> to generate other workloads,
+// --workload_capture=<path> to also replay an L2 capture file, and --workload_out=<directory> to write the generated
+// workloads out as capture files.
+
+#include <Python.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+#include "Benchmark.h"
+#include "BenchmarkWorkloads.h"
+#include "DiffCoalescer.h"
+#include "L3OrderTable.h"
+#include "LimitOrder.h"
+#include "OrderBookEntry.h"
+#include "OrderBookSide.h"
+#include "OrderExpirationEntry.h"
+#include "PyRef.h"
+
+namespace {
+
+const size_t TOP_LEVELS = 20;
+const size_t MESSAGES_PER_TICK = 10;
+const size_t NUM_ORDERS = 10000;
+
+std::vector<OrderBookEntry> toEntries(const std::vector<double> &rows) {
+    std::vector<OrderBookEntry> entries;
+    for (size_t i = 0; i + 2 < rows.size(); i += 3) {
+        entries.push_back(OrderBookEntry(rows[i], rows[i + 1], (int64_t)rows[i + 2]));
+    }
+    return entries;
+}
+
+std::string describe(const Workload &workload) {
+    std::ostringstream label;
+    label << workload.getSnapshotLevelCount() << " levels, " << workload.batches.size() << " messages, "
+          << workload.getDiffRowCount() << " rows";
+    return label.str();
+}
+
+// One diff row applied to a std::set side, the way the order book did before OrderBookSide.
+void applySetRow(std::set<OrderBookEntry> &book, const double *row) {
+    OrderBookEntry entry(row[0], row[1], (int64_t)row[2]);
+    std::set<OrderBookEntry>::iterator level = book.find(entry);
+    if (level != book.end()) {
+        book.erase(level);
+    }
+    if (row[1] > 0) {
+        book.insert(entry);
+    }
+}
+
+void benchmarkSetSnapshot(BenchmarkState &state, const Workload &workload) {
+    std::vector<OrderBookEntry> bids = toEntries(workload.snapshotBids);
+    std::vector<OrderBookEntry> asks = toEntries(workload.snapshotAsks);
+    while (state.keepRunning()) {
+        std::set<OrderBookEntry> bidBook(bids.begin(), bids.end());
+        std::set<OrderBookEntry> askBook(asks.begin(), asks.end());
+        doNotOptimize(bidBook.size() + askBook.size());
+    }
+    state.setItemsProcessed(state.getIterations() * workload.getSnapshotLevelCount());
+    state.setLabel(describe(workload));
+}
+
+void benchmarkSetApplyDiffs(BenchmarkState &state, const Workload &workload) {
+    std::vector<OrderBookEntry> bids = toEntries(workload.snapshotBids);
+    std::vector<OrderBookEntry> asks = toEntries(workload.snapshotAsks);
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        std::set<OrderBookEntry> bidBook(bids.begin(), bids.end());
+        std::set<OrderBookEntry> askBook(asks.begin(), asks.end());
+        state.resumeTiming();
+        for (size_t i = 0; i < workload.batches.size(); i++) {
+            const WorkloadBatch &batch = workload.batches[i];
+            for (size_t j = 0; j < batch.numBids; j++) {
+                applySetRow(bidBook, workload.bidRows.data() + (batch.bidOffset + j) * 3);
+            }
+            for (size_t j = 0; j < batch.numAsks; j++) {
+                applySetRow(askBook, workload.askRows.data() + (batch.askOffset + j) * 3);
+            }
+            truncateOverlapEntries(bidBook, askBook, 0);
+        }
+        doNotOptimize(bidBook.size() + askBook.size());
+    }
+    state.setItemsProcessed(state.getIterations() * workload.getDiffRowCount());
+    state.setLabel(describe(workload));
+}
+
+void benchmarkSideAssign(BenchmarkState &state, const Workload &workload) {
+    std::vector<OrderBookEntry> bids = toEntries(workload.snapshotBids);
+    std::vector<OrderBookEntry> asks = toEntries(workload.snapshotAsks);
+    OrderBookSide bidBook(true);
+    OrderBookSide askBook(false);
+    while (state.keepRunning()) {
+        bidBook.assign(bids);
+        askBook.assign(asks);
+        doNotOptimize(bidBook.size() + askBook.size());
+    }
+    state.setItemsProcessed(state.getIterations() * workload.getSnapshotLevelCount());
+    state.setLabel(describe(workload));
+}
+
+// Applies every message of the workload with applyDiffs(), optionally syncing the top levels and running a depth
+// query on both sides after each message, as a refreshed book does before a strategy reads it.
+void replayWorkload(const Workload &workload, OrderBookSide &bidBook, OrderBookSide &askBook, bool query) {
+    double bestBid = NAN;
+    double bestAsk = NAN;
+    for (size_t i = 0; i < workload.batches.size(); i++) {
+        const WorkloadBatch &batch = workload.batches[i];
+        applyDiffs(bidBook, askBook, workload.bidRows.data() + batch.bidOffset * 3, batch.numBids,
+                   workload.askRows.data() + batch.askOffset * 3, batch.numAsks, 0, bestBid, bestAsk);
+        if (query) {
+            bidBook.syncTopLevels();
+            askBook.syncTopLevels();
+            doNotOptimize(bidBook.getVwapForVolume(50).resultPrice);
+            doNotOptimize(askBook.getVwapForVolume(50).resultPrice);
+        }
+    }
+    doNotOptimize(bestBid + bestAsk);
+}
+
+void benchmarkSideApplyDiffs(BenchmarkState &state, const Workload &workload) {
+    std::vector<OrderBookEntry> bids = toEntries(workload.snapshotBids);
+    std::vector<OrderBookEntry> asks = toEntries(workload.snapshotAsks);
+    OrderBookSide bidBook(true);
+    OrderBookSide askBook(false);
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        bidBook.assign(bids);
+        askBook.assign(asks);
+        state.resumeTiming();
+        replayWorkload(workload, bidBook, askBook, false);
+    }
+    state.setItemsProcessed(state.getIterations() * workload.getDiffRowCount());
+    state.setLabel(describe(workload));
+}
+
+// The whole feed as a live book sees it: the snapshot, every message, and a mirrored and queried top of book.
+void benchmarkReplay(BenchmarkState &state, const Workload &workload, bool depthIndex) {
+    std::vector<OrderBookEntry> bids = toEntries(workload.snapshotBids);
+    std::vector<OrderBookEntry> asks = toEntries(workload.snapshotAsks);
+    std::vector<double> bidTop(TOP_LEVELS * 3);
+    std::vector<double> askTop(TOP_LEVELS * 3);
+    while (state.keepRunning()) {
+        OrderBookSide bidBook(true);
+        OrderBookSide askBook(false);
+        bidBook.setDepthIndexEnabled(depthIndex);
+        askBook.setDepthIndexEnabled(depthIndex);
+        bidBook.setTopLevelsBuffer(bidTop.data(), TOP_LEVELS);
+        askBook.setTopLevelsBuffer(askTop.data(), TOP_LEVELS);
+        bidBook.assign(bids);
+        askBook.assign(asks);
+        replayWorkload(workload, bidBook, askBook, true);
+    }
+    state.setItemsProcessed(state.getIterations() * workload.batches.size());
+    state.setLabel(describe(workload));
+}
+
+// The replay above as a coalescing order book runs it: the messages are held back and their net levels applied once
+// every few messages, when a strategy tick reads the book.
+void benchmarkCoalescedReplay(BenchmarkState &state, const Workload &workload) {
+    std::vector<OrderBookEntry> bids = toEntries(workload.snapshotBids);
+    std::vector<OrderBookEntry> asks = toEntries(workload.snapshotAsks);
+    std::vector<double> bidTop(TOP_LEVELS * 3);
+    std::vector<double> askTop(TOP_LEVELS * 3);
+    DiffCoalescer coalescer;
+    while (state.keepRunning()) {
+        OrderBookSide bidBook(true);
+        OrderBookSide askBook(false);
+        bidBook.setTopLevelsBuffer(bidTop.data(), TOP_LEVELS);
+        askBook.setTopLevelsBuffer(askTop.data(), TOP_LEVELS);
+        bidBook.assign(bids);
+        askBook.assign(asks);
+        double bestBid = NAN;
+        double bestAsk = NAN;
+        for (size_t i = 0; i < workload.batches.size(); i++) {
+            const WorkloadBatch &batch = workload.batches[i];
+            coalescer.addRows(workload.bidRows.data() + batch.bidOffset * 3, batch.numBids,
+                              workload.askRows.data() + batch.askOffset * 3, batch.numAsks);
+            if ((i + 1) % MESSAGES_PER_TICK == 0 || i + 1 == workload.batches.size()) {
+                applyDiffs(bidBook, askBook, coalescer.getBidRows(), coalescer.getBidCount(),
+                           coalescer.getAskRows(), coalescer.getAskCount(), 0, bestBid, bestAsk);
+                coalescer.clear();
+                doNotOptimize(bidBook.getVwapForVolume(50).resultPrice);
+                doNotOptimize(askBook.getVwapForVolume(50).resultPrice);
+            }
+        }
+        doNotOptimize(bestBid + bestAsk);
+    }
+    state.setItemsProcessed(state.getIterations() * workload.batches.size());
+    state.setLabel(describe(workload));
+}
+
+// Two sides of 1000 levels whose top 100 levels cross, with the bids newer than the asks on every other level.
+void makeCrossedRows(std::vector<OrderBookEntry> &bids, std::vector<OrderBookEntry> &asks) {
+    for (int64_t i = 0; i < 1000; i++) {
+        bids.push_back(OrderBookEntry((10100 - i) * 0.01, 1 + i % 7, i % 2 == 0 ? 3 : 1));
+        asks.push_back(OrderBookEntry((10001 + i) * 0.01, 1 + i % 5, 2));
+    }
+}
+
+void benchmarkTruncateSide(BenchmarkState &state, int dex) {
+    std::vector<OrderBookEntry> bids, asks;
+    makeCrossedRows(bids, asks);
+    OrderBookSide bidBook(true);
+    OrderBookSide askBook(false);
+    uint64_t removed = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        bidBook.assign(bids);
+        askBook.assign(asks);
+        state.resumeTiming();
+        truncateOverlapEntries(bidBook, askBook, dex);
+        removed += bids.size() + asks.size() - bidBook.size() - askBook.size();
+    }
+    state.setItemsProcessed(removed);
+}
+
+void benchmarkTruncateSet(BenchmarkState &state, int dex) {
+    std::vector<OrderBookEntry> bids, asks;
+    makeCrossedRows(bids, asks);
+    uint64_t removed = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        std::set<OrderBookEntry> bidBook(bids.begin(), bids.end());
+        std::set<OrderBookEntry> askBook(asks.begin(), asks.end());
+        state.resumeTiming();
+        truncateOverlapEntries(bidBook, askBook, dex);
+        removed += bids.size() + asks.size() - bidBook.size() - askBook.size();
+    }
+    state.setItemsProcessed(removed);
+}
+
+std::string makeOrderId(size_t i) {
+    std::ostringstream id;
+    id << "buy-ETH-USDT-" << 1600000000000000 + i;
+    return id.str();
+}
+
+// Orders quoted over 200 ticks, in a shuffled order. The price objects are created once and shared.
+struct OrderFixture {
+    std::vector<PyObject *> prices;
+    PyObject *quantity;
+    std::vector<std::string> ids;
+    std::vector<size_t> priceIndices;
+
+    OrderFixture() {
+        WorkloadRandom random(7);
+        for (size_t i = 0; i < 200; i++) {
+            this->prices.push_back(PyFloat_FromDouble(100 + i * 0.01));
+        }
+        this->quantity = PyFloat_FromDouble(1);
+        for (size_t i = 0; i < NUM_ORDERS; i++) {
+            this->ids.push_back(makeOrderId(random.below(NUM_ORDERS * 10)));
+            this->priceIndices.push_back(random.below(this->prices.size()));
+        }
+    }
+
+    ~OrderFixture() {
+        for (size_t i = 0; i < this->prices.size(); i++) {
+            Py_DECREF(this->prices[i]);
+        }
+        Py_DECREF(this->quantity);
+    }
+};
+
+void benchmarkLimitOrderSort(BenchmarkState &state, const OrderFixture &fixture) {
+    std::vector<LimitOrder> orders;
+    for (size_t i = 0; i < NUM_ORDERS; i++) {
+        orders.push_back(LimitOrder(fixture.ids[i], "ETH-USDT", true, "ETH", "USDT",
+                                    fixture.prices[fixture.priceIndices[i]], fixture.quantity));
+    }
+    std::vector<LimitOrder> sorted;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        sorted = orders;
+        state.resumeTiming();
+        std::sort(sorted.begin(), sorted.end());
+        doNotOptimize(sorted.front().getPriceKey());
+    }
+    state.setItemsProcessed(state.getIterations() * NUM_ORDERS);
+}
+
+// Places every order, then cancels them in the order they were placed, so the set keeps reusing its pooled nodes.
+void benchmarkLimitOrderSet(BenchmarkState &state, const OrderFixture &fixture) {
+    LimitOrderSet orders;
+    std::vector<LimitOrderSet::iterator> placed;
+    placed.reserve(NUM_ORDERS);
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < NUM_ORDERS; i++) {
+            std::pair<LimitOrderSet::iterator, bool> result = emplaceLimitOrder(
+                orders, fixture.ids[i], "ETH-USDT", true, "ETH", "USDT", fixture.prices[fixture.priceIndices[i]],
+                fixture.quantity, fixture.quantity, 0, 0, "NIL");
+            if (result.second) {
+                placed.push_back(result.first);
+            }
+        }
+        for (size_t i = 0; i < placed.size(); i++) {
+            orders.erase(placed[i]);
+        }
+        placed.clear();
+    }
+    state.setItemsProcessed(state.getIterations() * NUM_ORDERS * 2);
+}
+
+// A set of live orders where every step expires the earliest order and adds a new one.
+void benchmarkExpirationSet(BenchmarkState &state, const OrderFixture &fixture) {
+    OrderExpirationSet entries;
+    for (size_t i = 0; i < NUM_ORDERS; i++) {
+        emplaceOrderExpirationEntry(entries, "ETH-USDT", fixture.ids[i], i, i + 60.0 * fixture.priceIndices[i]);
+    }
+    double timestamp = NUM_ORDERS;
+    size_t next = 0;
+    while (state.keepRunning()) {
+        entries.erase(entries.begin());
+        emplaceOrderExpirationEntry(entries, "ETH-USDT", fixture.ids[next], timestamp,
+                                    timestamp + 60.0 * fixture.priceIndices[next]);
+        timestamp += 1;
+        next = (next + 1) % NUM_ORDERS;
+    }
+    doNotOptimize(entries.size());
+    state.setItemsProcessed(state.getIterations() * 2);
+}
+
+void benchmarkPyRefHash(BenchmarkState &state, const OrderFixture &fixture) {
+    std::vector<PyRef> refs(fixture.prices.begin(), fixture.prices.end());
+    std::hash<PyRef> hasher;
+    while (state.keepRunning()) {
+        size_t sum = 0;
+        for (size_t i = 0; i < refs.size(); i++) {
+            sum += hasher(refs[i]);
+        }
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * refs.size());
+}
+
+void benchmarkPyRefSet(BenchmarkState &state, const OrderFixture &fixture) {
+    std::vector<PyRef> refs(fixture.prices.begin(), fixture.prices.end());
+    while (state.keepRunning()) {
+        std::unordered_set<PyRef> set(refs.begin(), refs.end());
+        size_t found = 0;
+        for (size_t i = 0; i < refs.size(); i++) {
+            found += set.count(refs[i]);
+        }
+        doNotOptimize(found);
+    }
+    state.setItemsProcessed(state.getIterations() * refs.size() * 2);
+}
+
+// Opens every order of the fixture on an L3 table, resizes each one and closes them all, looking each order up by
+// its exchange order ID the way a market by order feed does.
+void benchmarkL3OrderTable(BenchmarkState &state, const OrderFixture &fixture) {
+    L3OrderTable table;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < NUM_ORDERS; i++) {
+            table.open(fixture.ids[i], "", i % 2 == 0, 100 + fixture.priceIndices[i] * 0.01, 1, i);
+        }
+        for (size_t i = 0; i < NUM_ORDERS; i++) {
+            table.change(table.findByExchangeOrderId(fixture.ids[i]), 0.5, NUM_ORDERS + i);
+        }
+        for (size_t i = 0; i < NUM_ORDERS; i++) {
+            table.close(table.findByExchangeOrderId(fixture.ids[i]), NUM_ORDERS * 2 + i);
+        }
+        doNotOptimize(table.getBidDiffCount() + table.getAskDiffCount());
+        table.clearDiffRows();
+    }
+    state.setItemsProcessed(state.getIterations() * NUM_ORDERS * 3);
+}
+
+}
+
+int main(int argc, char **argv) {
+    Py_Initialize();
+    int exitCode = 0;
+    {
+        BenchmarkRunner runner;
+        std::vector<std::string> arguments = runner.parseArguments(argc, argv);
+        uint64_t seed = 1;
+        std::string capturePath;
+        std::string outputDirectory;
+        for (size_t i = 0; i < arguments.size(); i++) {
+            const std::string &argument = arguments[i];
+            std::string value = argument.substr(argument.find('=') + 1);
+            if (argument.compare(0, 16, "--workload_seed=") == 0) {
+                seed = std::strtoull(value.c_str(), NULL, 10);
+            } else if (argument.compare(0, 19, "--workload_capture=") == 0) {
+                capturePath = value;
+            } else if (argument.compare(0, 15, "--workload_out=") == 0) {
+                outputDirectory = value;
+            } else {
+                fprintf(stderr, "Unknown argument %s\n", argument.c_str());
+                Py_Finalize();
+                return 2;
+            }
+        }
+
+        std::vector<Workload> workloads;
+        workloads.push_back(makeDeepBookWorkload(seed));
+        workloads.push_back(makeBurstyDiffWorkload(seed));
+        workloads.push_back(makeCancelReplaceWorkload(seed));
+        for (size_t i = 0; i < workloads.size() && !outputDirectory.empty(); i++) {
+            std::string path = outputDirectory + "/" + workloads[i].name + ".l2";
+            if (!writeCaptureWorkload(path, workloads[i])) {
+                fprintf(stderr, "Cannot write %s\n", path.c_str());
+                Py_Finalize();
+                return 1;
+            }
+        }
+        if (!capturePath.empty()) {
+            Workload capture;
+            if (!readCaptureWorkload(capturePath, capture)) {
+                fprintf(stderr, "Cannot read a snapshot from %s\n", capturePath.c_str());
+                Py_Finalize();
+                return 1;
+            }
+            workloads.push_back(capture);
+        }
+
+        runner.addContext("executable", argv[0]);
+        runner.addContext("workload_seed", std::to_string((unsigned long long)seed));
+        runner.addContext("workload_capture", capturePath);
+
+        for (size_t i = 0; i < workloads.size(); i++) {
+            const Workload *workload = &workloads[i];
+            runner.add("OrderBookEntrySet/Snapshot/" + workload->name, [workload](BenchmarkState &state) {
+                benchmarkSetSnapshot(state, *workload);
+            });
+            runner.add("OrderBookEntrySet/ApplyDiffs/" + workload->name, [workload](BenchmarkState &state) {
+                benchmarkSetApplyDiffs(state, *workload);
+            });
+            runner.add("OrderBookSide/Assign/" + workload->name, [workload](BenchmarkState &state) {
+                benchmarkSideAssign(state, *workload);
+            });
+            runner.add("OrderBookSide/ApplyDiffs/" + workload->name, [workload](BenchmarkState &state) {
+                benchmarkSideApplyDiffs(state, *workload);
+            });
+            runner.add("Replay/" + workload->name, [workload](BenchmarkState &state) {
+                benchmarkReplay(state, *workload, false);
+            });
+            runner.add("Replay/" + workload->name + "/DepthIndex", [workload](BenchmarkState &state) {
+                benchmarkReplay(state, *workload, true);
+            });
+            runner.add("Replay/" + workload->name + "/Coalesced", [workload](BenchmarkState &state) {
+                benchmarkCoalescedReplay(state, *workload);
+            });
+        }
+        runner.add("TruncateOverlap/OrderBookSide/Centralised", [](BenchmarkState &state) {
+            benchmarkTruncateSide(state, 0);
+        });
+        runner.add("TruncateOverlap/OrderBookSide/Dex", [](BenchmarkState &state) {
+            benchmarkTruncateSide(state, 1);
+        });
+        runner.add("TruncateOverlap/OrderBookEntrySet/Centralised", [](BenchmarkState &state) {
+            benchmarkTruncateSet(state, 0);
+        });
+        runner.add("TruncateOverlap/OrderBookEntrySet/Dex", [](BenchmarkState &state) {
+            benchmarkTruncateSet(state, 1);
+        });
+
+        OrderFixture fixture;
+        const OrderFixture *orders = &fixture;
+        runner.add("LimitOrder/Sort", [orders](BenchmarkState &state) {
+            benchmarkLimitOrderSort(state, *orders);
+        });
+        runner.add("LimitOrderSet/PlaceCancel", [orders](BenchmarkState &state) {
+            benchmarkLimitOrderSet(state, *orders);
+        });
+        runner.add("OrderExpirationSet/Churn", [orders](BenchmarkState &state) {
+            benchmarkExpirationSet(state, *orders);
+        });
+        runner.add("PyRef/Hash", [orders](BenchmarkState &state) {
+            benchmarkPyRefHash(state, *orders);
+        });
+        runner.add("PyRef/UnorderedSet", [orders](BenchmarkState &state) {
+            benchmarkPyRefSet(state, *orders);
+        });
+        runner.add("L3OrderTable/OpenChangeClose", [orders](BenchmarkState &state) {
+            benchmarkL3OrderTable(state, *orders);
+        });
+
+        exitCode = runner.run();
+    }
+    Py_Finalize();
+    return exitCode;
+}
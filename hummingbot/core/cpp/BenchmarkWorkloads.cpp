@@ -0,0 +1,230 @@
+#include "BenchmarkWorkloads.h"
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include "L2Capture.h"
+
+namespace {
+
+const int64_t MID_TICKS = 10000;
+const double TICK = 0.01;
+
+void appendRow(std::vector<double> &rows, int64_t ticks, double amount, int64_t updateId) {
+    rows.push_back(ticks * TICK);
+    rows.push_back(amount);
+    rows.push_back((double)updateId);
+}
+
+// Amounts are whole hundredths between 0.01 and 10.
+double drawAmount(WorkloadRandom &random) {
+    return (1 + random.below(1000)) / 100.0;
+}
+
+void makeSnapshot(Workload &workload, WorkloadRandom &random, size_t numLevels, std::set<int64_t> *bidTicks,
+                  std::set<int64_t> *askTicks) {
+    for (size_t i = 0; i < numLevels; i++) {
+        appendRow(workload.snapshotBids, MID_TICKS - 1 - (int64_t)i, drawAmount(random), 1);
+        appendRow(workload.snapshotAsks, MID_TICKS + 1 + (int64_t)i, drawAmount(random), 1);
+        if (bidTicks != NULL) {
+            bidTicks->insert(MID_TICKS - 1 - (int64_t)i);
+            askTicks->insert(MID_TICKS + 1 + (int64_t)i);
+        }
+    }
+}
+
+// Starts a new message, whose rows are the rows appended until the next call.
+void beginBatch(Workload &workload) {
+    WorkloadBatch batch;
+    batch.bidOffset = workload.bidRows.size() / 3;
+    batch.askOffset = workload.askRows.size() / 3;
+    batch.numBids = batch.numAsks = 0;
+    batch.updateId = (int64_t)workload.batches.size() + 2;
+    workload.batches.push_back(batch);
+}
+
+void endBatch(Workload &workload) {
+    WorkloadBatch &batch = workload.batches.back();
+    batch.numBids = workload.bidRows.size() / 3 - batch.bidOffset;
+    batch.numAsks = workload.askRows.size() / 3 - batch.askOffset;
+}
+
+}
+
+size_t Workload::getSnapshotLevelCount() const {
+    return (this->snapshotBids.size() + this->snapshotAsks.size()) / 3;
+}
+
+size_t Workload::getDiffRowCount() const {
+    return (this->bidRows.size() + this->askRows.size()) / 3;
+}
+
+WorkloadRandom::WorkloadRandom(uint64_t seed) {
+    this->state = seed;
+}
+
+uint64_t WorkloadRandom::next() {
+    uint64_t z = (this->state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// The small modulo bias does not matter for workloads.
+uint64_t WorkloadRandom::below(uint64_t bound) {
+    return bound == 0 ? 0 : this->next() % bound;
+}
+
+Workload makeDeepBookWorkload(uint64_t seed) {
+    WorkloadRandom random(seed);
+    Workload workload;
+    workload.name = "deep_book";
+    makeSnapshot(workload, random, 5000, NULL, NULL);
+    for (size_t i = 0; i < 20000; i++) {
+        beginBatch(workload);
+        int64_t depth = (int64_t)random.below(5000);
+        // A quarter of the updates remove their level.
+        double amount = random.below(4) == 0 ? 0 : drawAmount(random);
+        if (random.below(2) == 0) {
+            appendRow(workload.bidRows, MID_TICKS - 1 - depth, amount, workload.batches.back().updateId);
+        } else {
+            appendRow(workload.askRows, MID_TICKS + 1 + depth, amount, workload.batches.back().updateId);
+        }
+        endBatch(workload);
+    }
+    return workload;
+}
+
+Workload makeBurstyDiffWorkload(uint64_t seed) {
+    WorkloadRandom random(seed);
+    Workload workload;
+    workload.name = "bursty_diffs";
+    makeSnapshot(workload, random, 500, NULL, NULL);
+    int64_t mid = MID_TICKS;
+    while (workload.batches.size() < 20000) {
+        size_t quietMessages = 10 + random.below(50);
+        for (size_t i = 0; i < quietMessages; i++) {
+            beginBatch(workload);
+            int64_t updateId = workload.batches.back().updateId;
+            size_t numLevels = 1 + random.below(2);
+            for (size_t j = 0; j < numLevels; j++) {
+                int64_t depth = (int64_t)random.below(10);
+                double amount = random.below(5) == 0 ? 0 : drawAmount(random);
+                if (random.below(2) == 0) {
+                    appendRow(workload.bidRows, mid - 1 - depth, amount, updateId);
+                } else {
+                    appendRow(workload.askRows, mid + 1 + depth, amount, updateId);
+                }
+            }
+            endBatch(workload);
+        }
+
+        // The mid price jumps, and the new quotes land all over the top 100 levels of both sides.
+        beginBatch(workload);
+        int64_t updateId = workload.batches.back().updateId;
+        int64_t move = 1 + (int64_t)random.below(5);
+        mid += random.below(2) == 0 ? move : -move;
+        size_t numLevels = 50 + random.below(151);
+        for (size_t j = 0; j < numLevels; j++) {
+            int64_t depth = (int64_t)random.below(100);
+            double amount = random.below(5) == 0 ? 0 : drawAmount(random);
+            if (j % 2 == 0) {
+                appendRow(workload.bidRows, mid - 1 - depth, amount, updateId);
+            } else {
+                appendRow(workload.askRows, mid + 1 + depth, amount, updateId);
+            }
+        }
+        endBatch(workload);
+    }
+    return workload;
+}
+
+Workload makeCancelReplaceWorkload(uint64_t seed) {
+    WorkloadRandom random(seed);
+    Workload workload;
+    workload.name = "cancel_replace";
+    std::set<int64_t> bidTicks;
+    std::set<int64_t> askTicks;
+    makeSnapshot(workload, random, 1000, &bidTicks, &askTicks);
+    for (size_t i = 0; i < 20000; i++) {
+        beginBatch(workload);
+        int64_t updateId = workload.batches.back().updateId;
+        bool isBid = random.below(2) == 0;
+        std::set<int64_t> &ticks = isBid ? bidTicks : askTicks;
+        std::vector<double> &rows = isBid ? workload.bidRows : workload.askRows;
+        size_t numOrders = 1 + random.below(4);
+        for (size_t j = 0; j < numOrders && ticks.size() > 20; j++) {
+            size_t depth = random.below(20);
+            int64_t tick;
+            if (isBid) {
+                tick = *std::next(ticks.rbegin(), depth);
+            } else {
+                tick = *std::next(ticks.begin(), depth);
+            }
+            // Replace inside the own side of the book, a tick or two away.
+            int64_t offset = 1 + (int64_t)random.below(2);
+            int64_t newTick = random.below(2) == 0 ? tick + offset : tick - offset;
+            if (isBid) {
+                newTick = std::min(newTick, *askTicks.begin() - 1);
+            } else {
+                newTick = std::max(newTick, *bidTicks.rbegin() + 1);
+            }
+            if (newTick == tick) {
+                continue;
+            }
+            appendRow(rows, tick, 0, updateId);
+            appendRow(rows, newTick, drawAmount(random), updateId);
+            ticks.erase(tick);
+            ticks.insert(newTick);
+        }
+        endBatch(workload);
+    }
+    return workload;
+}
+
+bool writeCaptureWorkload(const std::string &path, const Workload &workload) {
+    L2Recorder recorder;
+    if (!recorder.open(path, workload.name)) {
+        return false;
+    }
+    // Timestamps are made up from the update IDs, so the file is the same on every run.
+    bool ok = recorder.writeSnapshotRows(workload.snapshotBids.data(), workload.snapshotBids.size() / 3,
+                                         workload.snapshotAsks.data(), workload.snapshotAsks.size() / 3,
+                                         1, 1.0);
+    for (size_t i = 0; ok && i < workload.batches.size(); i++) {
+        const WorkloadBatch &batch = workload.batches[i];
+        ok = recorder.writeDiffRows(workload.bidRows.data() + batch.bidOffset * 3, batch.numBids,
+                                    workload.askRows.data() + batch.askOffset * 3, batch.numAsks,
+                                    batch.updateId, 1.0 + batch.updateId * 0.001);
+    }
+    recorder.close();
+    return ok;
+}
+
+bool readCaptureWorkload(const std::string &path, Workload &workload) {
+    L2Reader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    workload = Workload();
+    workload.name = "capture";
+    bool hasSnapshot = false;
+    L2Record record;
+    while (reader.next(record)) {
+        if (record.type == L2_RECORD_SNAPSHOT && !hasSnapshot) {
+            workload.snapshotBids.assign(record.bidRows, record.bidRows + record.numBids * 3);
+            workload.snapshotAsks.assign(record.askRows, record.askRows + record.numAsks * 3);
+            hasSnapshot = true;
+        } else if (record.type == L2_RECORD_DIFF && hasSnapshot) {
+            WorkloadBatch batch;
+            batch.bidOffset = workload.bidRows.size() / 3;
+            batch.numBids = record.numBids;
+            batch.askOffset = workload.askRows.size() / 3;
+            batch.numAsks = record.numAsks;
+            batch.updateId = record.updateId;
+            workload.bidRows.insert(workload.bidRows.end(), record.bidRows, record.bidRows + record.numBids * 3);
+            workload.askRows.insert(workload.askRows.end(), record.askRows, record.askRows + record.numAsks * 3);
+            workload.batches.push_back(batch);
+        }
+    }
+    return hasSnapshot;
+}
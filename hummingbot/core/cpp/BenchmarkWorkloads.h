@@ -0,0 +1,59 @@
+#ifndef _BENCHMARK_WORKLOADS_H
+#define _BENCHMARK_WORKLOADS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// One diff message of a workload: its rows in the workload's bid and ask row arrays.
+struct WorkloadBatch {
+    size_t bidOffset;
+    size_t numBids;
+    size_t askOffset;
+    size_t numAsks;
+    int64_t updateId;
+};
+
+// An L2 feed to replay in benchmarks: a snapshot, then diff messages. Rows are packed (price, amount, updateId)
+// doubles, as in capture files and as applyDiffs() reads them.
+struct Workload {
+    std::string name;
+    std::vector<double> snapshotBids;
+    std::vector<double> snapshotAsks;
+    std::vector<double> bidRows;
+    std::vector<double> askRows;
+    std::vector<WorkloadBatch> batches;
+
+    size_t getSnapshotLevelCount() const;
+    size_t getDiffRowCount() const;
+};
+
+// A splitmix64 generator. The workloads only draw from it through integer arithmetic, so the same seed makes the same
+// workload on every platform and standard library.
+class WorkloadRandom {
+    uint64_t state;
+
+    public:
+        WorkloadRandom(uint64_t seed);
+
+        uint64_t next();
+        uint64_t below(uint64_t bound);
+};
+
+// Generated workloads of the kinds a live book goes through, around a mid price of 100 with 0.01 ticks:
+// - deep_book: a 5000 level snapshot per side, then sparse single level updates spread over the whole depth.
+// - bursty_diffs: a 500 level book whose diffs come in quiet stretches of one or two levels near the top, then bursts
+//   of 50 to 200 levels while the mid price moves, which also updates levels the other side still holds.
+// - cancel_replace: quoting churn, where every message removes a few of the top 20 levels of a side and quotes each of
+//   them again a tick or two away.
+Workload makeDeepBookWorkload(uint64_t seed);
+Workload makeBurstyDiffWorkload(uint64_t seed);
+Workload makeCancelReplaceWorkload(uint64_t seed);
+
+// Workloads can be written to and read from L2 capture files, so a recorded feed can be benchmarked and a generated
+// one replayed through the Python side. Reading starts at the first snapshot of the file and ignores trades.
+bool writeCaptureWorkload(const std::string &path, const Workload &workload);
+bool readCaptureWorkload(const std::string &path, Workload &workload);
+
+#endif
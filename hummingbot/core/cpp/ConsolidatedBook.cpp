@@ -0,0 +1,167 @@
+#include "ConsolidatedBook.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+DepthQueryResult makeConsolidatedQueryResult(double queryPrice, double queryVolume,
+                                             double resultPrice, double resultVolume) {
+    DepthQueryResult result;
+    result.queryPrice = queryPrice;
+    result.queryVolume = queryVolume;
+    result.resultPrice = resultPrice;
+    result.resultVolume = resultVolume;
+    return result;
+}
+
+// Walks the consolidated ladder of one side, best level first.
+class LadderCursor {
+    const std::vector<const OrderBookSide *> &sides;
+    std::vector<size_t> depths;
+    bool isBuy;
+
+    public:
+        LadderCursor(const std::vector<const OrderBookSide *> &sides, bool isBuy) : sides(sides),
+                                                                                    depths(sides.size(), 0) {
+            this->isBuy = isBuy;
+        }
+
+        bool next(VenueLevel &level) {
+            size_t bestVenue = this->sides.size();
+            double bestPrice = 0;
+            for (size_t venue = 0; venue < this->sides.size(); venue++) {
+                if (this->depths[venue] >= this->sides[venue]->size()) {
+                    continue;
+                }
+                double price = this->sides[venue]->getLevel(this->depths[venue]).getPrice();
+                // Buying takes the asks from the lowest price up, selling takes the bids from the highest down.
+                if (bestVenue == this->sides.size() || (this->isBuy ? price < bestPrice : price > bestPrice)) {
+                    bestVenue = venue;
+                    bestPrice = price;
+                }
+            }
+            if (bestVenue == this->sides.size()) {
+                return false;
+            }
+            const OrderBookEntry &entry = this->sides[bestVenue]->getLevel(this->depths[bestVenue]++);
+            level.price = entry.getPrice();
+            level.amount = entry.getAmount();
+            level.venue = bestVenue;
+            return true;
+        }
+};
+
+}
+
+ConsolidatedBook::ConsolidatedBook() {
+}
+
+const std::vector<const OrderBookSide *> &ConsolidatedBook::getSides(bool isBuy) const {
+    return isBuy ? this->askSides : this->bidSides;
+}
+
+// Adds the sides of one venue's book, and returns the venue's index.
+size_t ConsolidatedBook::addVenue(const OrderBookSide &bidSide, const OrderBookSide &askSide) {
+    this->bidSides.push_back(&bidSide);
+    this->askSides.push_back(&askSide);
+    return this->bidSides.size() - 1;
+}
+
+void ConsolidatedBook::clear() {
+    this->bidSides.clear();
+    this->askSides.clear();
+}
+
+size_t ConsolidatedBook::getVenueCount() const {
+    return this->bidSides.size();
+}
+
+bool ConsolidatedBook::getBest(bool isBuy, VenueLevel &level) const {
+    LadderCursor cursor(this->getSides(isBuy), isBuy);
+    return cursor.next(level);
+}
+
+// Exports the ladder as packed (price, amount, venue) rows, best level first, and returns the number of rows.
+size_t ConsolidatedBook::exportLevels(bool isBuy, double *rows, size_t maxRows) const {
+    LadderCursor cursor(this->getSides(isBuy), isBuy);
+    VenueLevel level;
+    size_t numRows = 0;
+    while (numRows < maxRows && cursor.next(level)) {
+        rows[numRows * 3] = level.price;
+        rows[numRows * 3 + 1] = level.amount;
+        rows[numRows * 3 + 2] = (double)level.venue;
+        numRows++;
+    }
+    return numRows;
+}
+
+DepthQueryResult ConsolidatedBook::getPriceForVolume(bool isBuy, double volume) const {
+    LadderCursor cursor(this->getSides(isBuy), isBuy);
+    VenueLevel level;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    while (cursor.next(level)) {
+        cumulativeVolume += level.amount;
+        if (cumulativeVolume >= volume) {
+            resultPrice = level.price;
+            break;
+        }
+    }
+    return makeConsolidatedQueryResult(NAN, volume, resultPrice, std::min(cumulativeVolume, volume));
+}
+
+DepthQueryResult ConsolidatedBook::getVwapForVolume(bool isBuy, double volume) const {
+    LadderCursor cursor(this->getSides(isBuy), isBuy);
+    VenueLevel level;
+    double totalCost = 0;
+    double totalVolume = 0;
+    double resultVwap = NAN;
+    while (cursor.next(level)) {
+        if (totalVolume + level.amount >= volume) {
+            // Only take the part of the last level that is needed to reach the requested volume.
+            double incrementalAmount = volume - totalVolume;
+            totalCost += incrementalAmount * level.price;
+            totalVolume += incrementalAmount;
+            resultVwap = totalCost / totalVolume;
+            break;
+        }
+        totalCost += level.amount * level.price;
+        totalVolume += level.amount;
+    }
+    return makeConsolidatedQueryResult(NAN, volume, resultVwap, std::min(totalVolume, volume));
+}
+
+DepthQueryResult ConsolidatedBook::getVolumeForPrice(bool isBuy, double price) const {
+    LadderCursor cursor(this->getSides(isBuy), isBuy);
+    VenueLevel level;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    while (cursor.next(level)) {
+        if (isBuy ? level.price > price : level.price < price) {
+            break;
+        }
+        cumulativeVolume += level.amount;
+        resultPrice = level.price;
+    }
+    return makeConsolidatedQueryResult(price, NAN, resultPrice, cumulativeVolume);
+}
+
+// Splits the given volume across the venues, best prices first, the way a sweep of the consolidated ladder would
+// fill it. venueVolumes must hold one slot per venue. The result is laid out like getPriceForVolume().
+DepthQueryResult ConsolidatedBook::getVenueVolumesForVolume(bool isBuy, double volume, double *venueVolumes) const {
+    LadderCursor cursor(this->getSides(isBuy), isBuy);
+    VenueLevel level;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    std::fill(venueVolumes, venueVolumes + this->getVenueCount(), 0.0);
+    while (cursor.next(level)) {
+        double amount = std::min(level.amount, volume - cumulativeVolume);
+        venueVolumes[level.venue] += amount;
+        cumulativeVolume += amount;
+        if (cumulativeVolume >= volume) {
+            resultPrice = level.price;
+            break;
+        }
+    }
+    return makeConsolidatedQueryResult(NAN, volume, resultPrice, cumulativeVolume);
+}
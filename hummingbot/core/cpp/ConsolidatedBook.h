@@ -0,0 +1,47 @@
+#ifndef _CONSOLIDATED_BOOK_H
+#define _CONSOLIDATED_BOOK_H
+
+#include <stddef.h>
+#include <vector>
+#include "OrderBookSide.h"
+
+// A level of the consolidated ladder: one price level of one venue.
+struct VenueLevel {
+    double price;
+    double amount;
+    size_t venue;
+};
+
+// A consolidated view of the same market on several venues, such as the order books of one trading pair on several
+// exchanges.
+//
+// The venues' book sides are merged lazily at query time rather than copied into a ladder of their own. Each side is
+// already sorted by price, so walking the consolidated ladder from the best price is a merge of the venues' sides,
+// and a query only ever looks at the levels it needs. There is nothing to maintain when a venue's book changes, which
+// matters as diffs arrive far more often than queries. With the handful of venues a pair trades on, picking the best
+// head with a linear scan is cheaper than keeping a heap.
+//
+// Levels at the same price on different venues stay separate in the ladder, tagged with their venue, and ties go to
+// the venue added first. The venues' sides must outlive the consolidated book.
+class ConsolidatedBook {
+    std::vector<const OrderBookSide *> bidSides;
+    std::vector<const OrderBookSide *> askSides;
+
+    const std::vector<const OrderBookSide *> &getSides(bool isBuy) const;
+
+    public:
+        ConsolidatedBook();
+
+        size_t addVenue(const OrderBookSide &bidSide, const OrderBookSide &askSide);
+        void clear();
+        size_t getVenueCount() const;
+
+        bool getBest(bool isBuy, VenueLevel &level) const;
+        size_t exportLevels(bool isBuy, double *rows, size_t maxRows) const;
+        DepthQueryResult getPriceForVolume(bool isBuy, double volume) const;
+        DepthQueryResult getVwapForVolume(bool isBuy, double volume) const;
+        DepthQueryResult getVolumeForPrice(bool isBuy, double price) const;
+        DepthQueryResult getVenueVolumesForVolume(bool isBuy, double volume, double *venueVolumes) const;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#include "DiffCoalescer.h"
+#include <algorithm>
+#include <string.h>
+
+DiffCoalescer::DiffCoalescer() {
+    this->lastUpdateId = 0;
+    this->mergedCount = 0;
+}
+
+void DiffCoalescer::setPriceIncrement(double priceIncrement) {
+    this->priceScale = FixedPointScale(priceIncrement);
+}
+
+int64_t DiffCoalescer::getKey(double price) const {
+    if (this->priceScale.isEnabled()) {
+        return this->priceScale.toUnits(price);
+    }
+    // The bits of the price, with -0.0 folded into 0.0 since the book treats them as the same level.
+    int64_t key = 0;
+    double value = price == 0 ? 0.0 : price;
+    memcpy(&key, &value, sizeof(key));
+    return key;
+}
+
+void DiffCoalescer::addRow(Side &side, double price, double amount, int64_t updateId) {
+    std::pair<std::unordered_map<int64_t, size_t>::iterator, bool> slot =
+        side.slots.insert(std::make_pair(this->getKey(price), side.rows.size()));
+    if (slot.second) {
+        side.rows.push_back(price);
+        side.rows.push_back(amount);
+        side.rows.push_back((double)updateId);
+        return;
+    }
+    this->mergedCount++;
+    double *row = side.rows.data() + slot.first->second;
+    if (updateId >= (int64_t)row[2]) {
+        row[0] = price;
+        row[1] = amount;
+        row[2] = (double)updateId;
+    }
+}
+
+// Returns the largest update ID of the rows, like applyDiffs() does.
+int64_t DiffCoalescer::addRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks) {
+    int64_t batchUpdateId = 0;
+    for (size_t i = 0; i < numBids; i++) {
+        const double *row = bidRows + i * 3;
+        this->addRow(this->bids, row[0], row[1], (int64_t)row[2]);
+        batchUpdateId = std::max(batchUpdateId, (int64_t)row[2]);
+    }
+    for (size_t i = 0; i < numAsks; i++) {
+        const double *row = askRows + i * 3;
+        this->addRow(this->asks, row[0], row[1], (int64_t)row[2]);
+        batchUpdateId = std::max(batchUpdateId, (int64_t)row[2]);
+    }
+    this->lastUpdateId = std::max(this->lastUpdateId, batchUpdateId);
+    return batchUpdateId;
+}
+
+void DiffCoalescer::addEntries(const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                               int64_t updateId) {
+    for (std::vector<OrderBookEntry>::const_iterator it = bids.begin(); it != bids.end(); ++it) {
+        this->addRow(this->bids, it->getPrice(), it->getAmount(), it->getUpdateId());
+    }
+    for (std::vector<OrderBookEntry>::const_iterator it = asks.begin(); it != asks.end(); ++it) {
+        this->addRow(this->asks, it->getPrice(), it->getAmount(), it->getUpdateId());
+    }
+    this->lastUpdateId = std::max(this->lastUpdateId, updateId);
+}
+
+void DiffCoalescer::discardSide(Side &side, int64_t updateId) {
+    size_t kept = 0;
+    side.slots.clear();
+    for (size_t i = 0; i < side.rows.size(); i += 3) {
+        if ((int64_t)side.rows[i + 2] <= updateId) {
+            continue;
+        }
+        std::copy(side.rows.begin() + i, side.rows.begin() + i + 3, side.rows.begin() + kept);
+        side.slots[this->getKey(side.rows[kept])] = kept;
+        kept += 3;
+    }
+    side.rows.resize(kept);
+}
+
+// Drops the pending rows a snapshot with the given update ID already covers.
+void DiffCoalescer::discardUpTo(int64_t updateId) {
+    this->discardSide(this->bids, updateId);
+    this->discardSide(this->asks, updateId);
+    if (this->getPendingCount() == 0) {
+        this->lastUpdateId = 0;
+    }
+}
+
+// Drops every pending row, usually once they have been applied. The merged count keeps running.
+void DiffCoalescer::clear() {
+    this->bids.rows.clear();
+    this->bids.slots.clear();
+    this->asks.rows.clear();
+    this->asks.slots.clear();
+    this->lastUpdateId = 0;
+}
+
+const double *DiffCoalescer::getBidRows() const {
+    return this->bids.rows.data();
+}
+
+size_t DiffCoalescer::getBidCount() const {
+    return this->bids.rows.size() / 3;
+}
+
+const double *DiffCoalescer::getAskRows() const {
+    return this->asks.rows.data();
+}
+
+size_t DiffCoalescer::getAskCount() const {
+    return this->asks.rows.size() / 3;
+}
+
+size_t DiffCoalescer::getPendingCount() const {
+    return (this->bids.rows.size() + this->asks.rows.size()) / 3;
+}
+
+int64_t DiffCoalescer::getLastUpdateId() const {
+    return this->lastUpdateId;
+}
+
+// The number of rows that landed on a level which already had a pending row.
+uint64_t DiffCoalescer::getMergedCount() const {
+    return this->mergedCount;
+}
@@ -0,0 +1,55 @@
+#ifndef _DIFF_COALESCER_H
+#define _DIFF_COALESCER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+#include "OrderBookEntry.h"
+
+// Collects the diffs of an order book between two reads, keeping one row per price level.
+//
+// A row for a level that already has one pending replaces it, unless its update ID is older. The pending rows stay in
+// packed (price, amount, updateId) form, in the order their levels were first touched, so they can be handed to
+// applyDiffs() in one batch: a level updated a hundred times during a burst is then applied once, and the batch only
+// needs one overlap truncation and one best price read.
+//
+// Levels are keyed by their exact price, or by their tick count once a price increment is set, so prices with float
+// noise that the book would match to the same level also share a pending row.
+class DiffCoalescer {
+    struct Side {
+        std::vector<double> rows;
+        std::unordered_map<int64_t, size_t> slots;
+    };
+
+    Side bids;
+    Side asks;
+    FixedPointScale priceScale;
+    int64_t lastUpdateId;
+    uint64_t mergedCount;
+
+    int64_t getKey(double price) const;
+    void addRow(Side &side, double price, double amount, int64_t updateId);
+    void discardSide(Side &side, int64_t updateId);
+
+    public:
+        DiffCoalescer();
+
+        void setPriceIncrement(double priceIncrement);
+
+        int64_t addRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks);
+        void addEntries(const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                        int64_t updateId);
+        void discardUpTo(int64_t updateId);
+        void clear();
+
+        const double *getBidRows() const;
+        size_t getBidCount() const;
+        const double *getAskRows() const;
+        size_t getAskCount() const;
+        size_t getPendingCount() const;
+        int64_t getLastUpdateId() const;
+        uint64_t getMergedCount() const;
+};
+
+#endif
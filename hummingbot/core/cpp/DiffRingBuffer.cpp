@@ -0,0 +1,128 @@
+#include "DiffRingBuffer.h"
+
+DiffRingBuffer::DiffRingBuffer() : DiffRingBuffer(0) {
+}
+
+DiffRingBuffer::DiffRingBuffer(size_t capacity) {
+    this->writePosition.store(0);
+    this->readPosition.store(0);
+    this->droppedCount.store(0);
+    this->reset(capacity);
+}
+
+// Resizes the ring to at least the given capacity, rounded up to a power of two, and forgets anything pending. A zero
+// capacity disables the ring, so every push is dropped. Not thread safe: neither side may be using the ring meanwhile.
+void DiffRingBuffer::reset(size_t capacity) {
+    size_t slotCount = 0;
+    if (capacity > 0) {
+        slotCount = 1;
+        while (slotCount < capacity) {
+            slotCount <<= 1;
+        }
+    }
+    std::vector<DiffRecord>(slotCount).swap(this->records);
+    this->mask = slotCount > 0 ? slotCount - 1 : 0;
+    this->writePosition.store(0, std::memory_order_relaxed);
+    this->readPosition.store(0, std::memory_order_relaxed);
+    this->cachedReadPosition = 0;
+    this->droppedCount.store(0, std::memory_order_release);
+}
+
+// Called by the producer. Checks that count more records fit, and returns the position to write them from.
+bool DiffRingBuffer::reserve(size_t count, size_t &position) {
+    position = this->writePosition.load(std::memory_order_relaxed);
+    if (position + count - this->cachedReadPosition > this->records.size()) {
+        this->cachedReadPosition = this->readPosition.load(std::memory_order_acquire);
+        if (position + count - this->cachedReadPosition > this->records.size()) {
+            this->droppedCount.fetch_add(count, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DiffRingBuffer::push(bool isBid, double price, double amount, int64_t updateId) {
+    size_t position;
+    if (!this->reserve(1, position)) {
+        return false;
+    }
+    DiffRecord &record = this->records[position & this->mask];
+    record.price = price;
+    record.amount = amount;
+    record.updateId = updateId;
+    record.isBid = isBid;
+    record.endsMessage = true;
+    this->writePosition.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// Pushes packed (price, amount, updateId) rows for both sides of one message. Either all rows are published or none.
+bool DiffRingBuffer::pushRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks) {
+    size_t position;
+    if (!this->reserve(numBids + numAsks, position)) {
+        return false;
+    }
+    for (size_t i = 0; i < numBids + numAsks; ++i) {
+        const double *row = i < numBids ? bidRows + i * 3 : askRows + (i - numBids) * 3;
+        DiffRecord &record = this->records[(position + i) & this->mask];
+        record.price = row[0];
+        record.amount = row[1];
+        record.updateId = (int64_t)row[2];
+        record.isBid = i < numBids;
+        record.endsMessage = i + 1 == numBids + numAsks;
+    }
+    this->writePosition.store(position + numBids + numAsks, std::memory_order_release);
+    return true;
+}
+
+// Called by the consumer. Appends the pending records to the bid and ask rows, as packed (price, amount, updateId)
+// rows in the order they were pushed. Only whole messages are taken: as many as fit in maxRecords, but always at least
+// one, or every pending record if maxRecords is 0. Returns the number of records drained.
+size_t DiffRingBuffer::drain(std::vector<double> &bidRows, std::vector<double> &askRows, size_t maxRecords) {
+    size_t position = this->readPosition.load(std::memory_order_relaxed);
+    size_t count = this->writePosition.load(std::memory_order_acquire) - position;
+    if (maxRecords > 0 && count > maxRecords) {
+        size_t messageEnd = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (this->records[(position + i) & this->mask].endsMessage) {
+                if (i + 1 > maxRecords && messageEnd > 0) {
+                    break;
+                }
+                messageEnd = i + 1;
+                if (messageEnd >= maxRecords) {
+                    break;
+                }
+            }
+        }
+        count = messageEnd;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const DiffRecord &record = this->records[(position + i) & this->mask];
+        std::vector<double> &rows = record.isBid ? bidRows : askRows;
+        rows.push_back(record.price);
+        rows.push_back(record.amount);
+        rows.push_back((double)record.updateId);
+    }
+    if (count > 0) {
+        this->readPosition.store(position + count, std::memory_order_release);
+    }
+    return count;
+}
+
+size_t DiffRingBuffer::capacity() const {
+    return this->records.size();
+}
+
+// Number of pending records. Exact on the consumer side, a lower bound on the producer side.
+size_t DiffRingBuffer::size() const {
+    size_t readPosition = this->readPosition.load(std::memory_order_acquire);
+    return this->writePosition.load(std::memory_order_acquire) - readPosition;
+}
+
+bool DiffRingBuffer::empty() const {
+    return this->size() == 0;
+}
+
+uint64_t DiffRingBuffer::getDroppedCount() const {
+    return this->droppedCount.load(std::memory_order_relaxed);
+}
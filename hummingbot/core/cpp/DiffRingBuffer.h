@@ -0,0 +1,59 @@
+#ifndef _DIFF_RING_BUFFER_H
+#define _DIFF_RING_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+// One diff row bound for one side of an order book.
+struct DiffRecord {
+    double price;
+    double amount;
+    int64_t updateId;
+    bool isBid;
+    // Set on the last row of each push, so the consumer can tell where one message ends.
+    bool endsMessage;
+};
+
+// A lock free single producer, single consumer ring buffer of order book diffs.
+//
+// One thread - typically a network parser that does not hold the GIL - pushes diffs, and the thread that owns the
+// order book drains them in one batch. Each push publishes its rows all at once, so the consumer never sees half of a
+// message. A push that does not fit is dropped as a whole and counted, since a book that has missed diffs needs a
+// fresh snapshot anyway.
+//
+// The read and write positions sit on their own cache lines, and the producer keeps a cached copy of the read position
+// so it only touches the shared one when the ring looks full.
+class DiffRingBuffer {
+    std::vector<DiffRecord> records;
+    size_t mask;
+    char padding0[64];
+    std::atomic<size_t> writePosition;
+    size_t cachedReadPosition;
+    char padding1[64];
+    std::atomic<size_t> readPosition;
+    char padding2[64];
+    std::atomic<uint64_t> droppedCount;
+
+    bool reserve(size_t count, size_t &position);
+
+    public:
+        DiffRingBuffer();
+        DiffRingBuffer(size_t capacity);
+        DiffRingBuffer(const DiffRingBuffer &other) = delete;
+        DiffRingBuffer &operator=(const DiffRingBuffer &other) = delete;
+
+        void reset(size_t capacity);
+
+        bool push(bool isBid, double price, double amount, int64_t updateId);
+        bool pushRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks);
+        size_t drain(std::vector<double> &bidRows, std::vector<double> &askRows, size_t maxRecords);
+
+        size_t capacity() const;
+        size_t size() const;
+        bool empty() const;
+        uint64_t getDroppedCount() const;
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include "L2Capture.h"
+#include <chrono>
+#include <cmath>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char L2_MAGIC[8] = {'H', 'B', 'O', 'T', 'L', '2', 0, 0};
+static const uint32_t L2_VERSION = 1;
+
+static double wallClockTime() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+L2Recorder::L2Recorder() {
+    this->file = NULL;
+    this->recordCount = 0;
+}
+
+L2Recorder::~L2Recorder() {
+    this->close();
+}
+
+// Opens a capture file for appending, creating it if needed. An existing file must be a capture of the same trading
+// pair. A record cut short by an earlier crash is truncated away, so new records line up again.
+bool L2Recorder::open(const std::string &path, const std::string &tradingPair) {
+    this->close();
+    if (tradingPair.size() >= sizeof(((L2FileHeader *)0)->tradingPair)) {
+        return false;
+    }
+    FILE *file = fopen(path.c_str(), "ab+");
+    if (file == NULL) {
+        return false;
+    }
+    L2FileHeader header;
+    fseek(file, 0, SEEK_SET);
+    size_t numRead = fread(&header, 1, sizeof(header), file);
+    if (numRead == 0) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, L2_MAGIC, sizeof(L2_MAGIC));
+        header.version = L2_VERSION;
+        header.headerSize = sizeof(header);
+        memcpy(header.tradingPair, tradingPair.data(), tradingPair.size());
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            fclose(file);
+            return false;
+        }
+    } else if (numRead != sizeof(header) || memcmp(header.magic, L2_MAGIC, sizeof(L2_MAGIC)) != 0 ||
+               header.version != L2_VERSION || header.headerSize < sizeof(header) ||
+               strnlen(header.tradingPair, sizeof(header.tradingPair)) == sizeof(header.tradingPair) ||
+               tradingPair != header.tradingPair) {
+        fclose(file);
+        return false;
+    } else {
+        fseek(file, 0, SEEK_END);
+        long fileSize = ftell(file);
+        long validSize = header.headerSize;
+        L2RecordHeader recordHeader;
+        while (fseek(file, validSize, SEEK_SET) == 0 && fread(&recordHeader, sizeof(recordHeader), 1, file) == 1) {
+            long recordSize = (long)(sizeof(L2RecordHeader) +
+                                     ((size_t)recordHeader.numBids + recordHeader.numAsks) * sizeof(double) * 3);
+            if (validSize + recordSize > fileSize) {
+                break;
+            }
+            validSize += recordSize;
+        }
+        if (validSize < fileSize && (fflush(file) != 0 || ftruncate(fileno(file), validSize) != 0)) {
+            fclose(file);
+            return false;
+        }
+    }
+    // Switching from reading to writing needs a seek in between. Writes always go to the end in append mode.
+    fseek(file, 0, SEEK_END);
+    this->file = file;
+    this->recordCount = 0;
+    return true;
+}
+
+void L2Recorder::close() {
+    if (this->file != NULL) {
+        fclose(this->file);
+        this->file = NULL;
+    }
+}
+
+bool L2Recorder::isOpen() const {
+    return this->file != NULL;
+}
+
+bool L2Recorder::flush() {
+    return this->file != NULL && fflush(this->file) == 0;
+}
+
+bool L2Recorder::writeRecord(uint32_t type, uint32_t flags, size_t numBids, size_t numAsks, double timestamp,
+                             int64_t updateId, const double *bidRows, const double *askRows) {
+    if (this->file == NULL) {
+        return false;
+    }
+    L2RecordHeader header;
+    header.type = type;
+    header.flags = flags;
+    header.numBids = (uint32_t)numBids;
+    header.numAsks = (uint32_t)numAsks;
+    header.timestamp = std::isnan(timestamp) ? wallClockTime() : timestamp;
+    header.updateId = updateId;
+    if (fwrite(&header, sizeof(header), 1, this->file) != 1 ||
+        (numBids > 0 && fwrite(bidRows, sizeof(double) * 3, numBids, this->file) != numBids) ||
+        (numAsks > 0 && fwrite(askRows, sizeof(double) * 3, numAsks, this->file) != numAsks)) {
+        return false;
+    }
+    this->recordCount++;
+    return true;
+}
+
+bool L2Recorder::writeEntries(uint32_t type, const std::vector<OrderBookEntry> &bids,
+                              const std::vector<OrderBookEntry> &asks, int64_t updateId, double timestamp) {
+    this->rows.clear();
+    this->rows.reserve((bids.size() + asks.size()) * 3);
+    for (size_t i = 0; i < bids.size(); ++i) {
+        this->rows.push_back(bids[i].getPrice());
+        this->rows.push_back(bids[i].getAmount());
+        this->rows.push_back((double)bids[i].getUpdateId());
+    }
+    for (size_t i = 0; i < asks.size(); ++i) {
+        this->rows.push_back(asks[i].getPrice());
+        this->rows.push_back(asks[i].getAmount());
+        this->rows.push_back((double)asks[i].getUpdateId());
+    }
+    return this->writeRecord(type, 0, bids.size(), asks.size(), timestamp, updateId,
+                             this->rows.data(), this->rows.data() + bids.size() * 3);
+}
+
+bool L2Recorder::writeSnapshot(const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                               int64_t updateId, double timestamp) {
+    return this->writeEntries(L2_RECORD_SNAPSHOT, bids, asks, updateId, timestamp);
+}
+
+bool L2Recorder::writeDiffs(const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                            int64_t updateId, double timestamp) {
+    return this->writeEntries(L2_RECORD_DIFF, bids, asks, updateId, timestamp);
+}
+
+bool L2Recorder::writeSnapshotRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                                   int64_t updateId, double timestamp) {
+    return this->writeRecord(L2_RECORD_SNAPSHOT, 0, numBids, numAsks, timestamp, updateId, bidRows, askRows);
+}
+
+bool L2Recorder::writeDiffRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                               int64_t updateId, double timestamp) {
+    return this->writeRecord(L2_RECORD_DIFF, 0, numBids, numAsks, timestamp, updateId, bidRows, askRows);
+}
+
+bool L2Recorder::writeTrade(bool isBuy, double price, double amount, double tradeId, double timestamp) {
+    double row[3] = {price, amount, tradeId};
+    return this->writeRecord(L2_RECORD_TRADE, isBuy ? L2_TRADE_BUY : L2_TRADE_SELL, 1, 0, timestamp, 0, row, NULL);
+}
+
+uint64_t L2Recorder::getRecordCount() const {
+    return this->recordCount;
+}
+
+L2Reader::L2Reader() {
+    this->data = NULL;
+    this->dataSize = 0;
+    this->position = 0;
+}
+
+L2Reader::~L2Reader() {
+    this->close();
+}
+
+bool L2Reader::open(const std::string &path) {
+    this->close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(L2FileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t dataSize = (size_t)fileStat.st_size;
+    void *data = mmap(NULL, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    const L2FileHeader *header = (const L2FileHeader *)data;
+    if (memcmp(header->magic, L2_MAGIC, sizeof(L2_MAGIC)) != 0 || header->version != L2_VERSION ||
+        header->headerSize < sizeof(L2FileHeader) || header->headerSize > dataSize) {
+        munmap(data, dataSize);
+        return false;
+    }
+    madvise(data, dataSize, MADV_SEQUENTIAL);
+    this->data = (const char *)data;
+    this->dataSize = dataSize;
+    this->position = header->headerSize;
+    this->tradingPair.assign(header->tradingPair, strnlen(header->tradingPair, sizeof(header->tradingPair)));
+    return true;
+}
+
+void L2Reader::close() {
+    if (this->data != NULL) {
+        munmap((void *)this->data, this->dataSize);
+        this->data = NULL;
+    }
+    this->dataSize = 0;
+    this->position = 0;
+    this->tradingPair.clear();
+}
+
+bool L2Reader::isOpen() const {
+    return this->data != NULL;
+}
+
+// Reads the record header at the given offset. Returns false at the end of the file, or if the record there is cut
+// short.
+bool L2Reader::readHeaderAt(size_t offset, L2RecordHeader &header, size_t &recordSize) const {
+    if (this->data == NULL || offset + sizeof(L2RecordHeader) > this->dataSize) {
+        return false;
+    }
+    memcpy(&header, this->data + offset, sizeof(header));
+    recordSize = sizeof(L2RecordHeader) + ((size_t)header.numBids + header.numAsks) * sizeof(double) * 3;
+    return offset + recordSize <= this->dataSize;
+}
+
+bool L2Reader::next(L2Record &record) {
+    L2RecordHeader header;
+    size_t recordSize;
+    if (!this->readHeaderAt(this->position, header, recordSize)) {
+        return false;
+    }
+    const double *rows = (const double *)(this->data + this->position + sizeof(L2RecordHeader));
+    record.type = header.type;
+    record.flags = header.flags;
+    record.timestamp = header.timestamp;
+    record.updateId = header.updateId;
+    record.bidRows = rows;
+    record.numBids = header.numBids;
+    record.askRows = rows + (size_t)header.numBids * 3;
+    record.numAsks = header.numAsks;
+    this->position += recordSize;
+    return true;
+}
+
+// Returns the timestamp of the next record, or NaN if there is none.
+double L2Reader::peekTimestamp() const {
+    L2RecordHeader header;
+    size_t recordSize;
+    if (!this->readHeaderAt(this->position, header, recordSize)) {
+        return NAN;
+    }
+    return header.timestamp;
+}
+
+// Returns the timestamp of the last whole record in the file, or NaN if there is none. Only the record headers are read,
+// and the read position is left where it is.
+double L2Reader::getLastTimestamp() const {
+    L2RecordHeader header;
+    size_t recordSize;
+    double lastTimestamp = NAN;
+    if (this->data == NULL) {
+        return lastTimestamp;
+    }
+    size_t offset = ((const L2FileHeader *)this->data)->headerSize;
+    while (this->readHeaderAt(offset, header, recordSize)) {
+        lastTimestamp = header.timestamp;
+        offset += recordSize;
+    }
+    return lastTimestamp;
+}
+
+void L2Reader::rewind() {
+    if (this->data != NULL) {
+        this->position = ((const L2FileHeader *)this->data)->headerSize;
+    }
+}
+
+bool L2Reader::atEnd() const {
+    L2RecordHeader header;
+    size_t recordSize;
+    return !this->readHeaderAt(this->position, header, recordSize);
+}
+
+size_t L2Reader::getPosition() const {
+    return this->position;
+}
+
+size_t L2Reader::getSize() const {
+    return this->dataSize;
+}
+
+const std::string &L2Reader::getTradingPair() const {
+    return this->tradingPair;
+}
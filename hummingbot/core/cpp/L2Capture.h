@@ -0,0 +1,125 @@
+#ifndef _L2_CAPTURE_H
+#define _L2_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "OrderBookEntry.h"
+
+// Binary capture files of the L2 feed of one trading pair.
+//
+// A file starts with an L2FileHeader and is followed by records, each an L2RecordHeader followed by its rows. Rows are
+// packed (price, amount, updateId) doubles, bids first and then asks, which is the layout applyDiffs() reads. A reader
+// that maps the file can therefore hand rows to the book without copying or parsing anything. Trade records carry a
+// single (price, amount, tradeId) row, with the taker side in the record flags, and a NaN trade ID if the original was
+// not numeric.
+//
+// All sizes are multiples of 8 bytes, so every row of a mapped file is aligned. Values are stored in native byte
+// order. Files are append only: a record cut short by a crash is ignored on replay.
+enum L2RecordType {
+    L2_RECORD_SNAPSHOT = 1,
+    L2_RECORD_DIFF = 2,
+    L2_RECORD_TRADE = 3
+};
+
+enum L2TradeSide {
+    L2_TRADE_BUY = 1,
+    L2_TRADE_SELL = 2
+};
+
+struct L2FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    char tradingPair[48];
+};
+
+struct L2RecordHeader {
+    uint32_t type;
+    uint32_t flags;
+    uint32_t numBids;
+    uint32_t numAsks;
+    double timestamp;
+    int64_t updateId;
+};
+
+// A record read from a mapped capture file. The row pointers point into the mapping.
+struct L2Record {
+    uint32_t type;
+    uint32_t flags;
+    double timestamp;
+    int64_t updateId;
+    const double *bidRows;
+    size_t numBids;
+    const double *askRows;
+    size_t numAsks;
+};
+
+// Appends records to a capture file. Timestamps are in seconds. A NaN timestamp is replaced by the current wall
+// clock time, which is what the order book passes for the book updates it records.
+class L2Recorder {
+    FILE *file;
+    uint64_t recordCount;
+    std::vector<double> rows;
+
+    bool writeRecord(uint32_t type, uint32_t flags, size_t numBids, size_t numAsks, double timestamp,
+                     int64_t updateId, const double *bidRows, const double *askRows);
+    bool writeEntries(uint32_t type, const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                      int64_t updateId, double timestamp);
+
+    public:
+        L2Recorder();
+        L2Recorder(const L2Recorder &other) = delete;
+        L2Recorder &operator=(const L2Recorder &other) = delete;
+        ~L2Recorder();
+
+        bool open(const std::string &path, const std::string &tradingPair);
+        void close();
+        bool isOpen() const;
+        bool flush();
+
+        bool writeSnapshot(const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                           int64_t updateId, double timestamp);
+        bool writeDiffs(const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                        int64_t updateId, double timestamp);
+        bool writeSnapshotRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                               int64_t updateId, double timestamp);
+        bool writeDiffRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                           int64_t updateId, double timestamp);
+        bool writeTrade(bool isBuy, double price, double amount, double tradeId, double timestamp);
+
+        uint64_t getRecordCount() const;
+};
+
+// Reads a capture file through a read only memory mapping.
+class L2Reader {
+    const char *data;
+    size_t dataSize;
+    size_t position;
+    std::string tradingPair;
+
+    bool readHeaderAt(size_t offset, L2RecordHeader &header, size_t &recordSize) const;
+
+    public:
+        L2Reader();
+        L2Reader(const L2Reader &other) = delete;
+        L2Reader &operator=(const L2Reader &other) = delete;
+        ~L2Reader();
+
+        bool open(const std::string &path);
+        void close();
+        bool isOpen() const;
+
+        bool next(L2Record &record);
+        double peekTimestamp() const;
+        double getLastTimestamp() const;
+        void rewind();
+        bool atEnd() const;
+        size_t getPosition() const;
+        size_t getSize() const;
+        const std::string &getTradingPair() const;
+};
+
+#endif
@@ -0,0 +1,331 @@
+#include "L3OrderTable.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const OrderHandle DELETED_ORDER_HANDLE = INVALID_ORDER_HANDLE - 1;
+const size_t MIN_INDEX_CAPACITY = 16;
+
+}
+
+OrderIdIndex::OrderIdIndex() {
+    this->liveCount = 0;
+    this->usedCount = 0;
+}
+
+uint32_t OrderIdIndex::getHash(const std::string &id) {
+    uint64_t hash = std::hash<std::string>()(id);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// Rebuilds the index with the given power of two capacity, dropping the deleted slots. Slots keep the hash of their
+// ID, so no ID needs to be hashed again.
+void OrderIdIndex::rebuild(size_t capacity) {
+    std::vector<Slot> previous;
+    previous.swap(this->slots);
+    Slot empty = {INVALID_ORDER_HANDLE, 0};
+    this->slots.assign(capacity, empty);
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < previous.size(); i++) {
+        if (previous[i].handle == INVALID_ORDER_HANDLE || previous[i].handle == DELETED_ORDER_HANDLE) {
+            continue;
+        }
+        size_t position = previous[i].hash & mask;
+        while (this->slots[position].handle != INVALID_ORDER_HANDLE) {
+            position = (position + 1) & mask;
+        }
+        this->slots[position] = previous[i];
+    }
+    this->usedCount = this->liveCount;
+}
+
+OrderHandle OrderIdIndex::find(const std::string &id, const std::vector<std::string> &ids) const {
+    if (this->slots.empty()) {
+        return INVALID_ORDER_HANDLE;
+    }
+    uint32_t hash = getHash(id);
+    size_t mask = this->slots.size() - 1;
+    for (size_t position = hash & mask; ; position = (position + 1) & mask) {
+        const Slot &slot = this->slots[position];
+        if (slot.handle == INVALID_ORDER_HANDLE) {
+            return INVALID_ORDER_HANDLE;
+        }
+        if (slot.handle != DELETED_ORDER_HANDLE && slot.hash == hash && ids[slot.handle] == id) {
+            return slot.handle;
+        }
+    }
+}
+
+// The ID must not be in the index already.
+void OrderIdIndex::insert(const std::string &id, OrderHandle handle) {
+    if ((this->usedCount + 1) * 4 > this->slots.size() * 3) {
+        size_t capacity = std::max(this->slots.size(), MIN_INDEX_CAPACITY);
+        while ((this->liveCount + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        this->rebuild(capacity);
+    }
+    uint32_t hash = getHash(id);
+    size_t mask = this->slots.size() - 1;
+    size_t position = hash & mask;
+    while (this->slots[position].handle != INVALID_ORDER_HANDLE &&
+           this->slots[position].handle != DELETED_ORDER_HANDLE) {
+        position = (position + 1) & mask;
+    }
+    if (this->slots[position].handle == INVALID_ORDER_HANDLE) {
+        this->usedCount++;
+    }
+    this->slots[position].handle = handle;
+    this->slots[position].hash = hash;
+    this->liveCount++;
+}
+
+bool OrderIdIndex::erase(const std::string &id, const std::vector<std::string> &ids) {
+    if (this->slots.empty()) {
+        return false;
+    }
+    uint32_t hash = getHash(id);
+    size_t mask = this->slots.size() - 1;
+    for (size_t position = hash & mask; ; position = (position + 1) & mask) {
+        Slot &slot = this->slots[position];
+        if (slot.handle == INVALID_ORDER_HANDLE) {
+            return false;
+        }
+        if (slot.handle != DELETED_ORDER_HANDLE && slot.hash == hash && ids[slot.handle] == id) {
+            slot.handle = DELETED_ORDER_HANDLE;
+            this->liveCount--;
+            return true;
+        }
+    }
+}
+
+void OrderIdIndex::clear() {
+    this->slots.clear();
+    this->liveCount = 0;
+    this->usedCount = 0;
+}
+
+size_t OrderIdIndex::size() const {
+    return this->liveCount;
+}
+
+L3OrderTable::L3OrderTable() {
+    this->openCount = 0;
+}
+
+void L3OrderTable::levelChanged(bool isBid, double price, double amountChange, int orderCountChange,
+                                int64_t updateId) {
+    std::unordered_map<double, PriceLevel> &levels = isBid ? this->bidLevels : this->askLevels;
+    std::vector<double> &rows = isBid ? this->bidDiffRows : this->askDiffRows;
+    PriceLevel &level = levels[price];
+    level.amount += amountChange;
+    level.orderCount += orderCountChange;
+    double amount = level.amount;
+    if (level.orderCount == 0) {
+        levels.erase(price);
+        amount = 0;
+    }
+    rows.push_back(price);
+    rows.push_back(std::max(amount, 0.0));
+    rows.push_back((double)updateId);
+}
+
+// Opens an order and returns its handle. An open order with the same exchange order ID is closed first, and an empty
+// client order ID leaves the order out of the client order ID index.
+OrderHandle L3OrderTable::open(const std::string &exchangeOrderId, const std::string &clientOrderId, bool isBid,
+                               double price, double size, int64_t updateId) {
+    OrderHandle previous = this->findByExchangeOrderId(exchangeOrderId);
+    if (previous != INVALID_ORDER_HANDLE) {
+        this->close(previous, updateId);
+    }
+    if (!clientOrderId.empty()) {
+        this->clientIndex.erase(clientOrderId, this->clientOrderIds);
+    }
+
+    OrderHandle handle;
+    if (!this->freeHandles.empty()) {
+        handle = this->freeHandles.back();
+        this->freeHandles.pop_back();
+        this->exchangeOrderIds[handle] = exchangeOrderId;
+        this->clientOrderIds[handle] = clientOrderId;
+        this->prices[handle] = price;
+        this->sizes[handle] = size;
+        this->updateIds[handle] = updateId;
+        this->isBids[handle] = isBid;
+        this->isOpens[handle] = 1;
+    } else {
+        handle = (OrderHandle)this->prices.size();
+        this->exchangeOrderIds.push_back(exchangeOrderId);
+        this->clientOrderIds.push_back(clientOrderId);
+        this->prices.push_back(price);
+        this->sizes.push_back(size);
+        this->updateIds.push_back(updateId);
+        this->isBids.push_back(isBid);
+        this->isOpens.push_back(1);
+    }
+    this->exchangeIndex.insert(exchangeOrderId, handle);
+    if (!clientOrderId.empty()) {
+        this->clientIndex.insert(clientOrderId, handle);
+    }
+    this->openCount++;
+    this->levelChanged(isBid, price, size, 1, updateId);
+    return handle;
+}
+
+// Sets the remaining size of an open order.
+bool L3OrderTable::change(OrderHandle handle, double size, int64_t updateId) {
+    if (!this->isOpen(handle)) {
+        return false;
+    }
+    double previousSize = this->sizes[handle];
+    this->sizes[handle] = size;
+    this->updateIds[handle] = updateId;
+    this->levelChanged(this->isBids[handle], this->prices[handle], size - previousSize, 0, updateId);
+    return true;
+}
+
+// Takes a fill off the remaining size of an open order. The order stays open, at a size of 0 at worst, until it is
+// closed.
+bool L3OrderTable::fill(OrderHandle handle, double filledSize, int64_t updateId) {
+    if (!this->isOpen(handle)) {
+        return false;
+    }
+    return this->change(handle, std::max(this->sizes[handle] - filledSize, 0.0), updateId);
+}
+
+bool L3OrderTable::close(OrderHandle handle, int64_t updateId) {
+    if (!this->isOpen(handle)) {
+        return false;
+    }
+    this->levelChanged(this->isBids[handle], this->prices[handle], -this->sizes[handle], -1, updateId);
+    this->exchangeIndex.erase(this->exchangeOrderIds[handle], this->exchangeOrderIds);
+    if (!this->clientOrderIds[handle].empty() &&
+        this->clientIndex.find(this->clientOrderIds[handle], this->clientOrderIds) == handle) {
+        this->clientIndex.erase(this->clientOrderIds[handle], this->clientOrderIds);
+    }
+    this->exchangeOrderIds[handle].clear();
+    this->clientOrderIds[handle].clear();
+    this->isOpens[handle] = 0;
+    this->freeHandles.push_back(handle);
+    this->openCount--;
+    return true;
+}
+
+// Drops every order and level, and any diff rows not taken yet, usually before loading a snapshot.
+void L3OrderTable::clear() {
+    this->exchangeOrderIds.clear();
+    this->clientOrderIds.clear();
+    this->prices.clear();
+    this->sizes.clear();
+    this->updateIds.clear();
+    this->isBids.clear();
+    this->isOpens.clear();
+    this->freeHandles.clear();
+    this->exchangeIndex.clear();
+    this->clientIndex.clear();
+    this->bidLevels.clear();
+    this->askLevels.clear();
+    this->clearDiffRows();
+    this->openCount = 0;
+}
+
+OrderHandle L3OrderTable::findByExchangeOrderId(const std::string &exchangeOrderId) const {
+    return this->exchangeIndex.find(exchangeOrderId, this->exchangeOrderIds);
+}
+
+OrderHandle L3OrderTable::findByClientOrderId(const std::string &clientOrderId) const {
+    return this->clientIndex.find(clientOrderId, this->clientOrderIds);
+}
+
+bool L3OrderTable::isOpen(OrderHandle handle) const {
+    return handle < this->isOpens.size() && this->isOpens[handle];
+}
+
+// The getters below expect the handle of an open order.
+const std::string &L3OrderTable::getExchangeOrderId(OrderHandle handle) const {
+    return this->exchangeOrderIds[handle];
+}
+
+const std::string &L3OrderTable::getClientOrderId(OrderHandle handle) const {
+    return this->clientOrderIds[handle];
+}
+
+bool L3OrderTable::getIsBid(OrderHandle handle) const {
+    return this->isBids[handle];
+}
+
+double L3OrderTable::getPrice(OrderHandle handle) const {
+    return this->prices[handle];
+}
+
+double L3OrderTable::getSize(OrderHandle handle) const {
+    return this->sizes[handle];
+}
+
+int64_t L3OrderTable::getUpdateId(OrderHandle handle) const {
+    return this->updateIds[handle];
+}
+
+size_t L3OrderTable::size() const {
+    return this->openCount;
+}
+
+double L3OrderTable::getLevelAmount(bool isBid, double price) const {
+    const std::unordered_map<double, PriceLevel> &levels = isBid ? this->bidLevels : this->askLevels;
+    std::unordered_map<double, PriceLevel>::const_iterator level = levels.find(price);
+    return level == levels.end() ? 0 : level->second.amount;
+}
+
+size_t L3OrderTable::getLevelOrderCount(bool isBid, double price) const {
+    const std::unordered_map<double, PriceLevel> &levels = isBid ? this->bidLevels : this->askLevels;
+    std::unordered_map<double, PriceLevel>::const_iterator level = levels.find(price);
+    return level == levels.end() ? 0 : level->second.orderCount;
+}
+
+size_t L3OrderTable::getLevelCount(bool isBid) const {
+    return (isBid ? this->bidLevels : this->askLevels).size();
+}
+
+// Appends the levels of a side to packed (price, amount, updateId) rows, best level first, as a snapshot of the L2
+// book. Returns the number of levels.
+size_t L3OrderTable::exportLevels(bool isBid, std::vector<double> &rows, int64_t updateId) const {
+    const std::unordered_map<double, PriceLevel> &levels = isBid ? this->bidLevels : this->askLevels;
+    std::vector<std::pair<double, double>> sorted;
+    sorted.reserve(levels.size());
+    for (std::unordered_map<double, PriceLevel>::const_iterator it = levels.begin(); it != levels.end(); ++it) {
+        sorted.push_back(std::make_pair(it->first, std::max(it->second.amount, 0.0)));
+    }
+    if (isBid) {
+        std::sort(sorted.begin(), sorted.end(), std::greater<std::pair<double, double>>());
+    } else {
+        std::sort(sorted.begin(), sorted.end());
+    }
+    for (size_t i = 0; i < sorted.size(); i++) {
+        rows.push_back(sorted[i].first);
+        rows.push_back(sorted[i].second);
+        rows.push_back((double)updateId);
+    }
+    return sorted.size();
+}
+
+const double *L3OrderTable::getBidDiffRows() const {
+    return this->bidDiffRows.data();
+}
+
+size_t L3OrderTable::getBidDiffCount() const {
+    return this->bidDiffRows.size() / 3;
+}
+
+const double *L3OrderTable::getAskDiffRows() const {
+    return this->askDiffRows.data();
+}
+
+size_t L3OrderTable::getAskDiffCount() const {
+    return this->askDiffRows.size() / 3;
+}
+
+void L3OrderTable::clearDiffRows() {
+    this->bidDiffRows.clear();
+    this->askDiffRows.clear();
+}
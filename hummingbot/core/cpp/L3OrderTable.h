@@ -0,0 +1,109 @@
+#ifndef _L3_ORDER_TABLE_H
+#define _L3_ORDER_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t OrderHandle;
+
+const OrderHandle INVALID_ORDER_HANDLE = 0xffffffff;
+
+// An open addressing hash index from order ID strings to order handles, with linear probing.
+//
+// The index does not keep the IDs themselves. Lookups are given the ID column of the table and compare against it,
+// and every slot keeps 32 bits of the hash of its ID, so a probe only compares strings when those bits match. Erased
+// slots are marked deleted and reused by later inserts; the index is rebuilt once live and deleted slots fill three
+// quarters of it.
+class OrderIdIndex {
+    struct Slot {
+        OrderHandle handle;
+        uint32_t hash;
+    };
+
+    std::vector<Slot> slots;
+    size_t liveCount;
+    size_t usedCount;
+
+    static uint32_t getHash(const std::string &id);
+    void rebuild(size_t capacity);
+
+    public:
+        OrderIdIndex();
+
+        OrderHandle find(const std::string &id, const std::vector<std::string> &ids) const;
+        void insert(const std::string &id, OrderHandle handle);
+        bool erase(const std::string &id, const std::vector<std::string> &ids);
+        void clear();
+        size_t size() const;
+};
+
+// The resting orders of a market by order (L3) feed, for one trading pair.
+//
+// Orders are stored as a struct of arrays: each field is a column indexed by the order handle, and the handles of
+// closed orders are reused by the next orders opened. Orders are found by their exchange order ID, or by their client
+// order ID when they have one, through open addressing indexes over the ID columns.
+//
+// The table also keeps the total amount and the number of orders of every price level. Each change to a level is
+// appended as a packed (price, amount, updateId) diff row holding the new total of the level, 0 once its last order is
+// gone, so the rows can be applied to an OrderBook as they are with applyDiffs().
+class L3OrderTable {
+    struct PriceLevel {
+        double amount;
+        size_t orderCount;
+    };
+
+    std::vector<std::string> exchangeOrderIds;
+    std::vector<std::string> clientOrderIds;
+    std::vector<double> prices;
+    std::vector<double> sizes;
+    std::vector<int64_t> updateIds;
+    std::vector<uint8_t> isBids;
+    std::vector<uint8_t> isOpens;
+    std::vector<OrderHandle> freeHandles;
+    OrderIdIndex exchangeIndex;
+    OrderIdIndex clientIndex;
+    std::unordered_map<double, PriceLevel> bidLevels;
+    std::unordered_map<double, PriceLevel> askLevels;
+    std::vector<double> bidDiffRows;
+    std::vector<double> askDiffRows;
+    size_t openCount;
+
+    void levelChanged(bool isBid, double price, double amountChange, int orderCountChange, int64_t updateId);
+
+    public:
+        L3OrderTable();
+
+        OrderHandle open(const std::string &exchangeOrderId, const std::string &clientOrderId, bool isBid, double price,
+                         double size, int64_t updateId);
+        bool change(OrderHandle handle, double size, int64_t updateId);
+        bool fill(OrderHandle handle, double filledSize, int64_t updateId);
+        bool close(OrderHandle handle, int64_t updateId);
+        void clear();
+
+        OrderHandle findByExchangeOrderId(const std::string &exchangeOrderId) const;
+        OrderHandle findByClientOrderId(const std::string &clientOrderId) const;
+        bool isOpen(OrderHandle handle) const;
+        const std::string &getExchangeOrderId(OrderHandle handle) const;
+        const std::string &getClientOrderId(OrderHandle handle) const;
+        bool getIsBid(OrderHandle handle) const;
+        double getPrice(OrderHandle handle) const;
+        double getSize(OrderHandle handle) const;
+        int64_t getUpdateId(OrderHandle handle) const;
+        size_t size() const;
+
+        double getLevelAmount(bool isBid, double price) const;
+        size_t getLevelOrderCount(bool isBid, double price) const;
+        size_t getLevelCount(bool isBid) const;
+        size_t exportLevels(bool isBid, std::vector<double> &rows, int64_t updateId) const;
+
+        const double *getBidDiffRows() const;
+        size_t getBidDiffCount() const;
+        const double *getAskDiffRows() const;
+        size_t getAskDiffCount() const;
+        void clearDiffRows();
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int SUB_BUCKET_BITS = 5;
+const uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+const uint64_t SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2;
+// Values with their highest bit at 63 land in the last range.
+const size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF_COUNT;
+
+}
+
+LatencyHistogram::LatencyHistogram() {
+    this->counts.resize(BUCKET_COUNT);
+    this->clear();
+}
+
+// Values from 2 ^ (SUB_BUCKET_BITS - 1 + shift) up are shifted right until they fit in the upper half of the sub
+// buckets, and each shift gets its own half of the sub buckets.
+size_t LatencyHistogram::getBucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return (size_t)value;
+    }
+    int highestBit = 63 - __builtin_clzll(value);
+    int shift = highestBit - (SUB_BUCKET_BITS - 1);
+    return (size_t)(SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF_COUNT +
+                    ((value >> shift) - SUB_BUCKET_HALF_COUNT));
+}
+
+uint64_t LatencyHistogram::getBucketHighestValue(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    int shift = (int)((index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF_COUNT) + 1;
+    uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF_COUNT + SUB_BUCKET_HALF_COUNT;
+    return (subBucket << shift) + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    this->counts[getBucketIndex(value)]++;
+    this->totalCount++;
+    this->minValue = std::min(this->minValue, value);
+    this->maxValue = std::max(this->maxValue, value);
+    this->sum += (double)value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        this->counts[i] += other.counts[i];
+    }
+    this->totalCount += other.totalCount;
+    this->minValue = std::min(this->minValue, other.minValue);
+    this->maxValue = std::max(this->maxValue, other.maxValue);
+    this->sum += other.sum;
+}
+
+void LatencyHistogram::clear() {
+    std::fill(this->counts.begin(), this->counts.end(), 0);
+    this->totalCount = 0;
+    this->minValue = UINT64_MAX;
+    this->maxValue = 0;
+    this->sum = 0;
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return this->totalCount;
+}
+
+uint64_t LatencyHistogram::getMin() const {
+    return this->totalCount == 0 ? 0 : this->minValue;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return this->maxValue;
+}
+
+double LatencyHistogram::getMean() const {
+    return this->totalCount == 0 ? NAN : this->sum / this->totalCount;
+}
+
+// The smallest bucket value that at least the given percentage of the recorded values are at or below. 0 if the
+// histogram is empty.
+uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (this->totalCount == 0) {
+        return 0;
+    }
+    double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+    uint64_t target = std::max((uint64_t)std::ceil(fraction * this->totalCount), uint64_t(1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += this->counts[i];
+        if (seen >= target) {
+            return std::min(std::max(getBucketHighestValue(i), this->minValue), this->maxValue);
+        }
+    }
+    return this->maxValue;
+}
@@ -0,0 +1,39 @@
+#ifndef _LATENCY_HISTOGRAM_H
+#define _LATENCY_HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// A histogram of non-negative integer values, such as latencies in nanoseconds, in the style of an HDR histogram.
+//
+// Values below 32 get a bucket each. Above that, every power of two range is split into 16 equal buckets, so a
+// bucket never spans more than about 6% of the values in it, from nanoseconds up to the full 64 bit range. Recording
+// a value is a count leading zeros instruction and an increment, and the buckets take a fixed 8 KB, so the histogram
+// can stay on in production. Percentiles are read by walking the buckets and are reported as the highest value of
+// their bucket, capped by the largest value recorded.
+class LatencyHistogram {
+    std::vector<uint64_t> counts;
+    uint64_t totalCount;
+    uint64_t minValue;
+    uint64_t maxValue;
+    double sum;
+
+    static size_t getBucketIndex(uint64_t value);
+    static uint64_t getBucketHighestValue(size_t index);
+
+    public:
+        LatencyHistogram();
+
+        void record(uint64_t value);
+        void merge(const LatencyHistogram &other);
+        void clear();
+
+        uint64_t getCount() const;
+        uint64_t getMin() const;
+        uint64_t getMax() const;
+        double getMean() const;
+        uint64_t getValueAtPercentile(double percentile) const;
+};
+
+#endif
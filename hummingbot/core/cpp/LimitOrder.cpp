@@ -1,65 +1,80 @@
 #include "LimitOrder.h"
+#include <cmath>
+
+static double toPriceKey(PyObject *price) {
+    if (price == NULL || price == Py_None) {
+        return NAN;
+    }
+    double priceKey = PyFloat_AsDouble(price);
+    if (priceKey == -1.0 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return NAN;
+    }
+    return priceKey;
+}
 
 LimitOrder::LimitOrder() {
-    this->clientOrderID = "";
-    this->tradingPair = "";
+    this->tradingPair = 0;
     this->isBuy = false;
-    this->baseCurrency = "";
-    this->quoteCurrency = "";
+    this->baseCurrency = 0;
+    this->quoteCurrency = 0;
     this->price = NULL;
+    this->priceKey = NAN;
     this->quantity = NULL;
     this->filledQuantity = NULL;
     this->creationTimestamp = 0.0;
     this->status = 0;
-    this->position = "NIL";
+    this->position = internSymbol("NIL");
 }
 
-LimitOrder::LimitOrder(std::string clientOrderID,
-                       std::string tradingPair,
+LimitOrder::LimitOrder(const std::string &clientOrderID,
+                       const std::string &tradingPair,
                        bool isBuy,
-                       std::string baseCurrency,
-                       std::string quoteCurrency,
+                       const std::string &baseCurrency,
+                       const std::string &quoteCurrency,
                        PyObject *price,
                        PyObject *quantity
                        ) {
-    this->clientOrderID = clientOrderID;
-    this->tradingPair = tradingPair;
+    this->clientOrderID = Symbol(clientOrderID);
+    this->tradingPair = internSymbol(tradingPair);
     this->isBuy = isBuy;
-    this->baseCurrency = baseCurrency;
-    this->quoteCurrency = quoteCurrency;
+    this->baseCurrency = internSymbol(baseCurrency);
+    this->quoteCurrency = internSymbol(quoteCurrency);
     this->price = price;
+    this->priceKey = toPriceKey(price);
     this->quantity = quantity;
     this->filledQuantity = NULL;
     this->creationTimestamp = 0.0;
     this->status = 0;
-    this->position = "NIL";
+    this->position = internSymbol("NIL");
     Py_XINCREF(price);
     Py_XINCREF(quantity);
 }
 
-LimitOrder::LimitOrder(std::string clientOrderID,
-                       std::string tradingPair,
+LimitOrder::LimitOrder(const std::string &clientOrderID,
+                       const std::string &tradingPair,
                        bool isBuy,
-                       std::string baseCurrency,
-                       std::string quoteCurrency,
+                       const std::string &baseCurrency,
+                       const std::string &quoteCurrency,
                        PyObject *price,
                        PyObject *quantity,
                        PyObject *filledQuantity,
                        long creationTimestamp,
                        short int status,
-                       std::string position
+                       const std::string &position
                        ) {
-    this->clientOrderID = clientOrderID;
-    this->tradingPair = tradingPair;
+    this->clientOrderID = Symbol(clientOrderID);
+    this->tradingPair = internSymbol(tradingPair);
     this->isBuy = isBuy;
-    this->baseCurrency = baseCurrency;
-    this->quoteCurrency = quoteCurrency;
+    this->baseCurrency = internSymbol(baseCurrency);
+    this->quoteCurrency = internSymbol(quoteCurrency);
     this->price = price;
+    this->priceKey = toPriceKey(price);
     this->quantity = quantity;
     this->filledQuantity = filledQuantity;
     this->creationTimestamp = creationTimestamp;
     this->status = status;
-    this->position = position;
+    this->position = internSymbol(position);
     Py_XINCREF(price);
     Py_XINCREF(quantity);
     Py_XINCREF(filledQuantity);
@@ -72,6 +87,7 @@ LimitOrder::LimitOrder(const LimitOrder &other) {
     this->baseCurrency = other.baseCurrency;
     this->quoteCurrency = other.quoteCurrency;
     this->price = other.price;
+    this->priceKey = other.priceKey;
     this->quantity = other.quantity;
     this->filledQuantity = other.filledQuantity;
     this->creationTimestamp = other.creationTimestamp;
@@ -82,6 +98,24 @@ LimitOrder::LimitOrder(const LimitOrder &other) {
     Py_XINCREF(this->filledQuantity);
 }
 
+LimitOrder::LimitOrder(LimitOrder &&other) {
+    this->clientOrderID = std::move(other.clientOrderID);
+    this->tradingPair = other.tradingPair;
+    this->isBuy = other.isBuy;
+    this->baseCurrency = other.baseCurrency;
+    this->quoteCurrency = other.quoteCurrency;
+    this->price = other.price;
+    this->priceKey = other.priceKey;
+    this->quantity = other.quantity;
+    this->filledQuantity = other.filledQuantity;
+    this->creationTimestamp = other.creationTimestamp;
+    this->status = other.status;
+    this->position = other.position;
+    other.price = NULL;
+    other.quantity = NULL;
+    other.filledQuantity = NULL;
+}
+
 LimitOrder::~LimitOrder() {
     Py_XDECREF(this->price);
     Py_XDECREF(this->quantity);
@@ -92,38 +126,83 @@ LimitOrder::~LimitOrder() {
 }
 
 LimitOrder &LimitOrder::operator=(const LimitOrder &other) {
+    // Take the new references before dropping the old ones, so self assignment keeps the objects alive.
+    Py_XINCREF(other.price);
+    Py_XINCREF(other.quantity);
+    Py_XINCREF(other.filledQuantity);
+    Py_XDECREF(this->price);
+    Py_XDECREF(this->quantity);
+    Py_XDECREF(this->filledQuantity);
+
     this->clientOrderID = other.clientOrderID;
     this->tradingPair = other.tradingPair;
     this->isBuy = other.isBuy;
     this->baseCurrency = other.baseCurrency;
     this->quoteCurrency = other.quoteCurrency;
     this->price = other.price;
+    this->priceKey = other.priceKey;
     this->quantity = other.quantity;
     this->filledQuantity = other.filledQuantity;
     this->creationTimestamp = other.creationTimestamp;
     this->status = other.status;
     this->position = other.position;
-    Py_XINCREF(this->price);
-    Py_XINCREF(this->quantity);
-    Py_XINCREF(this->filledQuantity);
+
+    return *this;
+}
+
+LimitOrder &LimitOrder::operator=(LimitOrder &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    Py_XDECREF(this->price);
+    Py_XDECREF(this->quantity);
+    Py_XDECREF(this->filledQuantity);
+
+    this->clientOrderID = std::move(other.clientOrderID);
+    this->tradingPair = other.tradingPair;
+    this->isBuy = other.isBuy;
+    this->baseCurrency = other.baseCurrency;
+    this->quoteCurrency = other.quoteCurrency;
+    this->price = other.price;
+    this->priceKey = other.priceKey;
+    this->quantity = other.quantity;
+    this->filledQuantity = other.filledQuantity;
+    this->creationTimestamp = other.creationTimestamp;
+    this->status = other.status;
+    this->position = other.position;
+    other.price = NULL;
+    other.quantity = NULL;
+    other.filledQuantity = NULL;
 
     return *this;
 }
 
 bool operator<(LimitOrder const &a, LimitOrder const &b) {
-    if ((bool)(PyObject_RichCompareBool(a.price, b.price, Py_EQ))) {
-        // return (bool)(PyObject_RichCompareBool(a.quantity, b.quantity, Py_LT));
-        return (bool)(a.clientOrderID < b.clientOrderID);
-    } else {
-        return (bool)(PyObject_RichCompareBool(a.price, b.price, Py_LT));
+    // Orders without a numeric price sort before every other order, so the ordering stays strict and weak.
+    bool aIsNaN = std::isnan(a.priceKey);
+    bool bIsNaN = std::isnan(b.priceKey);
+    if (aIsNaN != bIsNaN) {
+        return aIsNaN;
     }
+    if (aIsNaN || a.priceKey == b.priceKey) {
+        return a.clientOrderID < b.clientOrderID;
+    }
+    return a.priceKey < b.priceKey;
+}
+
+const std::string &LimitOrder::getClientOrderID() const {
+    return this->clientOrderID.getName();
 }
 
-std::string LimitOrder::getClientOrderID() const {
-    return this->clientOrderID;
+SymbolHandle LimitOrder::getClientOrderHandle() const {
+    return this->clientOrderID.getHandle();
 }
 
-std::string LimitOrder::getTradingPair() const {
+const std::string &LimitOrder::getTradingPair() const {
+    return getSymbolName(this->tradingPair);
+}
+
+SymbolHandle LimitOrder::getTradingPairHandle() const {
     return this->tradingPair;
 }
 
@@ -131,18 +210,22 @@ bool LimitOrder::getIsBuy() const {
     return this->isBuy;
 }
 
-std::string LimitOrder::getBaseCurrency() const {
-    return this->baseCurrency;
+const std::string &LimitOrder::getBaseCurrency() const {
+    return getSymbolName(this->baseCurrency);
 }
 
-std::string LimitOrder::getQuoteCurrency() const {
-    return this->quoteCurrency;
+const std::string &LimitOrder::getQuoteCurrency() const {
+    return getSymbolName(this->quoteCurrency);
 }
 
 PyObject *LimitOrder::getPrice() const {
     return this->price;
 }
 
+double LimitOrder::getPriceKey() const {
+    return this->priceKey;
+}
+
 PyObject *LimitOrder::getQuantity() const {
     return this->quantity;
 }
@@ -159,6 +242,22 @@ short int LimitOrder::getStatus() const{
     return this->status;
 }
 
-std::string LimitOrder::getPosition() const{
-    return this->position;
+const std::string &LimitOrder::getPosition() const{
+    return getSymbolName(this->position);
+}
+
+std::pair<LimitOrderSet::iterator, bool> emplaceLimitOrder(LimitOrderSet &orders,
+                                                           const std::string &clientOrderID,
+                                                           const std::string &tradingPair,
+                                                           bool isBuy,
+                                                           const std::string &baseCurrency,
+                                                           const std::string &quoteCurrency,
+                                                           PyObject *price,
+                                                           PyObject *quantity,
+                                                           PyObject *filledQuantity,
+                                                           long creationTimestamp,
+                                                           short int status,
+                                                           const std::string &position) {
+    return orders.emplace(clientOrderID, tradingPair, isBuy, baseCurrency, quoteCurrency, price, quantity,
+                          filledQuantity, creationTimestamp, status, position);
 }
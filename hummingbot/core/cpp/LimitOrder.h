@@ -2,57 +2,92 @@
 #define _LIMIT_ORDER_H
 
 #include <string>
+#include <set>
+#include <utility>
 #include <Python.h>
+#include "PoolAllocator.h"
+#include "SymbolTable.h"
 
+// A limit order, with the price, quantity and filled quantity held as Python Decimal objects.
+//
+// The price is also cached as a double when the order is created. Ordering between orders and the price checks done
+// by the paper trade matching only use the cached key, so they never call back into Python.
+//
+// The client order ID, trading pair, currencies and position are held as SymbolTable handles. Orders at the same price
+// are ordered by when their client order ID entered the SymbolTable, not by handle, since handles are recycled.
 class LimitOrder {
-    std::string clientOrderID;
-    std::string tradingPair;
+    Symbol clientOrderID;
+    SymbolHandle tradingPair;
     bool isBuy;
-    std::string baseCurrency;
-    std::string quoteCurrency;
+    SymbolHandle baseCurrency;
+    SymbolHandle quoteCurrency;
     PyObject *price;
+    double priceKey;
     PyObject *quantity;
     PyObject *filledQuantity;
     long creationTimestamp;
     short int status;
-    std::string position;
+    SymbolHandle position;
 
     public:
         LimitOrder();
-        LimitOrder(std::string clientOrderID,
-                   std::string tradingPair,
+        LimitOrder(const std::string &clientOrderID,
+                   const std::string &tradingPair,
                    bool isBuy,
-                   std::string baseCurrency,
-                   std::string quoteCurrency,
+                   const std::string &baseCurrency,
+                   const std::string &quoteCurrency,
                    PyObject *price,
                    PyObject *quantity);
-        LimitOrder(std::string clientOrderID,
-                   std::string tradingPair,
+        LimitOrder(const std::string &clientOrderID,
+                   const std::string &tradingPair,
                    bool isBuy,
-                   std::string baseCurrency,
-                   std::string quoteCurrency,
+                   const std::string &baseCurrency,
+                   const std::string &quoteCurrency,
                    PyObject *price,
                    PyObject *quantity,
                    PyObject *filledQuantity,
                    long creationTimestamp,
                    short int status,
-                   std::string position);
+                   const std::string &position);
         ~LimitOrder();
         LimitOrder(const LimitOrder &other);
+        LimitOrder(LimitOrder &&other);
         LimitOrder &operator=(const LimitOrder &other);
+        LimitOrder &operator=(LimitOrder &&other);
         friend bool operator<(LimitOrder const &a, LimitOrder const &b);
 
-        std::string getClientOrderID() const;
-        std::string getTradingPair() const;
+        const std::string &getClientOrderID() const;
+        SymbolHandle getClientOrderHandle() const;
+        const std::string &getTradingPair() const;
+        SymbolHandle getTradingPairHandle() const;
         bool getIsBuy() const;
-        std::string getBaseCurrency() const;
-        std::string getQuoteCurrency() const;
+        const std::string &getBaseCurrency() const;
+        const std::string &getQuoteCurrency() const;
         PyObject *getPrice() const;
+        double getPriceKey() const;
         PyObject *getQuantity() const;
         PyObject *getFilledQuantity() const;
         long getCreationTimestamp() const;
         short int getStatus() const;
-        std::string getPosition() const;
+        const std::string &getPosition() const;
 };
 
+// The resting orders of one trading pair and side. Each set allocates its nodes from a pool of its own, so placing and
+// cancelling orders reuses the same nodes instead of going through the global allocator every time.
+typedef std::set<LimitOrder, std::less<LimitOrder>, PoolAllocator<LimitOrder>> LimitOrderSet;
+
+// Builds a limit order directly inside the set, without copying a temporary order into it.
+std::pair<LimitOrderSet::iterator, bool> emplaceLimitOrder(LimitOrderSet &orders,
+                                                           const std::string &clientOrderID,
+                                                           const std::string &tradingPair,
+                                                           bool isBuy,
+                                                           const std::string &baseCurrency,
+                                                           const std::string &quoteCurrency,
+                                                           PyObject *price,
+                                                           PyObject *quantity,
+                                                           PyObject *filledQuantity,
+                                                           long creationTimestamp,
+                                                           short int status,
+                                                           const std::string &position);
+
 #endif
@@ -0,0 +1,263 @@
+#include "MatchingEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+MatchingEngine::MatchingEngine() {
+    this->nextSequence = 0;
+    this->partialFillsEnabled = false;
+    this->queuePositionsEnabled = false;
+}
+
+void MatchingEngine::setPartialFillsEnabled(bool enabled) {
+    this->partialFillsEnabled = enabled;
+}
+
+bool MatchingEngine::getPartialFillsEnabled() const {
+    return this->partialFillsEnabled;
+}
+
+void MatchingEngine::setQueuePositionsEnabled(bool enabled) {
+    this->queuePositionsEnabled = enabled;
+}
+
+bool MatchingEngine::getQueuePositionsEnabled() const {
+    return this->queuePositionsEnabled;
+}
+
+void MatchingEngine::addOrder(const LimitOrder &order, double quantity) {
+    OrderState state;
+    state.remainingQuantity = quantity;
+    state.sequence = this->nextSequence++;
+    state.queuePositionTracked = false;
+    this->orders[order.getClientOrderHandle()] = state;
+}
+
+// Adds an order and starts tracking its queue position on the given side. The caller untracks it from the same side
+// once the order is removed.
+void MatchingEngine::addOrder(const LimitOrder &order, double quantity, OrderBookSide &queueBook) {
+    this->addOrder(order, quantity);
+    if (!std::isnan(order.getPriceKey())) {
+        queueBook.trackQueuePosition(order.getClientOrderHandle(), order.getPriceKey());
+        this->orders[order.getClientOrderHandle()].queuePositionTracked = true;
+    }
+}
+
+bool MatchingEngine::removeOrder(SymbolHandle orderHandle) {
+    return this->orders.erase(orderHandle) > 0;
+}
+
+bool MatchingEngine::contains(SymbolHandle orderHandle) const {
+    return this->orders.find(orderHandle) != this->orders.end();
+}
+
+bool MatchingEngine::isQueuePositionTracked(SymbolHandle orderHandle) const {
+    OrderStateMap::const_iterator it = this->orders.find(orderHandle);
+    return it != this->orders.end() && it->second.queuePositionTracked;
+}
+
+double MatchingEngine::getRemainingQuantity(SymbolHandle orderHandle) const {
+    OrderStateMap::const_iterator it = this->orders.find(orderHandle);
+    if (it == this->orders.end()) {
+        return NAN;
+    }
+    return it->second.remainingQuantity;
+}
+
+// Gives part of a fill back to the remaining quantity of an order, when the caller applied less of the fill than the
+// engine took off the order, e.g. after rounding it down to the order size quantum.
+void MatchingEngine::restoreQuantity(SymbolHandle orderHandle, double quantity) {
+    OrderStateMap::iterator it = this->orders.find(orderHandle);
+    if (it != this->orders.end() && quantity > 0) {
+        it->second.remainingQuantity += quantity;
+    }
+}
+
+void MatchingEngine::clear() {
+    this->orders.clear();
+}
+
+size_t MatchingEngine::size() const {
+    return this->orders.size();
+}
+
+bool MatchingEngine::isThrough(bool isBuy, double limitPrice, double price, bool inclusive) const {
+    if (isBuy) {
+        return inclusive ? limitPrice >= price : limitPrice > price;
+    }
+    return inclusive ? limitPrice <= price : limitPrice < price;
+}
+
+void MatchingEngine::sortPriceLevel() {
+    if (this->priceLevel.size() < 2) {
+        return;
+    }
+    const OrderStateMap &orders = this->orders;
+    std::sort(this->priceLevel.begin(), this->priceLevel.end(),
+              [&orders](const LimitOrderSet::iterator &a, const LimitOrderSet::iterator &b) {
+        OrderStateMap::const_iterator stateA = orders.find(a->getClientOrderHandle());
+        OrderStateMap::const_iterator stateB = orders.find(b->getClientOrderHandle());
+        uint64_t sequenceA = stateA == orders.end() ? UINT64_MAX : stateA->second.sequence;
+        uint64_t sequenceB = stateB == orders.end() ? UINT64_MAX : stateB->second.sequence;
+        return sequenceA < sequenceB;
+    });
+}
+
+size_t MatchingEngine::match(LimitOrderSet &restingOrders,
+                             bool isBuy,
+                             double price,
+                             bool inclusive,
+                             double quantity,
+                             double queueVolume,
+                             OrderBookSide *queueBook,
+                             std::vector<MatchFill> &fills) {
+    size_t firstFill = fills.size();
+    if (std::isnan(price)) {
+        return 0;
+    }
+    bool limited = !std::isinf(quantity);
+    double unfilledQuantity = quantity;
+
+    // Bids are walked from the back of the set and asks from the front, so both start at the best price. Orders
+    // without a numeric price sort first and are never matched.
+    LimitOrderSet::reverse_iterator bidIt = restingOrders.rbegin();
+    LimitOrderSet::iterator askIt = restingOrders.begin();
+    while (!isBuy && askIt != restingOrders.end() && std::isnan(askIt->getPriceKey())) {
+        ++askIt;
+    }
+
+    while (!limited || unfilledQuantity > 0) {
+        if (isBuy ? bidIt == restingOrders.rend() : askIt == restingOrders.end()) {
+            break;
+        }
+        double levelPrice = isBuy ? bidIt->getPriceKey() : askIt->getPriceKey();
+        bool atQueueLevel = queueBook != NULL && levelPrice == price;
+        if (!atQueueLevel && !this->isThrough(isBuy, levelPrice, price, inclusive)) {
+            break;
+        }
+
+        this->priceLevel.clear();
+        if (isBuy) {
+            while (bidIt != restingOrders.rend() && bidIt->getPriceKey() == levelPrice) {
+                this->priceLevel.push_back(std::prev(bidIt.base()));
+                ++bidIt;
+            }
+        } else {
+            while (askIt != restingOrders.end() && askIt->getPriceKey() == levelPrice) {
+                this->priceLevel.push_back(askIt);
+                ++askIt;
+            }
+        }
+        this->sortPriceLevel();
+
+        if (atQueueLevel) {
+            this->matchQueueLevel(levelPrice, limited, unfilledQuantity, queueVolume, *queueBook, fills);
+            break;
+        }
+        for (size_t i = 0; i < this->priceLevel.size(); i++) {
+            MatchFill fill;
+            fill.order = this->priceLevel[i];
+            fill.price = levelPrice;
+            OrderStateMap::iterator state =
+                this->orders.find(fill.order->getClientOrderHandle());
+            if (state == this->orders.end() || state->second.remainingQuantity <= 0) {
+                // Orders the engine does not track, or has already filled, are reported as complete.
+                fill.quantity = state == this->orders.end() ? NAN : 0;
+                fill.remainingQuantity = 0;
+                fills.push_back(fill);
+                continue;
+            }
+            if (limited && unfilledQuantity <= 0) {
+                break;
+            }
+            fill.quantity = limited ? std::min(state->second.remainingQuantity, unfilledQuantity)
+                                    : state->second.remainingQuantity;
+            state->second.remainingQuantity -= fill.quantity;
+            fill.remainingQuantity = state->second.remainingQuantity;
+            if (limited) {
+                unfilledQuantity -= fill.quantity;
+            }
+            fills.push_back(fill);
+        }
+        if (queueBook != NULL) {
+            // A trade through the level has used up everything that was queued at it.
+            queueBook->recordQueueTrade(levelPrice, HUGE_VAL);
+        }
+    }
+    return fills.size() - firstFill;
+}
+
+// Fills the orders at the level of a trade's own price, in arrival order, with whatever trade volume gets past the
+// volume queued ahead of each of them. Orders without a tracked queue position are left alone. Afterwards the volume
+// that reached the level is taken off the front of its queue.
+void MatchingEngine::matchQueueLevel(double levelPrice,
+                                     bool limited,
+                                     double &unfilledQuantity,
+                                     double queueVolume,
+                                     OrderBookSide &queueBook,
+                                     std::vector<MatchFill> &fills) {
+    double levelVolume = limited ? unfilledQuantity : queueVolume;
+    for (size_t i = 0; i < this->priceLevel.size(); i++) {
+        if (limited && unfilledQuantity <= 0) {
+            break;
+        }
+        MatchFill fill;
+        fill.order = this->priceLevel[i];
+        fill.price = levelPrice;
+        SymbolHandle orderHandle = fill.order->getClientOrderHandle();
+        OrderStateMap::iterator state = this->orders.find(orderHandle);
+        if (state == this->orders.end() || state->second.remainingQuantity <= 0) {
+            fill.quantity = state == this->orders.end() ? NAN : 0;
+            fill.remainingQuantity = 0;
+            fills.push_back(fill);
+            continue;
+        }
+        double volumeAhead = queueBook.getQueuePosition(orderHandle);
+        if (std::isnan(volumeAhead)) {
+            continue;
+        }
+        // Volume filled for orders earlier in this level has already come out of the unfilled quantity.
+        double volumePast = (limited ? unfilledQuantity : levelVolume) - volumeAhead;
+        if (volumePast <= 0) {
+            continue;
+        }
+        fill.quantity = limited ? std::min(state->second.remainingQuantity, volumePast)
+                                : state->second.remainingQuantity;
+        state->second.remainingQuantity -= fill.quantity;
+        fill.remainingQuantity = state->second.remainingQuantity;
+        if (limited) {
+            unfilledQuantity -= fill.quantity;
+        }
+        fills.push_back(fill);
+    }
+    queueBook.recordQueueTrade(levelPrice, levelVolume);
+}
+
+size_t MatchingEngine::matchTrade(LimitOrderSet &restingOrders,
+                                  bool isBuy,
+                                  double tradePrice,
+                                  double tradeQuantity,
+                                  std::vector<MatchFill> &fills) {
+    double quantity = this->partialFillsEnabled && !std::isnan(tradeQuantity) ? tradeQuantity : HUGE_VAL;
+    return this->match(restingOrders, isBuy, tradePrice, false, quantity, quantity, NULL, fills);
+}
+
+// Same as above, but also matches the orders at the trade price against their queue positions on queueBook, the side
+// of the order book the resting orders are on.
+size_t MatchingEngine::matchTrade(LimitOrderSet &restingOrders,
+                                  bool isBuy,
+                                  double tradePrice,
+                                  double tradeQuantity,
+                                  OrderBookSide &queueBook,
+                                  std::vector<MatchFill> &fills) {
+    double queueVolume = std::isnan(tradeQuantity) ? HUGE_VAL : tradeQuantity;
+    double quantity = this->partialFillsEnabled ? queueVolume : HUGE_VAL;
+    return this->match(restingOrders, isBuy, tradePrice, false, quantity, queueVolume, &queueBook, fills);
+}
+
+size_t MatchingEngine::matchCrossedBook(LimitOrderSet &restingOrders,
+                                        bool isBuy,
+                                        double oppositePrice,
+                                        std::vector<MatchFill> &fills) {
+    return this->match(restingOrders, isBuy, oppositePrice, true, HUGE_VAL, HUGE_VAL, NULL, fills);
+}
@@ -0,0 +1,101 @@
+#ifndef _MATCHING_ENGINE_H
+#define _MATCHING_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+#include "LimitOrder.h"
+#include "OrderBookSide.h"
+#include "PoolAllocator.h"
+#include "SymbolTable.h"
+
+// A fill produced by the matching engine for one resting limit order.
+struct MatchFill {
+    LimitOrderSet::iterator order;
+    double price;
+    double quantity;
+    double remainingQuantity;
+};
+
+// Matches trades and crossed books against the resting limit orders of one exchange.
+//
+// The engine does not own the orders. It walks a LimitOrderSet in price priority, from the best price to the worst,
+// and keeps its own per order state keyed by client order handle: the remaining quantity and the arrival sequence.
+// Orders at the same price are filled in arrival order. Fills are made at the limit price of the resting order.
+//
+// By default a trade through an order's price fills the whole remaining quantity, like a crossed book does. With
+// partial fills enabled, a trade only fills up to its own quantity, shared out in price-time priority.
+//
+// Orders can also be placed with their queue position tracked by the order book side they rest on. A trade at
+// exactly the price of such an order then fills it once the trade volume gets past the volume still queued ahead of
+// it, instead of never filling it at all.
+class MatchingEngine {
+    struct OrderState {
+        double remainingQuantity;
+        uint64_t sequence;
+        bool queuePositionTracked;
+    };
+
+    typedef std::unordered_map<SymbolHandle, OrderState, std::hash<SymbolHandle>, std::equal_to<SymbolHandle>,
+                               PoolAllocator<std::pair<const SymbolHandle, OrderState>>> OrderStateMap;
+
+    OrderStateMap orders;
+    std::vector<LimitOrderSet::iterator> priceLevel;
+    uint64_t nextSequence;
+    bool partialFillsEnabled;
+    bool queuePositionsEnabled;
+
+    bool isThrough(bool isBuy, double limitPrice, double price, bool inclusive) const;
+    void sortPriceLevel();
+    size_t match(LimitOrderSet &restingOrders,
+                 bool isBuy,
+                 double price,
+                 bool inclusive,
+                 double quantity,
+                 double queueVolume,
+                 OrderBookSide *queueBook,
+                 std::vector<MatchFill> &fills);
+    void matchQueueLevel(double levelPrice,
+                         bool limited,
+                         double &unfilledQuantity,
+                         double queueVolume,
+                         OrderBookSide &queueBook,
+                         std::vector<MatchFill> &fills);
+
+    public:
+        MatchingEngine();
+
+        void setPartialFillsEnabled(bool enabled);
+        bool getPartialFillsEnabled() const;
+        void setQueuePositionsEnabled(bool enabled);
+        bool getQueuePositionsEnabled() const;
+
+        void addOrder(const LimitOrder &order, double quantity);
+        void addOrder(const LimitOrder &order, double quantity, OrderBookSide &queueBook);
+        bool removeOrder(SymbolHandle orderHandle);
+        bool contains(SymbolHandle orderHandle) const;
+        bool isQueuePositionTracked(SymbolHandle orderHandle) const;
+        double getRemainingQuantity(SymbolHandle orderHandle) const;
+        void restoreQuantity(SymbolHandle orderHandle, double quantity);
+        void clear();
+        size_t size() const;
+
+        size_t matchTrade(LimitOrderSet &restingOrders,
+                          bool isBuy,
+                          double tradePrice,
+                          double tradeQuantity,
+                          std::vector<MatchFill> &fills);
+        size_t matchTrade(LimitOrderSet &restingOrders,
+                          bool isBuy,
+                          double tradePrice,
+                          double tradeQuantity,
+                          OrderBookSide &queueBook,
+                          std::vector<MatchFill> &fills);
+        size_t matchCrossedBook(LimitOrderSet &restingOrders,
+                                bool isBuy,
+                                double oppositePrice,
+                                std::vector<MatchFill> &fills);
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "OrderBookCache.h"
+#include <chrono>
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char ORDER_BOOK_CACHE_MAGIC[8] = {'H', 'B', 'O', 'T', 'O', 'B', 'C', 0};
+static const uint32_t ORDER_BOOK_CACHE_VERSION = 1;
+
+static double wallClockTime() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a over the bytes of the rows.
+static uint64_t getChecksum(const double *rows, size_t numValues) {
+    const unsigned char *bytes = (const unsigned char *)rows;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < numValues * sizeof(double); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+OrderBookCacheWriter::OrderBookCacheWriter() {
+    this->numBids = 0;
+    this->numAsks = 0;
+    this->snapshotUid = 0;
+    this->lastDiffUid = 0;
+}
+
+void OrderBookCacheWriter::capture(const OrderBookSide &bids, const OrderBookSide &asks, int64_t snapshotUid,
+                                   int64_t lastDiffUid) {
+    this->rows.resize((bids.size() + asks.size()) * 3);
+    this->numBids = bids.exportLevels(this->rows.data(), bids.size());
+    this->numAsks = asks.exportLevels(this->rows.data() + this->numBids * 3, asks.size());
+    this->rows.resize((this->numBids + this->numAsks) * 3);
+    this->snapshotUid = snapshotUid;
+    this->lastDiffUid = lastDiffUid;
+}
+
+// Writes the captured state to path. A NaN timestamp is replaced by the current wall clock time.
+bool OrderBookCacheWriter::write(const std::string &path, const std::string &tradingPair, double timestamp) const {
+    OrderBookCacheHeader header;
+    if (tradingPair.size() >= sizeof(header.tradingPair)) {
+        return false;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ORDER_BOOK_CACHE_MAGIC, sizeof(ORDER_BOOK_CACHE_MAGIC));
+    header.version = ORDER_BOOK_CACHE_VERSION;
+    header.headerSize = sizeof(header);
+    memcpy(header.tradingPair, tradingPair.data(), tradingPair.size());
+    header.snapshotUid = this->snapshotUid;
+    header.lastDiffUid = this->lastDiffUid;
+    header.timestamp = std::isnan(timestamp) ? wallClockTime() : timestamp;
+    header.numBids = (uint32_t)this->numBids;
+    header.numAsks = (uint32_t)this->numAsks;
+    header.checksum = getChecksum(this->rows.data(), this->rows.size());
+
+    std::string temporaryPath = path + ".tmp";
+    FILE *file = fopen(temporaryPath.c_str(), "wb");
+    if (file == NULL) {
+        return false;
+    }
+    size_t numValues = this->rows.size();
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        (numValues == 0 || fwrite(this->rows.data(), sizeof(double), numValues, file) == numValues) &&
+        fflush(file) == 0 && fsync(fileno(file)) == 0;
+    written = fclose(file) == 0 && written;
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+OrderBookCacheReader::OrderBookCacheReader() {
+    this->data = NULL;
+    this->dataSize = 0;
+}
+
+OrderBookCacheReader::~OrderBookCacheReader() {
+    this->close();
+}
+
+bool OrderBookCacheReader::open(const std::string &path) {
+    this->close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(OrderBookCacheHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t dataSize = (size_t)fileStat.st_size;
+    void *data = mmap(NULL, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    const OrderBookCacheHeader *header = (const OrderBookCacheHeader *)data;
+    size_t numValues = ((size_t)header->numBids + header->numAsks) * 3;
+    if (memcmp(header->magic, ORDER_BOOK_CACHE_MAGIC, sizeof(ORDER_BOOK_CACHE_MAGIC)) != 0 ||
+        header->version != ORDER_BOOK_CACHE_VERSION || header->headerSize < sizeof(OrderBookCacheHeader) ||
+        header->headerSize % sizeof(double) != 0 ||
+        strnlen(header->tradingPair, sizeof(header->tradingPair)) == sizeof(header->tradingPair) ||
+        header->headerSize + numValues * sizeof(double) != dataSize ||
+        getChecksum((const double *)((const char *)data + header->headerSize), numValues) != header->checksum) {
+        munmap(data, dataSize);
+        return false;
+    }
+    this->data = (const char *)data;
+    this->dataSize = dataSize;
+    this->tradingPair.assign(header->tradingPair, strnlen(header->tradingPair, sizeof(header->tradingPair)));
+    return true;
+}
+
+void OrderBookCacheReader::close() {
+    if (this->data != NULL) {
+        munmap((void *)this->data, this->dataSize);
+        this->data = NULL;
+    }
+    this->dataSize = 0;
+    this->tradingPair.clear();
+}
+
+bool OrderBookCacheReader::isOpen() const {
+    return this->data != NULL;
+}
+
+// The getters below expect an open file.
+const OrderBookCacheHeader &OrderBookCacheReader::getHeader() const {
+    return *(const OrderBookCacheHeader *)this->data;
+}
+
+const std::string &OrderBookCacheReader::getTradingPair() const {
+    return this->tradingPair;
+}
+
+int64_t OrderBookCacheReader::getSnapshotUid() const {
+    return this->getHeader().snapshotUid;
+}
+
+int64_t OrderBookCacheReader::getLastDiffUid() const {
+    return this->getHeader().lastDiffUid;
+}
+
+double OrderBookCacheReader::getTimestamp() const {
+    return this->getHeader().timestamp;
+}
+
+const double *OrderBookCacheReader::getBidRows() const {
+    return (const double *)(this->data + this->getHeader().headerSize);
+}
+
+size_t OrderBookCacheReader::getBidCount() const {
+    return this->getHeader().numBids;
+}
+
+const double *OrderBookCacheReader::getAskRows() const {
+    return this->getBidRows() + this->getBidCount() * 3;
+}
+
+size_t OrderBookCacheReader::getAskCount() const {
+    return this->getHeader().numAsks;
+}
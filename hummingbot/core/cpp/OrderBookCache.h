@@ -0,0 +1,76 @@
+#ifndef _ORDER_BOOK_CACHE_H
+#define _ORDER_BOOK_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "OrderBookSide.h"
+
+// Warm start cache files of the state of one order book.
+//
+// A file is an OrderBookCacheHeader followed by the levels of the book as packed (price, amount, updateId) rows, bids
+// first and then asks, best level first, which is the layout the book applies natively. The header keeps the snapshot
+// and last diff update IDs of the book, the wall clock time the state was captured at, and a checksum of the rows.
+//
+// Files are written to a temporary file next to the cache and renamed over it, so a reader sees either the previous
+// state or the new one, never a partial write. Values are stored in native byte order.
+struct OrderBookCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    char tradingPair[48];
+    int64_t snapshotUid;
+    int64_t lastDiffUid;
+    double timestamp;
+    uint32_t numBids;
+    uint32_t numAsks;
+    uint64_t checksum;
+};
+
+// Captures the state of a book and writes it out. capture() only copies the levels, so a book shared with other threads
+// needs to stay locked for that call alone, and not while the file is written.
+class OrderBookCacheWriter {
+    std::vector<double> rows;
+    size_t numBids;
+    size_t numAsks;
+    int64_t snapshotUid;
+    int64_t lastDiffUid;
+
+    public:
+        OrderBookCacheWriter();
+
+        void capture(const OrderBookSide &bids, const OrderBookSide &asks, int64_t snapshotUid, int64_t lastDiffUid);
+        bool write(const std::string &path, const std::string &tradingPair, double timestamp) const;
+};
+
+// Reads a cache file through a read only memory mapping. open() rejects files that are cut short, come from another
+// version, or whose rows do not match their checksum.
+class OrderBookCacheReader {
+    const char *data;
+    size_t dataSize;
+    std::string tradingPair;
+
+    const OrderBookCacheHeader &getHeader() const;
+
+    public:
+        OrderBookCacheReader();
+        OrderBookCacheReader(const OrderBookCacheReader &other) = delete;
+        OrderBookCacheReader &operator=(const OrderBookCacheReader &other) = delete;
+        ~OrderBookCacheReader();
+
+        bool open(const std::string &path);
+        void close();
+        bool isOpen() const;
+
+        const std::string &getTradingPair() const;
+        int64_t getSnapshotUid() const;
+        int64_t getLastDiffUid() const;
+        double getTimestamp() const;
+        const double *getBidRows() const;
+        size_t getBidCount() const;
+        const double *getAskRows() const;
+        size_t getAskCount() const;
+};
+
+#endif
@@ -1,5 +1,46 @@
 #include "OrderBookEntry.h"
 #include <iostream>
+#include <cmath>
+
+FixedPointScale::FixedPointScale() {
+    this->increment = 0;
+    this->inverse = 0;
+}
+
+FixedPointScale::FixedPointScale(double increment) {
+    this->increment = increment > 0 ? increment : 0;
+    this->inverse = 0;
+    if (this->increment > 0) {
+        // Increments like 0.01 are not exact in binary, but their inverse is a whole number. Dividing by that gives
+        // the double nearest to the decimal value, whereas multiplying by the increment can be off by one ulp.
+        double wholeInverse = std::round(1.0 / this->increment);
+        if (wholeInverse >= 1 && std::fabs(1.0 / this->increment - wholeInverse) <= 1e-9 * wholeInverse) {
+            this->inverse = wholeInverse;
+        }
+    }
+}
+
+bool FixedPointScale::isEnabled() const {
+    return this->increment > 0;
+}
+
+double FixedPointScale::getIncrement() const {
+    return this->increment;
+}
+
+int64_t FixedPointScale::toUnits(double value) const {
+    if (this->inverse > 0) {
+        return std::llround(value * this->inverse);
+    }
+    return std::llround(value / this->increment);
+}
+
+double FixedPointScale::fromUnits(int64_t units) const {
+    if (this->inverse > 0) {
+        return (double)units / this->inverse;
+    }
+    return (double)units * this->increment;
+}
 
 OrderBookEntry::OrderBookEntry() {
     this->price = this->amount = 0;
@@ -90,3 +131,17 @@ double OrderBookEntry::getAmount() const {
 int64_t OrderBookEntry::getUpdateId() const {
     return this->updateId;
 }
+
+// Returns a copy of this entry with the price and amount rounded to the nearest multiple of their increments.
+// Disabled scales leave the value untouched.
+OrderBookEntry OrderBookEntry::roundedTo(const FixedPointScale &priceScale, const FixedPointScale &amountScale) const {
+    double price = this->price;
+    double amount = this->amount;
+    if (priceScale.isEnabled()) {
+        price = priceScale.fromUnits(priceScale.toUnits(price));
+    }
+    if (amountScale.isEnabled()) {
+        amount = amountScale.fromUnits(amountScale.toUnits(amount));
+    }
+    return OrderBookEntry(price, amount, this->updateId);
+}
@@ -5,6 +5,21 @@
 #include <set>
 #include <iterator>
 
+// Converts between doubles and whole multiples of a fixed increment, such as price ticks or amount lots.
+// A scale with a zero increment is disabled.
+class FixedPointScale {
+    double increment;
+    double inverse;
+
+    public:
+        FixedPointScale();
+        FixedPointScale(double increment);
+        bool isEnabled() const;
+        double getIncrement() const;
+        int64_t toUnits(double value) const;
+        double fromUnits(int64_t units) const;
+};
+
 class OrderBookEntry {
     double price;
     double amount;
@@ -23,6 +38,7 @@ class OrderBookEntry {
         double getPrice() const;
         double getAmount() const;
         int64_t getUpdateId() const;
+        OrderBookEntry roundedTo(const FixedPointScale &priceScale, const FixedPointScale &amountScale) const;
 };
 
 #endif
@@ -0,0 +1,109 @@
+#include "OrderBookFeatureEngine.h"
+#include <cmath>
+
+namespace {
+
+// The base volume of a side from its best level out to the bound price, inclusive.
+double getVolumeInsideBand(const OrderBookSide &book, double bound) {
+    double volume = 0;
+    for (OrderBookSide::iterator it = book.begin(); it != book.end(); ++it) {
+        if (book.getIsBid() ? it->getPrice() < bound : it->getPrice() > bound) {
+            break;
+        }
+        volume += it->getAmount();
+    }
+    return volume;
+}
+
+}
+
+OrderBookFeatureEngine::OrderBookFeatureEngine() {
+    this->depth = 0;
+    this->pressureBps = 0;
+    this->clear();
+}
+
+void OrderBookFeatureEngine::configure(size_t depth, double pressureBps) {
+    this->depth = depth;
+    this->pressureBps = pressureBps;
+    this->clear();
+}
+
+bool OrderBookFeatureEngine::isEnabled() const {
+    return this->depth > 0;
+}
+
+size_t OrderBookFeatureEngine::getDepth() const {
+    return this->depth;
+}
+
+double OrderBookFeatureEngine::getPressureBps() const {
+    return this->pressureBps;
+}
+
+void OrderBookFeatureEngine::update(const OrderBookSide &bidBook, const OrderBookSide &askBook) {
+    if (this->depth == 0) {
+        return;
+    }
+    if (bidBook.empty() || askBook.empty()) {
+        this->clear();
+        return;
+    }
+
+    const OrderBookEntry &bestBid = bidBook.best();
+    const OrderBookEntry &bestAsk = askBook.best();
+    double topVolume = bestBid.getAmount() + bestAsk.getAmount();
+    this->values.microprice = topVolume > 0
+                              ? (bestBid.getPrice() * bestAsk.getAmount() + bestAsk.getPrice() * bestBid.getAmount()) /
+                                topVolume
+                              : (bestBid.getPrice() + bestAsk.getPrice()) / 2;
+
+    // One pass over the top depths of both sides, for the imbalance and the weighted mid.
+    double bidVolume = 0;
+    double askVolume = 0;
+    double weightedMidSum = 0;
+    double weightSum = 0;
+    OrderBookSide::iterator bid = bidBook.begin();
+    OrderBookSide::iterator ask = askBook.begin();
+    for (size_t i = 0; i < this->depth && (bid != bidBook.end() || ask != askBook.end()); i++) {
+        if (bid != bidBook.end() && ask != askBook.end()) {
+            double weight = bid->getAmount() + ask->getAmount();
+            weightedMidSum += (bid->getPrice() + ask->getPrice()) * 0.5 * weight;
+            weightSum += weight;
+        }
+        if (bid != bidBook.end()) {
+            bidVolume += bid->getAmount();
+            ++bid;
+        }
+        if (ask != askBook.end()) {
+            askVolume += ask->getAmount();
+            ++ask;
+        }
+    }
+    this->values.depthImbalance = bidVolume + askVolume > 0
+                                  ? (bidVolume - askVolume) / (bidVolume + askVolume) : 0;
+    this->values.weightedMid = weightSum > 0
+                               ? weightedMidSum / weightSum : (bestBid.getPrice() + bestAsk.getPrice()) / 2;
+
+    double mid = (bestBid.getPrice() + bestAsk.getPrice()) / 2;
+    double band = mid * this->pressureBps / 10000;
+    this->values.bidPressureVolume = getVolumeInsideBand(bidBook, mid - band);
+    this->values.askPressureVolume = getVolumeInsideBand(askBook, mid + band);
+    double pressureVolume = this->values.bidPressureVolume + this->values.askPressureVolume;
+    this->values.bookPressure = pressureVolume > 0
+                                ? (this->values.bidPressureVolume - this->values.askPressureVolume) / pressureVolume
+                                : 0;
+}
+
+void OrderBookFeatureEngine::clear() {
+    this->values.microprice = NAN;
+    this->values.depthImbalance = NAN;
+    this->values.bidPressureVolume = NAN;
+    this->values.askPressureVolume = NAN;
+    this->values.bookPressure = NAN;
+    this->values.weightedMid = NAN;
+}
+
+const OrderBookFeatureValues &OrderBookFeatureEngine::getValues() const {
+    return this->values;
+}
@@ -0,0 +1,50 @@
+#ifndef _ORDER_BOOK_FEATURE_ENGINE_H
+#define _ORDER_BOOK_FEATURE_ENGINE_H
+
+#include <stddef.h>
+#include "OrderBookSide.h"
+
+// Features of the top of an order book, as strategies read them on every tick. All of them are NaN while a side of
+// the book is empty or the engine is disabled.
+//
+// - microprice: the best bid and ask weighted by the amount on the opposite side,
+//   (bid * askAmount + ask * bidAmount) / (bidAmount + askAmount).
+// - depthImbalance: (bidVolume - askVolume) / (bidVolume + askVolume) over the top N levels of each side, in [-1, 1].
+// - bidPressureVolume, askPressureVolume: the base volume quoted within k bps of the mid price on each side.
+// - bookPressure: the imbalance of those two volumes, in [-1, 1], or 0 if neither side quotes inside the band.
+// - weightedMid: the midpoints of the top N depths, (bid[i] + ask[i]) / 2, averaged with the combined amount at each
+//   depth as weights. Only depths both sides have are used.
+struct OrderBookFeatureValues {
+    double microprice;
+    double depthImbalance;
+    double bidPressureVolume;
+    double askPressureVolume;
+    double bookPressure;
+    double weightedMid;
+};
+
+// Keeps the features of one order book up to date. The book calls update() after every change to its sides, under
+// the same lock, so reading the features costs a field load. A depth of 0 disables the engine, and update() then
+// returns straight away.
+//
+// Every update walks the top N levels and the levels inside the pressure band, best level first. Those are a few
+// contiguous entries at the back of each side's vector, so the walk stays within a handful of cache lines.
+class OrderBookFeatureEngine {
+    size_t depth;
+    double pressureBps;
+    OrderBookFeatureValues values;
+
+    public:
+        OrderBookFeatureEngine();
+
+        void configure(size_t depth, double pressureBps);
+        bool isEnabled() const;
+        size_t getDepth() const;
+        double getPressureBps() const;
+
+        void update(const OrderBookSide &bidBook, const OrderBookSide &askBook);
+        void clear();
+        const OrderBookFeatureValues &getValues() const;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "OrderBookOverlay.h"
+#include <algorithm>
+#include <cmath>
+
+static DepthQueryResult makeOverlayQueryResult(double queryPrice, double queryVolume,
+                                               double resultPrice, double resultVolume) {
+    DepthQueryResult result;
+    result.queryPrice = queryPrice;
+    result.queryVolume = queryVolume;
+    result.resultPrice = resultPrice;
+    result.resultVolume = resultVolume;
+    return result;
+}
+
+OrderBookOverlay::OrderBookOverlay() {
+    this->base = NULL;
+    this->consumed = NULL;
+    this->depth = 0;
+    this->consumedDepth = 0;
+}
+
+OrderBookOverlay::OrderBookOverlay(const OrderBookSide &base, OrderBookSide &consumed) {
+    this->base = &base;
+    this->consumed = &consumed;
+    this->depth = 0;
+    this->consumedDepth = 0;
+}
+
+bool OrderBookOverlay::isBetter(double a, double b) const {
+    return this->base->getIsBid() ? a > b : a < b;
+}
+
+void OrderBookOverlay::rewind() {
+    this->depth = 0;
+    this->consumedDepth = 0;
+    this->consumedChanges.clear();
+}
+
+// Moves to the next level of the view, best first. Levels that have been consumed whole are skipped.
+bool OrderBookOverlay::next(OrderBookEntry &entry) {
+    if (this->base == NULL) {
+        return false;
+    }
+    while (this->depth < this->base->size()) {
+        const OrderBookEntry &level = this->base->getLevel(this->depth++);
+        bool consumedWhole = false;
+        while (this->consumedDepth < this->consumed->size()) {
+            const OrderBookEntry &consumedLevel = this->consumed->getLevel(this->consumedDepth);
+            if (consumedLevel.getPrice() == level.getPrice()) {
+                this->consumedDepth++;
+                double amount = level.getAmount() - consumedLevel.getAmount();
+                if (amount > 0) {
+                    entry = OrderBookEntry(level.getPrice(), amount, level.getUpdateId());
+                    return true;
+                }
+                this->consumedChanges.push_back(OrderBookEntry(level.getPrice(),
+                                                               std::min(level.getAmount(), consumedLevel.getAmount()),
+                                                               consumedLevel.getUpdateId()));
+                consumedWhole = true;
+                break;
+            } else if (this->isBetter(consumedLevel.getPrice(), level.getPrice())) {
+                // The level is not in the base book anymore.
+                this->consumedChanges.push_back(OrderBookEntry(consumedLevel.getPrice(), 0,
+                                                               consumedLevel.getUpdateId()));
+                this->consumedDepth++;
+            } else {
+                break;
+            }
+        }
+        if (!consumedWhole) {
+            entry = level;
+            return true;
+        }
+    }
+    return false;
+}
+
+void OrderBookOverlay::commit() {
+    if (this->consumed != NULL) {
+        for (size_t i = 0; i < this->consumedChanges.size(); ++i) {
+            this->consumed->applyDiff(this->consumedChanges[i]);
+        }
+    }
+    this->rewind();
+}
+
+size_t OrderBookOverlay::exportLevels(double *rows, size_t maxRows) {
+    OrderBookEntry entry;
+    size_t numRows = 0;
+    this->rewind();
+    while (numRows < maxRows && this->next(entry)) {
+        rows[numRows * 3] = entry.getPrice();
+        rows[numRows * 3 + 1] = entry.getAmount();
+        rows[numRows * 3 + 2] = (double)entry.getUpdateId();
+        numRows++;
+    }
+    this->commit();
+    return numRows;
+}
+
+DepthQueryResult OrderBookOverlay::getPriceForVolume(double volume) {
+    OrderBookEntry entry;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    this->rewind();
+    while (this->next(entry)) {
+        cumulativeVolume += entry.getAmount();
+        if (cumulativeVolume >= volume) {
+            resultPrice = entry.getPrice();
+            break;
+        }
+    }
+    this->commit();
+    return makeOverlayQueryResult(NAN, volume, resultPrice, std::min(cumulativeVolume, volume));
+}
+
+DepthQueryResult OrderBookOverlay::getVwapForVolume(double volume) {
+    OrderBookEntry entry;
+    double totalCost = 0;
+    double totalVolume = 0;
+    double resultVwap = NAN;
+    this->rewind();
+    while (this->next(entry)) {
+        totalCost += entry.getAmount() * entry.getPrice();
+        totalVolume += entry.getAmount();
+        if (totalVolume >= volume) {
+            // Only take the part of the last level that is needed to reach the requested volume.
+            totalCost -= entry.getAmount() * entry.getPrice();
+            totalVolume -= entry.getAmount();
+            double incrementalAmount = volume - totalVolume;
+            totalCost += incrementalAmount * entry.getPrice();
+            totalVolume += incrementalAmount;
+            resultVwap = totalCost / totalVolume;
+            break;
+        }
+    }
+    this->commit();
+    return makeOverlayQueryResult(NAN, volume, resultVwap, std::min(totalVolume, volume));
+}
+
+DepthQueryResult OrderBookOverlay::getPriceForQuoteVolume(double quoteVolume) {
+    OrderBookEntry entry;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    this->rewind();
+    while (this->next(entry)) {
+        cumulativeVolume += entry.getAmount() * entry.getPrice();
+        if (cumulativeVolume >= quoteVolume) {
+            resultPrice = entry.getPrice();
+            break;
+        }
+    }
+    this->commit();
+    return makeOverlayQueryResult(NAN, quoteVolume, resultPrice, std::min(cumulativeVolume, quoteVolume));
+}
+
+DepthQueryResult OrderBookOverlay::getQuoteVolumeForBaseAmount(double baseAmount) {
+    OrderBookEntry entry;
+    double cumulativeVolume = 0;
+    double cumulativeBaseAmount = 0;
+    this->rewind();
+    while (this->next(entry)) {
+        double rowAmount = entry.getAmount();
+        if (rowAmount + cumulativeBaseAmount >= baseAmount) {
+            rowAmount = baseAmount - cumulativeBaseAmount;
+        }
+        cumulativeBaseAmount += rowAmount;
+        cumulativeVolume += rowAmount * entry.getPrice();
+        if (cumulativeBaseAmount >= baseAmount) {
+            break;
+        }
+    }
+    this->commit();
+    return makeOverlayQueryResult(NAN, baseAmount, NAN, cumulativeVolume);
+}
+
+DepthQueryResult OrderBookOverlay::getVolumeForPrice(double price) {
+    OrderBookEntry entry;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    this->rewind();
+    while (this->next(entry)) {
+        if (this->isBetter(price, entry.getPrice())) {
+            break;
+        }
+        cumulativeVolume += entry.getAmount();
+        resultPrice = entry.getPrice();
+    }
+    this->commit();
+    return makeOverlayQueryResult(price, NAN, resultPrice, cumulativeVolume);
+}
+
+DepthQueryResult OrderBookOverlay::getQuoteVolumeForPrice(double price) {
+    OrderBookEntry entry;
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    this->rewind();
+    while (this->next(entry)) {
+        if (this->isBetter(price, entry.getPrice())) {
+            break;
+        }
+        cumulativeVolume += entry.getAmount() * entry.getPrice();
+        resultPrice = entry.getPrice();
+    }
+    this->commit();
+    return makeOverlayQueryResult(price, NAN, resultPrice, cumulativeVolume);
+}
@@ -0,0 +1,46 @@
+#ifndef _ORDER_BOOK_OVERLAY_H
+#define _ORDER_BOOK_OVERLAY_H
+
+#include <stddef.h>
+#include <vector>
+#include "OrderBookEntry.h"
+#include "OrderBookSide.h"
+
+// A view of one side of an order book with the volume already consumed by the bot's own fills taken off its levels,
+// without copying the book.
+//
+// The consumed volume is kept as a book side of its own, holding the total filled at each price. The view is merged
+// lazily while walking both sides from the best price down. Consumed volume at a price that is no longer in the base
+// book has since been traded away on the exchange as well, so it is dropped as the walk passes it. Consumed volume
+// that clears a level out is capped to the level's amount, so volume added to the level later on shows up again.
+// These changes to the consumed side are collected during the walk and applied by commit(), as the walk goes by depth
+// and must not see the consumed side shift under it.
+//
+// The depth queries walk the view the same way OrderBookSide walks its levels, and commit once they are done.
+class OrderBookOverlay {
+    const OrderBookSide *base;
+    OrderBookSide *consumed;
+    size_t depth;
+    size_t consumedDepth;
+    std::vector<OrderBookEntry> consumedChanges;
+
+    bool isBetter(double a, double b) const;
+
+    public:
+        OrderBookOverlay();
+        OrderBookOverlay(const OrderBookSide &base, OrderBookSide &consumed);
+
+        void rewind();
+        bool next(OrderBookEntry &entry);
+        void commit();
+
+        size_t exportLevels(double *rows, size_t maxRows);
+        DepthQueryResult getPriceForVolume(double volume);
+        DepthQueryResult getVwapForVolume(double volume);
+        DepthQueryResult getPriceForQuoteVolume(double quoteVolume);
+        DepthQueryResult getQuoteVolumeForBaseAmount(double baseAmount);
+        DepthQueryResult getVolumeForPrice(double price);
+        DepthQueryResult getQuoteVolumeForPrice(double price);
+};
+
+#endif
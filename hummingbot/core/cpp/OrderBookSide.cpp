@@ -0,0 +1,791 @@
+#include "OrderBookSide.h"
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+OrderBookSide::OrderBookSide() {
+    this->isBid = true;
+    this->depthIndexEnabled = false;
+    this->depthIndexValid = false;
+    this->topLevels = NULL;
+    this->topLevelsCapacity = this->topLevelsCount = 0;
+    this->topLevelsDirtyFrom = this->topLevelsDirtyTo = 0;
+    this->clearLevelCounts();
+}
+
+OrderBookSide::OrderBookSide(bool isBid) {
+    this->isBid = isBid;
+    this->depthIndexEnabled = false;
+    this->depthIndexValid = false;
+    this->topLevels = NULL;
+    this->topLevelsCapacity = this->topLevelsCount = 0;
+    this->topLevelsDirtyFrom = this->topLevelsDirtyTo = 0;
+    this->clearLevelCounts();
+}
+
+// Copies do not share the top levels buffer, the queue positions or the level counts of the original side.
+OrderBookSide::OrderBookSide(const OrderBookSide &other) {
+    this->levels = other.levels;
+    this->priceTicks = other.priceTicks;
+    this->priceScale = other.priceScale;
+    this->amountScale = other.amountScale;
+    this->isBid = other.isBid;
+    this->depthIndexEnabled = other.depthIndexEnabled;
+    this->depthIndexValid = false;
+    this->topLevels = NULL;
+    this->topLevelsCapacity = this->topLevelsCount = 0;
+    this->topLevelsDirtyFrom = this->topLevelsDirtyTo = 0;
+    this->clearLevelCounts();
+}
+
+OrderBookSide &OrderBookSide::operator=(const OrderBookSide &other) {
+    this->levels = other.levels;
+    this->priceTicks = other.priceTicks;
+    this->priceScale = other.priceScale;
+    this->amountScale = other.amountScale;
+    this->isBid = other.isBid;
+    this->depthIndexEnabled = other.depthIndexEnabled;
+    this->levelsChanged(0, SIZE_MAX);
+    this->resyncQueuePositions();
+    return *this;
+}
+
+// Records that the levels between the two depths have changed. Levels are addressed by depth, so inserting or erasing
+// a level changes every level below it as well.
+void OrderBookSide::levelsChanged(size_t fromDepth, size_t toDepth) {
+    this->depthIndexValid = false;
+    if (fromDepth < this->topLevelsCapacity) {
+        if (this->topLevelsDirtyFrom >= this->topLevelsDirtyTo) {
+            this->topLevelsDirtyFrom = fromDepth;
+            this->topLevelsDirtyTo = toDepth;
+        } else {
+            this->topLevelsDirtyFrom = std::min(this->topLevelsDirtyFrom, fromDepth);
+            this->topLevelsDirtyTo = std::max(this->topLevelsDirtyTo, toDepth);
+        }
+    }
+}
+
+bool OrderBookSide::isWorse(double a, double b) const {
+    return this->isBid ? (a < b) : (a > b);
+}
+
+// Returns the storage index of the first level whose price is not worse than the given price.
+size_t OrderBookSide::lowerBound(double price) const {
+    size_t low = 0;
+    size_t high = this->levels.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (this->isWorse(this->levels[middle].getPrice(), price)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+OrderBookSide::iterator OrderBookSide::begin() const {
+    return this->levels.rbegin();
+}
+
+OrderBookSide::iterator OrderBookSide::end() const {
+    return this->levels.rend();
+}
+
+// Returns the storage index where the given price is, or should be inserted. In fixed point mode the price is matched
+// by its tick count.
+size_t OrderBookSide::findPosition(double price, bool &found) const {
+    if (!this->priceScale.isEnabled()) {
+        size_t position = this->lowerBound(price);
+        found = position < this->levels.size() && this->levels[position].getPrice() == price;
+        return position;
+    }
+    int64_t ticks = this->priceScale.toUnits(price);
+    size_t low = 0;
+    size_t high = this->priceTicks.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (this->isBid ? (this->priceTicks[middle] < ticks) : (this->priceTicks[middle] > ticks)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    found = low < this->priceTicks.size() && this->priceTicks[low] == ticks;
+    return low;
+}
+
+// Inserts an entry that has already been rounded to the fixed point increments, if any.
+void OrderBookSide::insertLevel(size_t position, const OrderBookEntry &entry) {
+    this->levels.insert(this->levels.begin() + position, entry);
+    if (this->priceScale.isEnabled()) {
+        this->priceTicks.insert(this->priceTicks.begin() + position, this->priceScale.toUnits(entry.getPrice()));
+    }
+    this->levelsChanged(this->levels.size() - 1 - position, SIZE_MAX);
+    this->levelCounts.inserted++;
+}
+
+void OrderBookSide::eraseLevel(size_t position) {
+    this->levelsChanged(this->levels.size() - 1 - position, SIZE_MAX);
+    this->levelCounts.erased++;
+    this->levels.erase(this->levels.begin() + position);
+    if (this->priceScale.isEnabled()) {
+        this->priceTicks.erase(this->priceTicks.begin() + position);
+    }
+}
+
+OrderBookSide::iterator OrderBookSide::find(double price) const {
+    bool found;
+    size_t position = this->findPosition(price, found);
+    if (found) {
+        return iterator(this->levels.begin() + position + 1);
+    }
+    return this->end();
+}
+
+// Inserts a new price level. Like std::set::insert(), an existing level at the same price is left untouched.
+bool OrderBookSide::insert(const OrderBookEntry &entry) {
+    bool found;
+    size_t position = this->findPosition(entry.getPrice(), found);
+    if (found) {
+        return false;
+    }
+    this->insertLevel(position, entry.roundedTo(this->priceScale, this->amountScale));
+    return true;
+}
+
+bool OrderBookSide::erase(double price) {
+    bool found;
+    size_t position = this->findPosition(price, found);
+    if (found) {
+        if (!this->queueLevels.empty()) {
+            this->queueLevelChanged(this->levels[position].getPrice(), this->levels[position].getAmount(), 0);
+        }
+        this->eraseLevel(position);
+    }
+    return found;
+}
+
+// Applies a single diff row. Diffs with 0 amounts mean deletion, anything else replaces the level. In fixed point mode
+// that includes amounts that round to 0 lots.
+void OrderBookSide::applyDiff(const OrderBookEntry &entry) {
+    bool found;
+    size_t position = this->findPosition(entry.getPrice(), found);
+    OrderBookEntry rounded = entry.roundedTo(this->priceScale, this->amountScale);
+    if (!this->queueLevels.empty() && found) {
+        this->queueLevelChanged(rounded.getPrice(), this->levels[position].getAmount(),
+                                std::max(rounded.getAmount(), 0.0));
+    }
+    if (rounded.getAmount() > 0) {
+        if (found) {
+            size_t depth = this->levels.size() - 1 - position;
+            this->levels[position] = rounded;
+            this->levelsChanged(depth, depth + 1);
+            this->levelCounts.updated++;
+        } else {
+            this->insertLevel(position, rounded);
+        }
+    } else if (found) {
+        this->eraseLevel(position);
+    }
+}
+
+// Replaces the whole side with the given entries. Sorting once is much cheaper than inserting level by level, and
+// the first entry wins when a price appears more than once - the same as inserting into a std::set.
+void OrderBookSide::assign(const std::vector<OrderBookEntry> &entries) {
+    const bool isBid = this->isBid;
+    this->levels.assign(entries.begin(), entries.end());
+    if (this->priceScale.isEnabled()) {
+        // Prices that round to the same tick become the same double, so they are deduplicated below.
+        for (size_t i = 0; i < this->levels.size(); ++i) {
+            this->levels[i] = this->levels[i].roundedTo(this->priceScale, this->amountScale);
+        }
+    }
+    std::stable_sort(this->levels.begin(), this->levels.end(),
+                     [isBid](const OrderBookEntry &a, const OrderBookEntry &b) {
+                         return isBid ? (a.getPrice() < b.getPrice()) : (a.getPrice() > b.getPrice());
+                     });
+    // The stable sort keeps equal prices in input order, so std::unique leaves the first input entry of each price.
+    std::vector<OrderBookEntry>::iterator last = std::unique(
+        this->levels.begin(), this->levels.end(),
+        [](const OrderBookEntry &a, const OrderBookEntry &b) {
+            return a.getPrice() == b.getPrice();
+        });
+    this->levels.erase(last, this->levels.end());
+    this->priceTicks.clear();
+    if (this->priceScale.isEnabled()) {
+        this->priceTicks.reserve(this->levels.size());
+        for (size_t i = 0; i < this->levels.size(); ++i) {
+            this->priceTicks.push_back(this->priceScale.toUnits(this->levels[i].getPrice()));
+        }
+    }
+    this->levelsChanged(0, SIZE_MAX);
+    this->resyncQueuePositions();
+}
+
+void OrderBookSide::popBest() {
+    if (!this->queueLevels.empty()) {
+        this->queueLevelChanged(this->levels.back().getPrice(), this->levels.back().getAmount(), 0);
+    }
+    this->levels.pop_back();
+    if (this->priceScale.isEnabled()) {
+        this->priceTicks.pop_back();
+    }
+    this->levelsChanged(0, SIZE_MAX);
+    this->levelCounts.popped++;
+}
+
+void OrderBookSide::clear() {
+    this->levels.clear();
+    this->priceTicks.clear();
+    this->levelsChanged(0, SIZE_MAX);
+    this->resyncQueuePositions();
+}
+
+void OrderBookSide::reserve(size_t capacity) {
+    this->levels.reserve(capacity);
+    if (this->priceScale.isEnabled()) {
+        this->priceTicks.reserve(capacity);
+    }
+}
+
+const OrderBookEntry &OrderBookSide::best() const {
+    return this->levels.back();
+}
+
+// Returns the level at the given depth, where depth 0 is the best level.
+const OrderBookEntry &OrderBookSide::getLevel(size_t depth) const {
+    return this->levels[this->levels.size() - 1 - depth];
+}
+
+size_t OrderBookSide::size() const {
+    return this->levels.size();
+}
+
+bool OrderBookSide::empty() const {
+    return this->levels.empty();
+}
+
+bool OrderBookSide::getIsBid() const {
+    return this->isBid;
+}
+
+// Switches fixed point mode on, or off with a zero price increment. A zero amount increment leaves amounts untouched.
+// Levels already in the book are rounded to the new increments.
+void OrderBookSide::setFixedPointIncrements(double priceIncrement, double amountIncrement) {
+    std::vector<OrderBookEntry> currentLevels(this->levels.rbegin(), this->levels.rend());
+    this->priceScale = FixedPointScale(priceIncrement);
+    this->amountScale = this->priceScale.isEnabled() ? FixedPointScale(amountIncrement) : FixedPointScale();
+    this->assign(currentLevels);
+}
+
+bool OrderBookSide::getFixedPointEnabled() const {
+    return this->priceScale.isEnabled();
+}
+
+double OrderBookSide::getPriceIncrement() const {
+    return this->priceScale.getIncrement();
+}
+
+double OrderBookSide::getAmountIncrement() const {
+    return this->amountScale.getIncrement();
+}
+
+void OrderBookSide::setDepthIndexEnabled(bool enabled) {
+    this->depthIndexEnabled = enabled;
+    this->depthIndexValid = false;
+    if (!enabled) {
+        std::vector<double>().swap(this->cumulativeVolumes);
+        std::vector<double>().swap(this->cumulativeQuoteVolumes);
+    }
+}
+
+bool OrderBookSide::getDepthIndexEnabled() const {
+    return this->depthIndexEnabled;
+}
+
+// Points the top levels cache at a caller owned buffer of capacity * 3 doubles, or disables it with a NULL buffer.
+// The buffer is filled straight away.
+void OrderBookSide::setTopLevelsBuffer(double *buffer, size_t capacity) {
+    this->topLevels = buffer;
+    this->topLevelsCapacity = buffer != NULL ? capacity : 0;
+    this->topLevelsCount = 0;
+    this->topLevelsDirtyFrom = this->topLevelsDirtyTo = 0;
+    this->levelsChanged(0, SIZE_MAX);
+    this->syncTopLevels();
+}
+
+// Copies the changed levels inside the window into the top levels buffer, as (price, amount, updateId) rows ordered
+// from the best level. Rows past the end of the book are filled with NaN. Does nothing if no level in the window has
+// changed since the last call.
+void OrderBookSide::syncTopLevels() {
+    size_t toDepth = std::min(this->topLevelsDirtyTo, this->topLevelsCapacity);
+    for (size_t depth = this->topLevelsDirtyFrom; depth < toDepth; ++depth) {
+        double *row = this->topLevels + depth * 3;
+        if (depth < this->levels.size()) {
+            const OrderBookEntry &level = this->getLevel(depth);
+            row[0] = level.getPrice();
+            row[1] = level.getAmount();
+            row[2] = (double)level.getUpdateId();
+        } else {
+            row[0] = row[1] = row[2] = NAN;
+        }
+    }
+    this->topLevelsDirtyFrom = this->topLevelsDirtyTo = 0;
+    this->topLevelsCount = std::min(this->levels.size(), this->topLevelsCapacity);
+}
+
+size_t OrderBookSide::getTopLevelsCount() const {
+    return this->topLevelsCount;
+}
+
+// Writes up to maxRows levels into rows, as packed (price, amount, updateId) rows ordered from the best level.
+// Returns the number of rows written.
+size_t OrderBookSide::exportLevels(double *rows, size_t maxRows) const {
+    size_t numRows = std::min(this->levels.size(), maxRows);
+    for (size_t depth = 0; depth < numRows; ++depth) {
+        const OrderBookEntry &level = this->getLevel(depth);
+        rows[depth * 3] = level.getPrice();
+        rows[depth * 3 + 1] = level.getAmount();
+        rows[depth * 3 + 2] = (double)level.getUpdateId();
+    }
+    return numRows;
+}
+
+// Rebuilds the cumulative volumes by depth. The sums are accumulated from the best level in the same order as the
+// linear walks below, so both paths give identical results.
+void OrderBookSide::updateDepthIndex() const {
+    size_t numLevels = this->levels.size();
+    double volume = 0;
+    double quoteVolume = 0;
+    this->cumulativeVolumes.resize(numLevels);
+    this->cumulativeQuoteVolumes.resize(numLevels);
+    for (size_t depth = 0; depth < numLevels; ++depth) {
+        const OrderBookEntry &level = this->levels[numLevels - 1 - depth];
+        volume += level.getAmount();
+        quoteVolume += level.getAmount() * level.getPrice();
+        this->cumulativeVolumes[depth] = volume;
+        this->cumulativeQuoteVolumes[depth] = quoteVolume;
+    }
+    this->depthIndexValid = true;
+}
+
+// Returns the first depth whose cumulative value reaches the target, or the cumulative vector size if none does.
+static size_t firstDepthReaching(const std::vector<double> &cumulative, double target) {
+    return std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+}
+
+static DepthQueryResult makeDepthQueryResult(double queryPrice, double queryVolume,
+                                             double resultPrice, double resultVolume) {
+    DepthQueryResult result;
+    result.queryPrice = queryPrice;
+    result.queryVolume = queryVolume;
+    result.resultPrice = resultPrice;
+    result.resultVolume = resultVolume;
+    return result;
+}
+
+DepthQueryResult OrderBookSide::getPriceForVolume(double volume) const {
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    if (this->depthIndexEnabled) {
+        if (!this->depthIndexValid) {
+            this->updateDepthIndex();
+        }
+        size_t depth = firstDepthReaching(this->cumulativeVolumes, volume);
+        if (depth < this->levels.size()) {
+            cumulativeVolume = this->cumulativeVolumes[depth];
+            resultPrice = this->getLevel(depth).getPrice();
+        } else if (!this->levels.empty()) {
+            cumulativeVolume = this->cumulativeVolumes.back();
+        }
+    } else {
+        for (iterator it = this->begin(); it != this->end(); ++it) {
+            cumulativeVolume += it->getAmount();
+            if (cumulativeVolume >= volume) {
+                resultPrice = it->getPrice();
+                break;
+            }
+        }
+    }
+    return makeDepthQueryResult(NAN, volume, resultPrice, std::min(cumulativeVolume, volume));
+}
+
+DepthQueryResult OrderBookSide::getVwapForVolume(double volume) const {
+    double totalCost = 0;
+    double totalVolume = 0;
+    double resultVwap = NAN;
+    if (this->depthIndexEnabled) {
+        if (!this->depthIndexValid) {
+            this->updateDepthIndex();
+        }
+        size_t depth = firstDepthReaching(this->cumulativeVolumes, volume);
+        if (depth < this->levels.size()) {
+            const OrderBookEntry &level = this->getLevel(depth);
+            totalCost = this->cumulativeQuoteVolumes[depth] - level.getAmount() * level.getPrice();
+            totalVolume = this->cumulativeVolumes[depth] - level.getAmount();
+            double incrementalAmount = volume - totalVolume;
+            totalCost += incrementalAmount * level.getPrice();
+            totalVolume += incrementalAmount;
+            resultVwap = totalCost / totalVolume;
+        } else if (!this->levels.empty()) {
+            totalVolume = this->cumulativeVolumes.back();
+        }
+    } else {
+        for (iterator it = this->begin(); it != this->end(); ++it) {
+            totalCost += it->getAmount() * it->getPrice();
+            totalVolume += it->getAmount();
+            if (totalVolume >= volume) {
+                // Only take the part of the last level that is needed to reach the requested volume.
+                totalCost -= it->getAmount() * it->getPrice();
+                totalVolume -= it->getAmount();
+                double incrementalAmount = volume - totalVolume;
+                totalCost += incrementalAmount * it->getPrice();
+                totalVolume += incrementalAmount;
+                resultVwap = totalCost / totalVolume;
+                break;
+            }
+        }
+    }
+    return makeDepthQueryResult(NAN, volume, resultVwap, std::min(totalVolume, volume));
+}
+
+DepthQueryResult OrderBookSide::getPriceForQuoteVolume(double quoteVolume) const {
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    if (this->depthIndexEnabled) {
+        if (!this->depthIndexValid) {
+            this->updateDepthIndex();
+        }
+        size_t depth = firstDepthReaching(this->cumulativeQuoteVolumes, quoteVolume);
+        if (depth < this->levels.size()) {
+            cumulativeVolume = this->cumulativeQuoteVolumes[depth];
+            resultPrice = this->getLevel(depth).getPrice();
+        } else if (!this->levels.empty()) {
+            cumulativeVolume = this->cumulativeQuoteVolumes.back();
+        }
+    } else {
+        for (iterator it = this->begin(); it != this->end(); ++it) {
+            cumulativeVolume += it->getAmount() * it->getPrice();
+            if (cumulativeVolume >= quoteVolume) {
+                resultPrice = it->getPrice();
+                break;
+            }
+        }
+    }
+    return makeDepthQueryResult(NAN, quoteVolume, resultPrice, std::min(cumulativeVolume, quoteVolume));
+}
+
+DepthQueryResult OrderBookSide::getQuoteVolumeForBaseAmount(double baseAmount) const {
+    double cumulativeVolume = 0;
+    double cumulativeBaseAmount = 0;
+    size_t depth = 0;
+    if (this->depthIndexEnabled) {
+        if (!this->depthIndexValid) {
+            this->updateDepthIndex();
+        }
+        // Skip the levels that are taken whole, then finish with the same walk as the linear path.
+        depth = firstDepthReaching(this->cumulativeVolumes, baseAmount);
+        if (depth > 0) {
+            cumulativeBaseAmount = this->cumulativeVolumes[depth - 1];
+            cumulativeVolume = this->cumulativeQuoteVolumes[depth - 1];
+        }
+    }
+    for (; depth < this->levels.size(); ++depth) {
+        const OrderBookEntry &level = this->getLevel(depth);
+        double rowAmount = level.getAmount();
+        if (rowAmount + cumulativeBaseAmount >= baseAmount) {
+            rowAmount = baseAmount - cumulativeBaseAmount;
+        }
+        cumulativeBaseAmount += rowAmount;
+        cumulativeVolume += rowAmount * level.getPrice();
+        if (cumulativeBaseAmount >= baseAmount) {
+            break;
+        }
+    }
+    return makeDepthQueryResult(NAN, baseAmount, NAN, cumulativeVolume);
+}
+
+DepthQueryResult OrderBookSide::getVolumeForPrice(double price) const {
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    if (this->depthIndexEnabled) {
+        if (!this->depthIndexValid) {
+            this->updateDepthIndex();
+        }
+        // Levels at the given price or better are stored at the back, from lowerBound() onwards.
+        size_t numLevels = this->levels.size() - this->lowerBound(price);
+        if (numLevels > 0) {
+            cumulativeVolume = this->cumulativeVolumes[numLevels - 1];
+            resultPrice = this->getLevel(numLevels - 1).getPrice();
+        }
+    } else {
+        for (iterator it = this->begin(); it != this->end(); ++it) {
+            if (this->isWorse(it->getPrice(), price)) {
+                break;
+            }
+            cumulativeVolume += it->getAmount();
+            resultPrice = it->getPrice();
+        }
+    }
+    return makeDepthQueryResult(price, NAN, resultPrice, cumulativeVolume);
+}
+
+DepthQueryResult OrderBookSide::getQuoteVolumeForPrice(double price) const {
+    double cumulativeVolume = 0;
+    double resultPrice = NAN;
+    if (this->depthIndexEnabled) {
+        if (!this->depthIndexValid) {
+            this->updateDepthIndex();
+        }
+        size_t numLevels = this->levels.size() - this->lowerBound(price);
+        if (numLevels > 0) {
+            cumulativeVolume = this->cumulativeQuoteVolumes[numLevels - 1];
+            resultPrice = this->getLevel(numLevels - 1).getPrice();
+        }
+    } else {
+        for (iterator it = this->begin(); it != this->end(); ++it) {
+            if (this->isWorse(it->getPrice(), price)) {
+                break;
+            }
+            cumulativeVolume += it->getAmount() * it->getPrice();
+            resultPrice = it->getPrice();
+        }
+    }
+    return makeDepthQueryResult(price, NAN, resultPrice, cumulativeVolume);
+}
+
+// Returns the price of the level the given price falls into, which is the price rounded to ticks in fixed point mode.
+double OrderBookSide::getQueueLevelPrice(double price) const {
+    if (!this->priceScale.isEnabled()) {
+        return price;
+    }
+    return this->priceScale.fromUnits(this->priceScale.toUnits(price));
+}
+
+double OrderBookSide::getLevelAmount(double price) const {
+    bool found;
+    size_t position = this->findPosition(price, found);
+    return found ? this->levels[position].getAmount() : 0;
+}
+
+// Updates the queue positions at a level whose amount has changed. Decreases are first matched against recorded trade
+// volume, which has already been taken off the front of the queue. The rest is taken off in proportion to the volume
+// ahead of each order. Nothing can be ahead by more than the new level amount.
+void OrderBookSide::queueLevelChanged(double price, double previousAmount, double amount) {
+    std::unordered_map<double, QueueLevel>::iterator it = this->queueLevels.find(price);
+    if (it == this->queueLevels.end()) {
+        return;
+    }
+    QueueLevel &level = it->second;
+    double decrease = previousAmount - amount;
+    if (decrease > 0) {
+        double tradeVolume = std::min(decrease, level.pendingTradeVolume);
+        level.pendingTradeVolume -= tradeVolume;
+        decrease -= tradeVolume;
+    }
+    level.pendingTradeVolume = std::min(level.pendingTradeVolume, amount);
+    for (size_t i = 0; i < level.orders.size(); ++i) {
+        QueuePosition &position = this->queuePositions[level.orders[i]];
+        if (decrease > 0 && previousAmount > 0) {
+            position.volumeAhead -= decrease * (position.volumeAhead / previousAmount);
+        }
+        position.volumeAhead = std::max(0.0, std::min(position.volumeAhead, amount));
+    }
+}
+
+// Regroups the queue positions by level and caps them at the current level amounts, after the levels have been
+// replaced wholesale or rounded to new increments.
+void OrderBookSide::resyncQueuePositions() {
+    if (this->queuePositions.empty()) {
+        return;
+    }
+    this->queueLevels.clear();
+    for (std::unordered_map<SymbolHandle, QueuePosition>::iterator it = this->queuePositions.begin();
+         it != this->queuePositions.end(); ++it) {
+        double levelPrice = this->getQueueLevelPrice(it->second.price);
+        std::unordered_map<double, QueueLevel>::iterator levelIt = this->queueLevels.find(levelPrice);
+        if (levelIt == this->queueLevels.end()) {
+            QueueLevel level;
+            level.pendingTradeVolume = 0;
+            levelIt = this->queueLevels.emplace(levelPrice, level).first;
+        }
+        levelIt->second.orders.push_back(it->first);
+        it->second.volumeAhead = std::min(it->second.volumeAhead, this->getLevelAmount(levelPrice));
+    }
+}
+
+// Starts tracking the queue position of an order resting at the given price, behind the whole amount currently at
+// that level. Returns the volume ahead of the order.
+double OrderBookSide::trackQueuePosition(SymbolHandle orderHandle, double price) {
+    this->untrackQueuePosition(orderHandle);
+    double levelPrice = this->getQueueLevelPrice(price);
+    QueuePosition position;
+    position.price = price;
+    position.volumeAhead = this->getLevelAmount(levelPrice);
+    this->queuePositions[orderHandle] = position;
+    std::unordered_map<double, QueueLevel>::iterator it = this->queueLevels.find(levelPrice);
+    if (it == this->queueLevels.end()) {
+        QueueLevel level;
+        level.pendingTradeVolume = 0;
+        it = this->queueLevels.emplace(levelPrice, level).first;
+    }
+    it->second.orders.push_back(orderHandle);
+    return position.volumeAhead;
+}
+
+bool OrderBookSide::untrackQueuePosition(SymbolHandle orderHandle) {
+    std::unordered_map<SymbolHandle, QueuePosition>::iterator it = this->queuePositions.find(orderHandle);
+    if (it == this->queuePositions.end()) {
+        return false;
+    }
+    std::unordered_map<double, QueueLevel>::iterator levelIt =
+        this->queueLevels.find(this->getQueueLevelPrice(it->second.price));
+    if (levelIt != this->queueLevels.end()) {
+        std::vector<SymbolHandle> &orders = levelIt->second.orders;
+        orders.erase(std::remove(orders.begin(), orders.end(), orderHandle), orders.end());
+        if (orders.empty()) {
+            this->queueLevels.erase(levelIt);
+        }
+    }
+    this->queuePositions.erase(it);
+    return true;
+}
+
+// Returns the volume ahead of an order, or NaN if its queue position is not tracked.
+double OrderBookSide::getQueuePosition(SymbolHandle orderHandle) const {
+    std::unordered_map<SymbolHandle, QueuePosition>::const_iterator it = this->queuePositions.find(orderHandle);
+    if (it == this->queuePositions.end()) {
+        return NAN;
+    }
+    return it->second.volumeAhead;
+}
+
+// Takes the volume of a trade at the given price off the front of the queue at that level.
+void OrderBookSide::recordQueueTrade(double price, double volume) {
+    if (!(volume > 0)) {
+        return;
+    }
+    double levelPrice = this->getQueueLevelPrice(price);
+    std::unordered_map<double, QueueLevel>::iterator it = this->queueLevels.find(levelPrice);
+    if (it == this->queueLevels.end()) {
+        return;
+    }
+    QueueLevel &level = it->second;
+    level.pendingTradeVolume = std::min(level.pendingTradeVolume + volume, this->getLevelAmount(levelPrice));
+    for (size_t i = 0; i < level.orders.size(); ++i) {
+        QueuePosition &position = this->queuePositions[level.orders[i]];
+        position.volumeAhead = std::max(0.0, position.volumeAhead - volume);
+    }
+}
+
+size_t OrderBookSide::getQueuePositionCount() const {
+    return this->queuePositions.size();
+}
+
+const LevelCounts &OrderBookSide::getLevelCounts() const {
+    return this->levelCounts;
+}
+
+void OrderBookSide::clearLevelCounts() {
+    this->levelCounts.inserted = 0;
+    this->levelCounts.updated = 0;
+    this->levelCounts.erased = 0;
+    this->levelCounts.popped = 0;
+}
+
+void truncateOverlapEntries(OrderBookSide &bidBook, OrderBookSide &askBook, const int &dex) {
+    if (dex != 0) {
+        truncateOverlapEntriesDex(bidBook, askBook);
+    } else {
+        truncateOverlapEntriesCentralised(bidBook, askBook);
+    }
+}
+
+void truncateOverlapEntriesDex(OrderBookSide &bidBook, OrderBookSide &askBook) {
+    while (!bidBook.empty() && !askBook.empty()) {
+        const OrderBookEntry &topBid = bidBook.best();
+        const OrderBookEntry &topAsk = askBook.best();
+        if (topBid.getPrice() >= topAsk.getPrice()) {
+            if (topBid.getAmount() * topBid.getPrice() > topAsk.getAmount() * topAsk.getPrice()) {
+                askBook.popBest();
+            } else {
+                bidBook.popBest();
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+void truncateOverlapEntriesCentralised(OrderBookSide &bidBook, OrderBookSide &askBook) {
+    while (!bidBook.empty() && !askBook.empty()) {
+        const OrderBookEntry &topBid = bidBook.best();
+        const OrderBookEntry &topAsk = askBook.best();
+        if (topBid.getPrice() >= topAsk.getPrice()) {
+            if (topBid.getUpdateId() > topAsk.getUpdateId()) {
+                askBook.popBest();
+            } else {
+                bidBook.popBest();
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+static void recordBestPrices(const OrderBookSide &bidBook, const OrderBookSide &askBook, double &bestBid, double &bestAsk) {
+    // An emptied side keeps its last known best price, same as before the diff batch.
+    if (!bidBook.empty()) {
+        bestBid = bidBook.best().getPrice();
+    }
+    if (!askBook.empty()) {
+        bestAsk = askBook.best().getPrice();
+    }
+}
+
+// Applies a whole diff batch, truncates any overlap between the two sides and records the new best prices.
+// Returns the largest update ID seen in the batch, or 0 if the batch is empty.
+int64_t applyDiffs(OrderBookSide &bidBook, OrderBookSide &askBook,
+                   const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                   const int &dex, double &bestBid, double &bestAsk) {
+    int64_t lastUpdateId = 0;
+    for (std::vector<OrderBookEntry>::const_iterator it = bids.begin(); it != bids.end(); ++it) {
+        bidBook.applyDiff(*it);
+        lastUpdateId = std::max(lastUpdateId, it->getUpdateId());
+    }
+    for (std::vector<OrderBookEntry>::const_iterator it = asks.begin(); it != asks.end(); ++it) {
+        askBook.applyDiff(*it);
+        lastUpdateId = std::max(lastUpdateId, it->getUpdateId());
+    }
+    truncateOverlapEntries(bidBook, askBook, dex);
+    bidBook.syncTopLevels();
+    askBook.syncTopLevels();
+    recordBestPrices(bidBook, askBook, bestBid, bestAsk);
+    return lastUpdateId;
+}
+
+// Same as above, but reads the diffs straight from packed (price, amount, updateId) rows of doubles - the layout of a
+// C-contiguous (N, 3) float64 numpy array - so no OrderBookEntry vectors need to be built by the caller.
+int64_t applyDiffs(OrderBookSide &bidBook, OrderBookSide &askBook,
+                   const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                   const int &dex, double &bestBid, double &bestAsk) {
+    int64_t lastUpdateId = 0;
+    for (size_t i = 0; i < numBids; ++i) {
+        const double *row = bidRows + i * 3;
+        int64_t updateId = (int64_t)row[2];
+        bidBook.applyDiff(OrderBookEntry(row[0], row[1], updateId));
+        lastUpdateId = std::max(lastUpdateId, updateId);
+    }
+    for (size_t i = 0; i < numAsks; ++i) {
+        const double *row = askRows + i * 3;
+        int64_t updateId = (int64_t)row[2];
+        askBook.applyDiff(OrderBookEntry(row[0], row[1], updateId));
+        lastUpdateId = std::max(lastUpdateId, updateId);
+    }
+    truncateOverlapEntries(bidBook, askBook, dex);
+    bidBook.syncTopLevels();
+    askBook.syncTopLevels();
+    recordBestPrices(bidBook, askBook, bestBid, bestAsk);
+    return lastUpdateId;
+}
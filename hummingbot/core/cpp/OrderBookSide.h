@@ -0,0 +1,161 @@
+#ifndef _ORDER_BOOK_SIDE_H
+#define _ORDER_BOOK_SIDE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <iterator>
+#include <unordered_map>
+#include "OrderBookEntry.h"
+#include "SymbolTable.h"
+
+// Result of a depth query, laid out like OrderBookQueryResult on the Cython side.
+struct DepthQueryResult {
+    double queryPrice;
+    double queryVolume;
+    double resultPrice;
+    double resultVolume;
+};
+
+// Running counts of how the levels of a side have changed, for instrumentation.
+struct LevelCounts {
+    uint64_t inserted;
+    uint64_t updated;
+    uint64_t erased;
+    uint64_t popped;
+};
+
+// One side of an order book, stored as a contiguous vector of price levels.
+//
+// Levels are kept sorted from the worst price to the best price, so the best level sits at the back of the vector.
+// Most diffs touch levels close to the top of the book, which means inserts and erases only need to shift a few
+// entries, and removing crossed levels during overlap truncation is a pop_back().
+//
+// Iteration always goes from the best level to the worst level, for both bids and asks.
+//
+// Depth queries walk the levels natively. When the depth index is enabled, the side also keeps cumulative base and
+// quote volumes by depth. The index is rebuilt lazily on the first query after a change to the side, so repeated
+// queries against an unchanged book become binary searches. The index assumes level amounts are never negative.
+//
+// The side can also mirror its top levels into a fixed size buffer of packed (price, amount, updateId) rows. Changes
+// are tracked by depth, and syncTopLevels() only rewrites the rows inside the window that have changed.
+//
+// In fixed point mode, incoming prices and amounts are rounded to whole ticks and lots, and every level also keeps its
+// price as an int64_t tick count. Level lookups then compare ticks, so matching a diff to its level is exact and does
+// not depend on float noise. Prices and amounts are only turned back into doubles at the query boundary.
+//
+// Finally, the side can track the queue position of simulated orders resting at its prices. The volume ahead of an
+// order starts out as the amount of its level when it is tracked. Trades at the level consume it from the front, and
+// any other decrease of the level amount is treated as cancellations spread evenly over the queue. Volume added to the
+// level joins behind the order. Trade volume is remembered until the matching decrease of the level shows up in the
+// diffs, so the same volume is not taken off twice. All of this happens while diffs are applied, so replaying a diff
+// stream never calls back into Python.
+//
+// Levels inserted, updated, erased and popped are counted as they happen. Assigning a whole side is not counted.
+class OrderBookSide {
+    struct QueuePosition {
+        double price;
+        double volumeAhead;
+    };
+
+    struct QueueLevel {
+        double pendingTradeVolume;
+        std::vector<SymbolHandle> orders;
+    };
+
+    std::vector<OrderBookEntry> levels;
+    std::vector<int64_t> priceTicks;
+    FixedPointScale priceScale;
+    FixedPointScale amountScale;
+    bool isBid;
+    bool depthIndexEnabled;
+    mutable bool depthIndexValid;
+    mutable std::vector<double> cumulativeVolumes;
+    mutable std::vector<double> cumulativeQuoteVolumes;
+    double *topLevels;
+    size_t topLevelsCapacity;
+    size_t topLevelsCount;
+    size_t topLevelsDirtyFrom;
+    size_t topLevelsDirtyTo;
+    std::unordered_map<SymbolHandle, QueuePosition> queuePositions;
+    std::unordered_map<double, QueueLevel> queueLevels;
+    LevelCounts levelCounts;
+
+    bool isWorse(double a, double b) const;
+    size_t lowerBound(double price) const;
+    size_t findPosition(double price, bool &found) const;
+    void insertLevel(size_t position, const OrderBookEntry &entry);
+    void eraseLevel(size_t position);
+    void updateDepthIndex() const;
+    void levelsChanged(size_t fromDepth, size_t toDepth);
+    double getQueueLevelPrice(double price) const;
+    double getLevelAmount(double price) const;
+    void queueLevelChanged(double price, double previousAmount, double amount);
+    void resyncQueuePositions();
+
+    public:
+        typedef std::vector<OrderBookEntry>::const_reverse_iterator iterator;
+
+        OrderBookSide();
+        OrderBookSide(bool isBid);
+        OrderBookSide(const OrderBookSide &other);
+        OrderBookSide &operator=(const OrderBookSide &other);
+
+        iterator begin() const;
+        iterator end() const;
+        iterator find(double price) const;
+
+        bool insert(const OrderBookEntry &entry);
+        bool erase(double price);
+        void applyDiff(const OrderBookEntry &entry);
+        void assign(const std::vector<OrderBookEntry> &entries);
+        void popBest();
+        void clear();
+        void reserve(size_t capacity);
+
+        const OrderBookEntry &best() const;
+        const OrderBookEntry &getLevel(size_t depth) const;
+        size_t size() const;
+        bool empty() const;
+        bool getIsBid() const;
+
+        void setFixedPointIncrements(double priceIncrement, double amountIncrement);
+        bool getFixedPointEnabled() const;
+        double getPriceIncrement() const;
+        double getAmountIncrement() const;
+
+        void setDepthIndexEnabled(bool enabled);
+        bool getDepthIndexEnabled() const;
+        void setTopLevelsBuffer(double *buffer, size_t capacity);
+        void syncTopLevels();
+        size_t getTopLevelsCount() const;
+        size_t exportLevels(double *rows, size_t maxRows) const;
+        DepthQueryResult getPriceForVolume(double volume) const;
+        DepthQueryResult getVwapForVolume(double volume) const;
+        DepthQueryResult getPriceForQuoteVolume(double quoteVolume) const;
+        DepthQueryResult getQuoteVolumeForBaseAmount(double baseAmount) const;
+        DepthQueryResult getVolumeForPrice(double price) const;
+        DepthQueryResult getQuoteVolumeForPrice(double price) const;
+
+        double trackQueuePosition(SymbolHandle orderHandle, double price);
+        bool untrackQueuePosition(SymbolHandle orderHandle);
+        double getQueuePosition(SymbolHandle orderHandle) const;
+        void recordQueueTrade(double price, double volume);
+        size_t getQueuePositionCount() const;
+
+        const LevelCounts &getLevelCounts() const;
+        void clearLevelCounts();
+};
+
+void truncateOverlapEntries(OrderBookSide &bidBook, OrderBookSide &askBook, const int &dex);
+void truncateOverlapEntriesDex(OrderBookSide &bidBook, OrderBookSide &askBook);
+void truncateOverlapEntriesCentralised(OrderBookSide &bidBook, OrderBookSide &askBook);
+
+int64_t applyDiffs(OrderBookSide &bidBook, OrderBookSide &askBook,
+                   const std::vector<OrderBookEntry> &bids, const std::vector<OrderBookEntry> &asks,
+                   const int &dex, double &bestBid, double &bestAsk);
+int64_t applyDiffs(OrderBookSide &bidBook, OrderBookSide &askBook,
+                   const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                   const int &dex, double &bestBid, double &bestAsk);
+
+#endif
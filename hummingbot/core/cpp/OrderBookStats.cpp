@@ -0,0 +1,75 @@
+#include "OrderBookStats.h"
+#include <chrono>
+
+OrderBookStats::OrderBookStats() {
+    this->clear();
+}
+
+int64_t OrderBookStats::getMonotonicNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Overlap truncation is the only thing that pops levels off a side, so the number of levels it has removed is the
+// number of levels popped.
+uint64_t OrderBookStats::getTruncatedLevelCount(const OrderBookSide &bidBook, const OrderBookSide &askBook) {
+    return bidBook.getLevelCounts().popped + askBook.getLevelCounts().popped;
+}
+
+void OrderBookStats::recordDiffBatch(int64_t elapsedNanoseconds, size_t numLevels, uint64_t truncatedLevels) {
+    this->counters.diffBatches++;
+    this->counters.diffLevels += numLevels;
+    if (truncatedLevels > 0) {
+        this->counters.truncations++;
+        this->counters.truncatedLevels += truncatedLevels;
+    }
+    this->diffApplyTimes.record(elapsedNanoseconds > 0 ? (uint64_t)elapsedNanoseconds : 0);
+    this->diffBatchLevels.record(numLevels);
+}
+
+void OrderBookStats::recordSnapshot(int64_t elapsedNanoseconds) {
+    this->counters.snapshots++;
+    this->snapshotApplyTimes.record(elapsedNanoseconds > 0 ? (uint64_t)elapsedNanoseconds : 0);
+}
+
+void OrderBookStats::recordUpdateIdGap() {
+    this->counters.updateIdGaps++;
+}
+
+// Clocks drift, so diffs that seem to arrive before they were sent count as no lag at all.
+void OrderBookStats::recordExchangeLag(int64_t lagNanoseconds) {
+    this->exchangeLags.record(lagNanoseconds > 0 ? (uint64_t)lagNanoseconds : 0);
+}
+
+void OrderBookStats::clear() {
+    this->counters.diffBatches = 0;
+    this->counters.diffLevels = 0;
+    this->counters.truncations = 0;
+    this->counters.truncatedLevels = 0;
+    this->counters.snapshots = 0;
+    this->counters.updateIdGaps = 0;
+    this->diffApplyTimes.clear();
+    this->diffBatchLevels.clear();
+    this->snapshotApplyTimes.clear();
+    this->exchangeLags.clear();
+}
+
+const OrderBookCounters &OrderBookStats::getCounters() const {
+    return this->counters;
+}
+
+const LatencyHistogram &OrderBookStats::getDiffApplyTimes() const {
+    return this->diffApplyTimes;
+}
+
+const LatencyHistogram &OrderBookStats::getDiffBatchLevels() const {
+    return this->diffBatchLevels;
+}
+
+const LatencyHistogram &OrderBookStats::getSnapshotApplyTimes() const {
+    return this->snapshotApplyTimes;
+}
+
+const LatencyHistogram &OrderBookStats::getExchangeLags() const {
+    return this->exchangeLags;
+}
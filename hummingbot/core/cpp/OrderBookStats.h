@@ -0,0 +1,50 @@
+#ifndef _ORDER_BOOK_STATS_H
+#define _ORDER_BOOK_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LatencyHistogram.h"
+#include "OrderBookSide.h"
+
+// Plain counters of an order book, laid out for the Cython side.
+struct OrderBookCounters {
+    uint64_t diffBatches;
+    uint64_t diffLevels;
+    uint64_t truncations;
+    uint64_t truncatedLevels;
+    uint64_t snapshots;
+    uint64_t updateIdGaps;
+};
+
+// Instrumentation of one order book: counters, and histograms of how long diff batches and snapshots take to apply,
+// how many levels each diff batch carries and how far behind the exchange the diffs arrive. Times are in nanoseconds.
+//
+// The stats are updated by whoever applies to the book - the owning thread or a worker pool - while holding the book,
+// and read under the same lock. Inserted, updated and erased level counts are kept by the book sides themselves.
+class OrderBookStats {
+    OrderBookCounters counters;
+    LatencyHistogram diffApplyTimes;
+    LatencyHistogram diffBatchLevels;
+    LatencyHistogram snapshotApplyTimes;
+    LatencyHistogram exchangeLags;
+
+    public:
+        OrderBookStats();
+
+        static int64_t getMonotonicNanoseconds();
+        static uint64_t getTruncatedLevelCount(const OrderBookSide &bidBook, const OrderBookSide &askBook);
+
+        void recordDiffBatch(int64_t elapsedNanoseconds, size_t numLevels, uint64_t truncatedLevels);
+        void recordSnapshot(int64_t elapsedNanoseconds);
+        void recordUpdateIdGap();
+        void recordExchangeLag(int64_t lagNanoseconds);
+        void clear();
+
+        const OrderBookCounters &getCounters() const;
+        const LatencyHistogram &getDiffApplyTimes() const;
+        const LatencyHistogram &getDiffBatchLevels() const;
+        const LatencyHistogram &getSnapshotApplyTimes() const;
+        const LatencyHistogram &getExchangeLags() const;
+};
+
+#endif
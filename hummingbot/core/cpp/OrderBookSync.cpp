@@ -0,0 +1,81 @@
+#include "OrderBookSync.h"
+#include <cmath>
+#include <thread>
+
+OrderBookSync::OrderBookSync() {
+    this->sequence.store(0);
+    this->bidPrice.store(NAN);
+    this->bidAmount.store(0);
+    this->askPrice.store(NAN);
+    this->askAmount.store(0);
+    this->updateId.store(0);
+    this->bookVersion.store(0);
+    this->lastDiffUid.store(0);
+}
+
+void OrderBookSync::lock() {
+    this->mutex.lock();
+}
+
+void OrderBookSync::unlock() {
+    this->mutex.unlock();
+}
+
+// Publishes the best levels. Must be called with the mutex held, which keeps publishes from different threads apart.
+// The best prices are passed in rather than read off the sides, so an emptied side keeps its last known price like
+// OrderBook.c_get_price() does. Its amount reads as 0.
+void OrderBookSync::publishTopOfBook(const OrderBookSide &bidBook,
+                                     const OrderBookSide &askBook,
+                                     double bestBid,
+                                     double bestAsk,
+                                     int64_t updateId) {
+    uint64_t sequence = this->sequence.load(std::memory_order_relaxed);
+    this->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->bidPrice.store(bestBid, std::memory_order_relaxed);
+    this->bidAmount.store(bidBook.empty() ? 0 : bidBook.best().getAmount(), std::memory_order_relaxed);
+    this->askPrice.store(bestAsk, std::memory_order_relaxed);
+    this->askAmount.store(askBook.empty() ? 0 : askBook.best().getAmount(), std::memory_order_relaxed);
+    this->updateId.store(updateId, std::memory_order_relaxed);
+    this->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Reads the last published best levels without taking the mutex.
+TopOfBook OrderBookSync::readTopOfBook() const {
+    TopOfBook result;
+    while (true) {
+        uint64_t sequence = this->sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        result.bidPrice = this->bidPrice.load(std::memory_order_relaxed);
+        result.bidAmount = this->bidAmount.load(std::memory_order_relaxed);
+        result.askPrice = this->askPrice.load(std::memory_order_relaxed);
+        result.askAmount = this->askAmount.load(std::memory_order_relaxed);
+        result.updateId = this->updateId.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (this->sequence.load(std::memory_order_relaxed) == sequence) {
+            result.version = sequence / 2;
+            return result;
+        }
+    }
+}
+
+uint64_t OrderBookSync::getVersion() const {
+    return this->sequence.load(std::memory_order_acquire) / 2;
+}
+
+// Stores copies of the book's update counter and last diff update ID. Must be called with the mutex held.
+void OrderBookSync::storeCounters(uint64_t bookVersion, int64_t lastDiffUid) {
+    this->bookVersion.store(bookVersion, std::memory_order_release);
+    this->lastDiffUid.store(lastDiffUid, std::memory_order_release);
+}
+
+uint64_t OrderBookSync::getBookVersion() const {
+    return this->bookVersion.load(std::memory_order_acquire);
+}
+
+int64_t OrderBookSync::getLastDiffUid() const {
+    return this->lastDiffUid.load(std::memory_order_acquire);
+}
@@ -0,0 +1,59 @@
+#ifndef _ORDER_BOOK_SYNC_H
+#define _ORDER_BOOK_SYNC_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include "OrderBookSide.h"
+
+// A consistent copy of the best levels of an order book, as of one update.
+struct TopOfBook {
+    double bidPrice;
+    double bidAmount;
+    double askPrice;
+    double askAmount;
+    int64_t updateId;
+    uint64_t version;
+};
+
+// Synchronises an order book that is maintained on one thread and read on others.
+//
+// Whoever mutates the book holds the mutex for the duration, and so does anyone reading more than the best levels.
+// The best levels are also published through a seqlock after every update, so readers that only need the top of the
+// book never block the writer: they retry in the rare case that their read overlapped a publish. The version counts
+// publishes, so readers can also tell whether the book has changed since they last looked.
+//
+// The book's own update counter and last diff update ID are plain fields, written with the mutex held. Whoever writes
+// them stores copies here before unlocking, so readers that do not take the mutex read them from here.
+class OrderBookSync {
+    std::mutex mutex;
+    std::atomic<uint64_t> sequence;
+    std::atomic<double> bidPrice;
+    std::atomic<double> bidAmount;
+    std::atomic<double> askPrice;
+    std::atomic<double> askAmount;
+    std::atomic<int64_t> updateId;
+    std::atomic<uint64_t> bookVersion;
+    std::atomic<int64_t> lastDiffUid;
+
+    public:
+        OrderBookSync();
+        OrderBookSync(const OrderBookSync &other) = delete;
+        OrderBookSync &operator=(const OrderBookSync &other) = delete;
+
+        void lock();
+        void unlock();
+
+        void publishTopOfBook(const OrderBookSide &bidBook,
+                              const OrderBookSide &askBook,
+                              double bestBid,
+                              double bestAsk,
+                              int64_t updateId);
+        TopOfBook readTopOfBook() const;
+        uint64_t getVersion() const;
+        void storeCounters(uint64_t bookVersion, int64_t lastDiffUid);
+        uint64_t getBookVersion() const;
+        int64_t getLastDiffUid() const;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "OrderBookWorkerPool.h"
+#include <algorithm>
+#include <chrono>
+
+OrderBookWorkerPool::OrderBookWorkerPool() : OrderBookWorkerPool(std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+OrderBookWorkerPool::OrderBookWorkerPool(size_t numThreads) {
+    this->running.store(false);
+    this->appliedCount.store(0);
+    this->numThreads = std::max((size_t)1, numThreads);
+    this->numWorkers = 0;
+    this->idleSleepMicroseconds = 100;
+}
+
+OrderBookWorkerPool::~OrderBookWorkerPool() {
+    this->stop();
+}
+
+bool OrderBookWorkerPool::addBook(const MaintainedOrderBook &book) {
+    if (this->running.load()) {
+        return false;
+    }
+    std::unique_ptr<Book> entry(new Book());
+    entry->parts = book;
+    this->books.push_back(std::move(entry));
+    return true;
+}
+
+bool OrderBookWorkerPool::removeBook(const OrderBookSync *sync) {
+    if (this->running.load()) {
+        return false;
+    }
+    for (size_t i = 0; i < this->books.size(); ++i) {
+        if (this->books[i]->parts.sync == sync) {
+            this->books.erase(this->books.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t OrderBookWorkerPool::getBookCount() const {
+    return this->books.size();
+}
+
+void OrderBookWorkerPool::setIdleSleepMicroseconds(int64_t microseconds) {
+    this->idleSleepMicroseconds = std::max((int64_t)0, microseconds);
+}
+
+bool OrderBookWorkerPool::start() {
+    if (this->running.exchange(true)) {
+        return false;
+    }
+    this->numWorkers = std::min(this->numThreads, std::max((size_t)1, this->books.size()));
+    for (size_t i = 0; i < this->numWorkers; ++i) {
+        this->threads.push_back(std::thread(&OrderBookWorkerPool::runWorker, this, i));
+    }
+    return true;
+}
+
+// Stops the workers once they have finished their current batch. Diffs still pending in the rings are left there.
+void OrderBookWorkerPool::stop() {
+    this->running.store(false);
+    for (size_t i = 0; i < this->threads.size(); ++i) {
+        this->threads[i].join();
+    }
+    this->threads.clear();
+}
+
+bool OrderBookWorkerPool::isRunning() const {
+    return this->running.load();
+}
+
+size_t OrderBookWorkerPool::getNumThreads() const {
+    return this->numThreads;
+}
+
+// Returns the number of diff rows applied by the workers so far.
+uint64_t OrderBookWorkerPool::getAppliedCount() const {
+    return this->appliedCount.load(std::memory_order_relaxed);
+}
+
+// Drains the diff ring of a book and applies everything pending as one batch, under the sync mutex of the book.
+// Returns the number of rows applied. Must only be called from the consumer side of the ring.
+size_t OrderBookWorkerPool::applyPending(MaintainedOrderBook &book,
+                                         std::vector<double> &bidRows,
+                                         std::vector<double> &askRows) {
+    if (book.diffRing->empty()) {
+        return 0;
+    }
+    bidRows.clear();
+    askRows.clear();
+    size_t numRecords = book.diffRing->drain(bidRows, askRows, 0);
+    if (numRecords == 0) {
+        return 0;
+    }
+    book.sync->lock();
+    int64_t start = OrderBookStats::getMonotonicNanoseconds();
+    uint64_t truncatedLevels = OrderBookStats::getTruncatedLevelCount(*book.bidBook, *book.askBook);
+    int64_t lastUpdateId = applyDiffs(*book.bidBook, *book.askBook,
+                                      bidRows.data(), bidRows.size() / 3, askRows.data(), askRows.size() / 3,
+                                      book.dex ? 1 : 0, *book.bestBid, *book.bestAsk);
+    if (book.stats != NULL) {
+        book.stats->recordDiffBatch(OrderBookStats::getMonotonicNanoseconds() - start, numRecords,
+                                    OrderBookStats::getTruncatedLevelCount(*book.bidBook, *book.askBook) -
+                                    truncatedLevels);
+    }
+    if (book.features != NULL) {
+        book.features->update(*book.bidBook, *book.askBook);
+    }
+    *book.lastDiffUid = lastUpdateId;
+    if (book.version != NULL) {
+        (*book.version)++;
+    }
+    book.sync->storeCounters(book.version != NULL ? *book.version : 0, lastUpdateId);
+    book.sync->publishTopOfBook(*book.bidBook, *book.askBook, *book.bestBid, *book.bestAsk, lastUpdateId);
+    book.sync->unlock();
+    return numRecords;
+}
+
+// Books are dealt out to the workers round robin, by index.
+void OrderBookWorkerPool::runWorker(size_t workerIndex) {
+    int idlePasses = 0;
+    while (this->running.load(std::memory_order_acquire)) {
+        size_t applied = 0;
+        for (size_t i = workerIndex; i < this->books.size(); i += this->numWorkers) {
+            Book &book = *this->books[i];
+            applied += applyPending(book.parts, book.bidRows, book.askRows);
+        }
+        if (applied > 0) {
+            this->appliedCount.fetch_add(applied, std::memory_order_relaxed);
+            idlePasses = 0;
+        } else if (++idlePasses < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(this->idleSleepMicroseconds));
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef _ORDER_BOOK_WORKER_POOL_H
+#define _ORDER_BOOK_WORKER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "DiffRingBuffer.h"
+#include "OrderBookFeatureEngine.h"
+#include "OrderBookSide.h"
+#include "OrderBookStats.h"
+#include "OrderBookSync.h"
+
+// The parts of an order book a worker pool needs to maintain it. The pool does not own any of them.
+struct MaintainedOrderBook {
+    OrderBookSide *bidBook;
+    OrderBookSide *askBook;
+    DiffRingBuffer *diffRing;
+    OrderBookSync *sync;
+    double *bestBid;
+    double *bestAsk;
+    int64_t *lastDiffUid;
+    uint64_t *version;
+    OrderBookStats *stats;
+    OrderBookFeatureEngine *features;
+    bool dex;
+};
+
+// A pool of native threads that maintains many order books at once, without the GIL.
+//
+// Each book is assigned to one worker, which drains the diff ring of the book and applies the pending diffs in one
+// batch while holding the sync mutex of the book, then publishes the new top of book. Books can only be added or
+// removed while the pool is stopped. Workers that find nothing to do back off to short sleeps.
+class OrderBookWorkerPool {
+    struct Book {
+        MaintainedOrderBook parts;
+        std::vector<double> bidRows;
+        std::vector<double> askRows;
+    };
+
+    std::vector<std::unique_ptr<Book>> books;
+    std::vector<std::thread> threads;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> appliedCount;
+    size_t numThreads;
+    size_t numWorkers;
+    int64_t idleSleepMicroseconds;
+
+    void runWorker(size_t workerIndex);
+
+    public:
+        OrderBookWorkerPool();
+        OrderBookWorkerPool(size_t numThreads);
+        OrderBookWorkerPool(const OrderBookWorkerPool &other) = delete;
+        OrderBookWorkerPool &operator=(const OrderBookWorkerPool &other) = delete;
+        ~OrderBookWorkerPool();
+
+        bool addBook(const MaintainedOrderBook &book);
+        bool removeBook(const OrderBookSync *sync);
+        size_t getBookCount() const;
+
+        void setIdleSleepMicroseconds(int64_t microseconds);
+        bool start();
+        void stop();
+        bool isRunning() const;
+        size_t getNumThreads() const;
+        uint64_t getAppliedCount() const;
+
+        static size_t applyPending(MaintainedOrderBook &book,
+                                   std::vector<double> &bidRows,
+                                   std::vector<double> &askRows);
+};
+
+#endif
@@ -2,18 +2,17 @@
 #include <iostream>
 
 OrderExpirationEntry::OrderExpirationEntry() {
-    this->tradingPair = "";
-    this->orderId = "";
+    this->tradingPair = 0;
     this->timestamp = 0;
     this->expiration_timestamp = 0;
 }
 
-OrderExpirationEntry::OrderExpirationEntry(std::string tradingPair,
-                                           std::string orderId,
+OrderExpirationEntry::OrderExpirationEntry(const std::string &tradingPair,
+                                           const std::string &orderId,
                                            double timestamp,
                                            double expiration_timestamp) {
-    this->tradingPair = tradingPair;
-    this->orderId = orderId;
+    this->tradingPair = internSymbol(tradingPair);
+    this->orderId = Symbol(orderId);
     this->timestamp = timestamp;
     this->expiration_timestamp = expiration_timestamp;
 }
@@ -25,6 +24,13 @@ OrderExpirationEntry::OrderExpirationEntry(const OrderExpirationEntry &other) {
     this->expiration_timestamp = other.expiration_timestamp;
 }
 
+OrderExpirationEntry::OrderExpirationEntry(OrderExpirationEntry &&other) {
+    this->tradingPair = other.tradingPair;
+    this->orderId = std::move(other.orderId);
+    this->timestamp = other.timestamp;
+    this->expiration_timestamp = other.expiration_timestamp;
+}
+
 OrderExpirationEntry &OrderExpirationEntry::operator=(const OrderExpirationEntry &other) {
     this->tradingPair = other.tradingPair;
     this->orderId = other.orderId;
@@ -33,6 +39,14 @@ OrderExpirationEntry &OrderExpirationEntry::operator=(const OrderExpirationEntry
     return *this;
 }
 
+OrderExpirationEntry &OrderExpirationEntry::operator=(OrderExpirationEntry &&other) {
+    this->tradingPair = other.tradingPair;
+    this->orderId = std::move(other.orderId);
+    this->timestamp = other.timestamp;
+    this->expiration_timestamp = other.expiration_timestamp;
+    return *this;
+}
+
 bool operator<(OrderExpirationEntry const &a, OrderExpirationEntry const &b) {
     if(a.expiration_timestamp == b.expiration_timestamp){
         return a.orderId < b.orderId;
@@ -42,12 +56,16 @@ bool operator<(OrderExpirationEntry const &a, OrderExpirationEntry const &b) {
     }
 }
 
-std::string OrderExpirationEntry::getTradingPair() const {
-    return this->tradingPair;
+const std::string &OrderExpirationEntry::getTradingPair() const {
+    return getSymbolName(this->tradingPair);
 }
 
-std::string OrderExpirationEntry::getClientOrderID() const {
-    return this->orderId;
+const std::string &OrderExpirationEntry::getClientOrderID() const {
+    return this->orderId.getName();
+}
+
+SymbolHandle OrderExpirationEntry::getClientOrderHandle() const {
+    return this->orderId.getHandle();
 }
 
 double OrderExpirationEntry::getTimestamp() const {
@@ -57,3 +75,11 @@ double OrderExpirationEntry::getTimestamp() const {
 double OrderExpirationEntry::getExpirationTimestamp() const {
     return this->expiration_timestamp;
 }
+
+std::pair<OrderExpirationSet::iterator, bool> emplaceOrderExpirationEntry(OrderExpirationSet &entries,
+                                                                          const std::string &tradingPair,
+                                                                          const std::string &orderId,
+                                                                          double timestamp,
+                                                                          double expiration_timestamp) {
+    return entries.emplace(tradingPair, orderId, timestamp, expiration_timestamp);
+}
@@ -4,24 +4,41 @@
 #include <string>
 #include <set>
 #include <iterator>
+#include <utility>
 #include <Python.h>
+#include "SymbolTable.h"
 
 class OrderExpirationEntry {
-    std::string tradingPair;
-    std::string orderId;
+    SymbolHandle tradingPair;
+    Symbol orderId;
     double timestamp;
     double expiration_timestamp;
 
     public:
         OrderExpirationEntry();
-        OrderExpirationEntry(std::string tradingPair, std::string orderId, double timestamp, double expiration_timestamp);
+        OrderExpirationEntry(const std::string &tradingPair,
+                             const std::string &orderId,
+                             double timestamp,
+                             double expiration_timestamp);
         OrderExpirationEntry(const OrderExpirationEntry &other);
+        OrderExpirationEntry(OrderExpirationEntry &&other);
         OrderExpirationEntry &operator=(const OrderExpirationEntry &other);
+        OrderExpirationEntry &operator=(OrderExpirationEntry &&other);
         friend bool operator<(OrderExpirationEntry const &a, OrderExpirationEntry const &b);
-        std::string getTradingPair() const;
-        std::string getClientOrderID() const;
+        const std::string &getTradingPair() const;
+        const std::string &getClientOrderID() const;
+        SymbolHandle getClientOrderHandle() const;
         double getTimestamp() const;
         double getExpirationTimestamp() const;
 };
 
+typedef std::set<OrderExpirationEntry> OrderExpirationSet;
+
+// Builds an expiration entry directly inside the set, without copying a temporary entry into it.
+std::pair<OrderExpirationSet::iterator, bool> emplaceOrderExpirationEntry(OrderExpirationSet &entries,
+                                                                          const std::string &tradingPair,
+                                                                          const std::string &orderId,
+                                                                          double timestamp,
+                                                                          double expiration_timestamp);
+
 #endif
@@ -0,0 +1,167 @@
+#include "OrderExpirationWheel.h"
+#include <algorithm>
+#include <cmath>
+
+OrderExpirationWheel::OrderExpirationWheel() : OrderExpirationWheel(1.0, 1024) {
+}
+
+OrderExpirationWheel::OrderExpirationWheel(double tickSize, size_t numSlots) {
+    size_t slotCount = 1;
+    while (slotCount < numSlots) {
+        slotCount <<= 1;
+    }
+    this->slots.resize(slotCount);
+    this->tickSize = tickSize > 0 ? tickSize : 1.0;
+    this->slotMask = slotCount - 1;
+    this->currentTick = 0;
+    this->started = false;
+}
+
+// Ticks are clamped well inside the int64_t range, so converting far off timestamps is defined and the difference of two
+// ticks cannot overflow.
+int64_t OrderExpirationWheel::getTick(double timestamp) const {
+    static const double MAX_TICK = 2305843009213693952.0;
+    double tick = std::floor(timestamp / this->tickSize);
+    return (int64_t)std::max(-MAX_TICK, std::min(tick, MAX_TICK));
+}
+
+void OrderExpirationWheel::removeAt(const Location &location) {
+    std::vector<OrderExpirationEntry> &slot = this->slots[location.slot];
+    if (location.index + 1 != slot.size()) {
+        slot[location.index] = std::move(slot.back());
+        this->locations[slot[location.index].getClientOrderHandle()].index = location.index;
+    }
+    slot.pop_back();
+}
+
+bool OrderExpirationWheel::insert(const std::string &tradingPair,
+                                  const std::string &orderId,
+                                  double timestamp,
+                                  double expirationTimestamp) {
+    // Orders without a finite expiration never expire, so they are not tracked.
+    if (!std::isfinite(expirationTimestamp)) {
+        return false;
+    }
+    OrderExpirationEntry entry(tradingPair, orderId, timestamp, expirationTimestamp);
+    SymbolHandle orderHandle = entry.getClientOrderHandle();
+    this->cancel(orderHandle);
+
+    // Entries that are already due go into the current slot, which the next popExpired() call always visits.
+    int64_t tick = this->getTick(expirationTimestamp);
+    if (this->started && tick < this->currentTick) {
+        tick = this->currentTick;
+    }
+    Location location;
+    location.slot = (size_t)tick & this->slotMask;
+    location.index = this->slots[location.slot].size();
+    this->slots[location.slot].push_back(std::move(entry));
+    this->locations[orderHandle] = location;
+    return true;
+}
+
+bool OrderExpirationWheel::cancel(SymbolHandle orderHandle) {
+    LocationMap::iterator it = this->locations.find(orderHandle);
+    if (it == this->locations.end()) {
+        return false;
+    }
+    Location location = it->second;
+    this->locations.erase(it);
+    this->removeAt(location);
+    return true;
+}
+
+bool OrderExpirationWheel::contains(SymbolHandle orderHandle) const {
+    return this->locations.find(orderHandle) != this->locations.end();
+}
+
+void OrderExpirationWheel::popExpiredFromSlot(size_t slot, double now, std::vector<OrderExpirationEntry> &expired) {
+    std::vector<OrderExpirationEntry> &entries = this->slots[slot];
+    size_t index = 0;
+    while (index < entries.size()) {
+        if (entries[index].getExpirationTimestamp() > now) {
+            index++;
+            continue;
+        }
+        SymbolHandle orderHandle = entries[index].getClientOrderHandle();
+        expired.push_back(std::move(entries[index]));
+        this->locations.erase(orderHandle);
+        Location location;
+        location.slot = slot;
+        location.index = index;
+        this->removeAt(location);
+    }
+}
+
+size_t OrderExpirationWheel::popExpired(double now, std::vector<OrderExpirationEntry> &expired) {
+    if (std::isnan(now)) {
+        return 0;
+    }
+    size_t firstExpired = expired.size();
+    int64_t nowTick = this->getTick(now);
+
+    if (!this->locations.empty()) {
+        if (!this->started || nowTick - this->currentTick >= (int64_t)this->slots.size()) {
+            for (size_t slot = 0; slot < this->slots.size(); slot++) {
+                this->popExpiredFromSlot(slot, now, expired);
+            }
+        } else {
+            for (int64_t tick = this->currentTick; tick <= nowTick; tick++) {
+                this->popExpiredFromSlot((size_t)tick & this->slotMask, now, expired);
+            }
+        }
+    }
+    if (!this->started || nowTick > this->currentTick) {
+        this->currentTick = nowTick;
+    }
+    this->started = true;
+
+    std::sort(expired.begin() + firstExpired, expired.end());
+    return expired.size() - firstExpired;
+}
+
+// Returns the earliest expiration timestamp in the wheel, or NaN if the wheel is empty.
+double OrderExpirationWheel::getNextExpirationTimestamp() const {
+    if (this->locations.empty()) {
+        return NAN;
+    }
+    double nextExpiration = HUGE_VAL;
+    if (this->started) {
+        // Every entry is due in the current tick or later, apart from overdue ones which sit in the current slot. The
+        // first tick with an entry due in it therefore holds the earliest one.
+        for (size_t offset = 0; offset < this->slots.size(); offset++) {
+            int64_t tick = this->currentTick + (int64_t)offset;
+            const std::vector<OrderExpirationEntry> &slot = this->slots[(size_t)tick & this->slotMask];
+            for (size_t i = 0; i < slot.size(); i++) {
+                double expirationTimestamp = slot[i].getExpirationTimestamp();
+                if (this->getTick(expirationTimestamp) <= tick) {
+                    nextExpiration = std::min(nextExpiration, expirationTimestamp);
+                }
+            }
+            if (nextExpiration != HUGE_VAL) {
+                return nextExpiration;
+            }
+        }
+    }
+    // Everything is more than one turn of the wheel away, or the wheel has not started turning yet.
+    for (size_t slot = 0; slot < this->slots.size(); slot++) {
+        for (size_t i = 0; i < this->slots[slot].size(); i++) {
+            nextExpiration = std::min(nextExpiration, this->slots[slot][i].getExpirationTimestamp());
+        }
+    }
+    return nextExpiration;
+}
+
+void OrderExpirationWheel::clear() {
+    for (size_t slot = 0; slot < this->slots.size(); slot++) {
+        this->slots[slot].clear();
+    }
+    this->locations.clear();
+}
+
+size_t OrderExpirationWheel::size() const {
+    return this->locations.size();
+}
+
+bool OrderExpirationWheel::empty() const {
+    return this->locations.empty();
+}
@@ -0,0 +1,58 @@
+#ifndef _ORDER_EXPIRATION_WHEEL_H
+#define _ORDER_EXPIRATION_WHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "OrderExpirationEntry.h"
+#include "PoolAllocator.h"
+#include "SymbolTable.h"
+
+// Tracks order expirations in a hashed timer wheel. Orders with a NaN or infinite expiration timestamp never expire, and
+// insert() leaves them out.
+//
+// Expiration timestamps are cut into ticks of tickSize seconds, and each tick maps to one of a fixed number of slots.
+// Entries further out than one turn of the wheel share slots with nearer ones and simply stay put until their
+// timestamp has passed. Inserting and cancelling an entry are O(1), cancels are looked up by client order handle.
+// popExpired() only visits the slots for the ticks that have elapsed since the previous call, and
+// getNextExpirationTimestamp() walks forward from the current tick to the first slot with an entry due in that tick.
+class OrderExpirationWheel {
+    struct Location {
+        size_t slot;
+        size_t index;
+    };
+
+    typedef std::unordered_map<SymbolHandle, Location, std::hash<SymbolHandle>, std::equal_to<SymbolHandle>,
+                               PoolAllocator<std::pair<const SymbolHandle, Location>>> LocationMap;
+
+    std::vector<std::vector<OrderExpirationEntry>> slots;
+    LocationMap locations;
+    double tickSize;
+    size_t slotMask;
+    int64_t currentTick;
+    bool started;
+
+    int64_t getTick(double timestamp) const;
+    void removeAt(const Location &location);
+    void popExpiredFromSlot(size_t slot, double now, std::vector<OrderExpirationEntry> &expired);
+
+    public:
+        OrderExpirationWheel();
+        OrderExpirationWheel(double tickSize, size_t numSlots);
+
+        bool insert(const std::string &tradingPair,
+                    const std::string &orderId,
+                    double timestamp,
+                    double expirationTimestamp);
+        bool cancel(SymbolHandle orderHandle);
+        bool contains(SymbolHandle orderHandle) const;
+        size_t popExpired(double now, std::vector<OrderExpirationEntry> &expired);
+        double getNextExpirationTimestamp() const;
+        void clear();
+        size_t size() const;
+        bool empty() const;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "PoolAllocator.h"
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+
+const size_t FIRST_CHUNK_BLOCKS = 16;
+const size_t MAX_CHUNK_BLOCKS = 4096;
+
+}
+
+// Blocks are big enough to hold a free list link, and rounded up so every block stays aligned for any node type.
+size_t NodePool::getBlockSizeFor(size_t size) {
+    size_t alignment = alignof(std::max_align_t);
+    size = std::max(size, sizeof(FreeBlock));
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+NodePool::NodePool() {
+    this->freeList = NULL;
+    this->blockSize = 0;
+    this->nextChunkBlocks = FIRST_CHUNK_BLOCKS;
+    this->liveBlocks = 0;
+}
+
+NodePool::~NodePool() {
+    for (size_t i = 0; i < this->chunks.size(); i++) {
+        ::operator delete(this->chunks[i]);
+    }
+}
+
+void NodePool::addChunk() {
+    char *chunk = static_cast<char *>(::operator new(this->blockSize * this->nextChunkBlocks));
+    this->chunks.push_back(chunk);
+    // Thread the new blocks onto the free list, so they are handed out from the start of the chunk.
+    for (size_t i = this->nextChunkBlocks; i > 0; i--) {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * this->blockSize);
+        block->next = this->freeList;
+        this->freeList = block;
+    }
+    this->nextChunkBlocks = std::min(this->nextChunkBlocks * 2, MAX_CHUNK_BLOCKS);
+}
+
+// Whether blocks of the given size come from this pool. The first size asked for becomes the pool's block size.
+bool NodePool::canAllocate(size_t size) const {
+    return this->blockSize == 0 || this->blockSize == getBlockSizeFor(size);
+}
+
+void *NodePool::allocate(size_t size) {
+    if (this->blockSize == 0) {
+        this->blockSize = getBlockSizeFor(size);
+    }
+    if (this->freeList == NULL) {
+        this->addChunk();
+    }
+    FreeBlock *block = this->freeList;
+    this->freeList = block->next;
+    this->liveBlocks++;
+    return block;
+}
+
+void NodePool::deallocate(void *block) {
+    FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+    freeBlock->next = this->freeList;
+    this->freeList = freeBlock;
+    this->liveBlocks--;
+}
+
+size_t NodePool::getBlockSize() const {
+    return this->blockSize;
+}
+
+size_t NodePool::getChunkCount() const {
+    return this->chunks.size();
+}
+
+size_t NodePool::getLiveBlockCount() const {
+    return this->liveBlocks;
+}
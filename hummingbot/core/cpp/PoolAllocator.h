@@ -0,0 +1,105 @@
+#ifndef _POOL_ALLOCATOR_H
+#define _POOL_ALLOCATOR_H
+
+#include <stddef.h>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// A pool of fixed size blocks, carved out of chunks that grow geometrically. Freed blocks go on a free list and are
+// handed out again before any new chunk is allocated, and chunks are only given back when the pool is destroyed. So
+// a container that keeps inserting and erasing nodes settles on its high water mark and stops calling the global
+// allocator, and its nodes sit together in a few chunks instead of being spread over the heap.
+//
+// The block size is fixed by the first allocation. Pools are not thread safe, which is fine for the containers that use
+// them, as those are not either.
+class NodePool {
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    std::vector<void *> chunks;
+    FreeBlock *freeList;
+    size_t blockSize;
+    size_t nextChunkBlocks;
+    size_t liveBlocks;
+
+    static size_t getBlockSizeFor(size_t size);
+    void addChunk();
+
+    public:
+        NodePool();
+        ~NodePool();
+
+        void *allocate(size_t size);
+        void deallocate(void *block);
+        bool canAllocate(size_t size) const;
+
+        size_t getBlockSize() const;
+        size_t getChunkCount() const;
+        size_t getLiveBlockCount() const;
+};
+
+// A node allocator for node based containers, such as std::set and std::unordered_map, backed by a NodePool.
+//
+// Every container default constructs its own allocator, and so gets a pool of its own. Copies and rebinds of an
+// allocator share its pool. Single node allocations are served from the pool, anything else - such as the bucket
+// arrays of hash maps - goes to the global allocator.
+template <typename T>
+class PoolAllocator {
+    template <typename U> friend class PoolAllocator;
+
+    std::shared_ptr<NodePool> pool;
+
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        template <typename U>
+        struct rebind {
+            typedef PoolAllocator<U> other;
+        };
+
+        PoolAllocator() : pool(std::make_shared<NodePool>()) {
+        }
+
+        PoolAllocator(const PoolAllocator &other) : pool(other.pool) {
+        }
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {
+        }
+
+        T *allocate(size_t n) {
+            if (n == 1 && this->pool->canAllocate(sizeof(T))) {
+                return static_cast<T *>(this->pool->allocate(sizeof(T)));
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t n) {
+            if (n == 1 && this->pool->canAllocate(sizeof(T))) {
+                this->pool->deallocate(p);
+            } else {
+                ::operator delete(p);
+            }
+        }
+
+        const std::shared_ptr<NodePool> &getPool() const {
+            return this->pool;
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U> &other) const {
+            return this->pool == other.pool;
+        }
+
+        template <typename U>
+        bool operator!=(const PoolAllocator<U> &other) const {
+            return this->pool != other.pool;
+        }
+};
+
+#endif
@@ -15,13 +15,28 @@ PyRef::PyRef(const PyRef &other) {
     Py_XINCREF(this->obj);
 }
 
+PyRef::PyRef(PyRef &&other) {
+    this->obj = other.obj;
+    other.obj = NULL;
+}
+
 PyRef::~PyRef() {
     Py_XDECREF(this->obj);
 }
 
 PyRef &PyRef::operator=(const PyRef &other) {
+    Py_XINCREF(other.obj);
+    Py_XDECREF(this->obj);
     this->obj = other.obj;
-    Py_XINCREF(this->obj);
+    return *this;
+}
+
+PyRef &PyRef::operator=(PyRef &&other) {
+    if (this != &other) {
+        Py_XDECREF(this->obj);
+        this->obj = other.obj;
+        other.obj = NULL;
+    }
     return *this;
 }
 
@@ -12,7 +12,9 @@ class PyRef {
         PyRef();
         PyRef(PyObject *obj);
         PyRef(const PyRef &other);
+        PyRef(PyRef &&other);
         PyRef &operator=(const PyRef &other);
+        PyRef &operator=(PyRef &&other);
         bool operator==(const PyRef &other) const;
         ~PyRef();
         PyObject *get() const;
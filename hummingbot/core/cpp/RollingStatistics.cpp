@@ -0,0 +1,277 @@
+#include "RollingStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+double sum(const double *values, size_t count) {
+    double sums[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sums[0] += values[i];
+        sums[1] += values[i + 1];
+        sums[2] += values[i + 2];
+        sums[3] += values[i + 3];
+    }
+    for (; i < count; i++) {
+        sums[0] += values[i];
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+double sumSquaredDeviations(const double *values, size_t count, double mean) {
+    double sums[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        double d0 = values[i] - mean;
+        double d1 = values[i + 1] - mean;
+        double d2 = values[i + 2] - mean;
+        double d3 = values[i + 3] - mean;
+        sums[0] += d0 * d0;
+        sums[1] += d1 * d1;
+        sums[2] += d2 * d2;
+        sums[3] += d3 * d3;
+    }
+    for (; i < count; i++) {
+        double d = values[i] - mean;
+        sums[0] += d * d;
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// Sum of (values[i + 1] - values[i]) ^ 2 within one run.
+double sumSquaredDiffsInRun(const double *values, size_t count) {
+    if (count < 2) {
+        return 0;
+    }
+    double sums[4] = {0, 0, 0, 0};
+    size_t numDiffs = count - 1;
+    size_t i = 0;
+    for (; i + 4 <= numDiffs; i += 4) {
+        double d0 = values[i + 1] - values[i];
+        double d1 = values[i + 2] - values[i + 1];
+        double d2 = values[i + 3] - values[i + 2];
+        double d3 = values[i + 4] - values[i + 3];
+        sums[0] += d0 * d0;
+        sums[1] += d1 * d1;
+        sums[2] += d2 * d2;
+        sums[3] += d3 * d3;
+    }
+    for (; i < numDiffs; i++) {
+        double d = values[i + 1] - values[i];
+        sums[0] += d * d;
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// Sum of (log(values[i + 1] / values[i]) - mean) ^ 2 within one run.
+double sumSquaredLogReturnDeviationsInRun(const double *values, size_t count, double mean) {
+    double total = 0;
+    for (size_t i = 0; i + 1 < count; i++) {
+        double d = std::log(values[i + 1] / values[i]) - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+}
+
+RollingStatistics::RollingStatistics() : RollingStatistics(0) {
+}
+
+RollingStatistics::RollingStatistics(size_t capacity) {
+    this->values.resize(capacity);
+    this->clear();
+}
+
+// The oldest run of the window starts at the oldest value, and ends at the newest value or at the end of the storage.
+size_t RollingStatistics::getFirstRun(const double *&run) const {
+    size_t start = this->count < this->values.size() ? 0 : this->head;
+    run = this->values.data() + start;
+    return std::min(this->count, this->values.size() - start);
+}
+
+// The newer run wraps around to the start of the storage, if the window does.
+size_t RollingStatistics::getSecondRun(const double *&run) const {
+    const double *firstRun;
+    run = this->values.data();
+    return this->count - this->getFirstRun(firstRun);
+}
+
+void RollingStatistics::recompute() {
+    const double *firstRun;
+    const double *secondRun;
+    size_t firstCount = this->getFirstRun(firstRun);
+    size_t secondCount = this->getSecondRun(secondRun);
+
+    this->updatesSinceRecompute = 0;
+    if (this->count == 0) {
+        this->mean = 0;
+        this->m2 = 0;
+        this->sumSquaredDiffs = 0;
+        return;
+    }
+    this->mean = (sum(firstRun, firstCount) + sum(secondRun, secondCount)) / this->count;
+    this->m2 = sumSquaredDeviations(firstRun, firstCount, this->mean) +
+               sumSquaredDeviations(secondRun, secondCount, this->mean);
+    this->sumSquaredDiffs = sumSquaredDiffsInRun(firstRun, firstCount) + sumSquaredDiffsInRun(secondRun, secondCount);
+    if (secondCount > 0) {
+        double d = secondRun[0] - firstRun[firstCount - 1];
+        this->sumSquaredDiffs += d * d;
+    }
+}
+
+void RollingStatistics::add(double value) {
+    size_t capacity = this->values.size();
+    if (capacity == 0) {
+        return;
+    }
+    if (this->count > 0 && capacity > 1) {
+        double d = value - this->getLast();
+        this->sumSquaredDiffs += d * d;
+    }
+
+    if (this->count < capacity) {
+        this->values[this->head] = value;
+        this->count++;
+        double delta = value - this->mean;
+        this->mean += delta / this->count;
+        this->m2 += delta * (value - this->mean);
+    } else {
+        // The value at the head is the oldest one, and goes out of the window.
+        double oldest = this->values[this->head];
+        if (capacity > 1) {
+            double d = this->values[(this->head + 1) % capacity] - oldest;
+            this->sumSquaredDiffs -= d * d;
+        }
+        this->values[this->head] = value;
+        double oldMean = this->mean;
+        double delta = value - oldest;
+        this->mean += delta / capacity;
+        this->m2 += delta * (value - this->mean + oldest - oldMean);
+    }
+    this->head = this->head + 1 == capacity ? 0 : this->head + 1;
+
+    // Recompute exactly once the window first fills up, and after every full turn of the ring from then on.
+    if (++this->updatesSinceRecompute >= capacity) {
+        this->recompute();
+    }
+    this->m2 = std::max(this->m2, 0.0);
+    this->sumSquaredDiffs = std::max(this->sumSquaredDiffs, 0.0);
+}
+
+void RollingStatistics::clear() {
+    this->head = 0;
+    this->count = 0;
+    this->recompute();
+}
+
+// Changes the window size, keeping the latest values that still fit.
+void RollingStatistics::setCapacity(size_t capacity) {
+    std::vector<double> window(this->count);
+    this->copyTo(window.data());
+    this->values.assign(capacity, 0);
+    this->clear();
+    size_t first = window.size() > capacity ? window.size() - capacity : 0;
+    for (size_t i = first; i < window.size(); i++) {
+        this->values[this->count++] = window[i];
+    }
+    this->head = this->count == capacity ? 0 : this->count;
+    this->recompute();
+}
+
+size_t RollingStatistics::getCapacity() const {
+    return this->values.size();
+}
+
+size_t RollingStatistics::size() const {
+    return this->count;
+}
+
+bool RollingStatistics::empty() const {
+    return this->count == 0;
+}
+
+bool RollingStatistics::isFull() const {
+    return this->count > 0 && this->count == this->values.size();
+}
+
+double RollingStatistics::getLast() const {
+    if (this->count == 0) {
+        return NAN;
+    }
+    return this->values[this->head == 0 ? this->values.size() - 1 : this->head - 1];
+}
+
+double RollingStatistics::getMean() const {
+    return this->count == 0 ? NAN : this->mean;
+}
+
+double RollingStatistics::getVariance() const {
+    return this->count == 0 ? NAN : this->m2 / this->count;
+}
+
+double RollingStatistics::getStdDev() const {
+    return std::sqrt(this->getVariance());
+}
+
+double RollingStatistics::getSumSquaredDiffs() const {
+    return this->sumSquaredDiffs;
+}
+
+// The variance of the log returns between consecutive values, or NaN with fewer than two values. Their mean telescopes
+// to the log return from the oldest value to the newest, so one pass over the window is enough.
+double RollingStatistics::getLogReturnVariance() const {
+    if (this->count < 2) {
+        return NAN;
+    }
+    const double *firstRun;
+    const double *secondRun;
+    size_t firstCount = this->getFirstRun(firstRun);
+    size_t secondCount = this->getSecondRun(secondRun);
+    size_t numReturns = this->count - 1;
+    double first = firstRun[0];
+    double mean = std::log(this->getLast() / first) / numReturns;
+
+    double total = sumSquaredLogReturnDeviationsInRun(firstRun, firstCount, mean) +
+                   sumSquaredLogReturnDeviationsInRun(secondRun, secondCount, mean);
+    if (secondCount > 0) {
+        double d = std::log(secondRun[0] / firstRun[firstCount - 1]) - mean;
+        total += d * d;
+    }
+    return total / numReturns;
+}
+
+// The exponential moving average of the window with smoothing factor alpha, weighting the values by
+// (1 - alpha) ^ age and normalising by the sum of the weights. This is what pandas' ewm(alpha=alpha, adjust=True)
+// computes for the last value. NaN if the window is empty.
+double RollingStatistics::getEma(double alpha) const {
+    if (this->count == 0) {
+        return NAN;
+    }
+    const double *runs[2];
+    size_t counts[2];
+    counts[0] = this->getFirstRun(runs[0]);
+    counts[1] = this->getSecondRun(runs[1]);
+    double decay = 1 - alpha;
+    double weightedSum = 0;
+    double totalWeight = 0;
+    for (size_t r = 0; r < 2; r++) {
+        for (size_t i = 0; i < counts[r]; i++) {
+            weightedSum = weightedSum * decay + runs[r][i];
+            totalWeight = totalWeight * decay + 1;
+        }
+    }
+    return weightedSum / totalWeight;
+}
+
+// Copies the window to out, oldest value first, and returns the number of values copied.
+size_t RollingStatistics::copyTo(double *out) const {
+    const double *firstRun;
+    const double *secondRun;
+    size_t firstCount = this->getFirstRun(firstRun);
+    size_t secondCount = this->getSecondRun(secondRun);
+    std::copy(firstRun, firstRun + firstCount, out);
+    std::copy(secondRun, secondRun + secondCount, out + firstCount);
+    return this->count;
+}
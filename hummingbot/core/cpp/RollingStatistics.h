@@ -0,0 +1,52 @@
+#ifndef _ROLLING_STATISTICS_H
+#define _ROLLING_STATISTICS_H
+
+#include <stddef.h>
+#include <vector>
+
+// A fixed size window over the latest values of a series, with rolling statistics.
+//
+// The mean and variance are kept as Welford running sums, and the sum of squared differences between consecutive
+// values as a plain running sum, so each of them is O(1) to update and to read. Removing values from running sums
+// slowly accumulates rounding error, so all of them are recomputed from the window once every full turn of the ring,
+// which keeps updates O(1) amortised.
+//
+// Statistics that depend on the whole window, such as the variance of the log returns or an EMA, are recomputed on
+// demand. The window is held oldest first in at most two contiguous runs, and the kernels are plain loops over those
+// runs, with independent accumulators so the compiler can vectorise them. The variance is the population variance.
+class RollingStatistics {
+    std::vector<double> values;
+    size_t head;
+    size_t count;
+    size_t updatesSinceRecompute;
+    double mean;
+    double m2;
+    double sumSquaredDiffs;
+
+    void recompute();
+    size_t getFirstRun(const double *&run) const;
+    size_t getSecondRun(const double *&run) const;
+
+    public:
+        RollingStatistics();
+        RollingStatistics(size_t capacity);
+
+        void add(double value);
+        void clear();
+        void setCapacity(size_t capacity);
+
+        size_t getCapacity() const;
+        size_t size() const;
+        bool empty() const;
+        bool isFull() const;
+        double getLast() const;
+        double getMean() const;
+        double getVariance() const;
+        double getStdDev() const;
+        double getSumSquaredDiffs() const;
+        double getLogReturnVariance() const;
+        double getEma(double alpha) const;
+        size_t copyTo(double *out) const;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "SnapshotReconciler.h"
+#include <cmath>
+
+namespace {
+
+const size_t ROW_SIZE = 5;
+
+bool isSameMessage(const double *a, const double *b) {
+    return a[2] == b[2] && (a[3] == b[3] || (std::isnan(a[3]) && std::isnan(b[3])));
+}
+
+// A side emptied by a diff keeps its last known best price, as in applyDiffs().
+void recordBestPrices(const OrderBookSide &bidBook, const OrderBookSide &askBook, double &bestBid, double &bestAsk) {
+    if (!bidBook.empty()) {
+        bestBid = bidBook.best().getPrice();
+    }
+    if (!askBook.empty()) {
+        bestAsk = askBook.best().getPrice();
+    }
+}
+
+}
+
+ReconcileResult reconcileSnapshotAndDiffs(OrderBookSide &bidBook, OrderBookSide &askBook,
+                                          const std::vector<OrderBookEntry> &snapshotBids,
+                                          const std::vector<OrderBookEntry> &snapshotAsks,
+                                          int64_t snapshotUpdateId,
+                                          const double *diffRows, size_t numDiffRows,
+                                          const int &dex, double &bestBid, double &bestAsk,
+                                          L2Recorder *recorder) {
+    ReconcileResult result;
+    result.status = RECONCILE_SYNCED;
+    result.lastUpdateId = snapshotUpdateId;
+    result.appliedDiffs = 0;
+    result.skippedDiffs = 0;
+    result.gapFirstUpdateId = 0;
+
+    if (recorder != NULL) {
+        recorder->writeSnapshot(snapshotBids, snapshotAsks, snapshotUpdateId, NAN);
+    }
+    bidBook.assign(snapshotBids);
+    askBook.assign(snapshotAsks);
+    if (dex) {
+        truncateOverlapEntries(bidBook, askBook, dex);
+    }
+    bestBid = bidBook.empty() ? NAN : bidBook.best().getPrice();
+    bestAsk = askBook.empty() ? NAN : askBook.best().getPrice();
+
+    // Rows of the current message, split by side, only needed to hand them to the recorder.
+    std::vector<double> bidRows;
+    std::vector<double> askRows;
+    size_t start = 0;
+    while (start < numDiffRows) {
+        const double *first = diffRows + start * ROW_SIZE;
+        size_t end = start + 1;
+        while (end < numDiffRows && isSameMessage(first, diffRows + end * ROW_SIZE)) {
+            end++;
+        }
+
+        int64_t updateId = (int64_t)first[2];
+        if (updateId <= result.lastUpdateId) {
+            result.skippedDiffs++;
+            start = end;
+            continue;
+        }
+        if (!std::isnan(first[3]) && (int64_t)first[3] > result.lastUpdateId + 1) {
+            result.status = RECONCILE_GAP;
+            result.gapFirstUpdateId = (int64_t)first[3];
+            break;
+        }
+
+        bidRows.clear();
+        askRows.clear();
+        for (size_t i = start; i < end; i++) {
+            const double *row = diffRows + i * ROW_SIZE;
+            if (std::isnan(row[0])) {
+                continue;
+            }
+            bool isBid = row[4] != 0;
+            (isBid ? bidBook : askBook).applyDiff(OrderBookEntry(row[0], row[1], updateId));
+            if (recorder != NULL) {
+                std::vector<double> &rows = isBid ? bidRows : askRows;
+                rows.push_back(row[0]);
+                rows.push_back(row[1]);
+                rows.push_back(row[2]);
+            }
+        }
+        truncateOverlapEntries(bidBook, askBook, dex);
+        recordBestPrices(bidBook, askBook, bestBid, bestAsk);
+        if (recorder != NULL) {
+            recorder->writeDiffRows(bidRows.data(), bidRows.size() / 3, askRows.data(), askRows.size() / 3,
+                                    updateId, NAN);
+        }
+        result.appliedDiffs++;
+        result.lastUpdateId = updateId;
+        start = end;
+    }
+
+    bidBook.syncTopLevels();
+    askBook.syncTopLevels();
+    return result;
+}
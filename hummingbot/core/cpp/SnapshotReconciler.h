@@ -0,0 +1,45 @@
+#ifndef _SNAPSHOT_RECONCILER_H
+#define _SNAPSHOT_RECONCILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "L2Capture.h"
+#include "OrderBookEntry.h"
+#include "OrderBookSide.h"
+
+enum ReconcileStatus {
+    RECONCILE_SYNCED = 0,
+    RECONCILE_GAP = 1
+};
+
+// Outcome of restoring a book from a snapshot and the diffs buffered around it.
+struct ReconcileResult {
+    int status;
+    int64_t lastUpdateId;
+    size_t appliedDiffs;
+    size_t skippedDiffs;
+    int64_t gapFirstUpdateId;
+};
+
+// Restores an order book from a snapshot, then replays the buffered diffs on top of it in one pass.
+//
+// The diffs are packed (price, amount, updateId, firstUpdateId, isBid) rows of doubles. Consecutive rows with the same
+// update IDs make up one diff message, and a message with no levels is a single row with a NaN price. A NaN
+// firstUpdateId means the exchange does not number its diffs contiguously, so the message cannot be checked for gaps.
+//
+// Messages that are not newer than the snapshot, or than the last message applied, are stale and skipped. A message
+// whose first update ID leaves a hole after the last applied update ID stops the replay: the book is left at the last
+// contiguous update, and the result reports the gap so the caller can fetch a fresh snapshot.
+//
+// Overlaps are truncated after every message, as when the diffs are applied one by one, but the top levels are synced
+// once at the end. When a recorder is given, the snapshot and every applied message are captured.
+ReconcileResult reconcileSnapshotAndDiffs(OrderBookSide &bidBook, OrderBookSide &askBook,
+                                          const std::vector<OrderBookEntry> &snapshotBids,
+                                          const std::vector<OrderBookEntry> &snapshotAsks,
+                                          int64_t snapshotUpdateId,
+                                          const double *diffRows, size_t numDiffRows,
+                                          const int &dex, double &bestBid, double &bestAsk,
+                                          L2Recorder *recorder);
+
+#endif
@@ -0,0 +1,184 @@
+#include "SymbolTable.h"
+
+static const char *SYMBOL_TABLE_CAPSULE_NAME = "_hummingbot_symbol_table";
+static const uint32_t PINNED = UINT32_MAX;
+
+SymbolTable::SymbolTable() {
+    this->nextSequence = 0;
+    this->insertName("", PINNED);
+}
+
+SymbolTable &SymbolTable::getInstance() {
+    static SymbolTable *instance = NULL;
+    if (instance == NULL) {
+        PyObject *capsule = PySys_GetObject(SYMBOL_TABLE_CAPSULE_NAME);
+        if (capsule != NULL && PyCapsule_IsValid(capsule, SYMBOL_TABLE_CAPSULE_NAME)) {
+            instance = (SymbolTable *)PyCapsule_GetPointer(capsule, SYMBOL_TABLE_CAPSULE_NAME);
+        } else {
+            // The table lives for the rest of the process, handles may be held by any module.
+            instance = new SymbolTable();
+            capsule = PyCapsule_New(instance, SYMBOL_TABLE_CAPSULE_NAME, NULL);
+            if (capsule == NULL || PySys_SetObject(SYMBOL_TABLE_CAPSULE_NAME, capsule) != 0) {
+                PyErr_Clear();
+            }
+            Py_XDECREF(capsule);
+        }
+    }
+    return *instance;
+}
+
+SymbolHandle SymbolTable::insertName(const std::string &name, uint32_t refCount) {
+    SymbolHandle handle;
+    if (!this->freeHandles.empty()) {
+        handle = this->freeHandles.back();
+        this->freeHandles.pop_back();
+    } else {
+        handle = (SymbolHandle)this->names.size();
+        this->names.push_back(NULL);
+        this->refCounts.push_back(0);
+        this->sequences.push_back(0);
+    }
+    std::unordered_map<std::string, SymbolHandle>::iterator it = this->handles.emplace(name, handle).first;
+    this->names[handle] = &it->first;
+    this->refCounts[handle] = refCount;
+    this->sequences[handle] = this->nextSequence++;
+    return handle;
+}
+
+SymbolHandle SymbolTable::intern(const std::string &name) {
+    std::unordered_map<std::string, SymbolHandle>::const_iterator it = this->handles.find(name);
+    if (it == this->handles.end()) {
+        return this->insertName(name, PINNED);
+    }
+    this->refCounts[it->second] = PINNED;
+    return it->second;
+}
+
+SymbolHandle SymbolTable::acquire(const std::string &name) {
+    std::unordered_map<std::string, SymbolHandle>::const_iterator it = this->handles.find(name);
+    if (it == this->handles.end()) {
+        return this->insertName(name, 1);
+    }
+    this->retain(it->second);
+    return it->second;
+}
+
+void SymbolTable::retain(SymbolHandle handle) {
+    if (this->refCounts[handle] != PINNED) {
+        this->refCounts[handle]++;
+    }
+}
+
+void SymbolTable::release(SymbolHandle handle) {
+    if (this->refCounts[handle] == PINNED) {
+        return;
+    }
+    if (--this->refCounts[handle] == 0) {
+        this->handles.erase(*this->names[handle]);
+        this->names[handle] = NULL;
+        this->freeHandles.push_back(handle);
+    }
+}
+
+bool SymbolTable::find(const std::string &name, SymbolHandle &handle) const {
+    std::unordered_map<std::string, SymbolHandle>::const_iterator it = this->handles.find(name);
+    if (it == this->handles.end()) {
+        return false;
+    }
+    handle = it->second;
+    return true;
+}
+
+const std::string &SymbolTable::getName(SymbolHandle handle) const {
+    return *this->names[handle];
+}
+
+uint64_t SymbolTable::getSequence(SymbolHandle handle) const {
+    return this->sequences[handle];
+}
+
+// Interned names read as UINT32_MAX.
+uint32_t SymbolTable::getRefCount(SymbolHandle handle) const {
+    return this->refCounts[handle];
+}
+
+size_t SymbolTable::size() const {
+    return this->handles.size();
+}
+
+Symbol::Symbol() {
+    this->handle = 0;
+}
+
+Symbol::Symbol(const std::string &name) {
+    this->handle = SymbolTable::getInstance().acquire(name);
+}
+
+Symbol::Symbol(const Symbol &other) {
+    this->handle = other.handle;
+    if (this->handle != 0) {
+        SymbolTable::getInstance().retain(this->handle);
+    }
+}
+
+Symbol::Symbol(Symbol &&other) {
+    this->handle = other.handle;
+    other.handle = 0;
+}
+
+Symbol::~Symbol() {
+    if (this->handle != 0) {
+        SymbolTable::getInstance().release(this->handle);
+    }
+}
+
+Symbol &Symbol::operator=(const Symbol &other) {
+    SymbolTable &table = SymbolTable::getInstance();
+    table.retain(other.handle);
+    table.release(this->handle);
+    this->handle = other.handle;
+    return *this;
+}
+
+Symbol &Symbol::operator=(Symbol &&other) {
+    if (this != &other) {
+        SymbolTable::getInstance().release(this->handle);
+        this->handle = other.handle;
+        other.handle = 0;
+    }
+    return *this;
+}
+
+bool Symbol::operator==(const Symbol &other) const {
+    return this->handle == other.handle;
+}
+
+// Symbols order by when their names entered the table. Handles are recycled, so ordering by handle would depend on which
+// handles were free, while comparing names would cost a string compare on every call.
+bool Symbol::operator<(const Symbol &other) const {
+    if (this->handle == other.handle) {
+        return false;
+    }
+    const SymbolTable &table = SymbolTable::getInstance();
+    return table.getSequence(this->handle) < table.getSequence(other.handle);
+}
+
+SymbolHandle Symbol::getHandle() const {
+    return this->handle;
+}
+
+const std::string &Symbol::getName() const {
+    return SymbolTable::getInstance().getName(this->handle);
+}
+
+SymbolHandle internSymbol(const std::string &name) {
+    return SymbolTable::getInstance().intern(name);
+}
+
+bool findSymbol(const std::string &name, SymbolHandle &handle) {
+    return SymbolTable::getInstance().find(name, handle);
+}
+
+const std::string &getSymbolName(SymbolHandle handle) {
+    return SymbolTable::getInstance().getName(handle);
+}
@@ -0,0 +1,74 @@
+#ifndef _SYMBOL_TABLE_H
+#define _SYMBOL_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <Python.h>
+
+typedef uint32_t SymbolHandle;
+
+// Maps strings such as trading pairs, currencies and client order IDs to compact integer handles.
+//
+// A handle stays valid for as long as the string is held. Interned strings are held for the life of the process, which
+// suits small sets of names like trading pairs and currencies. Acquired strings are reference counted through Symbol,
+// and their handles are recycled once the last Symbol is gone, so per order names like client order IDs do not pile
+// up over a long session. Handle 0 is always the empty string.
+//
+// Every name is also given a sequence number when it enters the table, which only ever grows. Unlike handles, sequence
+// numbers are never reused, so they give symbols an order that does not depend on which handles happened to be free.
+//
+// Every Cython extension module is built with its own copy of this file. The table itself is shared between them
+// through a capsule stored on the sys module, so a handle created in one module resolves to the same name in another.
+// The table is not thread safe, callers must hold the GIL.
+class SymbolTable {
+    std::unordered_map<std::string, SymbolHandle> handles;
+    std::vector<const std::string *> names;
+    std::vector<uint32_t> refCounts;
+    std::vector<uint64_t> sequences;
+    std::vector<SymbolHandle> freeHandles;
+    uint64_t nextSequence;
+
+    SymbolTable();
+    SymbolHandle insertName(const std::string &name, uint32_t refCount);
+
+    public:
+        static SymbolTable &getInstance();
+
+        SymbolHandle intern(const std::string &name);
+        SymbolHandle acquire(const std::string &name);
+        void retain(SymbolHandle handle);
+        void release(SymbolHandle handle);
+        bool find(const std::string &name, SymbolHandle &handle) const;
+        const std::string &getName(SymbolHandle handle) const;
+        uint64_t getSequence(SymbolHandle handle) const;
+        uint32_t getRefCount(SymbolHandle handle) const;
+        size_t size() const;
+};
+
+// A reference counted handle to a string in the shared SymbolTable.
+class Symbol {
+    SymbolHandle handle;
+
+    public:
+        Symbol();
+        Symbol(const std::string &name);
+        Symbol(const Symbol &other);
+        Symbol(Symbol &&other);
+        ~Symbol();
+        Symbol &operator=(const Symbol &other);
+        Symbol &operator=(Symbol &&other);
+        bool operator==(const Symbol &other) const;
+        bool operator<(const Symbol &other) const;
+
+        SymbolHandle getHandle() const;
+        const std::string &getName() const;
+};
+
+SymbolHandle internSymbol(const std::string &name);
+bool findSymbol(const std::string &name, SymbolHandle &handle);
+const std::string &getSymbolName(SymbolHandle handle);
+
+#endif
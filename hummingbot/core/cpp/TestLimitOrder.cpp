@@ -0,0 +1,109 @@
+#include <cassert>
+#include <cstdio>
+#include <utility>
+#include "LimitOrder.h"
+
+void testCopyAssignmentRefCounts();
+void testMoveAssignmentRefCounts();
+void testSelfAssignmentKeepsObjects();
+void testLimitOrderSetRefCounts();
+
+int main(const int argc, const char **argv) {
+    Py_Initialize();
+    testCopyAssignmentRefCounts();
+    testMoveAssignmentRefCounts();
+    testSelfAssignmentKeepsObjects();
+    testLimitOrderSetRefCounts();
+    printf("All limit order tests passed.\n");
+    return 0;
+}
+
+void testCopyAssignmentRefCounts() {
+    PyObject *price = PyFloat_FromDouble(100.5);
+    PyObject *quantity = PyFloat_FromDouble(2.0);
+    PyObject *otherPrice = PyFloat_FromDouble(99.5);
+    PyObject *otherQuantity = PyFloat_FromDouble(3.0);
+    {
+        LimitOrder order("buy-1", "ETH-USDT", true, "ETH", "USDT", price, quantity);
+        LimitOrder other("buy-2", "ETH-USDT", true, "ETH", "USDT", otherPrice, otherQuantity);
+        assert(Py_REFCNT(price) == 2 && Py_REFCNT(otherPrice) == 2);
+
+        // The objects of the overwritten order are released, the assigned ones are shared.
+        other = order;
+        assert(Py_REFCNT(price) == 3 && Py_REFCNT(quantity) == 3);
+        assert(Py_REFCNT(otherPrice) == 1 && Py_REFCNT(otherQuantity) == 1);
+        assert(other.getPrice() == price);
+    }
+    assert(Py_REFCNT(price) == 1 && Py_REFCNT(quantity) == 1);
+    Py_DECREF(price);
+    Py_DECREF(quantity);
+    Py_DECREF(otherPrice);
+    Py_DECREF(otherQuantity);
+}
+
+void testMoveAssignmentRefCounts() {
+    PyObject *price = PyFloat_FromDouble(100.5);
+    PyObject *quantity = PyFloat_FromDouble(2.0);
+    PyObject *otherPrice = PyFloat_FromDouble(99.5);
+    {
+        LimitOrder order("buy-1", "ETH-USDT", true, "ETH", "USDT", price, quantity);
+        LimitOrder other("buy-2", "ETH-USDT", true, "ETH", "USDT", otherPrice, quantity);
+        assert(Py_REFCNT(quantity) == 3);
+
+        // Moving hands the references over without touching the counts of the moved objects.
+        other = std::move(order);
+        assert(Py_REFCNT(price) == 2);
+        assert(Py_REFCNT(otherPrice) == 1);
+        assert(Py_REFCNT(quantity) == 2);
+        assert(order.getPrice() == NULL && other.getPrice() == price);
+
+        LimitOrder moved(std::move(other));
+        assert(Py_REFCNT(price) == 2 && Py_REFCNT(quantity) == 2);
+    }
+    assert(Py_REFCNT(price) == 1 && Py_REFCNT(quantity) == 1);
+    Py_DECREF(price);
+    Py_DECREF(quantity);
+    Py_DECREF(otherPrice);
+}
+
+void testSelfAssignmentKeepsObjects() {
+    PyObject *price = PyFloat_FromDouble(100.5);
+    PyObject *quantity = PyFloat_FromDouble(2.0);
+    {
+        LimitOrder order("buy-1", "ETH-USDT", true, "ETH", "USDT", price, quantity);
+        LimitOrder &alias = order;
+        order = alias;
+        assert(Py_REFCNT(price) == 2 && Py_REFCNT(quantity) == 2);
+        order = std::move(alias);
+        assert(Py_REFCNT(price) == 2 && Py_REFCNT(quantity) == 2);
+        assert(order.getPrice() == price);
+    }
+    assert(Py_REFCNT(price) == 1 && Py_REFCNT(quantity) == 1);
+    Py_DECREF(price);
+    Py_DECREF(quantity);
+}
+
+void testLimitOrderSetRefCounts() {
+    PyObject *price = PyFloat_FromDouble(100.5);
+    PyObject *quantity = PyFloat_FromDouble(2.0);
+    PyObject *filledQuantity = PyFloat_FromDouble(0.0);
+    {
+        LimitOrderSet orders;
+        LimitOrder order("buy-1", "ETH-USDT", true, "ETH", "USDT", price, quantity);
+        orders.insert(order);
+        assert(Py_REFCNT(price) == 3 && Py_REFCNT(quantity) == 3);
+        orders.erase(order);
+        assert(Py_REFCNT(price) == 2 && Py_REFCNT(quantity) == 2);
+
+        emplaceLimitOrder(orders, "buy-2", "ETH-USDT", true, "ETH", "USDT", price, quantity, filledQuantity, 0, 0,
+                          "NIL");
+        assert(Py_REFCNT(price) == 3 && Py_REFCNT(filledQuantity) == 2);
+        orders.insert(std::move(order));
+        assert(Py_REFCNT(price) == 3 && Py_REFCNT(quantity) == 3);
+        orders.clear();
+        assert(Py_REFCNT(price) == 1 && Py_REFCNT(quantity) == 1 && Py_REFCNT(filledQuantity) == 1);
+    }
+    Py_DECREF(price);
+    Py_DECREF(quantity);
+    Py_DECREF(filledQuantity);
+}
@@ -0,0 +1,81 @@
+#include <cassert>
+#include <cstdio>
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include "PoolAllocator.h"
+
+typedef std::set<int, std::less<int>, PoolAllocator<int>> PooledSet;
+typedef std::unordered_map<int, double, std::hash<int>, std::equal_to<int>,
+                           PoolAllocator<std::pair<const int, double>>> PooledMap;
+
+void testSetReusesFreedNodes();
+void testMapReusesFreedNodes();
+void testCopiesSharePool();
+
+int main(const int argc, const char **argv) {
+    testSetReusesFreedNodes();
+    testMapReusesFreedNodes();
+    testCopiesSharePool();
+    printf("All pool allocator tests passed.\n");
+    return 0;
+}
+
+void testSetReusesFreedNodes() {
+    PooledSet orders;
+    const NodePool &pool = *orders.get_allocator().getPool();
+    std::set<const void *> nodes;
+
+    for (int i = 0; i < 100; i++) {
+        nodes.insert(&*orders.insert(i).first);
+    }
+    size_t chunkCount = pool.getChunkCount();
+    assert(pool.getLiveBlockCount() == 100);
+    orders.clear();
+    assert(pool.getLiveBlockCount() == 0);
+
+    // Refilling the set up to its high water mark takes every node from the free list, none from a new chunk.
+    for (int i = 100; i < 200; i++) {
+        assert(nodes.count(&*orders.insert(i).first) == 1);
+    }
+    assert(pool.getChunkCount() == chunkCount);
+    assert(pool.getLiveBlockCount() == 100);
+
+    // Placing and cancelling one order at a time keeps reusing the same node.
+    const void *node = &*orders.insert(1000).first;
+    for (int i = 0; i < 1000; i++) {
+        orders.erase(1000 + i);
+        assert(&*orders.insert(1001 + i).first == node);
+    }
+    assert(pool.getChunkCount() == chunkCount);
+}
+
+void testMapReusesFreedNodes() {
+    PooledMap states;
+    const NodePool &pool = *states.get_allocator().getPool();
+
+    for (int i = 0; i < 100; i++) {
+        states[i] = i;
+    }
+    size_t chunkCount = pool.getChunkCount();
+    for (int i = 0; i < 100; i++) {
+        states.erase(i);
+    }
+    assert(pool.getLiveBlockCount() == 0);
+
+    // The nodes come from the pool again, while the bucket array never did.
+    for (int i = 0; i < 100; i++) {
+        states[i + 100] = i;
+    }
+    assert(pool.getChunkCount() == chunkCount);
+    assert(pool.getLiveBlockCount() == 100);
+}
+
+void testCopiesSharePool() {
+    PooledSet orders;
+    orders.insert(1);
+    PooledSet copy(orders);
+    assert(copy.get_allocator() == orders.get_allocator());
+    assert(orders.get_allocator().getPool()->getLiveBlockCount() == 2);
+    assert(PooledSet().get_allocator() != orders.get_allocator());
+}
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <cstdio>
+#include <dlfcn.h>
+#include <string>
+#include "SymbolTable.h"
+
+// Built a second time as TestSymbolTableModule.so, with its own copy of SymbolTable.cpp, the way every Cython extension
+// module gets one.
+#ifdef SYMBOL_TABLE_TEST_MODULE
+
+extern "C" __attribute__((visibility("default"))) SymbolHandle moduleInternSymbol(const char *name) {
+    return internSymbol(name);
+}
+
+extern "C" __attribute__((visibility("default"))) const char *moduleGetSymbolName(SymbolHandle handle) {
+    return getSymbolName(handle).c_str();
+}
+
+#else
+
+void testInternReturnsSameHandle();
+void testReleasedHandleIsRecycled();
+void testRefCounts();
+void testFindFailsAfterLastRelease();
+void testSymbolsOrderByCreation();
+void testTableSharedAcrossModules(const char *modulePath);
+
+int main(const int argc, const char **argv) {
+    Py_Initialize();
+    testInternReturnsSameHandle();
+    testReleasedHandleIsRecycled();
+    testRefCounts();
+    testFindFailsAfterLastRelease();
+    testSymbolsOrderByCreation();
+    testTableSharedAcrossModules(argc > 1 ? argv[1] : "./TestSymbolTableModule.so");
+    printf("All symbol table tests passed.\n");
+    return 0;
+}
+
+void testInternReturnsSameHandle() {
+    SymbolHandle handle = internSymbol("ETH-USDT");
+    assert(handle != 0);
+    assert(internSymbol("ETH-USDT") == handle);
+    assert(internSymbol("BTC-USDT") != handle);
+    assert(getSymbolName(handle) == "ETH-USDT");
+    assert(internSymbol("") == 0);
+}
+
+void testReleasedHandleIsRecycled() {
+    SymbolHandle handle;
+    {
+        Symbol order("buy-recycled-1");
+        handle = order.getHandle();
+    }
+    Symbol order("buy-recycled-2");
+    assert(order.getHandle() == handle);
+    assert(order.getName() == "buy-recycled-2");
+}
+
+void testRefCounts() {
+    SymbolTable &table = SymbolTable::getInstance();
+    Symbol order("buy-refcount");
+    SymbolHandle handle = order.getHandle();
+    assert(table.getRefCount(handle) == 1);
+    {
+        Symbol copy(order);
+        Symbol other("buy-refcount");
+        assert(other.getHandle() == handle);
+        assert(table.getRefCount(handle) == 3);
+        Symbol moved(std::move(copy));
+        assert(copy.getHandle() == 0);
+        assert(table.getRefCount(handle) == 3);
+        other = moved;
+        assert(table.getRefCount(handle) == 3);
+        other = Symbol("sell-refcount");
+        assert(table.getRefCount(handle) == 2);
+    }
+    assert(table.getRefCount(handle) == 1);
+
+    // Interned names are never released.
+    SymbolHandle pinned = internSymbol("buy-refcount");
+    assert(pinned == handle);
+    Symbol extra("buy-refcount");
+    assert(table.getRefCount(handle) == UINT32_MAX);
+}
+
+void testFindFailsAfterLastRelease() {
+    SymbolHandle handle;
+    {
+        Symbol order("buy-find");
+        Symbol copy(order);
+        assert(findSymbol("buy-find", handle));
+        assert(handle == order.getHandle());
+        order = Symbol();
+        assert(findSymbol("buy-find", handle));
+    }
+    assert(!findSymbol("buy-find", handle));
+}
+
+void testSymbolsOrderByCreation() {
+    Symbol first("order-b");
+    Symbol freed("order-freed");
+    Symbol second("order-a");
+    freed = Symbol();
+
+    // The recycled handle is older than second's, but its name is newer, so it orders last.
+    Symbol third("order-c");
+    assert(first < second && second < third);
+    assert(!(second < first) && !(third < second));
+    assert(!(first < first));
+}
+
+void testTableSharedAcrossModules(const char *modulePath) {
+    void *module = dlopen(modulePath, RTLD_NOW | RTLD_LOCAL);
+    if (module == NULL) {
+        fprintf(stderr, "%s\n", dlerror());
+    }
+    assert(module != NULL);
+    SymbolHandle (*moduleIntern)(const char *) = (SymbolHandle (*)(const char *))dlsym(module, "moduleInternSymbol");
+    const char *(*moduleGetName)(SymbolHandle) = (const char *(*)(SymbolHandle))dlsym(module, "moduleGetSymbolName");
+    assert(moduleIntern != NULL && moduleGetName != NULL);
+
+    // Both copies of the table code find the same table through the capsule on sys.
+    SymbolHandle handle = internSymbol("SOL-USDT");
+    assert(moduleIntern("SOL-USDT") == handle);
+    SymbolHandle moduleHandle = moduleIntern("XRP-USDT");
+    assert(getSymbolName(moduleHandle) == "XRP-USDT");
+    assert(std::string(moduleGetName(handle)) == "SOL-USDT");
+    dlclose(module);
+}
+
+#endif
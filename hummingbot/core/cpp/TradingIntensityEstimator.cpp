@@ -0,0 +1,252 @@
+#include "TradingIntensityEstimator.h"
+#include <algorithm>
+#include <cmath>
+
+TradingIntensityEstimator::TradingIntensityEstimator() : TradingIntensityEstimator(30) {
+}
+
+TradingIntensityEstimator::TradingIntensityEstimator(size_t samplingLength) {
+    this->samplingLength = samplingLength;
+    this->alpha = 0;
+    this->kappa = 0;
+    this->changed = false;
+}
+
+void TradingIntensityEstimator::setSamplingLength(size_t samplingLength) {
+    this->samplingLength = samplingLength;
+}
+
+size_t TradingIntensityEstimator::getSamplingLength() const {
+    return this->samplingLength;
+}
+
+void TradingIntensityEstimator::registerTrade(double timestamp, double price, double amount) {
+    Trade trade;
+    trade.timestamp = timestamp;
+    trade.price = price;
+    trade.amount = amount;
+    this->pendingTrades.push_back(trade);
+}
+
+void TradingIntensityEstimator::addToLevel(double priceLevel, double amount) {
+    LevelTotal &total = this->levelTotals[priceLevel];
+    total.amount += amount;
+    total.count++;
+}
+
+void TradingIntensityEstimator::removeFromLevel(double priceLevel, double amount) {
+    std::map<double, LevelTotal>::iterator it = this->levelTotals.find(priceLevel);
+    if (it == this->levelTotals.end()) {
+        return;
+    }
+    // Levels are dropped by count, so rounding in the running amount never leaves an empty level behind.
+    if (--it->second.count == 0) {
+        this->levelTotals.erase(it);
+    } else {
+        it->second.amount -= amount;
+    }
+}
+
+// Quotes the new mid price, buckets the trades registered since the last call, and refits the curve if the buckets
+// are full and have changed.
+void TradingIntensityEstimator::calculate(double timestamp, double midPrice) {
+    Quote quote;
+    quote.timestamp = timestamp;
+    quote.price = midPrice;
+    this->quotes.push_front(quote);
+
+    // Each trade is measured against the latest quote before it. Quotes older than the latest one any trade was
+    // measured against are not needed anymore.
+    size_t latestProcessedQuote = this->quotes.size();
+    for (size_t i = 0; i < this->pendingTrades.size(); i++) {
+        const Trade &trade = this->pendingTrades[i];
+        for (size_t j = 0; j < this->quotes.size(); j++) {
+            if (this->quotes[j].timestamp < trade.timestamp) {
+                latestProcessedQuote = std::min(latestProcessedQuote, j);
+                double priceLevel = std::fabs(trade.price - this->quotes[j].price);
+                this->samples[this->quotes[j].timestamp + 1].push_back(std::make_pair(priceLevel, trade.amount));
+                this->addToLevel(priceLevel, trade.amount);
+                this->changed = true;
+                break;
+            }
+        }
+    }
+    this->pendingTrades.clear();
+    if (latestProcessedQuote < this->quotes.size()) {
+        this->quotes.resize(latestProcessedQuote + 1);
+    }
+
+    while (this->samples.size() > this->samplingLength) {
+        std::map<double, std::vector<std::pair<double, double>>>::iterator oldest = this->samples.begin();
+        for (size_t i = 0; i < oldest->second.size(); i++) {
+            this->removeFromLevel(oldest->second[i].first, oldest->second[i].second);
+        }
+        this->samples.erase(oldest);
+        this->changed = true;
+    }
+
+    if (this->isFull() && this->changed) {
+        this->estimate();
+    }
+}
+
+// The derivative of the fit's explained sum of squares N(kappa)^2 / D(kappa) in kappa, scaled by D^2 / (2 * N), where
+// N = sum(y * exp(-kappa * d)) and D = sum(exp(-2 * kappa * d)). It is positive below the best kappa and negative
+// above it.
+double TradingIntensityEstimator::getFitDerivative(double kappa) const {
+    double n = 0;
+    double d = 0;
+    double dn = 0;
+    double dd = 0;
+    for (size_t i = 0; i < this->fitLevels.size(); i++) {
+        double e = std::exp(-kappa * this->fitLevels[i]);
+        double e2 = e * e;
+        n += this->fitAmounts[i] * e;
+        d += e2;
+        dn += this->fitLevels[i] * this->fitAmounts[i] * e;
+        dd += this->fitLevels[i] * e2;
+    }
+    return n * dd - dn * d;
+}
+
+double TradingIntensityEstimator::getFitResidual(double kappa) const {
+    double n = 0;
+    double d = 0;
+    for (size_t i = 0; i < this->fitLevels.size(); i++) {
+        double e = std::exp(-kappa * this->fitLevels[i]);
+        n += this->fitAmounts[i] * e;
+        d += e * e;
+    }
+    return -n * n / d;
+}
+
+// Fits the curve to the current totals. Keeps the previous parameters and returns false if the totals cannot pin
+// down both of them.
+bool TradingIntensityEstimator::estimate() {
+    this->changed = false;
+    this->fitLevels.clear();
+    this->fitAmounts.clear();
+    double maxLevel = 0;
+    for (std::map<double, LevelTotal>::const_iterator it = this->levelTotals.begin();
+         it != this->levelTotals.end(); ++it) {
+        this->fitLevels.push_back(it->first);
+        // Zero amounts are nudged up, as the curve can never reach zero.
+        this->fitAmounts.push_back(it->second.amount == 0 ? 1e-10 : it->second.amount);
+        maxLevel = std::max(maxLevel, it->first);
+    }
+    if (this->fitLevels.size() < 2 || !(maxLevel > 0) || std::isinf(maxLevel)) {
+        return false;
+    }
+
+    // Bracket the best kappa on a log spaced grid, from flat to decaying within a tiny fraction of the widest level.
+    const int gridSize = 45;
+    double bestKappa = 0;
+    double bestResidual = this->getFitResidual(0);
+    double grid[gridSize + 1];
+    grid[0] = 0;
+    int bestIndex = 0;
+    for (int i = 1; i <= gridSize; i++) {
+        grid[i] = std::pow(10.0, -8 + 0.25 * (i - 1)) / maxLevel;
+        double residual = this->getFitResidual(grid[i]);
+        if (residual < bestResidual) {
+            bestResidual = residual;
+            bestKappa = grid[i];
+            bestIndex = i;
+        }
+    }
+
+    double kappa = bestKappa;
+    double low = grid[std::max(bestIndex - 1, 0)];
+    double high = grid[std::min(bestIndex + 1, gridSize)];
+    double lowDerivative = this->getFitDerivative(low);
+    double highDerivative = this->getFitDerivative(high);
+    if (lowDerivative > 0 && highDerivative < 0) {
+        // Illinois regula falsi, which keeps the bracket and converges superlinearly.
+        int side = 0;
+        for (int iteration = 0; iteration < 200 && high - low > 1e-15 * high; iteration++) {
+            kappa = (low * highDerivative - high * lowDerivative) / (highDerivative - lowDerivative);
+            if (!(kappa > low && kappa < high)) {
+                kappa = 0.5 * (low + high);
+            }
+            double derivative = this->getFitDerivative(kappa);
+            if (derivative == 0) {
+                break;
+            }
+            if (derivative > 0) {
+                low = kappa;
+                lowDerivative = derivative;
+                if (side == 1) {
+                    highDerivative *= 0.5;
+                }
+                side = 1;
+            } else {
+                high = kappa;
+                highDerivative = derivative;
+                if (side == -1) {
+                    lowDerivative *= 0.5;
+                }
+                side = -1;
+            }
+        }
+    }
+
+    double n = 0;
+    double d = 0;
+    for (size_t i = 0; i < this->fitLevels.size(); i++) {
+        double e = std::exp(-kappa * this->fitLevels[i]);
+        n += this->fitAmounts[i] * e;
+        d += e * e;
+    }
+    double alpha = n / d;
+    if (std::isnan(alpha) || std::isinf(alpha) || std::isnan(kappa)) {
+        return false;
+    }
+    this->alpha = std::max(alpha, 0.0);
+    this->kappa = kappa;
+    return true;
+}
+
+void TradingIntensityEstimator::clearQuotes() {
+    this->quotes.clear();
+}
+
+// Adds a quote older than all the quotes held.
+void TradingIntensityEstimator::appendQuote(double timestamp, double price) {
+    Quote quote;
+    quote.timestamp = timestamp;
+    quote.price = price;
+    this->quotes.push_back(quote);
+}
+
+size_t TradingIntensityEstimator::getQuoteCount() const {
+    return this->quotes.size();
+}
+
+// Quotes are indexed from the latest one.
+double TradingIntensityEstimator::getQuoteTimestamp(size_t index) const {
+    return this->quotes[index].timestamp;
+}
+
+double TradingIntensityEstimator::getQuotePrice(size_t index) const {
+    return this->quotes[index].price;
+}
+
+size_t TradingIntensityEstimator::getSampleCount() const {
+    return this->samples.size();
+}
+
+size_t TradingIntensityEstimator::getPriceLevelCount() const {
+    return this->levelTotals.size();
+}
+
+bool TradingIntensityEstimator::isFull() const {
+    return this->samples.size() == this->samplingLength;
+}
+
+double TradingIntensityEstimator::getAlpha() const {
+    return this->alpha;
+}
+
+double TradingIntensityEstimator::getKappa() const {
+    return this->kappa;
+}
@@ -0,0 +1,78 @@
+#ifndef _TRADING_INTENSITY_ESTIMATOR_H
+#define _TRADING_INTENSITY_ESTIMATOR_H
+
+#include <stddef.h>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Estimates the trading intensity curve lambda(d) = alpha * exp(-kappa * d) of the Avellaneda-Stoikov model, where d is
+// how far from the mid price trades happen.
+//
+// Trades are registered as they arrive and bucketed on the next calculate() call: each one is measured against the
+// latest mid price quoted before it, and lands in the bucket of that quote. The traded amount at each distance is kept
+// in running totals over the latest samplingLength buckets, so the totals are updated as buckets come and go instead
+// of being rebuilt. The curve is refitted only when the totals have changed and the buckets are full.
+//
+// The fit is an unweighted least squares fit of the totals, with alpha and kappa bounded below by zero. For a given
+// kappa the best alpha is closed form, so the fit comes down to finding the root of the derivative in kappa, which is
+// bracketed on a coarse grid and then refined to machine precision.
+class TradingIntensityEstimator {
+    struct Quote {
+        double timestamp;
+        double price;
+    };
+
+    struct Trade {
+        double timestamp;
+        double price;
+        double amount;
+    };
+
+    struct LevelTotal {
+        double amount;
+        size_t count;
+    };
+
+    std::deque<Quote> quotes;
+    std::vector<Trade> pendingTrades;
+    std::map<double, std::vector<std::pair<double, double>>> samples;
+    std::map<double, LevelTotal> levelTotals;
+    std::vector<double> fitLevels;
+    std::vector<double> fitAmounts;
+    size_t samplingLength;
+    double alpha;
+    double kappa;
+    bool changed;
+
+    void addToLevel(double priceLevel, double amount);
+    void removeFromLevel(double priceLevel, double amount);
+    double getFitDerivative(double kappa) const;
+    double getFitResidual(double kappa) const;
+
+    public:
+        TradingIntensityEstimator();
+        TradingIntensityEstimator(size_t samplingLength);
+
+        void setSamplingLength(size_t samplingLength);
+        size_t getSamplingLength() const;
+
+        void registerTrade(double timestamp, double price, double amount);
+        void calculate(double timestamp, double midPrice);
+        bool estimate();
+
+        void clearQuotes();
+        void appendQuote(double timestamp, double price);
+        size_t getQuoteCount() const;
+        double getQuoteTimestamp(size_t index) const;
+        double getQuotePrice(size_t index) const;
+
+        size_t getSampleCount() const;
+        size_t getPriceLevelCount() const;
+        bool isFull() const;
+        double getAlpha() const;
+        double getKappa() const;
+};
+
+#endif
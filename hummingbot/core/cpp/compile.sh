@@ -3,3 +3,20 @@
 g++ -c -g TestOrderBookEntry.cpp
 g++ -c -g OrderBookEntry.cpp
 g++ TestOrderBookEntry.o OrderBookEntry.o -o TestOrderBookEntry
+
+g++ -std=c++11 -g TestPoolAllocator.cpp PoolAllocator.cpp -o TestPoolAllocator
+
+g++ -std=c++11 -g $(python3-config --includes) TestLimitOrder.cpp LimitOrder.cpp PoolAllocator.cpp SymbolTable.cpp \
+    $(python3-config --embed --ldflags) -o TestLimitOrder
+
+# The symbol table test loads a second copy of the table from a shared library, standing in for another extension module.
+g++ -std=c++11 -g -shared -fPIC -fvisibility=hidden -DSYMBOL_TABLE_TEST_MODULE $(python3-config --includes) \
+    TestSymbolTable.cpp SymbolTable.cpp -o TestSymbolTableModule.so
+g++ -std=c++11 -g $(python3-config --includes) TestSymbolTable.cpp SymbolTable.cpp \
+    $(python3-config --embed --ldflags) -ldl -o TestSymbolTable
+
+# Benchmarks of the order book path, see BenchmarkCore.cpp for its flags.
+g++ -std=c++11 -O2 -DNDEBUG $(python3-config --includes) \
+    Benchmark.cpp BenchmarkWorkloads.cpp BenchmarkCore.cpp DiffCoalescer.cpp OrderBookSide.cpp OrderBookEntry.cpp L2Capture.cpp \
+    L3OrderTable.cpp LimitOrder.cpp OrderExpirationEntry.cpp PoolAllocator.cpp PyRef.cpp SymbolTable.cpp \
+    $(python3-config --embed --ldflags) -o BenchmarkCore
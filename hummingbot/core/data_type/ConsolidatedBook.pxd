@@ -0,0 +1,21 @@
+# distutils: language=c++
+
+from hummingbot.core.data_type.OrderBookSide cimport DepthQueryResult, OrderBookSide
+
+cdef extern from "../cpp/ConsolidatedBook.h":
+    cdef struct VenueLevel:
+        double price
+        double amount
+        size_t venue
+
+    cdef cppclass ConsolidatedBook:
+        ConsolidatedBook()
+        size_t addVenue(const OrderBookSide &bidSide, const OrderBookSide &askSide)
+        void clear()
+        size_t getVenueCount() const
+        bint getBest(bint isBuy, VenueLevel &level) const
+        size_t exportLevels(bint isBuy, double *rows, size_t maxRows) const
+        DepthQueryResult getPriceForVolume(bint isBuy, double volume) const
+        DepthQueryResult getVwapForVolume(bint isBuy, double volume) const
+        DepthQueryResult getVolumeForPrice(bint isBuy, double price) const
+        DepthQueryResult getVenueVolumesForVolume(bint isBuy, double volume, double *venueVolumes) const
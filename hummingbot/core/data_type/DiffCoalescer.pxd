@@ -0,0 +1,22 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint64_t
+from libcpp.vector cimport vector
+
+from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+
+cdef extern from "../cpp/DiffCoalescer.h":
+    cdef cppclass DiffCoalescer:
+        DiffCoalescer()
+        void setPriceIncrement(double priceIncrement)
+        int64_t addRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks) nogil
+        void addEntries(const vector[OrderBookEntry] &bids, const vector[OrderBookEntry] &asks, int64_t updateId) nogil
+        void discardUpTo(int64_t updateId) nogil
+        void clear() nogil
+        const double *getBidRows() nogil const
+        size_t getBidCount() nogil const
+        const double *getAskRows() nogil const
+        size_t getAskCount() nogil const
+        size_t getPendingCount() nogil const
+        int64_t getLastUpdateId() nogil const
+        uint64_t getMergedCount() const
@@ -0,0 +1,17 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint64_t
+from libcpp.vector cimport vector
+
+cdef extern from "../cpp/DiffRingBuffer.h":
+    cdef cppclass DiffRingBuffer:
+        DiffRingBuffer()
+        DiffRingBuffer(size_t capacity)
+        void reset(size_t capacity)
+        bint push(bint isBid, double price, double amount, int64_t updateId) nogil
+        bint pushRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks) nogil
+        size_t drain(vector[double] &bidRows, vector[double] &askRows, size_t maxRecords)
+        size_t capacity() const
+        size_t size() const
+        bint empty() const
+        uint64_t getDroppedCount() const
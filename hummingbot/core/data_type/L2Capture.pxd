@@ -0,0 +1,58 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint32_t, uint64_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+
+cdef extern from "../cpp/L2Capture.h":
+    cdef enum L2RecordType:
+        L2_RECORD_SNAPSHOT
+        L2_RECORD_DIFF
+        L2_RECORD_TRADE
+
+    cdef enum L2TradeSide:
+        L2_TRADE_BUY
+        L2_TRADE_SELL
+
+    cdef struct L2Record:
+        uint32_t type
+        uint32_t flags
+        double timestamp
+        int64_t updateId
+        const double *bidRows
+        size_t numBids
+        const double *askRows
+        size_t numAsks
+
+    cdef cppclass L2Recorder:
+        L2Recorder()
+        bint open(const string &path, const string &tradingPair)
+        void close()
+        bint isOpen() const
+        bint flush()
+        bint writeSnapshot(const vector[OrderBookEntry] &bids, const vector[OrderBookEntry] &asks,
+                           int64_t updateId, double timestamp)
+        bint writeDiffs(const vector[OrderBookEntry] &bids, const vector[OrderBookEntry] &asks,
+                        int64_t updateId, double timestamp)
+        bint writeSnapshotRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                               int64_t updateId, double timestamp)
+        bint writeDiffRows(const double *bidRows, size_t numBids, const double *askRows, size_t numAsks,
+                           int64_t updateId, double timestamp)
+        bint writeTrade(bint isBuy, double price, double amount, double tradeId, double timestamp)
+        uint64_t getRecordCount() const
+
+    cdef cppclass L2Reader:
+        L2Reader()
+        bint open(const string &path)
+        void close()
+        bint isOpen() const
+        bint next(L2Record &record)
+        double peekTimestamp() const
+        double getLastTimestamp() const
+        void rewind()
+        bint atEnd() const
+        size_t getPosition() const
+        size_t getSize() const
+        const string &getTradingPair() const
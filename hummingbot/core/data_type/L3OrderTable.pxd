@@ -0,0 +1,38 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint32_t
+from libcpp cimport bool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+cdef extern from "../cpp/L3OrderTable.h":
+    ctypedef uint32_t OrderHandle
+    cdef OrderHandle INVALID_ORDER_HANDLE
+
+    cdef cppclass L3OrderTable:
+        L3OrderTable()
+        OrderHandle open(const string &exchangeOrderId, const string &clientOrderId, bool isBid, double price,
+                         double size, int64_t updateId)
+        bool change(OrderHandle handle, double size, int64_t updateId)
+        bool fill(OrderHandle handle, double filledSize, int64_t updateId)
+        bool close(OrderHandle handle, int64_t updateId)
+        void clear()
+        OrderHandle findByExchangeOrderId(const string &exchangeOrderId) const
+        OrderHandle findByClientOrderId(const string &clientOrderId) const
+        bool isOpen(OrderHandle handle) const
+        const string &getExchangeOrderId(OrderHandle handle) const
+        const string &getClientOrderId(OrderHandle handle) const
+        bool getIsBid(OrderHandle handle) const
+        double getPrice(OrderHandle handle) const
+        double getSize(OrderHandle handle) const
+        int64_t getUpdateId(OrderHandle handle) const
+        size_t size() const
+        double getLevelAmount(bool isBid, double price) const
+        size_t getLevelOrderCount(bool isBid, double price) const
+        size_t getLevelCount(bool isBid) const
+        size_t exportLevels(bool isBid, vector[double] &rows, int64_t updateId) const
+        const double *getBidDiffRows() const
+        size_t getBidDiffCount() const
+        const double *getAskDiffRows() const
+        size_t getAskDiffCount() const
+        void clearDiffRows()
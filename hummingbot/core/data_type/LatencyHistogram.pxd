@@ -0,0 +1,15 @@
+# distutils: language=c++
+
+from libc.stdint cimport uint64_t
+
+cdef extern from "../cpp/LatencyHistogram.h":
+    cdef cppclass LatencyHistogram:
+        LatencyHistogram()
+        void record(uint64_t value)
+        void merge(const LatencyHistogram &other)
+        void clear()
+        uint64_t getCount() const
+        uint64_t getMin() const
+        uint64_t getMax() const
+        double getMean() const
+        uint64_t getValueAtPercentile(double percentile) const
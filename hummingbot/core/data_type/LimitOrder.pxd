@@ -2,6 +2,9 @@
 
 from libcpp cimport bool as cppbool
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+
+from hummingbot.core.data_type.SymbolTable cimport SymbolHandle
 
 cdef extern from "../cpp/LimitOrder.h":
     ctypedef struct PyObject
@@ -29,13 +32,57 @@ cdef extern from "../cpp/LimitOrder.h":
         LimitOrder(const LimitOrder &other)
         LimitOrder &operator=(const LimitOrder &other)
         string getClientOrderID()
+        SymbolHandle getClientOrderHandle()
         string getTradingPair()
+        SymbolHandle getTradingPairHandle()
         cppbool getIsBuy()
         string getBaseCurrency()
         string getQuoteCurrency()
         PyObject *getPrice()
+        double getPriceKey()
         PyObject *getQuantity()
         PyObject *getFilledQuantity()
         long long getCreationTimestamp()
         short int getStatus()
         string getPosition()
+
+    cdef cppclass LimitOrderSet:
+        cppclass iterator:
+            const LimitOrder &operator*()
+            iterator operator++()
+            iterator operator--()
+            bint operator==(iterator)
+            bint operator!=(iterator)
+        cppclass reverse_iterator:
+            const LimitOrder &operator*()
+            reverse_iterator operator++()
+            reverse_iterator operator--()
+            bint operator==(reverse_iterator)
+            bint operator!=(reverse_iterator)
+
+        LimitOrderSet()
+        LimitOrderSet(const LimitOrderSet &other)
+        LimitOrderSet &operator=(const LimitOrderSet &other)
+        iterator begin()
+        iterator end()
+        reverse_iterator rbegin()
+        reverse_iterator rend()
+        iterator find(const LimitOrder &order)
+        pair[iterator, cppbool] insert(const LimitOrder &order)
+        iterator erase(iterator position)
+        void clear()
+        size_t size()
+        cppbool empty()
+
+    pair[LimitOrderSet.iterator, cppbool] emplaceLimitOrder(LimitOrderSet &orders,
+                                                            const string &clientOrderID,
+                                                            const string &tradingPair,
+                                                            cppbool isBuy,
+                                                            const string &baseCurrency,
+                                                            const string &quoteCurrency,
+                                                            PyObject *price,
+                                                            PyObject *quantity,
+                                                            PyObject *filledQuantity,
+                                                            long long creationTimestamp,
+                                                            short int status,
+                                                            const string &position)
@@ -0,0 +1,46 @@
+# distutils: language=c++
+
+from libcpp cimport bool as cppbool
+from libcpp.vector cimport vector
+
+from hummingbot.core.data_type.LimitOrder cimport LimitOrder, LimitOrderSet
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+from hummingbot.core.data_type.SymbolTable cimport SymbolHandle
+
+cdef extern from "../cpp/MatchingEngine.h":
+    cdef struct MatchFill:
+        LimitOrderSet.iterator order
+        double price
+        double quantity
+        double remainingQuantity
+
+    cdef cppclass MatchingEngine:
+        MatchingEngine()
+        void setPartialFillsEnabled(cppbool enabled)
+        cppbool getPartialFillsEnabled()
+        void setQueuePositionsEnabled(cppbool enabled)
+        cppbool getQueuePositionsEnabled()
+        void addOrder(const LimitOrder &order, double quantity)
+        void addOrder(const LimitOrder &order, double quantity, OrderBookSide &queueBook)
+        cppbool removeOrder(SymbolHandle orderHandle)
+        cppbool contains(SymbolHandle orderHandle)
+        cppbool isQueuePositionTracked(SymbolHandle orderHandle)
+        double getRemainingQuantity(SymbolHandle orderHandle)
+        void restoreQuantity(SymbolHandle orderHandle, double quantity)
+        void clear()
+        size_t size()
+        size_t matchTrade(LimitOrderSet &restingOrders,
+                          cppbool isBuy,
+                          double tradePrice,
+                          double tradeQuantity,
+                          vector[MatchFill] &fills)
+        size_t matchTrade(LimitOrderSet &restingOrders,
+                          cppbool isBuy,
+                          double tradePrice,
+                          double tradeQuantity,
+                          OrderBookSide &queueBook,
+                          vector[MatchFill] &fills)
+        size_t matchCrossedBook(LimitOrderSet &restingOrders,
+                                cppbool isBuy,
+                                double oppositePrice,
+                                vector[MatchFill] &fills)
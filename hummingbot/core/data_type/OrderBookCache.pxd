@@ -0,0 +1,28 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+
+cdef extern from "../cpp/OrderBookCache.h":
+    cdef cppclass OrderBookCacheWriter:
+        OrderBookCacheWriter()
+        void capture(const OrderBookSide &bids, const OrderBookSide &asks, int64_t snapshotUid,
+                     int64_t lastDiffUid) nogil
+        bool write(const string &path, const string &tradingPair, double timestamp) nogil const
+
+    cdef cppclass OrderBookCacheReader:
+        OrderBookCacheReader()
+        bool open(const string &path) nogil
+        void close()
+        bool isOpen() const
+        const string &getTradingPair() const
+        int64_t getSnapshotUid() const
+        int64_t getLastDiffUid() const
+        double getTimestamp() const
+        const double *getBidRows() const
+        size_t getBidCount() const
+        const double *getAskRows() const
+        size_t getAskCount() const
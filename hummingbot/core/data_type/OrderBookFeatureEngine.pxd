@@ -0,0 +1,24 @@
+# distutils: language=c++
+
+from libcpp cimport bool as cppbool
+
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+
+cdef extern from "../cpp/OrderBookFeatureEngine.h":
+    cdef struct OrderBookFeatureValues:
+        double microprice
+        double depthImbalance
+        double bidPressureVolume
+        double askPressureVolume
+        double bookPressure
+        double weightedMid
+
+    cdef cppclass OrderBookFeatureEngine:
+        OrderBookFeatureEngine()
+        void configure(size_t depth, double pressureBps)
+        cppbool isEnabled() const
+        size_t getDepth() const
+        double getPressureBps() const
+        void update(const OrderBookSide &bidBook, const OrderBookSide &askBook) nogil
+        void clear()
+        const OrderBookFeatureValues &getValues() const
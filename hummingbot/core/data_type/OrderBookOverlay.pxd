@@ -0,0 +1,19 @@
+# distutils: language=c++
+
+from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+from hummingbot.core.data_type.OrderBookSide cimport DepthQueryResult, OrderBookSide
+
+cdef extern from "../cpp/OrderBookOverlay.h":
+    cdef cppclass OrderBookOverlay:
+        OrderBookOverlay()
+        OrderBookOverlay(const OrderBookSide &base, OrderBookSide &consumed)
+        void rewind()
+        bint next(OrderBookEntry &entry)
+        void commit()
+        size_t exportLevels(double *rows, size_t maxRows)
+        DepthQueryResult getPriceForVolume(double volume)
+        DepthQueryResult getVwapForVolume(double volume)
+        DepthQueryResult getPriceForQuoteVolume(double quoteVolume)
+        DepthQueryResult getQuoteVolumeForBaseAmount(double baseAmount)
+        DepthQueryResult getVolumeForPrice(double price)
+        DepthQueryResult getQuoteVolumeForPrice(double price)
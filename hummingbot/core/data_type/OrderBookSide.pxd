@@ -0,0 +1,79 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint64_t
+from libcpp.vector cimport vector
+from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+from hummingbot.core.data_type.SymbolTable cimport SymbolHandle
+
+cdef extern from "../cpp/OrderBookSide.h":
+    cdef struct DepthQueryResult:
+        double queryPrice
+        double queryVolume
+        double resultPrice
+        double resultVolume
+
+    cdef struct LevelCounts:
+        uint64_t inserted
+        uint64_t updated
+        uint64_t erased
+        uint64_t popped
+
+    cdef cppclass OrderBookSide:
+        cppclass iterator:
+            const OrderBookEntry &operator*()
+            iterator &operator++()
+            iterator operator++(int)
+            bint operator==(iterator)
+            bint operator!=(iterator)
+
+        OrderBookSide()
+        OrderBookSide(bint isBid)
+        OrderBookSide(const OrderBookSide &other)
+        OrderBookSide &operator=(const OrderBookSide &other)
+        iterator begin() const
+        iterator end() const
+        iterator find(double price) const
+        bint insert(const OrderBookEntry &entry)
+        bint erase(double price)
+        void applyDiff(const OrderBookEntry &entry)
+        void assign(const vector[OrderBookEntry] &entries) nogil
+        void popBest()
+        void clear()
+        void reserve(size_t capacity)
+        const OrderBookEntry &best() const
+        const OrderBookEntry &getLevel(size_t depth) const
+        size_t size() const
+        bint empty() const
+        bint getIsBid() const
+        void setFixedPointIncrements(double priceIncrement, double amountIncrement)
+        bint getFixedPointEnabled() const
+        double getPriceIncrement() const
+        double getAmountIncrement() const
+        void setDepthIndexEnabled(bint enabled)
+        bint getDepthIndexEnabled() const
+        void setTopLevelsBuffer(double *buffer, size_t capacity)
+        void syncTopLevels() nogil
+        size_t getTopLevelsCount() const
+        size_t exportLevels(double *rows, size_t maxRows) const
+        DepthQueryResult getPriceForVolume(double volume) const
+        DepthQueryResult getVwapForVolume(double volume) const
+        DepthQueryResult getPriceForQuoteVolume(double quoteVolume) const
+        DepthQueryResult getQuoteVolumeForBaseAmount(double baseAmount) const
+        DepthQueryResult getVolumeForPrice(double price) const
+        DepthQueryResult getQuoteVolumeForPrice(double price) const
+        double trackQueuePosition(SymbolHandle orderHandle, double price)
+        bint untrackQueuePosition(SymbolHandle orderHandle)
+        double getQueuePosition(SymbolHandle orderHandle) const
+        void recordQueueTrade(double price, double volume)
+        size_t getQueuePositionCount() const
+        const LevelCounts &getLevelCounts() const
+        void clearLevelCounts()
+
+    # The book mutating core touches no Python objects, so it can run without the GIL.
+    void truncateOverlapEntries(OrderBookSide &bid_book, OrderBookSide &ask_book, const bint &dex) nogil
+    int64_t applyDiffs(OrderBookSide &bid_book, OrderBookSide &ask_book,
+                       const vector[OrderBookEntry] &bids, const vector[OrderBookEntry] &asks,
+                       const bint &dex, double &best_bid, double &best_ask) nogil
+    int64_t applyDiffs(OrderBookSide &bid_book, OrderBookSide &ask_book,
+                       const double *bid_rows, size_t num_bids, const double *ask_rows, size_t num_asks,
+                       const bint &dex, double &best_bid, double &best_ask) nogil
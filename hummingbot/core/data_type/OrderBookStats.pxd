@@ -0,0 +1,32 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint64_t
+
+from hummingbot.core.data_type.LatencyHistogram cimport LatencyHistogram
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+
+cdef extern from "../cpp/OrderBookStats.h":
+    cdef struct OrderBookCounters:
+        uint64_t diffBatches
+        uint64_t diffLevels
+        uint64_t truncations
+        uint64_t truncatedLevels
+        uint64_t snapshots
+        uint64_t updateIdGaps
+
+    cdef cppclass OrderBookStats:
+        OrderBookStats()
+        @staticmethod
+        int64_t getMonotonicNanoseconds() nogil
+        @staticmethod
+        uint64_t getTruncatedLevelCount(const OrderBookSide &bidBook, const OrderBookSide &askBook) nogil
+        void recordDiffBatch(int64_t elapsedNanoseconds, size_t numLevels, uint64_t truncatedLevels) nogil
+        void recordSnapshot(int64_t elapsedNanoseconds) nogil
+        void recordUpdateIdGap()
+        void recordExchangeLag(int64_t lagNanoseconds)
+        void clear()
+        const OrderBookCounters &getCounters() const
+        const LatencyHistogram &getDiffApplyTimes() const
+        const LatencyHistogram &getDiffBatchLevels() const
+        const LatencyHistogram &getSnapshotApplyTimes() const
+        const LatencyHistogram &getExchangeLags() const
@@ -0,0 +1,29 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint64_t
+
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+
+cdef extern from "../cpp/OrderBookSync.h":
+    cdef struct TopOfBook:
+        double bidPrice
+        double bidAmount
+        double askPrice
+        double askAmount
+        int64_t updateId
+        uint64_t version
+
+    cdef cppclass OrderBookSync:
+        OrderBookSync()
+        void lock() nogil
+        void unlock() nogil
+        void publishTopOfBook(const OrderBookSide &bidBook,
+                              const OrderBookSide &askBook,
+                              double bestBid,
+                              double bestAsk,
+                              int64_t updateId) nogil
+        TopOfBook readTopOfBook() nogil const
+        uint64_t getVersion() nogil const
+        void storeCounters(uint64_t bookVersion, int64_t lastDiffUid) nogil
+        uint64_t getBookVersion() nogil const
+        int64_t getLastDiffUid() nogil const
@@ -0,0 +1,37 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t, uint64_t
+from libcpp cimport bool as cppbool
+
+from hummingbot.core.data_type.DiffRingBuffer cimport DiffRingBuffer
+from hummingbot.core.data_type.OrderBookFeatureEngine cimport OrderBookFeatureEngine
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+from hummingbot.core.data_type.OrderBookStats cimport OrderBookStats
+from hummingbot.core.data_type.OrderBookSync cimport OrderBookSync
+
+cdef extern from "../cpp/OrderBookWorkerPool.h":
+    cdef struct MaintainedOrderBook:
+        OrderBookSide *bidBook
+        OrderBookSide *askBook
+        DiffRingBuffer *diffRing
+        OrderBookSync *sync
+        double *bestBid
+        double *bestAsk
+        int64_t *lastDiffUid
+        uint64_t *version
+        OrderBookStats *stats
+        OrderBookFeatureEngine *features
+        cppbool dex
+
+    cdef cppclass OrderBookWorkerPool:
+        OrderBookWorkerPool()
+        OrderBookWorkerPool(size_t numThreads)
+        cppbool addBook(const MaintainedOrderBook &book)
+        cppbool removeBook(const OrderBookSync *sync)
+        size_t getBookCount() const
+        void setIdleSleepMicroseconds(int64_t microseconds)
+        cppbool start()
+        void stop() nogil
+        cppbool isRunning() const
+        size_t getNumThreads() const
+        uint64_t getAppliedCount() const
@@ -1,6 +1,11 @@
 # distutils: language=c++
 
+from libcpp cimport bool as cppbool
+from libcpp.set cimport set as cpp_set
 from libcpp.string cimport string
+from libcpp.utility cimport pair
+
+from hummingbot.core.data_type.SymbolTable cimport SymbolHandle
 
 cdef extern from "../cpp/OrderExpirationEntry.h":
     cdef cppclass OrderExpirationEntry:
@@ -12,7 +17,16 @@ cdef extern from "../cpp/OrderExpirationEntry.h":
         OrderExpirationEntry(const OrderExpirationEntry &other)
         OrderExpirationEntry &operator=(const OrderExpirationEntry &other)
         string getClientOrderID()
+        SymbolHandle getClientOrderHandle()
         string getTradingPair()
         double getTimestamp()
         double getExpiration()
         double getExpirationTimestamp()
+
+    ctypedef cpp_set[OrderExpirationEntry] OrderExpirationSet
+
+    pair[OrderExpirationSet.iterator, cppbool] emplaceOrderExpirationEntry(OrderExpirationSet &entries,
+                                                                           const string &trading_pair,
+                                                                           const string &order_id,
+                                                                           double timestamp,
+                                                                           double expiration_timestamp)
@@ -0,0 +1,24 @@
+# distutils: language=c++
+
+from libcpp cimport bool as cppbool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from hummingbot.core.data_type.OrderExpirationEntry cimport OrderExpirationEntry
+from hummingbot.core.data_type.SymbolTable cimport SymbolHandle
+
+cdef extern from "../cpp/OrderExpirationWheel.h":
+    cdef cppclass OrderExpirationWheel:
+        OrderExpirationWheel()
+        OrderExpirationWheel(double tickSize, size_t numSlots)
+        cppbool insert(const string &tradingPair,
+                       const string &orderId,
+                       double timestamp,
+                       double expirationTimestamp)
+        cppbool cancel(SymbolHandle orderHandle)
+        cppbool contains(SymbolHandle orderHandle)
+        size_t popExpired(double now, vector[OrderExpirationEntry] &expired)
+        double getNextExpirationTimestamp()
+        void clear()
+        size_t size()
+        cppbool empty()
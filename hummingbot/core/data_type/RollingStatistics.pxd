@@ -0,0 +1,23 @@
+# distutils: language=c++
+
+from libcpp cimport bool as cppbool
+
+cdef extern from "../cpp/RollingStatistics.h":
+    cdef cppclass RollingStatistics:
+        RollingStatistics()
+        RollingStatistics(size_t capacity)
+        void add(double value)
+        void clear()
+        void setCapacity(size_t capacity)
+        size_t getCapacity()
+        size_t size()
+        cppbool empty()
+        cppbool isFull()
+        double getLast()
+        double getMean()
+        double getVariance()
+        double getStdDev()
+        double getSumSquaredDiffs()
+        double getLogReturnVariance()
+        double getEma(double alpha)
+        size_t copyTo(double *out)
@@ -0,0 +1,27 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t
+from libcpp.vector cimport vector
+from hummingbot.core.data_type.L2Capture cimport L2Recorder
+from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+
+cdef extern from "../cpp/SnapshotReconciler.h":
+    cdef enum ReconcileStatus:
+        RECONCILE_SYNCED
+        RECONCILE_GAP
+
+    cdef struct ReconcileResult:
+        int status
+        int64_t lastUpdateId
+        size_t appliedDiffs
+        size_t skippedDiffs
+        int64_t gapFirstUpdateId
+
+    ReconcileResult reconcileSnapshotAndDiffs(OrderBookSide &bid_book, OrderBookSide &ask_book,
+                                              const vector[OrderBookEntry] &snapshot_bids,
+                                              const vector[OrderBookEntry] &snapshot_asks,
+                                              int64_t snapshot_update_id,
+                                              const double *diff_rows, size_t num_diff_rows,
+                                              const bint &dex, double &best_bid, double &best_ask,
+                                              L2Recorder *recorder) nogil
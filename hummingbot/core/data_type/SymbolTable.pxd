@@ -0,0 +1,20 @@
+# distutils: language=c++
+
+from libc.stdint cimport uint32_t
+from libcpp cimport bool as cppbool
+from libcpp.string cimport string
+
+cdef extern from "../cpp/SymbolTable.h":
+    ctypedef uint32_t SymbolHandle
+
+    cdef cppclass Symbol:
+        Symbol()
+        Symbol(const string &name)
+        Symbol(const Symbol &other)
+        Symbol &operator=(const Symbol &other)
+        SymbolHandle getHandle()
+        const string &getName()
+
+    SymbolHandle internSymbol(const string &name)
+    cppbool findSymbol(const string &name, SymbolHandle &handle)
+    const string &getSymbolName(SymbolHandle handle)
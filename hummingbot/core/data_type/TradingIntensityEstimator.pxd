@@ -0,0 +1,23 @@
+# distutils: language=c++
+
+from libcpp cimport bool as cppbool
+
+cdef extern from "../cpp/TradingIntensityEstimator.h":
+    cdef cppclass TradingIntensityEstimator:
+        TradingIntensityEstimator()
+        TradingIntensityEstimator(size_t samplingLength)
+        void setSamplingLength(size_t samplingLength)
+        size_t getSamplingLength()
+        void registerTrade(double timestamp, double price, double amount)
+        void calculate(double timestamp, double midPrice)
+        cppbool estimate()
+        void clearQuotes()
+        void appendQuote(double timestamp, double price)
+        size_t getQuoteCount()
+        double getQuoteTimestamp(size_t index)
+        double getQuotePrice(size_t index)
+        size_t getSampleCount()
+        size_t getPriceLevelCount()
+        cppbool isFull()
+        double getAlpha()
+        double getKappa()
@@ -1,40 +1,73 @@
 # distutils: language=c++
-# distutils: sources=hummingbot/core/cpp/OrderBookEntry.cpp
+# distutils: sources=['hummingbot/core/cpp/OrderBookEntry.cpp', 'hummingbot/core/cpp/OrderBookOverlay.cpp', 'hummingbot/core/cpp/OrderBookSide.cpp']
 
-from typing import Iterator
+from typing import Iterator, Optional, Tuple
+
+import numpy as np
 
 from cython.operator cimport address as ref, dereference as deref, postincrement as inc
 from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
-from libcpp.set cimport set
+from hummingbot.core.data_type.OrderBookSide cimport DepthQueryResult, OrderBookSide
 from libcpp.vector cimport vector
 
 from hummingbot.core.data_type.common import TradeType
+from hummingbot.core.data_type.order_book_query_result import OrderBookQueryResult
 from hummingbot.core.data_type.order_book_row import OrderBookRow
 
+NaN = float("nan")
+
+
+cdef inline OrderBookQueryResult c_depth_query_result(DepthQueryResult result):
+    return OrderBookQueryResult(result.queryPrice, result.queryVolume, result.resultPrice, result.resultVolume)
+
+
+cdef object c_export_overlay(OrderBookOverlay *overlay, size_t max_levels, object out):
+    cdef:
+        double[:, ::1] rows
+        size_t num_rows = 0
+
+    if out is None:
+        out = np.empty((max_levels, 3), dtype=np.float64)
+    rows = out
+    if rows.shape[1] != 3:
+        raise ValueError("Snapshot buffers must have 3 columns: [price, amount, update_id].")
+    if rows.shape[0] > 0:
+        num_rows = deref(overlay).exportLevels(&rows[0, 0], rows.shape[0])
+    return out[:num_rows]
+
+
 cdef class CompositeOrderBook(OrderBook):
     """
     Record orders that are bought during back testing and used to simulate order book consumption without modifying
     the actual order book.
     Override the order book bid_entries, ask_entries methods to return the composite order book entries
+
+    The composite view is never materialised: each side is read through a native OrderBookOverlay, which takes the
+    recorded fills off the original levels as it walks them. The depth queries run on the overlays in C++.
     """
     def __init__(self, order_book: OrderBook = None):
         super().__init__()
         self._traded_order_book = OrderBook()
+        self._bid_overlay = OrderBookOverlay(self._bid_book, self._traded_order_book._bid_book)
+        self._ask_overlay = OrderBookOverlay(self._ask_book, self._traded_order_book._ask_book)
 
     @property
     def traded_order_book(self) -> OrderBook:
         return self._traded_order_book
 
     def clear_traded_order_book(self):
+        self.c_lock_book()
         self._traded_order_book._bid_book.clear()
         self._traded_order_book._ask_book.clear()
+        self._version += 1
+        self.c_unlock_book()
 
     def record_filled_order(self, order_fill_event):
         cdef:
             vector[OrderBookEntry] cpp_bids
             vector[OrderBookEntry] cpp_asks
-            set[OrderBookEntry].reverse_iterator bid_order_it = self._traded_order_book._bid_book.rbegin()
-            set[OrderBookEntry].iterator ask_order_it = self._traded_order_book._ask_book.begin()
+            OrderBookSide.iterator bid_order_it = self._traded_order_book._bid_book.begin()
+            OrderBookSide.iterator ask_order_it = self._traded_order_book._ask_book.begin()
             OrderBookEntry entry
 
         price = order_fill_event.price
@@ -57,7 +90,7 @@ cdef class CompositeOrderBook(OrderBook):
             cpp_asks.push_back(OrderBookEntry(price, amount, timestamp))
 
         elif order_fill_event.trade_type is TradeType.SELL:
-            while bid_order_it != self._traded_order_book._bid_book.rend():
+            while bid_order_it != self._traded_order_book._bid_book.end():
                 entry = deref(bid_order_it)
                 if entry.getPrice() == price:
                     amount += entry.getAmount()
@@ -71,6 +104,23 @@ cdef class CompositeOrderBook(OrderBook):
             cpp_bids.push_back(OrderBookEntry(price, amount, timestamp))
 
         self._traded_order_book.c_apply_diffs(cpp_bids, cpp_asks, timestamp)
+        self.c_lock_book()
+        self._version += 1
+        self.c_unlock_book()
+
+    def snapshot_arrays(self,
+                        bids_out: Optional[np.ndarray] = None,
+                        asks_out: Optional[np.ndarray] = None) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Same as OrderBook.snapshot_arrays(), but exports the composite bid_entries() and ask_entries() views.
+        """
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        try:
+            return (c_export_overlay(ref(self._bid_overlay), self._bid_book.size(), bids_out),
+                    c_export_overlay(ref(self._ask_overlay), self._ask_book.size(), asks_out))
+        finally:
+            self.c_unlock_book()
 
     def original_bid_entries(self) -> Iterator[OrderBookRow]:
         return super().bid_entries()
@@ -79,116 +129,103 @@ cdef class CompositeOrderBook(OrderBook):
         return super().ask_entries()
 
     def bid_entries(self) -> Iterator[OrderBookRow]:
+        # Each generator walks with an overlay of its own, by depth rather than by iterator, since the books may be
+        # updated while the generator is suspended. See OrderBook.bid_entries().
         cdef:
-            set[OrderBookEntry].reverse_iterator order_it = self._bid_book.rbegin()
-            set[OrderBookEntry].reverse_iterator traded_order_it = self._traded_order_book._bid_book.rbegin()
-            OrderBookEntry traded_order_entry
-            OrderBookEntry original_order_entry
-            vector[OrderBookEntry] cpp_asks_changes
-            vector[OrderBookEntry] cpp_bids_changes
-
-        while order_it != self._bid_book.rend():
-            original_order_entry = deref(order_it)
-            original_order_price = original_order_entry.getPrice()
-            original_order_amount = original_order_entry.getAmount()
-            original_order_update_id = original_order_entry.getUpdateId()
-
-            while traded_order_it != self._traded_order_book._bid_book.rend():
-                traded_order_entry = deref(traded_order_it)
-                traded_order_price = traded_order_entry.getPrice()
-                traded_order_amount = traded_order_entry.getAmount()
-                traded_order_update_id = traded_order_entry.getUpdateId()
-
-                # Found matching price for the recorded filled order, return composite order book row
-                if traded_order_price == original_order_price:
-                    composite_amount = original_order_amount - traded_order_amount
-                    if composite_amount > 0:
-                        yield OrderBookRow(original_order_price, composite_amount, original_order_update_id)
-                    else:
-                        cpp_bids_changes.push_back(OrderBookEntry(original_order_price,
-                                                                  min(original_order_amount, traded_order_amount),
-                                                                  traded_order_update_id))
-                    inc(traded_order_it)
-                    # continue to next original order book row
-                    break
-                # Recorded filled order price is outside of the bid price range
-                elif traded_order_price > original_order_price:
-                    # Remove the recorded entry and increment the pointer
-                    cpp_bids_changes.push_back(OrderBookEntry(traded_order_price, 0, traded_order_update_id))
-                    inc(traded_order_it)
-                # Recorded filled order price is within lower end of the bid price range, yield original bid entry
-                elif traded_order_price < original_order_price:
-                    yield OrderBookRow(original_order_price, original_order_amount, original_order_update_id)
-                    break
-            else:
-                yield OrderBookRow(original_order_price, original_order_amount, original_order_update_id)
-
-            inc(order_it)
-
-        self._traded_order_book.c_apply_diffs(cpp_bids_changes, cpp_asks_changes, self._last_diff_uid)
+            OrderBookOverlay *overlay
+            OrderBookEntry entry
+        self.c_flush_coalesced_diffs()
+        overlay = new OrderBookOverlay(self._bid_book, self._traded_order_book._bid_book)
+        try:
+            while deref(overlay).next(entry):
+                yield OrderBookRow(entry.getPrice(), entry.getAmount(), entry.getUpdateId())
+            deref(overlay).commit()
+        finally:
+            del overlay
 
     def ask_entries(self) -> Iterator[OrderBookRow]:
         cdef:
-            set[OrderBookEntry].iterator order_it = self._ask_book.begin()
-            set[OrderBookEntry].iterator traded_order_it = self._traded_order_book._ask_book.begin()
-            OrderBookEntry original_order_entry
-            OrderBookEntry traded_order_entry
-            vector[OrderBookEntry] cpp_asks_changes
-            vector[OrderBookEntry] cpp_bids_changes
-
-        while order_it != self._ask_book.end():
-            original_order_entry = deref(order_it)
-            original_order_price = original_order_entry.getPrice()
-            original_order_amount = original_order_entry.getAmount()
-            original_order_update_id = original_order_entry.getUpdateId()
-
-            while traded_order_it != self._traded_order_book._ask_book.end():
-                traded_order_entry = deref(traded_order_it)
-                traded_order_price = traded_order_entry.getPrice()
-                traded_order_amount = traded_order_entry.getAmount()
-                traded_order_update_id = traded_order_entry.getUpdateId()
-
-                if traded_order_price == original_order_price:
-                    composite_amount = original_order_amount - traded_order_amount
-                    if composite_amount > 0:
-                        yield OrderBookRow(original_order_price, composite_amount, original_order_update_id)
-                    else:
-                        cpp_asks_changes.push_back(OrderBookEntry(original_order_price,
-                                                                  min(original_order_amount, traded_order_amount),
-                                                                  traded_order_update_id))
-                    inc(traded_order_it)
-                    # continue to next original order book row
-                    break
-                # Recorded filled order price is within upper end of the ask price range, yield original ask entry
-                elif traded_order_price > original_order_price:
-                    yield OrderBookRow(original_order_price, original_order_amount, original_order_update_id)
-                    break
-                # Recorded filled order price is outside of the ask price range, remove the recorded ask order
-                elif traded_order_price < original_order_price:
-                    cpp_asks_changes.push_back(OrderBookEntry(traded_order_price, 0, traded_order_update_id))
-                    inc(traded_order_it)
-
-            else:
-                yield OrderBookRow(original_order_price, original_order_amount, original_order_update_id)
-
-            inc(order_it)
+            OrderBookOverlay *overlay
+            OrderBookEntry entry
+        self.c_flush_coalesced_diffs()
+        overlay = new OrderBookOverlay(self._ask_book, self._traded_order_book._ask_book)
+        try:
+            while deref(overlay).next(entry):
+                yield OrderBookRow(entry.getPrice(), entry.getAmount(), entry.getUpdateId())
+            deref(overlay).commit()
+        finally:
+            del overlay
 
-        self._traded_order_book.c_apply_diffs(cpp_bids_changes, cpp_asks_changes, self._last_diff_uid)
+    cdef OrderBookOverlay *c_get_overlay(self, bint is_buy):
+        self.c_flush_coalesced_diffs()
+        return ref(self._ask_overlay) if is_buy else ref(self._bid_overlay)
 
     cdef double c_get_price(self, bint is_buy) except? -1:
         cdef:
-            set[OrderBookEntry] *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            OrderBookOverlay *overlay = self.c_get_overlay(is_buy)
+            OrderBookEntry best
+            bint found
+        self.c_flush_coalesced_diffs()
         if deref(book).size() < 1:
             raise EnvironmentError("Order book is empty - no price quote is possible.")
 
-        ask_it = self.ask_entries()
-        bid_it = self.bid_entries()
-        try:
-            if is_buy:
-                best_ask = next(ask_it)
-                return best_ask.price
-            else:
-                best_bid = next(bid_it)
-                return best_bid.price
-        except Exception:
-            raise
+        self.c_lock_book()
+        deref(overlay).rewind()
+        found = deref(overlay).next(best)
+        deref(overlay).commit()
+        self.c_unlock_book()
+        if not found:
+            raise EnvironmentError("Order book has been consumed - no price quote is possible.")
+        return best.getPrice()
+
+    # The depth queries below run on the composite views natively, so they account for the volume already consumed by
+    # recorded fills without copying the book.
+
+    cdef OrderBookQueryResult c_get_price_for_volume(self, bint is_buy, double volume):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_book()
+        result = deref(self.c_get_overlay(is_buy)).getPriceForVolume(volume)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_vwap_for_volume(self, bint is_buy, double volume):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_book()
+        result = deref(self.c_get_overlay(is_buy)).getVwapForVolume(volume)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_price_for_quote_volume(self, bint is_buy, double quote_volume):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_book()
+        result = deref(self.c_get_overlay(is_buy)).getPriceForQuoteVolume(quote_volume)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_quote_volume_for_base_amount(self, bint is_buy, double base_amount):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_book()
+        result = deref(self.c_get_overlay(is_buy)).getQuoteVolumeForBaseAmount(base_amount)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_volume_for_price(self, bint is_buy, double price):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_book()
+        result = deref(self.c_get_overlay(is_buy)).getVolumeForPrice(price)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_quote_volume_for_price(self, bint is_buy, double price):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_book()
+        result = deref(self.c_get_overlay(is_buy)).getQuoteVolumeForPrice(price)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
@@ -0,0 +1,22 @@
+# distutils: language=c++
+
+from libcpp.vector cimport vector
+from hummingbot.core.data_type.ConsolidatedBook cimport ConsolidatedBook
+from hummingbot.core.data_type.order_book cimport OrderBook
+from hummingbot.core.data_type.order_book_query_result cimport OrderBookQueryResult
+
+
+cdef class ConsolidatedOrderBook:
+    cdef:
+        ConsolidatedBook _book
+        list _venues
+        list _order_books
+        list _lock_order
+        vector[double] _venue_volumes
+
+    cdef c_lock_books(self)
+    cdef c_unlock_books(self)
+    cdef double c_get_price(self, bint is_buy) except? -1
+    cdef OrderBookQueryResult c_get_price_for_volume(self, bint is_buy, double volume)
+    cdef OrderBookQueryResult c_get_vwap_for_volume(self, bint is_buy, double volume)
+    cdef OrderBookQueryResult c_get_volume_for_price(self, bint is_buy, double price)
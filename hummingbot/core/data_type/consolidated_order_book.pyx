@@ -0,0 +1,171 @@
+# distutils: language=c++
+# distutils: sources=['hummingbot/core/cpp/ConsolidatedBook.cpp', 'hummingbot/core/cpp/OrderBookEntry.cpp', 'hummingbot/core/cpp/OrderBookSide.cpp']
+
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+from hummingbot.core.data_type.ConsolidatedBook cimport VenueLevel
+from hummingbot.core.data_type.OrderBookSide cimport DepthQueryResult
+
+from hummingbot.core.data_type.order_book_query_result import OrderBookQueryResult
+
+
+cdef inline OrderBookQueryResult c_depth_query_result(DepthQueryResult result):
+    return OrderBookQueryResult(result.queryPrice, result.queryVolume, result.resultPrice, result.resultVolume)
+
+
+cdef class ConsolidatedOrderBook:
+    """
+    One view over the order books of the same trading pair on several venues, such as the books of one pair in the
+    order book trackers of several connectors.
+
+    The books are merged natively at query time, so each query walks the consolidated ladder in one call instead of
+    querying every book from Python. Nothing is copied, and nothing needs to be kept in sync as the books are updated.
+    Levels keep the venue they come from, so a query can also tell how a volume would be split across the venues.
+    """
+
+    def __init__(self, order_books: Optional[Dict[str, OrderBook]] = None):
+        self._venues = []
+        self._order_books = []
+        self._lock_order = []
+        for venue, order_book in (order_books or {}).items():
+            self.add_order_book(venue, order_book)
+
+    def add_order_book(self, venue: str, order_book: OrderBook):
+        cdef:
+            OrderBook typed_order_book = order_book
+        if venue in self._venues:
+            raise ValueError(f"Venue {venue} is already in the consolidated book.")
+        if any(existing is order_book for existing in self._order_books):
+            raise ValueError(f"The order book of venue {venue} is already in the consolidated book.")
+        # The native book points into the order book, which is kept alive by the list.
+        self._book.addVenue(typed_order_book._bid_book, typed_order_book._ask_book)
+        self._venues.append(venue)
+        self._order_books.append(order_book)
+        self._lock_order = sorted(self._order_books, key=id)
+        self._venue_volumes.resize(len(self._venues))
+
+    def clear(self):
+        self._book.clear()
+        self._venues = []
+        self._order_books = []
+        self._lock_order = []
+        self._venue_volumes.clear()
+
+    @property
+    def venues(self) -> List[str]:
+        return list(self._venues)
+
+    @property
+    def order_books(self) -> Dict[str, OrderBook]:
+        return dict(zip(self._venues, self._order_books))
+
+    cdef c_lock_books(self):
+        cdef:
+            OrderBook order_book
+        # The native book reads the sides directly, so the diffs each book has coalesced are applied first. Books are
+        # locked in the order of their addresses, the same order for every consolidated book, so two consolidated books
+        # sharing order books added in different orders cannot deadlock each other.
+        for order_book in self._order_books:
+            order_book.c_flush_coalesced_diffs()
+        for order_book in self._lock_order:
+            order_book.c_lock_book()
+
+    cdef c_unlock_books(self):
+        cdef:
+            OrderBook order_book
+        for order_book in reversed(self._lock_order):
+            order_book.c_unlock_book()
+
+    def get_best(self, is_buy: bool) -> Tuple[float, float, str]:
+        """
+        Returns the (price, amount, venue) of the best level across the venues.
+        """
+        cdef:
+            VenueLevel level
+            bint found
+        self.c_lock_books()
+        found = self._book.getBest(is_buy, level)
+        self.c_unlock_books()
+        if not found:
+            raise EnvironmentError("Consolidated order book is empty - no price quote is possible.")
+        return level.price, level.amount, self._venues[level.venue]
+
+    cdef double c_get_price(self, bint is_buy) except? -1:
+        cdef:
+            VenueLevel level
+            bint found
+        self.c_lock_books()
+        found = self._book.getBest(is_buy, level)
+        self.c_unlock_books()
+        if not found:
+            raise EnvironmentError("Consolidated order book is empty - no price quote is possible.")
+        return level.price
+
+    def get_price(self, is_buy: bool) -> float:
+        return self.c_get_price(is_buy)
+
+    cdef OrderBookQueryResult c_get_price_for_volume(self, bint is_buy, double volume):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_books()
+        result = self._book.getPriceForVolume(is_buy, volume)
+        self.c_unlock_books()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_vwap_for_volume(self, bint is_buy, double volume):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_books()
+        result = self._book.getVwapForVolume(is_buy, volume)
+        self.c_unlock_books()
+        return c_depth_query_result(result)
+
+    cdef OrderBookQueryResult c_get_volume_for_price(self, bint is_buy, double price):
+        cdef:
+            DepthQueryResult result
+        self.c_lock_books()
+        result = self._book.getVolumeForPrice(is_buy, price)
+        self.c_unlock_books()
+        return c_depth_query_result(result)
+
+    def get_price_for_volume(self, is_buy: bool, volume: float) -> OrderBookQueryResult:
+        return self.c_get_price_for_volume(is_buy, volume)
+
+    def get_vwap_for_volume(self, is_buy: bool, volume: float) -> OrderBookQueryResult:
+        return self.c_get_vwap_for_volume(is_buy, volume)
+
+    def get_volume_for_price(self, is_buy: bool, price: float) -> OrderBookQueryResult:
+        return self.c_get_volume_for_price(is_buy, price)
+
+    def get_venue_volumes_for_volume(self, is_buy: bool, volume: float) -> Dict[str, float]:
+        """
+        Splits the volume across the venues the way sweeping the consolidated ladder would fill it, best prices first.
+        Venues that get nothing are left out.
+        """
+        cdef:
+            size_t i
+        if self._venue_volumes.size() == 0:
+            return {}
+        self.c_lock_books()
+        self._book.getVenueVolumesForVolume(is_buy, volume, self._venue_volumes.data())
+        self.c_unlock_books()
+        return {self._venues[i]: self._venue_volumes[i]
+                for i in range(self._venue_volumes.size()) if self._venue_volumes[i] > 0}
+
+    def ladder_array(self, is_buy: bool, max_levels: int = 100) -> Tuple[np.ndarray, List[str]]:
+        """
+        Exports the top max_levels of the consolidated ladder as a float64 (N, 3) [price, amount, venue_index] array,
+        best level first, along with the venues the indices refer to.
+        """
+        cdef:
+            double[:, ::1] rows
+            size_t num_rows = 0
+        out = np.empty((max_levels, 3), dtype=np.float64)
+        rows = out
+        if max_levels > 0:
+            self.c_lock_books()
+            num_rows = self._book.exportLevels(is_buy, &rows[0, 0], max_levels)
+            self.c_unlock_books()
+        return out[:num_rows], self.venues
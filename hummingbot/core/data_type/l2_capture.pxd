@@ -0,0 +1,24 @@
+# distutils: language=c++
+
+from hummingbot.core.data_type.L2Capture cimport L2Reader as CPPL2Reader, L2Recorder as CPPL2Recorder
+from hummingbot.core.data_type.order_book cimport OrderBook
+from hummingbot.core.time_iterator cimport TimeIterator
+
+
+cdef class L2Recorder:
+    cdef CPPL2Recorder *_recorder
+    cdef str _path
+    cdef str _trading_pair
+
+
+cdef class L2Replay:
+    cdef CPPL2Reader *_reader
+    cdef str _path
+    cdef str _trading_pair
+
+    cdef size_t c_replay(self, list order_books, double until_timestamp, size_t max_records, bint apply_trades)
+
+
+cdef class L2ReplayIterator(TimeIterator):
+    cdef L2Replay _replay
+    cdef list _order_books
@@ -0,0 +1,293 @@
+# distutils: language=c++
+# distutils: sources=['hummingbot/core/cpp/L2Capture.cpp', 'hummingbot/core/cpp/OrderBookEntry.cpp']
+from decimal import Decimal
+from typing import List, Optional, Tuple
+
+import numpy as np
+
+from libc.math cimport INFINITY, NAN, isnan
+from libc.stdint cimport int64_t
+from libcpp.vector cimport vector
+
+from hummingbot.core.data_type.common import TradeType
+from hummingbot.core.data_type.L2Capture cimport (
+    L2_RECORD_DIFF,
+    L2_RECORD_SNAPSHOT,
+    L2_RECORD_TRADE,
+    L2_TRADE_BUY,
+    L2Record,
+)
+from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+from hummingbot.core.event.events import OrderBookTradeEvent
+from hummingbot.core.time_iterator cimport TimeIterator
+
+RECORD_TYPE_SNAPSHOT = L2_RECORD_SNAPSHOT
+RECORD_TYPE_DIFF = L2_RECORD_DIFF
+RECORD_TYPE_TRADE = L2_RECORD_TRADE
+
+
+cdef vector[OrderBookEntry] c_rows_to_entries(const double[:, :] rows, int64_t default_update_id):
+    cdef:
+        vector[OrderBookEntry] entries
+        Py_ssize_t i
+
+    entries.reserve(rows.shape[0])
+    for i in range(rows.shape[0]):
+        entries.push_back(OrderBookEntry(rows[i, 0], rows[i, 1],
+                                         <int64_t>rows[i, 2] if rows.shape[1] > 2 else default_update_id))
+    return entries
+
+
+cdef object c_rows_to_array(const double *rows, size_t num_rows):
+    if num_rows == 0:
+        return np.empty((0, 3), dtype="float64")
+    return np.asarray(<double[:num_rows * 3]><double *>rows).reshape(num_rows, 3).copy()
+
+
+cdef class L2Recorder:
+    """
+    Appends the L2 feed of one trading pair to a binary capture file: snapshots, diffs and trades, each stamped with a
+    timestamp. Records are written as fixed size headers followed by packed [price, amount, update_id] rows, the same
+    layout the order book applies natively, so L2Replay can feed them back without converting anything.
+
+    Attach the recorder to an OrderBook to capture everything applied to it. Reopening an existing file appends to it.
+    """
+
+    def __cinit__(self, str path, str trading_pair):
+        self._recorder = new CPPL2Recorder()
+        self._path = path
+        self._trading_pair = trading_pair
+
+    def __init__(self, str path, str trading_pair):
+        if not self._recorder.open(path.encode("utf8"), trading_pair.encode("utf8")):
+            raise IOError(f"Could not open {path} as an L2 capture file for {trading_pair}.")
+
+    def __dealloc__(self):
+        if self._recorder != NULL:
+            del self._recorder
+            self._recorder = NULL
+
+    @property
+    def path(self) -> str:
+        return self._path
+
+    @property
+    def trading_pair(self) -> str:
+        return self._trading_pair
+
+    @property
+    def record_count(self) -> int:
+        """
+        Number of records written since the file was opened.
+        """
+        return self._recorder.getRecordCount()
+
+    def attach(self, OrderBook order_book):
+        """
+        Records every snapshot, diff and trade applied to order_book from now on, stamped with the local wall clock.
+        Diffs applied by an OrderBookWorkerPool are not recorded.
+        """
+        order_book._l2_recorder = self._recorder
+        order_book._l2_recorder_owner = self
+
+    def detach(self, OrderBook order_book):
+        if order_book._l2_recorder_owner is self:
+            order_book._l2_recorder = NULL
+            order_book._l2_recorder_owner = None
+
+    def write_snapshot(self, bids_array: np.ndarray, asks_array: np.ndarray, int64_t update_id,
+                       double timestamp = NAN):
+        if not self._recorder.writeSnapshot(c_rows_to_entries(bids_array, update_id),
+                                            c_rows_to_entries(asks_array, update_id),
+                                            update_id, timestamp):
+            raise IOError(f"Failed to write to {self._path}.")
+
+    def write_diffs(self, bids_array: np.ndarray, asks_array: np.ndarray, int64_t update_id,
+                    double timestamp = NAN):
+        if not self._recorder.writeDiffs(c_rows_to_entries(bids_array, update_id),
+                                         c_rows_to_entries(asks_array, update_id),
+                                         update_id, timestamp):
+            raise IOError(f"Failed to write to {self._path}.")
+
+    def write_trade(self, trade_event: OrderBookTradeEvent):
+        trade_id = trade_event.trade_id
+        if not self._recorder.writeTrade(
+            trade_event.type is TradeType.BUY,
+            float(trade_event.price),
+            float(trade_event.amount),
+            float(trade_id) if isinstance(trade_id, int) or (isinstance(trade_id, str) and trade_id.isdigit())
+            else NAN,
+            float(trade_event.timestamp),
+        ):
+            raise IOError(f"Failed to write to {self._path}.")
+
+    def flush(self):
+        self._recorder.flush()
+
+    def close(self):
+        self._recorder.close()
+
+
+cdef class L2Replay:
+    """
+    Replays a capture file written by L2Recorder into an OrderBook.
+
+    The file is memory mapped and played forward record by record. Snapshot and diff rows go straight from the mapping
+    into the book's native apply path; only trades are turned back into OrderBookTradeEvent objects. A record cut short
+    at the end of the file, such as one left by a recorder that died mid-write, ends the replay.
+    """
+
+    def __cinit__(self, str path):
+        self._reader = new CPPL2Reader()
+        self._path = path
+
+    def __init__(self, str path):
+        if not self._reader.open(path.encode("utf8")):
+            raise IOError(f"{path} is not a readable L2 capture file.")
+        self._trading_pair = self._reader.getTradingPair().decode("utf8")
+
+    def __dealloc__(self):
+        if self._reader != NULL:
+            del self._reader
+            self._reader = NULL
+
+    @property
+    def path(self) -> str:
+        return self._path
+
+    @property
+    def trading_pair(self) -> str:
+        return self._trading_pair
+
+    @property
+    def next_timestamp(self) -> float:
+        """
+        Timestamp of the next record, or NaN once the replay has reached the end of the file.
+        """
+        return self._reader.peekTimestamp()
+
+    @property
+    def last_timestamp(self) -> float:
+        """
+        Timestamp of the last record in the file, or NaN if the file holds no records.
+        """
+        return self._reader.getLastTimestamp()
+
+    @property
+    def at_end(self) -> bool:
+        return self._reader.atEnd()
+
+    @property
+    def position(self) -> Tuple[int, int]:
+        """
+        The replay position in the file, and the size of the file, in bytes.
+        """
+        return self._reader.getPosition(), self._reader.getSize()
+
+    def rewind(self):
+        self._reader.rewind()
+
+    def read_record(self) -> Optional[Tuple[int, float, int, np.ndarray, np.ndarray, int]]:
+        """
+        Reads the next record as (record_type, timestamp, update_id, bid_rows, ask_rows, flags), without applying it.
+        Trade records carry a single [price, amount, trade_id] row in bid_rows, and the trade side in flags.
+        Returns None at the end of the file.
+        """
+        cdef:
+            L2Record record
+
+        if not self._reader.next(record):
+            return None
+        return (record.type, record.timestamp, record.updateId,
+                c_rows_to_array(record.bidRows, record.numBids),
+                c_rows_to_array(record.askRows, record.numAsks),
+                record.flags)
+
+    def replay(self,
+               OrderBook order_book,
+               double until_timestamp = INFINITY,
+               size_t max_records = 0,
+               bint apply_trades = True) -> int:
+        """
+        Applies the records up to and including until_timestamp to order_book, at most max_records of them if
+        max_records is not 0. Trades are applied through OrderBook.apply_trade() unless apply_trades is False.
+        Returns the number of records read.
+        """
+        return self.c_replay([order_book], until_timestamp, max_records, apply_trades)
+
+    cdef size_t c_replay(self, list order_books, double until_timestamp, size_t max_records, bint apply_trades):
+        """
+        Same as replay(), but applies every record to each of order_books in turn, so many books can follow one pass
+        over the file.
+        """
+        cdef:
+            L2Record record
+            size_t num_records = 0
+            double next_timestamp
+            const double *row
+            object trade_id
+            object trade_event
+            OrderBook order_book
+
+        while max_records == 0 or num_records < max_records:
+            next_timestamp = self._reader.peekTimestamp()
+            if isnan(next_timestamp) or next_timestamp > until_timestamp:
+                break
+            self._reader.next(record)
+            num_records += 1
+            if record.type == L2_RECORD_SNAPSHOT:
+                for order_book in order_books:
+                    order_book.c_apply_snapshot_rows(record.bidRows, record.numBids, record.askRows, record.numAsks,
+                                                     record.updateId)
+            elif record.type == L2_RECORD_DIFF:
+                for order_book in order_books:
+                    order_book.c_apply_diff_row_pointers(record.bidRows, record.numBids,
+                                                         record.askRows, record.numAsks)
+            elif record.type == L2_RECORD_TRADE and apply_trades:
+                row = record.bidRows
+                trade_id = None if isnan(row[2]) else str(<int64_t>row[2])
+                trade_event = OrderBookTradeEvent(
+                    trading_pair=self._trading_pair,
+                    timestamp=record.timestamp,
+                    type=TradeType.BUY if record.flags & L2_TRADE_BUY else TradeType.SELL,
+                    price=Decimal(repr(row[0])),
+                    amount=Decimal(repr(row[1])),
+                    trade_id=trade_id,
+                )
+                for order_book in order_books:
+                    order_book.c_apply_trade(trade_event)
+        return num_records
+
+
+cdef class L2ReplayIterator(TimeIterator):
+    """
+    Replays a capture file into one or more order books as a backtest clock ticks: each tick applies the records up to
+    the tick timestamp to every book, in a single pass over the file. Publishes the timestamp of the next record as its
+    wake-up time, so a fast forwarding clock can jump straight from one record to the next.
+    """
+
+    def __init__(self, L2Replay replay, *order_books: OrderBook):
+        super().__init__()
+        self._replay = replay
+        self._order_books = list(order_books)
+
+    @property
+    def replay(self) -> L2Replay:
+        return self._replay
+
+    @property
+    def order_books(self) -> List[OrderBook]:
+        return list(self._order_books)
+
+    def add_order_book(self, OrderBook order_book):
+        self._order_books.append(order_book)
+
+    cdef c_tick(self, double timestamp):
+        TimeIterator.c_tick(self, timestamp)
+        self._replay.c_replay(self._order_books, timestamp, 0, True)
+
+    cdef double c_next_wakeup_timestamp(self):
+        cdef:
+            double next_timestamp = self._replay._reader.peekTimestamp()
+
+        return INFINITY if isnan(next_timestamp) else next_timestamp
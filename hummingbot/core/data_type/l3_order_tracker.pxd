@@ -0,0 +1,13 @@
+# distutils: language=c++
+
+from libc.stdint cimport int64_t
+from hummingbot.core.data_type.L3OrderTable cimport L3OrderTable, OrderHandle
+from hummingbot.core.data_type.order_book cimport OrderBook
+
+
+cdef class L3OrderTracker:
+    cdef L3OrderTable _table
+
+    cdef OrderHandle c_find(self, str exchange_order_id)
+    cdef object c_get_order(self, OrderHandle handle)
+    cdef int64_t c_flush_to_order_book(self, OrderBook order_book)
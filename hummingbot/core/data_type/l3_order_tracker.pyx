@@ -0,0 +1,145 @@
+# distutils: language=c++
+# distutils: sources=['hummingbot/core/cpp/L3OrderTable.cpp']
+from typing import Iterable, Optional, Tuple
+
+from libc.stdint cimport int64_t
+from libcpp.vector cimport vector
+
+from hummingbot.core.data_type.L3OrderTable cimport INVALID_ORDER_HANDLE, OrderHandle
+from hummingbot.core.data_type.order_book cimport OrderBook
+
+
+cdef class L3OrderTracker:
+    """
+    Tracks the resting orders of a market by order (L3) feed natively and turns them into the L2 book.
+
+    Orders are kept in a struct of arrays table, indexed by exchange order ID and by client order ID, with the total
+    amount and order count of every price level maintained as orders open, change, fill and close. Each level change
+    is queued as a [price, amount, update_id] diff row holding the new total of the level, and flush_to_order_book()
+    applies the queued rows to an OrderBook in one batch, so an exchange connector only has to feed the order
+    messages in.
+    """
+
+    def open_order(self, str exchange_order_id, bint is_bid, double price, double size, int64_t update_id,
+                   str client_order_id = ""):
+        """
+        Opens an order. An open order with the same exchange order ID is replaced.
+        """
+        self._table.open(exchange_order_id.encode("utf8"), client_order_id.encode("utf8"), is_bid, price, size,
+                         update_id)
+
+    def change_order(self, str exchange_order_id, double size, int64_t update_id) -> bool:
+        """
+        Sets the remaining size of an open order. Returns False if the order is not open.
+        """
+        return self._table.change(self.c_find(exchange_order_id), size, update_id)
+
+    def fill_order(self, str exchange_order_id, double filled_size, int64_t update_id) -> bool:
+        """
+        Takes a fill off the remaining size of an open order, which stays open until it is closed. Returns False if
+        the order is not open.
+        """
+        return self._table.fill(self.c_find(exchange_order_id), filled_size, update_id)
+
+    def close_order(self, str exchange_order_id, int64_t update_id) -> bool:
+        """
+        Closes an open order, whether it was filled or canceled. Returns False if the order is not open.
+        """
+        return self._table.close(self.c_find(exchange_order_id), update_id)
+
+    def load_snapshot(self, bids: Iterable[Tuple[str, float, float]], asks: Iterable[Tuple[str, float, float]],
+                      int64_t update_id):
+        """
+        Replaces every order with the (exchange_order_id, price, size) orders of a snapshot, and drops the queued
+        diff rows. Use apply_snapshot_to_order_book() to turn the orders into an L2 snapshot.
+        """
+        self._table.clear()
+        for exchange_order_id, price, size in bids:
+            self._table.open(str(exchange_order_id).encode("utf8"), b"", True, price, size, update_id)
+        for exchange_order_id, price, size in asks:
+            self._table.open(str(exchange_order_id).encode("utf8"), b"", False, price, size, update_id)
+        self._table.clearDiffRows()
+
+    def apply_snapshot_to_order_book(self, OrderBook order_book, int64_t update_id):
+        """
+        Applies the price levels of every open order to order_book as a snapshot, and drops the queued diff rows.
+        """
+        cdef:
+            vector[double] bid_rows
+            vector[double] ask_rows
+            size_t num_bids = self._table.exportLevels(True, bid_rows, update_id)
+            size_t num_asks = self._table.exportLevels(False, ask_rows, update_id)
+
+        order_book.c_apply_snapshot_rows(bid_rows.data(), num_bids, ask_rows.data(), num_asks, update_id)
+        self._table.clearDiffRows()
+
+    def flush_to_order_book(self, OrderBook order_book) -> int:
+        """
+        Applies the queued diff rows to order_book and drops them. Returns the update ID of the batch, 0 if nothing
+        was queued.
+        """
+        return self.c_flush_to_order_book(order_book)
+
+    cdef int64_t c_flush_to_order_book(self, OrderBook order_book):
+        cdef int64_t update_id = 0
+
+        if self._table.getBidDiffCount() + self._table.getAskDiffCount() > 0:
+            update_id = order_book.c_apply_diff_row_pointers(self._table.getBidDiffRows(),
+                                                             self._table.getBidDiffCount(),
+                                                             self._table.getAskDiffRows(),
+                                                             self._table.getAskDiffCount())
+        self._table.clearDiffRows()
+        return update_id
+
+    def get_order(self, str exchange_order_id) -> Optional[Tuple[bool, float, float, int]]:
+        """
+        Returns (is_bid, price, size, update_id) for an open order, or None.
+        """
+        return self.c_get_order(self.c_find(exchange_order_id))
+
+    def get_order_by_client_order_id(self, str client_order_id) -> Optional[Tuple[str, bool, float, float, int]]:
+        """
+        Returns (exchange_order_id, is_bid, price, size, update_id) for an open order, or None.
+        """
+        cdef OrderHandle handle = self._table.findByClientOrderId(client_order_id.encode("utf8"))
+
+        if handle == INVALID_ORDER_HANDLE:
+            return None
+        return (self._table.getExchangeOrderId(handle).decode("utf8"),) + self.c_get_order(handle)
+
+    cdef object c_get_order(self, OrderHandle handle):
+        if not self._table.isOpen(handle):
+            return None
+        return (self._table.getIsBid(handle), self._table.getPrice(handle), self._table.getSize(handle),
+                self._table.getUpdateId(handle))
+
+    def level_amount(self, bint is_bid, double price) -> float:
+        return self._table.getLevelAmount(is_bid, price)
+
+    def level_order_count(self, bint is_bid, double price) -> int:
+        return self._table.getLevelOrderCount(is_bid, price)
+
+    @property
+    def order_count(self) -> int:
+        return self._table.size()
+
+    @property
+    def bid_level_count(self) -> int:
+        return self._table.getLevelCount(True)
+
+    @property
+    def ask_level_count(self) -> int:
+        return self._table.getLevelCount(False)
+
+    @property
+    def pending_diff_count(self) -> int:
+        """
+        Number of diff rows queued for the next flush_to_order_book().
+        """
+        return self._table.getBidDiffCount() + self._table.getAskDiffCount()
+
+    def clear(self):
+        self._table.clear()
+
+    cdef OrderHandle c_find(self, str exchange_order_id):
+        return self._table.findByExchangeOrderId(exchange_order_id.encode("utf8"))
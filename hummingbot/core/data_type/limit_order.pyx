@@ -1,5 +1,5 @@
 # distutils: language=c++
-# distutils: sources=hummingbot/core/cpp/LimitOrder.cpp
+# distutils: sources=['hummingbot/core/cpp/LimitOrder.cpp', 'hummingbot/core/cpp/PoolAllocator.cpp', 'hummingbot/core/cpp/SymbolTable.cpp']
 import time
 from decimal import Decimal
 from typing import List
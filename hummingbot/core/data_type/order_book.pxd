@@ -1,29 +1,76 @@
 # distutils: language=c++
 
-from libc.stdint cimport int64_t
-from libcpp.set cimport set
+from libc.stdint cimport int64_t, uint64_t
 from libcpp.vector cimport vector
+from hummingbot.core.data_type.DiffCoalescer cimport DiffCoalescer
+from hummingbot.core.data_type.DiffRingBuffer cimport DiffRingBuffer
+from hummingbot.core.data_type.L2Capture cimport L2Recorder
 from hummingbot.core.data_type.OrderBookEntry cimport OrderBookEntry
+from hummingbot.core.data_type.OrderBookFeatureEngine cimport OrderBookFeatureEngine
+from hummingbot.core.data_type.OrderBookSide cimport OrderBookSide
+from hummingbot.core.data_type.OrderBookStats cimport OrderBookStats
+from hummingbot.core.data_type.OrderBookSync cimport OrderBookSync
+from hummingbot.core.data_type.SnapshotReconciler cimport ReconcileResult
 from hummingbot.core.pubsub cimport PubSub
 from .order_book_query_result cimport OrderBookQueryResult
 cimport numpy as np
 
 
 cdef class OrderBook(PubSub):
-    cdef set[OrderBookEntry] _bid_book
-    cdef set[OrderBookEntry] _ask_book
+    cdef OrderBookSide _bid_book
+    cdef OrderBookSide _ask_book
     cdef int64_t _snapshot_uid
     cdef int64_t _last_diff_uid
+    cdef uint64_t _version
     cdef double _best_bid
     cdef double _best_ask
     cdef double _last_trade_price
     cdef double _last_applied_trade
     cdef double _last_trade_price_rest_updated
     cdef bint _dex
+    cdef object _top_bids
+    cdef object _top_asks
+    cdef DiffRingBuffer _diff_ring
+    cdef vector[double] _drained_bid_rows
+    cdef vector[double] _drained_ask_rows
+    cdef OrderBookSync _sync
+    cdef bint _concurrent
+    cdef L2Recorder *_l2_recorder
+    cdef object _l2_recorder_owner
+    cdef OrderBookStats _stats
+    cdef OrderBookFeatureEngine _features
+    cdef DiffCoalescer _coalescer
+    cdef bint _coalesce_diffs
 
+    cdef c_lock_book(self)
+    cdef c_unlock_book(self)
+    cdef uint64_t c_get_version(self)
     cdef c_apply_diffs(self, vector[OrderBookEntry] bids, vector[OrderBookEntry] asks, int64_t update_id)
+    cdef int64_t c_apply_diff_rows(self, const double[:, ::1] bid_rows, const double[:, ::1] ask_rows) except? -1
+    cdef int64_t c_apply_diff_row_pointers(self,
+                                           const double *bid_rows,
+                                           size_t num_bids,
+                                           const double *ask_rows,
+                                           size_t num_asks)
+    cdef size_t c_flush_coalesced_diffs(self)
     cdef c_apply_snapshot(self, vector[OrderBookEntry] bids, vector[OrderBookEntry] asks, int64_t update_id)
+    cdef c_apply_snapshot_rows(self,
+                               const double *bid_rows,
+                               size_t num_bids,
+                               const double *ask_rows,
+                               size_t num_asks,
+                               int64_t update_id)
+    cdef ReconcileResult c_restore_from_snapshot_rows(self,
+                                                      vector[OrderBookEntry] bids,
+                                                      vector[OrderBookEntry] asks,
+                                                      int64_t update_id,
+                                                      const double *diff_rows,
+                                                      size_t num_diff_rows)
     cdef c_apply_trade(self, object trade_event)
+    cdef c_set_top_levels_capacity(self, size_t capacity)
+    cdef DiffRingBuffer *c_get_diff_ring(self)
+    cdef bint c_push_diff_rows(self, const double[:, ::1] bid_rows, const double[:, ::1] ask_rows) except? -1
+    cdef size_t c_drain_diffs(self, size_t max_records)
     cdef c_apply_numpy_diffs(self,
                              np.ndarray[np.float64_t, ndim=2] bids_array,
                              np.ndarray[np.float64_t, ndim=2] asks_array)
@@ -31,6 +78,10 @@ cdef class OrderBook(PubSub):
                                 np.ndarray[np.float64_t, ndim=2] bids_array,
                                 np.ndarray[np.float64_t, ndim=2] asks_array)
     cdef double c_get_price(self, bint is_buy) except? -1
+    cdef double c_get_microprice(self)
+    cdef double c_get_depth_imbalance(self)
+    cdef double c_get_book_pressure(self)
+    cdef double c_get_weighted_mid(self)
     cdef OrderBookQueryResult c_get_price_for_volume(self, bint is_buy, double volume)
     cdef OrderBookQueryResult c_get_price_for_quote_volume(self, bint is_buy, double quote_volume)
     cdef OrderBookQueryResult c_get_volume_for_price(self, bint is_buy, double price)
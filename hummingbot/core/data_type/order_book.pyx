@@ -1,6 +1,5 @@
 # distutils: language=c++
-# distutils: sources=hummingbot/core/cpp/OrderBookEntry.cpp
-import bisect
+# distutils: sources=['hummingbot/core/cpp/DiffCoalescer.cpp', 'hummingbot/core/cpp/DiffRingBuffer.cpp', 'hummingbot/core/cpp/L2Capture.cpp', 'hummingbot/core/cpp/LatencyHistogram.cpp', 'hummingbot/core/cpp/OrderBookCache.cpp', 'hummingbot/core/cpp/OrderBookEntry.cpp', 'hummingbot/core/cpp/OrderBookFeatureEngine.cpp', 'hummingbot/core/cpp/OrderBookSide.cpp', 'hummingbot/core/cpp/OrderBookStats.cpp', 'hummingbot/core/cpp/OrderBookSync.cpp', 'hummingbot/core/cpp/SnapshotReconciler.cpp']
 import logging
 import time
 from typing import (
@@ -17,13 +16,28 @@ import pandas as pd
 from cython.operator cimport(
     address as ref,
     dereference as deref,
-    postincrement as inc,
 )
+from libc.math cimport INFINITY, NAN
+from libcpp.string cimport string
 
+from hummingbot.core.data_type.common import TradeType
+from hummingbot.core.data_type.order_book_features import OrderBookFeatures
 from hummingbot.core.data_type.order_book_message import OrderBookMessage
 from hummingbot.core.data_type.order_book_query_result import OrderBookQueryResult
-from hummingbot.core.data_type.order_book_row import OrderBookRow
-from hummingbot.core.data_type.OrderBookEntry cimport truncateOverlapEntries
+from hummingbot.core.data_type.order_book_reconcile_result import OrderBookReconcileResult, OrderBookReconcileStatus
+from hummingbot.core.data_type.order_book_stats import HistogramSummary, OrderBookStatsSnapshot
+from hummingbot.core.data_type.order_book_row import OrderBookRow, OrderBookTop
+from hummingbot.core.data_type.LatencyHistogram cimport LatencyHistogram
+from hummingbot.core.data_type.OrderBookCache cimport OrderBookCacheReader, OrderBookCacheWriter
+from hummingbot.core.data_type.OrderBookFeatureEngine cimport OrderBookFeatureValues
+from hummingbot.core.data_type.OrderBookSide cimport DepthQueryResult, applyDiffs, truncateOverlapEntries
+from hummingbot.core.data_type.OrderBookStats cimport OrderBookCounters
+from hummingbot.core.data_type.OrderBookSync cimport TopOfBook
+from hummingbot.core.data_type.SnapshotReconciler cimport (
+    RECONCILE_GAP,
+    ReconcileResult,
+    reconcileSnapshotAndDiffs,
+)
 from hummingbot.logger import HummingbotLogger
 from hummingbot.core.event.events import (
     OrderBookEvent,
@@ -36,6 +50,78 @@ ob_logger = None
 NaN = float("nan")
 
 
+cdef inline OrderBookQueryResult c_depth_query_result(DepthQueryResult result):
+    return OrderBookQueryResult(result.queryPrice, result.queryVolume, result.resultPrice, result.resultVolume)
+
+
+cdef object c_export_book_side(OrderBookSide *book, object out):
+    cdef:
+        double[:, ::1] rows
+        size_t num_rows = 0
+
+    if out is None:
+        out = np.empty((deref(book).size(), 3), dtype=np.float64)
+    rows = out
+    if rows.shape[1] != 3:
+        raise ValueError("Snapshot buffers must have 3 columns: [price, amount, update_id].")
+    if rows.shape[0] > 0:
+        num_rows = deref(book).exportLevels(&rows[0, 0], rows.shape[0])
+    return out[:num_rows]
+
+
+cdef object c_histogram_summary(const LatencyHistogram &histogram, double scale):
+    return HistogramSummary(
+        histogram.getCount(),
+        histogram.getMin() * scale,
+        histogram.getMean() * scale,
+        histogram.getValueAtPercentile(50) * scale,
+        histogram.getValueAtPercentile(90) * scale,
+        histogram.getValueAtPercentile(99) * scale,
+        histogram.getValueAtPercentile(99.9) * scale,
+        histogram.getMax() * scale,
+    )
+
+
+cdef c_pack_diff_message(object diff, vector[double] &rows):
+    # Appends the levels of one diff message as tagged [price, amount, update_id, first_update_id, is_bid] rows. Plain
+    # messages are read straight from their content, without building OrderBookRow objects.
+    cdef:
+        double update_id = diff.update_id
+        double first_update_id = NAN
+        size_t num_rows = rows.size()
+
+    content = diff.content
+    if isinstance(content, dict) and content.get("first_update_id") is not None:
+        first_update_id = content["first_update_id"]
+    if type(diff) is OrderBookMessage:
+        bids = content["bids"]
+        asks = content["asks"]
+    else:
+        bids = diff.bids
+        asks = diff.asks
+    for is_bid, levels in ((1.0, bids), (0.0, asks)):
+        for level in levels:
+            rows.push_back(float(level[0]))
+            rows.push_back(float(level[1]))
+            rows.push_back(update_id)
+            rows.push_back(first_update_id)
+            rows.push_back(is_bid)
+    if rows.size() == num_rows:
+        # Empty messages still count towards the sequence of update IDs.
+        for value in (NAN, 0.0, update_id, first_update_id, 1.0):
+            rows.push_back(value)
+
+
+cdef object c_reconcile_result(ReconcileResult result):
+    return OrderBookReconcileResult(
+        OrderBookReconcileStatus.GAP if result.status == RECONCILE_GAP else OrderBookReconcileStatus.SYNCED,
+        result.lastUpdateId,
+        result.appliedDiffs,
+        result.skippedDiffs,
+        result.gapFirstUpdateId,
+    )
+
+
 cdef class OrderBook(PubSub):
     ORDER_BOOK_TRADE_EVENT_TAG = OrderBookEvent.TradeEvent.value
 
@@ -46,99 +132,279 @@ cdef class OrderBook(PubSub):
             ob_logger = logging.getLogger(__name__)
         return ob_logger
 
+    def __cinit__(self):
+        self._bid_book = OrderBookSide(True)
+        self._ask_book = OrderBookSide(False)
+
     def __init__(self, dex=False):
         super().__init__()
         self._snapshot_uid = 0
         self._last_diff_uid = 0
+        self._version = 0
         self._best_bid = self._best_ask = float("NaN")
         self._last_trade_price = float("NaN")
         self._last_applied_trade = -1000.0
         self._last_trade_price_rest_updated = -1000
         self._dex = dex
+        self._concurrent = False
+        self._coalesce_diffs = False
+
+    cdef c_lock_book(self):
+        # Only books maintained by an OrderBookWorkerPool are touched by other threads, everything else skips the lock.
+        if self._concurrent:
+            with nogil:
+                self._sync.lock()
+
+    cdef c_unlock_book(self):
+        # Readers that do not take the lock read the update counters from the sync, so they are stored there first.
+        if self._concurrent:
+            self._sync.storeCounters(self._version, self._last_diff_uid)
+            self._sync.unlock()
+
+    cdef uint64_t c_get_version(self):
+        if self._concurrent:
+            return self._sync.getBookVersion()
+        return self._version
 
     cdef c_apply_diffs(self, vector[OrderBookEntry] bids, vector[OrderBookEntry] asks, int64_t update_id):
         cdef:
-            set[OrderBookEntry].iterator bid_book_end = self._bid_book.end()
-            set[OrderBookEntry].iterator ask_book_end = self._ask_book.end()
-            set[OrderBookEntry].reverse_iterator bid_iterator
-            set[OrderBookEntry].iterator ask_iterator
-            set[OrderBookEntry].iterator result
-            OrderBookEntry top_bid
-            OrderBookEntry top_ask
-
-        # Apply the diffs. Diffs with 0 amounts mean deletion.
-        for bid in bids:
-            result = self._bid_book.find(bid)
-            if result != bid_book_end:
-                self._bid_book.erase(result)
-            if bid.getAmount() > 0:
-                self._bid_book.insert(bid)
-        for ask in asks:
-            result = self._ask_book.find(ask)
-            if result != ask_book_end:
-                self._ask_book.erase(result)
-            if ask.getAmount() > 0:
-                self._ask_book.insert(ask)
-
-        # If any overlapping entries between the bid and ask books, centralised: newer entries win, dex: see OrderBookEntry.cpp
-        truncateOverlapEntries(self._bid_book, self._ask_book, self._dex)
-
-        # Record the current best prices, for faster c_get_price() calls.
-        bid_iterator = self._bid_book.rbegin()
-        ask_iterator = self._ask_book.begin()
-        if bid_iterator != self._bid_book.rend():
-            top_bid = deref(bid_iterator)
-            self._best_bid = top_bid.getPrice()
-        if ask_iterator != self._ask_book.end():
-            top_ask = deref(ask_iterator)
-            self._best_ask = top_ask.getPrice()
-
-        # Remember the last diff update ID.
-        self._last_diff_uid = update_id
+            int64_t start
+            uint64_t truncated_levels
+
+        # Apply the diffs, with 0 amounts meaning deletion. Any overlapping entries between the bid and ask books are
+        # truncated (centralised: newer entries win, dex: see OrderBookSide.cpp), and the best prices are recorded for
+        # faster c_get_price() calls. None of it touches Python objects, so it runs without the GIL.
+        if self._l2_recorder != NULL:
+            self._l2_recorder.writeDiffs(bids, asks, update_id, NAN)
+        if self._coalesce_diffs:
+            self._coalescer.addEntries(bids, asks, update_id)
+            self._last_diff_uid = self._coalescer.getLastUpdateId()
+            self._version += 1
+            return
+        self.c_lock_book()
+        with nogil:
+            start = OrderBookStats.getMonotonicNanoseconds()
+            truncated_levels = OrderBookStats.getTruncatedLevelCount(self._bid_book, self._ask_book)
+            applyDiffs(self._bid_book, self._ask_book, bids, asks, self._dex, self._best_bid, self._best_ask)
+            self._stats.recordDiffBatch(
+                OrderBookStats.getMonotonicNanoseconds() - start,
+                bids.size() + asks.size(),
+                OrderBookStats.getTruncatedLevelCount(self._bid_book, self._ask_book) - truncated_levels,
+            )
+            self._features.update(self._bid_book, self._ask_book)
+
+            # Remember the last diff update ID.
+            self._last_diff_uid = update_id
+            self._version += 1
+            self._sync.publishTopOfBook(self._bid_book, self._ask_book, self._best_bid, self._best_ask, update_id)
+        self.c_unlock_book()
+
+    cdef int64_t c_apply_diff_rows(self, const double[:, ::1] bid_rows, const double[:, ::1] ask_rows) except? -1:
+        """
+        Applies a batch of diffs given as packed [price, amount, update_id] rows, in one native call. Returns the largest
+        update ID in the batch.
+        """
+        cdef:
+            const double *bids_data = NULL
+            const double *asks_data = NULL
+
+        if bid_rows.shape[1] < 3 or ask_rows.shape[1] < 3:
+            raise ValueError("Diff rows must have 3 columns: [price, amount, update_id].")
+        if bid_rows.shape[0] > 0:
+            bids_data = &bid_rows[0, 0]
+        if ask_rows.shape[0] > 0:
+            asks_data = &ask_rows[0, 0]
+        return self.c_apply_diff_row_pointers(bids_data, bid_rows.shape[0], asks_data, ask_rows.shape[0])
+
+    cdef int64_t c_apply_diff_row_pointers(self,
+                                           const double *bid_rows,
+                                           size_t num_bids,
+                                           const double *ask_rows,
+                                           size_t num_asks):
+        """
+        Same as c_apply_diff_rows(), for rows that are not held by a memoryview - such as the rows of a mapped capture
+        file.
+        """
+        cdef:
+            int64_t last_update_id
+            int64_t start
+            uint64_t truncated_levels
+
+        if self._coalesce_diffs:
+            last_update_id = self._coalescer.addRows(bid_rows, num_bids, ask_rows, num_asks)
+            self._last_diff_uid = self._coalescer.getLastUpdateId()
+            self._version += 1
+            if self._l2_recorder != NULL:
+                self._l2_recorder.writeDiffRows(bid_rows, num_bids, ask_rows, num_asks, last_update_id, NAN)
+            return last_update_id
+        self.c_lock_book()
+        with nogil:
+            start = OrderBookStats.getMonotonicNanoseconds()
+            truncated_levels = OrderBookStats.getTruncatedLevelCount(self._bid_book, self._ask_book)
+            last_update_id = applyDiffs(self._bid_book, self._ask_book,
+                                        bid_rows, num_bids, ask_rows, num_asks,
+                                        self._dex, self._best_bid, self._best_ask)
+            self._stats.recordDiffBatch(
+                OrderBookStats.getMonotonicNanoseconds() - start,
+                num_bids + num_asks,
+                OrderBookStats.getTruncatedLevelCount(self._bid_book, self._ask_book) - truncated_levels,
+            )
+            self._features.update(self._bid_book, self._ask_book)
+            self._last_diff_uid = last_update_id
+            self._version += 1
+            self._sync.publishTopOfBook(self._bid_book, self._ask_book, self._best_bid, self._best_ask, last_update_id)
+        self.c_unlock_book()
+        if self._l2_recorder != NULL:
+            self._l2_recorder.writeDiffRows(bid_rows, num_bids, ask_rows, num_asks, last_update_id, NAN)
+        return last_update_id
+
+    cdef size_t c_flush_coalesced_diffs(self):
+        """
+        Applies the diffs held back in coalescing mode, one row per price level, as a single batch. Every read of the
+        book calls this first, so readers never see the book without the diffs it has been given. Returns the number of
+        levels applied.
+        """
+        cdef:
+            size_t num_levels = self._coalescer.getPendingCount()
+            int64_t start
+            uint64_t truncated_levels
+
+        if num_levels == 0:
+            return 0
+        self.c_lock_book()
+        with nogil:
+            start = OrderBookStats.getMonotonicNanoseconds()
+            truncated_levels = OrderBookStats.getTruncatedLevelCount(self._bid_book, self._ask_book)
+            applyDiffs(self._bid_book, self._ask_book,
+                       self._coalescer.getBidRows(), self._coalescer.getBidCount(),
+                       self._coalescer.getAskRows(), self._coalescer.getAskCount(),
+                       self._dex, self._best_bid, self._best_ask)
+            self._stats.recordDiffBatch(
+                OrderBookStats.getMonotonicNanoseconds() - start,
+                num_levels,
+                OrderBookStats.getTruncatedLevelCount(self._bid_book, self._ask_book) - truncated_levels,
+            )
+            self._features.update(self._bid_book, self._ask_book)
+            self._sync.publishTopOfBook(self._bid_book, self._ask_book, self._best_bid, self._best_ask,
+                                        self._coalescer.getLastUpdateId())
+            self._coalescer.clear()
+            self._version += 1
+        self.c_unlock_book()
+        return num_levels
 
     cdef c_apply_snapshot(self, vector[OrderBookEntry] bids, vector[OrderBookEntry] asks, int64_t update_id):
         cdef:
             double best_bid_price = float("NaN")
             double best_ask_price = float("NaN")
-            set[OrderBookEntry].reverse_iterator bid_iterator
-            set[OrderBookEntry].iterator ask_iterator
-            OrderBookEntry top_bid
-            OrderBookEntry top_ask
-
-        # Start with an empty order book, and then insert all entries.
-        self._bid_book.clear()
-        self._ask_book.clear()
-        for bid in bids:
-            self._bid_book.insert(bid)
-            if not (bid.getPrice() <= best_bid_price):
-                best_bid_price = bid.getPrice()
-        for ask in asks:
-            self._ask_book.insert(ask)
-            if not (ask.getPrice() >= best_ask_price):
-                best_ask_price = ask.getPrice()
-
-        if self._dex:
-            truncateOverlapEntries(self._bid_book, self._ask_book, self._dex)
-            # Record the current best prices, for faster c_get_price() calls.
-            bid_iterator = self._bid_book.rbegin()
-            ask_iterator = self._ask_book.begin()
-            if bid_iterator != self._bid_book.rend():
-                top_bid = deref(bid_iterator)
-                best_bid_price = top_bid.getPrice()
-            if ask_iterator != self._ask_book.end():
-                top_ask = deref(ask_iterator)
-                best_ask_price = top_ask.getPrice()
+            int64_t start
+
+        if self._l2_recorder != NULL:
+            self._l2_recorder.writeSnapshot(bids, asks, update_id, NAN)
+        # Replace both sides with the snapshot entries. The entries are sorted in bulk, so no per-level insertion.
+        # Coalesced diffs the snapshot covers are dropped, and newer ones stay pending on top of it.
+        self.c_lock_book()
+        with nogil:
+            self._coalescer.discardUpTo(update_id)
+            start = OrderBookStats.getMonotonicNanoseconds()
+            self._bid_book.assign(bids)
+            self._ask_book.assign(asks)
+
+            if self._dex:
+                truncateOverlapEntries(self._bid_book, self._ask_book, self._dex)
+            self._bid_book.syncTopLevels()
+            self._ask_book.syncTopLevels()
+            self._features.update(self._bid_book, self._ask_book)
+            self._stats.recordSnapshot(OrderBookStats.getMonotonicNanoseconds() - start)
 
         # Record the current best prices, for faster c_get_price() calls.
+        if not self._bid_book.empty():
+            best_bid_price = self._bid_book.best().getPrice()
+        if not self._ask_book.empty():
+            best_ask_price = self._ask_book.best().getPrice()
         self._best_bid = best_bid_price
         self._best_ask = best_ask_price
 
         # Remember the last snapshot update ID.
         self._snapshot_uid = update_id
+        self._version += 1
+        self._sync.publishTopOfBook(self._bid_book, self._ask_book, self._best_bid, self._best_ask, update_id)
+        self.c_unlock_book()
+
+    cdef c_apply_snapshot_rows(self,
+                               const double *bid_rows,
+                               size_t num_bids,
+                               const double *ask_rows,
+                               size_t num_asks,
+                               int64_t update_id):
+        cdef:
+            vector[OrderBookEntry] cpp_bids
+            vector[OrderBookEntry] cpp_asks
+            size_t i
+
+        cpp_bids.reserve(num_bids)
+        cpp_asks.reserve(num_asks)
+        for i in range(num_bids):
+            cpp_bids.push_back(OrderBookEntry(bid_rows[i * 3], bid_rows[i * 3 + 1], <int64_t>bid_rows[i * 3 + 2]))
+        for i in range(num_asks):
+            cpp_asks.push_back(OrderBookEntry(ask_rows[i * 3], ask_rows[i * 3 + 1], <int64_t>ask_rows[i * 3 + 2]))
+        self.c_apply_snapshot(cpp_bids, cpp_asks, update_id)
+
+    cdef ReconcileResult c_restore_from_snapshot_rows(self,
+                                                      vector[OrderBookEntry] bids,
+                                                      vector[OrderBookEntry] asks,
+                                                      int64_t update_id,
+                                                      const double *diff_rows,
+                                                      size_t num_diff_rows):
+        """
+        Applies a snapshot and replays the buffered diffs newer than it, given as tagged
+        [price, amount, update_id, first_update_id, is_bid] rows, under one lock and in one native call. See
+        SnapshotReconciler.h for how stale diffs and sequence gaps are handled.
+        """
+        cdef:
+            ReconcileResult result
+            int64_t start
+
+        # Coalesced diffs the snapshot covers are dropped, and newer ones stay pending on top of the replayed diffs.
+        self.c_lock_book()
+        with nogil:
+            self._coalescer.discardUpTo(update_id)
+            start = OrderBookStats.getMonotonicNanoseconds()
+            result = reconcileSnapshotAndDiffs(self._bid_book, self._ask_book, bids, asks, update_id,
+                                               diff_rows, num_diff_rows,
+                                               self._dex, self._best_bid, self._best_ask, self._l2_recorder)
+            self._features.update(self._bid_book, self._ask_book)
+            self._stats.recordSnapshot(OrderBookStats.getMonotonicNanoseconds() - start)
+            self._snapshot_uid = update_id
+            if result.appliedDiffs > 0:
+                self._last_diff_uid = max(result.lastUpdateId, self._coalescer.getLastUpdateId())
+            self._version += 1
+            self._sync.publishTopOfBook(self._bid_book, self._ask_book, self._best_bid, self._best_ask,
+                                        result.lastUpdateId)
+        if result.status == RECONCILE_GAP:
+            self._stats.recordUpdateIdGap()
+        self.c_unlock_book()
+        return result
 
     cdef c_apply_trade(self, object trade_event):
+        cdef:
+            object trade_id
+
+        if self._l2_recorder != NULL:
+            # Capture files keep numeric trade IDs only.
+            trade_id = trade_event.trade_id
+            self._l2_recorder.writeTrade(
+                trade_event.type is TradeType.BUY,
+                float(trade_event.price),
+                float(trade_event.amount),
+                float(trade_id) if isinstance(trade_id, int) or (isinstance(trade_id, str) and trade_id.isdigit())
+                else NAN,
+                float(trade_event.timestamp),
+            )
         self._last_trade_price = trade_event.price
         self._last_applied_trade = time.perf_counter()
+        self.c_lock_book()
+        self._version += 1
+        self.c_unlock_book()
         self.c_trigger_event(self.ORDER_BOOK_TRADE_EVENT_TAG, trade_event)
 
     @property
@@ -161,22 +427,398 @@ cdef class OrderBook(PubSub):
     def last_trade_price_rest_updated(self, value: float):
         self._last_trade_price_rest_updated = value
 
+    cdef c_set_top_levels_capacity(self, size_t capacity):
+        cdef:
+            double[:, ::1] bids_buffer
+            double[:, ::1] asks_buffer
+            object old_bids = self._top_bids
+            object old_asks = self._top_asks
+            object new_bids = np.full((capacity, 3), NaN, dtype=np.float64)
+            object new_asks = np.full((capacity, 3), NaN, dtype=np.float64)
+
+        # The cache rows live in numpy arrays owned by the order book, so views handed out earlier stay valid even
+        # after the capacity changes - they just stop being updated. Pool workers write through the buffer pointers, so
+        # they are swapped under the book lock, and the old arrays are only released once the swap is done.
+        if capacity > 0:
+            bids_buffer = new_bids
+            asks_buffer = new_asks
+        self.c_lock_book()
+        try:
+            if capacity > 0:
+                self._bid_book.setTopLevelsBuffer(&bids_buffer[0, 0], capacity)
+                self._ask_book.setTopLevelsBuffer(&asks_buffer[0, 0], capacity)
+            else:
+                self._bid_book.setTopLevelsBuffer(NULL, 0)
+                self._ask_book.setTopLevelsBuffer(NULL, 0)
+            self._top_bids = new_bids
+            self._top_asks = new_asks
+        finally:
+            self.c_unlock_book()
+
+    @property
+    def top_levels_capacity(self) -> int:
+        """
+        Number of levels per side kept in the top levels cache. 0 means the cache is disabled.
+        """
+        return 0 if self._top_bids is None else self._top_bids.shape[0]
+
+    @top_levels_capacity.setter
+    def top_levels_capacity(self, value: int):
+        if value < 0:
+            raise ValueError(f"The top levels capacity must not be negative, got {value}.")
+        self.c_set_top_levels_capacity(value)
+
+    def top_levels(self, n: int) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Returns read-only (k, 3) [price, amount, update_id] views of the best bid and ask levels, best first, where k is
+        the number of levels on each side up to n. The views alias the top levels cache, which is only rewritten where
+        book updates touch levels inside the window, so no rows are copied. They are updated in place as the book
+        changes; rows past the end of a shrinking book read as NaN.
+
+        Books maintained by an OrderBookWorkerPool have their cache rewritten by the worker threads, so a view could be
+        read half updated. For those books the rows are copied under the book lock instead, and the copies are not
+        updated as the book changes.
+
+        The cache capacity grows to n if needed. Raises ValueError if n is negative.
+        """
+        if n < 0:
+            raise ValueError(f"The number of levels must not be negative, got {n}.")
+        if n > self.top_levels_capacity or self._top_bids is None:
+            self.c_set_top_levels_capacity(n)
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        try:
+            self._bid_book.syncTopLevels()
+            self._ask_book.syncTopLevels()
+            bids = self._top_bids[:min(<size_t>n, self._bid_book.getTopLevelsCount())]
+            asks = self._top_asks[:min(<size_t>n, self._ask_book.getTopLevelsCount())]
+            if self._concurrent:
+                bids = bids.copy()
+                asks = asks.copy()
+        finally:
+            self.c_unlock_book()
+        bids.flags.writeable = False
+        asks.flags.writeable = False
+        return bids, asks
+
+    cdef DiffRingBuffer *c_get_diff_ring(self):
+        """
+        Returns the diff ring of the book, for native producers that push diffs without holding the GIL. The pointer
+        stays valid for the life of the order book, but the ring must not be resized while a producer is running.
+        """
+        return &self._diff_ring
+
+    @property
+    def diff_ring_capacity(self) -> int:
+        """
+        Number of diff rows the ring buffer between push_diff_rows() and drain_diffs() can hold. 0 means the ring is
+        disabled. Changing the capacity drops anything pending, so it has to be set before the producer starts.
+        """
+        return self._diff_ring.capacity()
+
+    @diff_ring_capacity.setter
+    def diff_ring_capacity(self, value: int):
+        if self._concurrent:
+            raise RuntimeError("The diff ring of an order book maintained by a worker pool cannot be resized.")
+        self._diff_ring.reset(value)
+
+    @property
+    def pending_diff_count(self) -> int:
+        return self._diff_ring.size()
+
+    @property
+    def dropped_diff_count(self) -> int:
+        """
+        Number of diff rows pushed while the ring was full. Any drops mean the book has missed diffs and needs a new
+        snapshot.
+        """
+        return self._diff_ring.getDroppedCount()
+
+    cdef bint c_push_diff_rows(self, const double[:, ::1] bid_rows, const double[:, ::1] ask_rows) except? -1:
+        cdef:
+            const double *bids_data = NULL
+            const double *asks_data = NULL
+            size_t num_bids = bid_rows.shape[0]
+            size_t num_asks = ask_rows.shape[0]
+            bint pushed
+
+        if bid_rows.shape[1] < 3 or ask_rows.shape[1] < 3:
+            raise ValueError("Diff rows must have 3 columns: [price, amount, update_id].")
+        if num_bids > 0:
+            bids_data = &bid_rows[0, 0]
+        if num_asks > 0:
+            asks_data = &ask_rows[0, 0]
+        with nogil:
+            pushed = self._diff_ring.pushRows(bids_data, num_bids, asks_data, num_asks)
+        return pushed
+
+    def push_diff_rows(self, bids_array: np.ndarray, asks_array: np.ndarray) -> bool:
+        """
+        Queues one message worth of [price, amount, update_id] diff rows in the diff ring, to be applied by the next
+        drain_diffs() call. This is the producer side of the ring: it may be called from one thread other than the one
+        that drains, and it does not hold the GIL while copying the rows. Returns False, and drops the whole message,
+        if the ring is full.
+        """
+        return self.c_push_diff_rows(np.ascontiguousarray(bids_array[:, :3], dtype=np.float64),
+                                     np.ascontiguousarray(asks_array[:, :3], dtype=np.float64))
+
+    cdef size_t c_drain_diffs(self, size_t max_records):
+        cdef:
+            size_t num_records
+
+        self._drained_bid_rows.clear()
+        self._drained_ask_rows.clear()
+        num_records = self._diff_ring.drain(self._drained_bid_rows, self._drained_ask_rows, max_records)
+        if num_records == 0:
+            return 0
+        self.c_apply_diff_row_pointers(self._drained_bid_rows.data(), self._drained_bid_rows.size() // 3,
+                                       self._drained_ask_rows.data(), self._drained_ask_rows.size() // 3)
+        return num_records
+
+    def drain_diffs(self, max_records: int = 0) -> int:
+        """
+        Applies the diffs pending in the diff ring as a single batch, in the order they were pushed. Only whole messages
+        are taken: as many as fit in max_records rows, but at least one, or everything pending if max_records is 0.
+        Returns the number of rows applied.
+
+        Books maintained by an OrderBookWorkerPool are drained by the pool, so this raises RuntimeError for them.
+        """
+        if self._concurrent:
+            raise RuntimeError("The diff ring of an order book maintained by a worker pool is drained by the pool.")
+        return self.c_drain_diffs(max_records)
+
+    @property
+    def coalesce_diffs(self) -> bool:
+        """
+        Holds diffs back instead of applying them as they arrive, keeping only the newest row for each price level by
+        update ID. The pending rows are applied as one batch by flush_diffs(), typically once per tick, or by the next
+        read of the book, whichever comes first - so a level updated many times during a burst is only applied once.
+
+        This changes what readers see when the book crosses itself between two reads. The overlap truncation only runs
+        on the net result of the batch, so a level the other side crossed for a moment is kept, where applying each diff
+        as it arrives would have truncated it for good.
+
+        Diffs are still written to the L2 recorder as they arrive. Turning the mode off applies what is pending.
+        """
+        return self._coalesce_diffs
+
+    @coalesce_diffs.setter
+    def coalesce_diffs(self, value: bool):
+        if value and self._concurrent:
+            raise ValueError("Order books maintained by a worker pool cannot coalesce diffs, the pool batches them.")
+        if not value:
+            self.c_flush_coalesced_diffs()
+        self._coalesce_diffs = value
+
+    def flush_diffs(self) -> int:
+        """
+        Applies the diffs held back in coalescing mode. Returns the number of price levels applied.
+        """
+        return self.c_flush_coalesced_diffs()
+
+    @property
+    def coalesced_diff_count(self) -> int:
+        """
+        The number of price levels with a diff held back in coalescing mode.
+        """
+        return self._coalescer.getPendingCount()
+
+    @property
+    def merged_diff_count(self) -> int:
+        """
+        The number of diff rows merged into a row already pending for their price level, since the book was created.
+        """
+        return self._coalescer.getMergedCount()
+
+    def set_fixed_point_increments(self, price_increment: float, amount_increment: float = 0):
+        """
+        Switches the book to fixed point mode. Prices and amounts are rounded to whole multiples of the increments,
+        usually the connector's TradingRule.min_price_increment and min_base_amount_increment, and levels are matched
+        by their integer tick counts instead of by comparing doubles. Levels already in the book are rounded too.
+
+        A zero price increment switches back to plain doubles. A zero amount increment leaves amounts unrounded.
+        """
+        if price_increment < 0 or amount_increment < 0:
+            raise ValueError("Fixed point increments cannot be negative.")
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        self._coalescer.setPriceIncrement(float(price_increment))
+        self._bid_book.setFixedPointIncrements(float(price_increment), float(amount_increment))
+        self._ask_book.setFixedPointIncrements(float(price_increment), float(amount_increment))
+        truncateOverlapEntries(self._bid_book, self._ask_book, self._dex)
+        self._bid_book.syncTopLevels()
+        self._ask_book.syncTopLevels()
+        self._features.update(self._bid_book, self._ask_book)
+        if not self._bid_book.empty():
+            self._best_bid = self._bid_book.best().getPrice()
+        if not self._ask_book.empty():
+            self._best_ask = self._ask_book.best().getPrice()
+        self._version += 1
+        self.c_unlock_book()
+
+    @property
+    def fixed_point_increments(self) -> Tuple[float, float]:
+        """
+        The (price, amount) increments of fixed point mode, or (0, 0) if the book stores plain doubles.
+        """
+        return self._bid_book.getPriceIncrement(), self._bid_book.getAmountIncrement()
+
+    @property
+    def depth_index_enabled(self) -> bool:
+        """
+        Keeps cumulative volumes by depth on both sides, so repeated depth queries against an unchanged book are binary
+        searches instead of full walks. The index is rebuilt on the first query after a book update.
+        """
+        return self._bid_book.getDepthIndexEnabled()
+
+    @depth_index_enabled.setter
+    def depth_index_enabled(self, value: bool):
+        self.c_lock_book()
+        self._bid_book.setDepthIndexEnabled(value)
+        self._ask_book.setDepthIndexEnabled(value)
+        self.c_unlock_book()
+
     @property
     def snapshot_uid(self) -> int:
         return self._snapshot_uid
 
     @property
     def last_diff_uid(self) -> int:
+        if self._concurrent:
+            return self._sync.getLastDiffUid()
         return self._last_diff_uid
 
+    @property
+    def version(self) -> int:
+        """
+        Counts the updates of the book: snapshots, diffs, including diffs held back in coalescing mode and diffs applied
+        by an OrderBookWorkerPool, and trades. Readers can compare it to an earlier value to tell whether the book has
+        changed since.
+        """
+        return self.c_get_version()
+
+    @property
+    def stats(self) -> OrderBookStatsSnapshot:
+        cdef:
+            OrderBookCounters counters
+
+        self.c_lock_book()
+        try:
+            counters = self._stats.getCounters()
+            return OrderBookStatsSnapshot(
+                counters.diffBatches,
+                counters.diffLevels,
+                self._bid_book.getLevelCounts().inserted + self._ask_book.getLevelCounts().inserted,
+                self._bid_book.getLevelCounts().updated + self._ask_book.getLevelCounts().updated,
+                self._bid_book.getLevelCounts().erased + self._ask_book.getLevelCounts().erased,
+                counters.truncations,
+                counters.truncatedLevels,
+                counters.snapshots,
+                counters.updateIdGaps,
+                max(self._snapshot_uid, self._last_diff_uid),
+                c_histogram_summary(self._stats.getDiffApplyTimes(), 1e-9),
+                c_histogram_summary(self._stats.getDiffBatchLevels(), 1),
+                c_histogram_summary(self._stats.getSnapshotApplyTimes(), 1e-9),
+                c_histogram_summary(self._stats.getExchangeLags(), 1e-9),
+            )
+        finally:
+            self.c_unlock_book()
+
+    def reset_stats(self):
+        self.c_lock_book()
+        self._stats.clear()
+        self._bid_book.clearLevelCounts()
+        self._ask_book.clearLevelCounts()
+        self.c_unlock_book()
+
+    def record_diff_arrival(self, double exchange_timestamp, int64_t first_update_id=-1):
+        """
+        Records a diff message in the stats as it arrives, before it is applied: how long after its exchange timestamp
+        it arrived, and whether its first update ID follows on from the last update applied to the book. Exchanges that
+        do not number their diffs contiguously pass -1 as the first update ID. A NaN timestamp skips the lag.
+        """
+        cdef:
+            int64_t last_update_id
+            double lag = time.time() - exchange_timestamp
+
+        self.c_lock_book()
+        last_update_id = max(self._snapshot_uid, self._last_diff_uid)
+        if lag == lag:
+            self._stats.recordExchangeLag(<int64_t>(min(max(lag, 0.0), 1e9) * 1e9))
+        if first_update_id >= 0 and last_update_id > 0 and first_update_id > last_update_id + 1:
+            self._stats.recordUpdateIdGap()
+        self.c_unlock_book()
+
     @property
     def snapshot(self) -> Tuple[pd.DataFrame, pd.DataFrame]:
-        bids_rows = list(self.bid_entries())
-        asks_rows = list(self.ask_entries())
-        bids_df = pd.DataFrame(data=bids_rows, columns=OrderBookRow._fields, dtype="float64")
-        asks_df = pd.DataFrame(data=asks_rows, columns=OrderBookRow._fields, dtype="float64")
+        bids_array, asks_array = self.snapshot_arrays()
+        bids_df = pd.DataFrame(data=bids_array, columns=OrderBookRow._fields, dtype="float64")
+        asks_df = pd.DataFrame(data=asks_array, columns=OrderBookRow._fields, dtype="float64")
         return bids_df, asks_df
 
+    def snapshot_arrays(self,
+                        bids_out: Optional[np.ndarray] = None,
+                        asks_out: Optional[np.ndarray] = None) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Exports both sides of the book as float64 (N, 3) [price, amount, update_id] arrays, best level first, without
+        building any row objects.
+
+        If C-contiguous float64 (M, 3) buffers are given, the levels are written into them instead of new arrays, and
+        views of their first min(N, M) rows are returned. This lets callers reuse the same buffers on every snapshot.
+        """
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        try:
+            return c_export_book_side(ref(self._bid_book), bids_out), c_export_book_side(ref(self._ask_book), asks_out)
+        finally:
+            self.c_unlock_book()
+
+    def save_cache(self, str path, str trading_pair = ""):
+        """
+        Writes the levels of the book and its snapshot and last diff update IDs to a warm start cache file, replacing
+        the previous one in a single rename. Only copying the levels happens under the book lock.
+        """
+        cdef:
+            OrderBookCacheWriter writer
+            string cpp_path = path.encode("utf8")
+            string cpp_trading_pair = trading_pair.encode("utf8")
+            bint written
+
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        writer.capture(self._bid_book, self._ask_book, self._snapshot_uid, self._last_diff_uid)
+        self.c_unlock_book()
+        with nogil:
+            written = writer.write(cpp_path, cpp_trading_pair, NAN)
+        if not written:
+            raise IOError(f"Could not write the order book cache file {path}.")
+
+    def load_cache(self, str path, str trading_pair = "", double max_age = INFINITY) -> bool:
+        """
+        Restores the book from a cache file written by save_cache(). Returns False, leaving the book as it is, if the
+        file is missing or invalid, belongs to another trading pair, or was written more than max_age seconds ago.
+
+        The cached levels are applied as a snapshot as of the last update ID of the cache, so that diffs the cached
+        state already covers are rejected like diffs older than a snapshot. The last diff update ID is restored too.
+        """
+        cdef:
+            OrderBookCacheReader reader
+            int64_t update_id
+
+        if not reader.open(path.encode("utf8")):
+            return False
+        if trading_pair and reader.getTradingPair().decode("utf8") != trading_pair:
+            return False
+        if time.time() - reader.getTimestamp() > max_age:
+            return False
+        update_id = max(reader.getSnapshotUid(), reader.getLastDiffUid())
+        self.c_apply_snapshot_rows(reader.getBidRows(), reader.getBidCount(), reader.getAskRows(), reader.getAskCount(),
+                                   update_id)
+        self.c_lock_book()
+        self._last_diff_uid = reader.getLastDiffUid()
+        self.c_unlock_book()
+        return True
+
     def apply_diffs(self, bids: List[OrderBookRow], asks: List[OrderBookRow], update_id: int):
         cdef:
             vector[OrderBookEntry] cpp_bids
@@ -222,18 +864,7 @@ cdef class OrderBook(PubSub):
         The diffs data frame must have 3 columns, [price, amount, update_id].
         All columns are of double type.
         """
-        cdef:
-            vector[OrderBookEntry] cpp_bids
-            vector[OrderBookEntry] cpp_asks
-            int64_t last_update_id = 0
-
-        for row in bids_array:
-            cpp_bids.push_back(OrderBookEntry(row[0], row[1], <int64_t>(row[2])))
-            last_update_id = max(last_update_id, <int64_t>row[2])
-        for row in asks_array:
-            cpp_asks.push_back(OrderBookEntry(row[0], row[1], <int64_t>(row[2])))
-            last_update_id = max(last_update_id, <int64_t>row[2])
-        self.c_apply_diffs(cpp_bids, cpp_asks, last_update_id)
+        self.c_apply_diff_rows(np.ascontiguousarray(bids_array[:, :3]), np.ascontiguousarray(asks_array[:, :3]))
 
     def apply_numpy_snapshot(self, bids_array: np.ndarray, asks_array: np.ndarray):
         """
@@ -263,22 +894,36 @@ cdef class OrderBook(PubSub):
         self.c_apply_snapshot(cpp_bids, cpp_asks, last_update_id)
 
     def bid_entries(self) -> Iterator[OrderBookRow]:
+        # Walk by depth rather than by iterator: the book may be updated while the generator is suspended, and that
+        # would invalidate an iterator into the contiguous level storage.
         cdef:
-            set[OrderBookEntry].reverse_iterator it = self._bid_book.rbegin()
+            size_t depth = 0
             OrderBookEntry entry
-        while it != self._bid_book.rend():
-            entry = deref(it)
+        self.c_flush_coalesced_diffs()
+        while True:
+            self.c_lock_book()
+            if depth >= self._bid_book.size():
+                self.c_unlock_book()
+                break
+            entry = self._bid_book.getLevel(depth)
+            self.c_unlock_book()
             yield OrderBookRow(entry.getPrice(), entry.getAmount(), entry.getUpdateId())
-            inc(it)
+            depth += 1
 
     def ask_entries(self) -> Iterator[OrderBookRow]:
         cdef:
-            set[OrderBookEntry].iterator it = self._ask_book.begin()
+            size_t depth = 0
             OrderBookEntry entry
-        while it != self._ask_book.end():
-            entry = deref(it)
+        self.c_flush_coalesced_diffs()
+        while True:
+            self.c_lock_book()
+            if depth >= self._ask_book.size():
+                self.c_unlock_book()
+                break
+            entry = self._ask_book.getLevel(depth)
+            self.c_unlock_book()
             yield OrderBookRow(entry.getPrice(), entry.getAmount(), entry.getUpdateId())
-            inc(it)
+            depth += 1
 
     def simulate_buy(self, amount: float) -> List[OrderBookRow]:
         amount_left = amount
@@ -310,7 +955,14 @@ cdef class OrderBook(PubSub):
 
     cdef double c_get_price(self, bint is_buy) except? -1:
         cdef:
-            set[OrderBookEntry] *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            TopOfBook top
+        self.c_flush_coalesced_diffs()
+        if self._concurrent:
+            top = self._sync.readTopOfBook()
+            if (top.askAmount if is_buy else top.bidAmount) <= 0:
+                raise EnvironmentError("Order book is empty - no price quote is possible.")
+            return top.askPrice if is_buy else top.bidPrice
         if deref(book).size() < 1:
             raise EnvironmentError("Order book is empty - no price quote is possible.")
         return self._best_ask if is_buy else self._best_bid
@@ -318,144 +970,132 @@ cdef class OrderBook(PubSub):
     def get_price(self, is_buy: bool) -> float:
         return self.c_get_price(is_buy)
 
-    cdef OrderBookQueryResult c_get_price_for_volume(self, bint is_buy, double volume):
+    cdef double c_get_microprice(self):
+        cdef:
+            double value
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        value = self._features.getValues().microprice
+        self.c_unlock_book()
+        return value
+
+    cdef double c_get_depth_imbalance(self):
+        cdef:
+            double value
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        value = self._features.getValues().depthImbalance
+        self.c_unlock_book()
+        return value
+
+    cdef double c_get_book_pressure(self):
         cdef:
-            double cumulative_volume = 0
-            double result_price = NaN
+            double value
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        value = self._features.getValues().bookPressure
+        self.c_unlock_book()
+        return value
+
+    cdef double c_get_weighted_mid(self):
+        cdef:
+            double value
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        value = self._features.getValues().weightedMid
+        self.c_unlock_book()
+        return value
+
+    def configure_features(self, depth: int = 5, pressure_bps: float = 10):
+        """
+        Keeps the microprice, the depth imbalance over the top depth levels, the book pressure within pressure_bps of
+        the mid price and the level weighted mid up to date as the book changes, natively and under the book lock. See
+        OrderBookFeatureEngine.h for their definitions. A depth of 0 turns the features off, and they read as NaN.
+        """
+        if depth < 0 or pressure_bps < 0:
+            raise ValueError("The feature depth and pressure band cannot be negative.")
+        self.c_lock_book()
+        self._features.configure(depth, float(pressure_bps))
+        self._features.update(self._bid_book, self._ask_book)
+        self.c_unlock_book()
 
-        if is_buy:
-            for order_book_row in self.ask_entries():
-                cumulative_volume += order_book_row.amount
-                if cumulative_volume >= volume:
-                    result_price = order_book_row.price
-                    break
-        else:
-            for order_book_row in self.bid_entries():
-                cumulative_volume += order_book_row.amount
-                if cumulative_volume >= volume:
-                    result_price = order_book_row.price
-                    break
+    @property
+    def features(self) -> OrderBookFeatures:
+        cdef:
+            OrderBookFeatureValues values
+
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        values = self._features.getValues()
+        self.c_unlock_book()
+        return OrderBookFeatures(
+            values.microprice,
+            values.depthImbalance,
+            values.bidPressureVolume,
+            values.askPressureVolume,
+            values.bookPressure,
+            values.weightedMid,
+        )
 
-        return OrderBookQueryResult(NaN, volume, result_price, min(cumulative_volume, volume))
+    cdef OrderBookQueryResult c_get_price_for_volume(self, bint is_buy, double volume):
+        cdef:
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            DepthQueryResult result
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        result = deref(book).getPriceForVolume(volume)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
 
     cdef OrderBookQueryResult c_get_vwap_for_volume(self, bint is_buy, double volume):
         cdef:
-            double total_cost = 0
-            double total_volume = 0
-            double result_vwap = NaN
-        if is_buy:
-            for order_book_row in self.ask_entries():
-                total_cost += order_book_row.amount * order_book_row.price
-                total_volume += order_book_row.amount
-                if total_volume >= volume:
-                    total_cost -= order_book_row.amount * order_book_row.price
-                    total_volume -= order_book_row.amount
-                    incremental_amount = volume - total_volume
-                    total_cost += incremental_amount * order_book_row.price
-                    total_volume += incremental_amount
-                    result_vwap = total_cost / total_volume
-                    break
-        else:
-            for order_book_row in self.bid_entries():
-                total_cost += order_book_row.amount * order_book_row.price
-                total_volume += order_book_row.amount
-                if total_volume >= volume:
-                    total_cost -= order_book_row.amount * order_book_row.price
-                    total_volume -= order_book_row.amount
-                    incremental_amount = volume - total_volume
-                    total_cost += incremental_amount * order_book_row.price
-                    total_volume += incremental_amount
-                    result_vwap = total_cost / total_volume
-                    break
-
-        return OrderBookQueryResult(NaN, volume, result_vwap, min(total_volume, volume))
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            DepthQueryResult result
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        result = deref(book).getVwapForVolume(volume)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
 
     cdef OrderBookQueryResult c_get_price_for_quote_volume(self, bint is_buy, double quote_volume):
         cdef:
-            double cumulative_volume = 0
-            double result_price = NaN
-
-        if is_buy:
-            for order_book_row in self.ask_entries():
-                cumulative_volume += order_book_row.amount * order_book_row.price
-                if cumulative_volume >= quote_volume:
-                    result_price = order_book_row.price
-                    break
-        else:
-            for order_book_row in self.bid_entries():
-                cumulative_volume += order_book_row.amount * order_book_row.price
-                if cumulative_volume >= quote_volume:
-                    result_price = order_book_row.price
-                    break
-
-        return OrderBookQueryResult(NaN, quote_volume, result_price, min(cumulative_volume, quote_volume))
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            DepthQueryResult result
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        result = deref(book).getPriceForQuoteVolume(quote_volume)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
 
     cdef OrderBookQueryResult c_get_quote_volume_for_base_amount(self, bint is_buy, double base_amount):
         cdef:
-            double cumulative_volume = 0
-            double cumulative_base_amount = 0
-            double row_amount = 0
-
-        if is_buy:
-            for order_book_row in self.ask_entries():
-                row_amount = order_book_row.amount
-                if row_amount + cumulative_base_amount >= base_amount:
-                    row_amount = base_amount - cumulative_base_amount
-                cumulative_base_amount += row_amount
-                cumulative_volume += row_amount * order_book_row.price
-                if cumulative_base_amount >= base_amount:
-                    break
-        else:
-            for order_book_row in self.bid_entries():
-                row_amount = order_book_row.amount
-                if row_amount + cumulative_base_amount >= base_amount:
-                    row_amount = base_amount - cumulative_base_amount
-                cumulative_base_amount += row_amount
-                cumulative_volume += row_amount * order_book_row.price
-                if cumulative_base_amount >= base_amount:
-                    break
-
-        return OrderBookQueryResult(NaN, base_amount, NaN, cumulative_volume)
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            DepthQueryResult result
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        result = deref(book).getQuoteVolumeForBaseAmount(base_amount)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
 
     cdef OrderBookQueryResult c_get_volume_for_price(self, bint is_buy, double price):
         cdef:
-            double cumulative_volume = 0
-            double result_price = NaN
-
-        if is_buy:
-            for order_book_row in self.ask_entries():
-                if order_book_row.price > price:
-                    break
-                cumulative_volume += order_book_row.amount
-                result_price = order_book_row.price
-        else:
-            for order_book_row in self.bid_entries():
-                if order_book_row.price < price:
-                    break
-                cumulative_volume += order_book_row.amount
-                result_price = order_book_row.price
-
-        return OrderBookQueryResult(price, NaN, result_price, cumulative_volume)
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            DepthQueryResult result
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        result = deref(book).getVolumeForPrice(price)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
 
     cdef OrderBookQueryResult c_get_quote_volume_for_price(self, bint is_buy, double price):
         cdef:
-            double cumulative_volume = 0
-            double result_price = NaN
-
-        if is_buy:
-            for order_book_row in self.ask_entries():
-                if order_book_row.price > price:
-                    break
-                cumulative_volume += order_book_row.amount * order_book_row.price
-                result_price = order_book_row.price
-        else:
-            for order_book_row in self.bid_entries():
-                if order_book_row.price < price:
-                    break
-                cumulative_volume += order_book_row.amount * order_book_row.price
-                result_price = order_book_row.price
-
-        return OrderBookQueryResult(price, NaN, result_price, cumulative_volume)
+            OrderBookSide *book = ref(self._ask_book) if is_buy else ref(self._bid_book)
+            DepthQueryResult result
+        self.c_flush_coalesced_diffs()
+        self.c_lock_book()
+        result = deref(book).getQuoteVolumeForPrice(price)
+        self.c_unlock_book()
+        return c_depth_query_result(result)
 
     def get_price_for_volume(self, is_buy: bool, volume: float) -> OrderBookQueryResult:
         return self.c_get_price_for_volume(is_buy, volume)
@@ -475,9 +1115,53 @@ cdef class OrderBook(PubSub):
     def get_quote_volume_for_price(self, is_buy: bool, price: float) -> OrderBookQueryResult:
         return self.c_get_quote_volume_for_price(is_buy, price)
 
-    def restore_from_snapshot_and_diffs(self, snapshot: OrderBookMessage, diffs: List[OrderBookMessage]):
-        replay_position = bisect.bisect_right(diffs, snapshot)
-        replay_diffs = diffs[replay_position:]
-        self.apply_snapshot(snapshot.bids, snapshot.asks, snapshot.update_id)
-        for diff in replay_diffs:
-            self.apply_diffs(diff.bids, diff.asks, diff.update_id)
+    def restore_from_snapshot_and_diffs(self,
+                                        snapshot: OrderBookMessage,
+                                        diffs: List[OrderBookMessage]) -> OrderBookReconcileResult:
+        """
+        Applies the snapshot, then the diffs that are newer than it, in order. Diffs carrying a first_update_id are
+        checked for gaps in the update ID sequence; a gap stops the replay and is reported in the result, so the caller
+        can fetch a fresh snapshot.
+        """
+        cdef:
+            vector[OrderBookEntry] cpp_bids
+            vector[OrderBookEntry] cpp_asks
+            vector[double] diff_rows
+
+        for row in snapshot.bids:
+            cpp_bids.push_back(OrderBookEntry(row.price, row.amount, row.update_id))
+        for row in snapshot.asks:
+            cpp_asks.push_back(OrderBookEntry(row.price, row.amount, row.update_id))
+        for diff in diffs:
+            c_pack_diff_message(diff, diff_rows)
+        return c_reconcile_result(self.c_restore_from_snapshot_rows(cpp_bids, cpp_asks, snapshot.update_id,
+                                                                    diff_rows.data(), diff_rows.size() // 5))
+
+    def restore_from_numpy_snapshot_and_diffs(self,
+                                              bids_array: np.ndarray,
+                                              asks_array: np.ndarray,
+                                              update_id: int,
+                                              diffs_array: np.ndarray) -> OrderBookReconcileResult:
+        """
+        Same as restore_from_snapshot_and_diffs(), from packed rows. The snapshot arrays have 3 columns,
+        [price, amount, update_id], and the diffs array 5, [price, amount, update_id, first_update_id, is_bid], with
+        the rows of each diff message next to each other. A NaN first_update_id skips the gap check for its message,
+        and a row with a NaN price stands for a message with no levels.
+        """
+        cdef:
+            vector[OrderBookEntry] cpp_bids
+            vector[OrderBookEntry] cpp_asks
+            const double[:, ::1] diff_rows
+            const double *diff_data = NULL
+
+        if diffs_array.ndim != 2 or diffs_array.shape[1] < 5:
+            raise ValueError("Diff rows must have 5 columns: [price, amount, update_id, first_update_id, is_bid].")
+        diff_rows = np.ascontiguousarray(diffs_array[:, :5], dtype=np.float64)
+        for row in bids_array:
+            cpp_bids.push_back(OrderBookEntry(row[0], row[1], <int64_t>row[2]))
+        for row in asks_array:
+            cpp_asks.push_back(OrderBookEntry(row[0], row[1], <int64_t>row[2]))
+        if diff_rows.shape[0] > 0:
+            diff_data = &diff_rows[0, 0]
+        return c_reconcile_result(self.c_restore_from_snapshot_rows(cpp_bids, cpp_asks, update_id,
+                                                                    diff_data, diff_rows.shape[0]))
@@ -0,0 +1,19 @@
+#!/usr/bin/env python
+
+from typing import NamedTuple
+
+
+class OrderBookFeatures(NamedTuple):
+    """
+    Features of the top of an OrderBook, kept up to date by the book once OrderBook.configure_features() is called.
+    Everything is NaN while the features are off or a side of the book is empty.
+
+    The depth imbalance and the book pressure are in [-1, 1] and positive when the bids outweigh the asks. The pressure
+    volumes are the base amounts quoted within the pressure band around the mid price.
+    """
+    microprice: float
+    depth_imbalance: float
+    bid_pressure_volume: float
+    ask_pressure_volume: float
+    book_pressure: float
+    weighted_mid: float
@@ -0,0 +1,25 @@
+#!/usr/bin/env python
+
+from enum import Enum
+from typing import NamedTuple
+
+
+class OrderBookReconcileStatus(Enum):
+    SYNCED = 0
+    GAP = 1
+
+
+class OrderBookReconcileResult(NamedTuple):
+    """
+    The outcome of restoring an OrderBook from a snapshot and the diffs buffered around it. After a GAP, the book is
+    left at last_update_id, the last update that follows on contiguously from the snapshot, and needs a fresh snapshot.
+    """
+    status: OrderBookReconcileStatus
+    last_update_id: int
+    applied_diffs: int
+    skipped_diffs: int
+    gap_first_update_id: int
+
+    @property
+    def in_sync(self) -> bool:
+        return self.status is OrderBookReconcileStatus.SYNCED
@@ -13,6 +13,18 @@ class OrderBookRow(namedtuple("_OrderBookRow", "price, amount, update_id")):
     update_id: int
 
 
+class OrderBookTop(namedtuple("_OrderBookTop", "bid_price, bid_amount, ask_price, ask_amount, update_id, version")):
+    """
+    The best levels of an OrderBook as of one update, read without blocking the thread that maintains the book.
+    """
+    bid_price: float
+    bid_amount: float
+    ask_price: float
+    ask_amount: float
+    update_id: int
+    version: int
+
+
 class ClientOrderBookRow(namedtuple("_OrderBookRow", "price, amount, update_id")):
     """
     Used in market classes where OrderBook values are converted to Decimal.
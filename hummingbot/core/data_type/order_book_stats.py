@@ -0,0 +1,42 @@
+#!/usr/bin/env python
+
+from typing import NamedTuple
+
+
+class HistogramSummary(NamedTuple):
+    """
+    Percentiles of a histogram of an OrderBook's stats, accurate to about 6%. Times are in seconds. The mean is NaN and
+    the rest 0 if nothing was recorded.
+    """
+    count: int
+    min: float
+    mean: float
+    p50: float
+    p90: float
+    p99: float
+    p999: float
+    max: float
+
+
+class OrderBookStatsSnapshot(NamedTuple):
+    """
+    The instrumentation of an OrderBook since it was created or its stats were last reset.
+
+    Truncations count the diff batches whose overlap truncation removed crossed levels, and truncated_levels the levels
+    it removed. Update ID gaps are diffs that did not follow on from the last update applied, seen on arrival or while
+    restoring from a snapshot. The exchange lag is how long after their exchange timestamp the diffs arrived.
+    """
+    diff_batches: int
+    diff_levels: int
+    levels_inserted: int
+    levels_updated: int
+    levels_erased: int
+    truncations: int
+    truncated_levels: int
+    snapshots: int
+    update_id_gaps: int
+    last_update_id: int
+    diff_apply_time: HistogramSummary
+    diff_batch_levels: HistogramSummary
+    snapshot_apply_time: HistogramSummary
+    exchange_lag: HistogramSummary
@@ -1,15 +1,19 @@
 import asyncio
 import logging
+import os
+import re
 import time
 from collections import defaultdict, deque
 from enum import Enum
-from typing import Deque, Dict, List, Optional, Tuple
+from typing import Deque, Dict, List, Optional, Set, Tuple
 
 import pandas as pd
 
 from hummingbot.core.data_type.common import TradeType
 from hummingbot.core.data_type.order_book import OrderBook
 from hummingbot.core.data_type.order_book_message import OrderBookMessage, OrderBookMessageType
+from hummingbot.core.data_type.order_book_reconcile_result import OrderBookReconcileResult
+from hummingbot.core.data_type.order_book_stats import OrderBookStatsSnapshot
 from hummingbot.core.data_type.order_book_tracker_data_source import OrderBookTrackerDataSource
 from hummingbot.core.event.events import OrderBookTradeEvent
 from hummingbot.core.utils.async_utils import safe_ensure_future
@@ -23,6 +27,11 @@ class OrderBookTrackerDataSourceType(Enum):
 
 class OrderBookTracker:
     PAST_DIFF_WINDOW_SIZE: int = 32
+    # How old a warm start cache file may be for the tracker to start from it, and how often the files are rewritten.
+    ORDER_BOOK_CACHE_MAX_AGE: float = 300.0
+    ORDER_BOOK_CACHE_SAVE_INTERVAL: float = 10.0
+    # How long a book started from the cache may wait for its first live diff before a REST snapshot is requested.
+    ORDER_BOOK_CACHE_VERIFY_TIMEOUT: float = 10.0
     _obt_logger: Optional[HummingbotLogger] = None
 
     @classmethod
@@ -31,12 +40,23 @@ class OrderBookTracker:
             cls._obt_logger = logging.getLogger(__name__)
         return cls._obt_logger
 
-    def __init__(self, data_source: OrderBookTrackerDataSource, trading_pairs: List[str], domain: Optional[str] = None):
+    def __init__(self,
+                 data_source: OrderBookTrackerDataSource,
+                 trading_pairs: List[str],
+                 domain: Optional[str] = None,
+                 order_book_cache_dir: Optional[str] = None):
         self._domain: Optional[str] = domain
+        self._order_book_cache_dir: Optional[str] = order_book_cache_dir
+        # Books started from the cache are tracked here, out of order_books and the ready state, until their first diff
+        # follows on from the cache or, when it does not, until a REST snapshot has been applied to them.
+        self._unverified_cached_books: Dict[str, OrderBook] = {}
+        self._resyncing_cached_books: Set[str] = set()
+        self._cached_books_verified: asyncio.Event = asyncio.Event()
         self._data_source: OrderBookTrackerDataSource = data_source
         self._trading_pairs: List[str] = trading_pairs
         self._order_books_initialized: asyncio.Event = asyncio.Event()
         self._tracking_tasks: Dict[str, asyncio.Task] = {}
+        self._resync_tasks: Dict[str, asyncio.Task] = {}
         self._order_books: Dict[str, OrderBook] = {}
         self._tracking_message_queues: Dict[str, asyncio.Queue] = {}
         self._past_diffs_windows: Dict[str, Deque] = defaultdict(lambda: deque(maxlen=self.PAST_DIFF_WINDOW_SIZE))
@@ -55,6 +75,7 @@ class OrderBookTracker:
         self._order_book_snapshot_router_task: Optional[asyncio.Task] = None
         self._update_last_trade_prices_task: Optional[asyncio.Task] = None
         self._order_book_stream_listener_task: Optional[asyncio.Task] = None
+        self._save_order_book_cache_task: Optional[asyncio.Task] = None
 
     @property
     def data_source(self) -> OrderBookTrackerDataSource:
@@ -68,6 +89,16 @@ class OrderBookTracker:
     def ready(self) -> bool:
         return self._order_books_initialized.is_set()
 
+    @property
+    def order_book_stats(self) -> Dict[str, OrderBookStatsSnapshot]:
+        """
+        The instrumentation of every tracked order book, by trading pair. Cheap enough to poll for metrics.
+        """
+        return {
+            trading_pair: order_book.stats
+            for trading_pair, order_book in self._order_books.items()
+        }
+
     @property
     def snapshot(self) -> Dict[str, Tuple[pd.DataFrame, pd.DataFrame]]:
         return {
@@ -104,6 +135,10 @@ class OrderBookTracker:
         self._update_last_trade_prices_task = safe_ensure_future(
             self._update_last_trade_prices_loop()
         )
+        if self._order_book_cache_dir is not None:
+            self._save_order_book_cache_task = safe_ensure_future(
+                self._save_order_book_cache_loop()
+            )
 
     def stop(self):
         if self._init_order_books_task is not None:
@@ -133,10 +168,19 @@ class OrderBookTracker:
             self._update_last_trade_prices_task = None
         if self._order_book_stream_listener_task is not None:
             self._order_book_stream_listener_task.cancel()
+        if self._save_order_book_cache_task is not None:
+            self._save_order_book_cache_task.cancel()
+            self._save_order_book_cache_task = None
+            self.save_order_book_cache()
         if len(self._tracking_tasks) > 0:
             for _, task in self._tracking_tasks.items():
                 task.cancel()
             self._tracking_tasks.clear()
+        for task in self._resync_tasks.values():
+            task.cancel()
+        self._resync_tasks.clear()
+        self._unverified_cached_books.clear()
+        self._resyncing_cached_books.clear()
         self._order_books_initialized.clear()
 
     async def wait_ready(self):
@@ -174,17 +218,117 @@ class OrderBookTracker:
 
     async def _init_order_books(self):
         """
-        Initialize order books
+        Initialize order books. With a cache directory, books with a recent enough cache file start from it without a
+        REST request, and only the others are fetched, one per second. The tracker is only ready once the books started
+        from the cache have been verified against the live feed.
         """
+        self._cached_books_verified.clear()
         for index, trading_pair in enumerate(self._trading_pairs):
-            self._order_books[trading_pair] = await self._initial_order_book_for_trading_pair(trading_pair)
+            order_book: Optional[OrderBook] = self._cached_order_book_for_trading_pair(trading_pair)
+            if order_book is not None:
+                self._unverified_cached_books[trading_pair] = order_book
+            else:
+                order_book = await self._initial_order_book_for_trading_pair(trading_pair)
+                self._order_books[trading_pair] = order_book
             self._tracking_message_queues[trading_pair] = asyncio.Queue()
             self._tracking_tasks[trading_pair] = safe_ensure_future(self._track_single_book(trading_pair))
-            self.logger().info(f"Initialized order book for {trading_pair}. "
+            self.logger().info(f"Initialized order book for {trading_pair}"
+                               f"{' from the cache' if trading_pair in self._unverified_cached_books else ''}. "
                                f"{index + 1}/{len(self._trading_pairs)} completed.")
-            await self._sleep(delay=1)
+            if trading_pair not in self._unverified_cached_books:
+                await self._sleep(delay=1)
+        await self._wait_cached_books_verified()
         self._order_books_initialized.set()
 
+    async def _wait_cached_books_verified(self):
+        if len(self._unverified_cached_books) == 0:
+            return
+        try:
+            await asyncio.wait_for(self._cached_books_verified.wait(), timeout=self.ORDER_BOOK_CACHE_VERIFY_TIMEOUT)
+        except asyncio.TimeoutError:
+            # Without a diff to check the cache against, the books are resynced from a REST snapshot instead.
+            for trading_pair in list(self._unverified_cached_books):
+                if trading_pair not in self._resyncing_cached_books:
+                    self.logger().info(f"No order book diff for {trading_pair} to verify the cache against. "
+                                       f"Requesting a new snapshot.")
+                    self._resyncing_cached_books.add(trading_pair)
+                    self._request_resync(trading_pair)
+            await self._cached_books_verified.wait()
+
+    def _tracked_order_book(self, trading_pair: str) -> OrderBook:
+        order_book: Optional[OrderBook] = self._unverified_cached_books.get(trading_pair)
+        return self._order_books[trading_pair] if order_book is None else order_book
+
+    def _mark_cached_order_book_verified(self, trading_pair: str):
+        self._order_books[trading_pair] = self._unverified_cached_books.pop(trading_pair)
+        self._resyncing_cached_books.discard(trading_pair)
+        if len(self._unverified_cached_books) == 0:
+            self._cached_books_verified.set()
+
+    def _order_book_cache_path(self, trading_pair: str) -> str:
+        return os.path.join(self._order_book_cache_dir, re.sub(r"[^A-Za-z0-9_.-]", "_", trading_pair) + ".book")
+
+    def _cached_order_book_for_trading_pair(self, trading_pair: str) -> Optional[OrderBook]:
+        if self._order_book_cache_dir is None:
+            return None
+        order_book: OrderBook = self._data_source.order_book_create_function()
+        try:
+            if order_book.load_cache(self._order_book_cache_path(trading_pair), trading_pair,
+                                     self.ORDER_BOOK_CACHE_MAX_AGE):
+                return order_book
+        except Exception:
+            self.logger().warning(f"Could not read the order book cache of {trading_pair}.", exc_info=True)
+        return None
+
+    def save_order_book_cache(self):
+        """
+        Writes the state of every tracked order book to the cache directory, for the next start to warm start from.
+        Books started from the cache are only written once they have been verified against the live feed.
+        """
+        if self._order_book_cache_dir is None:
+            return
+        os.makedirs(self._order_book_cache_dir, exist_ok=True)
+        for trading_pair, order_book in self._order_books.items():
+            try:
+                order_book.save_cache(self._order_book_cache_path(trading_pair), trading_pair)
+            except Exception:
+                self.logger().warning(f"Could not write the order book cache of {trading_pair}.", exc_info=True)
+
+    async def _save_order_book_cache_loop(self):
+        await self._order_books_initialized.wait()
+        while True:
+            try:
+                await self._sleep(delay=self.ORDER_BOOK_CACHE_SAVE_INTERVAL)
+                self.save_order_book_cache()
+            except asyncio.CancelledError:
+                raise
+            except Exception:
+                self.logger().error("Unexpected error saving the order book cache.", exc_info=True)
+
+    def _verify_cached_order_book(self, trading_pair: str, order_book: OrderBook, message: OrderBookMessage) -> bool:
+        """
+        Checks the first live diff of a book started from the cache. Returns False for a diff the cache already covers.
+        A diff that follows on from the cache verifies the book. One that does not, or that cannot tell because the
+        exchange does not number its diffs contiguously, requests a REST snapshot, and the book is verified once it has
+        been applied; the diffs keep being applied until then.
+        """
+        if trading_pair in self._resyncing_cached_books:
+            return True
+        last_update_id: int = max(order_book.snapshot_uid, order_book.last_diff_uid)
+        if message.update_id <= last_update_id:
+            return False
+        content = message.content
+        first_update_id: Optional[int] = content.get("first_update_id") if isinstance(content, dict) else None
+        first_update_id = -1 if first_update_id is None else first_update_id
+        if first_update_id < 0 or first_update_id > last_update_id + 1:
+            self.logger().info(f"Order book diffs for {trading_pair} do not follow on from the cache at update "
+                               f"{last_update_id}. Requesting a new snapshot.")
+            self._resyncing_cached_books.add(trading_pair)
+            self._request_resync(trading_pair)
+        else:
+            self._mark_cached_order_book_verified(trading_pair)
+        return True
+
     async def _order_book_diff_router(self):
         """
         Routes the real-time order book diff messages to the correct order book.
@@ -206,7 +350,7 @@ class OrderBookTracker:
                     continue
                 message_queue: asyncio.Queue = self._tracking_message_queues[trading_pair]
                 # Check the order book's initial update ID. If it's larger, don't bother.
-                order_book: OrderBook = self._order_books[trading_pair]
+                order_book: OrderBook = self._tracked_order_book(trading_pair)
 
                 if order_book.snapshot_uid > ob_message.update_id:
                     messages_rejected += 1
@@ -257,7 +401,7 @@ class OrderBookTracker:
         past_diffs_window = self._past_diffs_windows[trading_pair]
 
         message_queue: asyncio.Queue = self._tracking_message_queues[trading_pair]
-        order_book: OrderBook = self._order_books[trading_pair]
+        order_book: OrderBook = self._tracked_order_book(trading_pair)
         last_message_timestamp: float = time.time()
         diff_messages_accepted: int = 0
 
@@ -272,6 +416,14 @@ class OrderBookTracker:
                     message = await message_queue.get()
 
                 if message.type is OrderBookMessageType.DIFF:
+                    if (trading_pair in self._unverified_cached_books and
+                            not self._verify_cached_order_book(trading_pair, order_book, message)):
+                        continue
+                    content = message.content
+                    order_book.record_diff_arrival(
+                        float("nan") if message.timestamp is None else message.timestamp,
+                        (content.get("first_update_id") or -1) if isinstance(content, dict) else -1,
+                    )
                     order_book.apply_diffs(message.bids, message.asks, message.update_id)
                     past_diffs_window.append(message)
                     diff_messages_accepted += 1
@@ -284,7 +436,17 @@ class OrderBookTracker:
                     last_message_timestamp = now
                 elif message.type is OrderBookMessageType.SNAPSHOT:
                     past_diffs: List[OrderBookMessage] = list(past_diffs_window)
-                    order_book.restore_from_snapshot_and_diffs(message, past_diffs)
+                    result: Optional[OrderBookReconcileResult] = order_book.restore_from_snapshot_and_diffs(
+                        message, past_diffs
+                    )
+                    if result is not None and not result.in_sync:
+                        self.logger().warning(
+                            f"Order book diffs for {trading_pair} skip from update {result.last_update_id} to "
+                            f"{result.gap_first_update_id}. Requesting a new snapshot."
+                        )
+                        self._request_resync(trading_pair)
+                    elif trading_pair in self._unverified_cached_books:
+                        self._mark_cached_order_book_verified(trading_pair)
             except asyncio.CancelledError:
                 raise
             except Exception:
@@ -295,6 +457,25 @@ class OrderBookTracker:
                 )
                 await asyncio.sleep(5.0)
 
+    def _request_resync(self, trading_pair: str):
+        # One snapshot request at a time per book, however many gaps pile up while it is in flight.
+        task = self._resync_tasks.get(trading_pair)
+        if task is None or task.done():
+            self._resync_tasks[trading_pair] = safe_ensure_future(self._resync_order_book(trading_pair))
+
+    async def _resync_order_book(self, trading_pair: str):
+        try:
+            snapshot: OrderBookMessage = await self._data_source.get_order_book_snapshot(trading_pair)
+            await self._tracking_message_queues[trading_pair].put(snapshot)
+        except asyncio.CancelledError:
+            raise
+        except Exception:
+            self.logger().network(
+                f"Unexpected error fetching a new order book snapshot for {trading_pair}.",
+                exc_info=True,
+                app_warning_msg="Unexpected error resyncing an order book. The next snapshot will resync it."
+            )
+
     async def _emit_trade_event_loop(self):
         last_message_timestamp: float = time.time()
         messages_accepted: int = 0
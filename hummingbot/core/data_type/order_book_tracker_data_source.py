@@ -67,6 +67,17 @@ class OrderBookTrackerDataSource(metaclass=ABCMeta):
         order_book.apply_snapshot(snapshot_msg.bids, snapshot_msg.asks, snapshot_msg.update_id)
         return order_book
 
+    async def get_order_book_snapshot(self, trading_pair: str) -> OrderBookMessage:
+        """
+        Fetches a snapshot of the exchange order book for a particular trading pair, such as to resync a local order
+        book that has missed diffs
+
+        :param trading_pair: the trading pair for which the snapshot has to be retrieved
+
+        :return: the snapshot message
+        """
+        return await self._order_book_snapshot(trading_pair=trading_pair)
+
     async def listen_for_subscriptions(self):
         """
         Connects to the trade events and order diffs websocket endpoints and listens to the messages sent by the
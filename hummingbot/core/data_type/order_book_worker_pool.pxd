@@ -0,0 +1,8 @@
+# distutils: language=c++
+
+from hummingbot.core.data_type.OrderBookWorkerPool cimport OrderBookWorkerPool as CPPOrderBookWorkerPool
+
+
+cdef class OrderBookWorkerPool:
+    cdef CPPOrderBookWorkerPool *_pool
+    cdef dict _order_books
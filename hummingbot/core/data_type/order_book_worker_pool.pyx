@@ -0,0 +1,114 @@
+# distutils: language=c++
+# distutils: sources=['hummingbot/core/cpp/DiffRingBuffer.cpp', 'hummingbot/core/cpp/LatencyHistogram.cpp', 'hummingbot/core/cpp/OrderBookEntry.cpp', 'hummingbot/core/cpp/OrderBookFeatureEngine.cpp', 'hummingbot/core/cpp/OrderBookSide.cpp', 'hummingbot/core/cpp/OrderBookStats.cpp', 'hummingbot/core/cpp/OrderBookSync.cpp', 'hummingbot/core/cpp/OrderBookWorkerPool.cpp']
+from typing import Dict
+
+from libc.stdint cimport int64_t
+
+from hummingbot.core.data_type.order_book cimport OrderBook
+from hummingbot.core.data_type.OrderBookWorkerPool cimport MaintainedOrderBook
+
+DEFAULT_DIFF_RING_CAPACITY = 1 << 16
+
+
+cdef class OrderBookWorkerPool:
+    """
+    Maintains the order books of many trading pairs on a pool of native threads, without the GIL.
+
+    Diffs reach the books through their diff rings (see OrderBook.push_diff_rows()), and each worker drains the rings
+    of its books and applies them in batches. While a book is in the pool, its own apply and query methods lock it
+    first, and OrderBook.top_of_book() and c_get_price() read the last published best levels without locking at all.
+
+    Books can only be added or removed while the pool is stopped.
+    """
+
+    def __cinit__(self, size_t num_threads = 0):
+        self._pool = new CPPOrderBookWorkerPool() if num_threads == 0 else new CPPOrderBookWorkerPool(num_threads)
+        self._order_books = {}
+
+    def __dealloc__(self):
+        cdef:
+            OrderBook order_book
+
+        if self._pool != NULL:
+            with nogil:
+                self._pool.stop()
+            del self._pool
+            self._pool = NULL
+        if self._order_books is not None:
+            for order_book in self._order_books.values():
+                order_book._concurrent = False
+
+    def add_order_book(self, str trading_pair, OrderBook order_book):
+        cdef:
+            MaintainedOrderBook book
+
+        if self._pool.isRunning():
+            raise RuntimeError("Order books cannot be added while the worker pool is running.")
+        if trading_pair in self._order_books:
+            raise ValueError(f"An order book for {trading_pair} is already in the worker pool.")
+        if order_book._concurrent:
+            raise ValueError(f"The order book for {trading_pair} is already maintained by a worker pool.")
+        if order_book._coalesce_diffs:
+            raise ValueError(f"The order book for {trading_pair} coalesces its diffs, which a worker pool cannot do.")
+        if order_book._diff_ring.capacity() == 0:
+            order_book._diff_ring.reset(DEFAULT_DIFF_RING_CAPACITY)
+
+        book.bidBook = &order_book._bid_book
+        book.askBook = &order_book._ask_book
+        book.diffRing = &order_book._diff_ring
+        book.sync = &order_book._sync
+        book.bestBid = &order_book._best_bid
+        book.bestAsk = &order_book._best_ask
+        book.lastDiffUid = &order_book._last_diff_uid
+        book.version = &order_book._version
+        book.stats = &order_book._stats
+        book.features = &order_book._features
+        book.dex = order_book._dex
+        self._pool.addBook(book)
+        order_book._concurrent = True
+        order_book._sync.storeCounters(order_book._version, order_book._last_diff_uid)
+        self._order_books[trading_pair] = order_book
+
+    def remove_order_book(self, str trading_pair):
+        cdef:
+            OrderBook order_book = self._order_books.get(trading_pair)
+
+        if self._pool.isRunning():
+            raise RuntimeError("Order books cannot be removed while the worker pool is running.")
+        if order_book is None:
+            return
+        self._pool.removeBook(&order_book._sync)
+        order_book._concurrent = False
+        del self._order_books[trading_pair]
+
+    def start(self):
+        self._pool.start()
+
+    def stop(self):
+        with nogil:
+            self._pool.stop()
+
+    @property
+    def running(self) -> bool:
+        return self._pool.isRunning()
+
+    @property
+    def num_threads(self) -> int:
+        return self._pool.getNumThreads()
+
+    @property
+    def applied_count(self) -> int:
+        """
+        Number of diff rows applied by the workers since the pool was created.
+        """
+        return self._pool.getAppliedCount()
+
+    @property
+    def order_books(self) -> Dict[str, OrderBook]:
+        return dict(self._order_books)
+
+    def set_idle_sleep(self, double seconds):
+        """
+        How long a worker sleeps once it has found nothing to apply for a while.
+        """
+        self._pool.setIdleSleepMicroseconds(<int64_t>(seconds * 1e6))
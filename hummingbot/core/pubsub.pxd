@@ -1,27 +1,32 @@
 # distutils: language=c++
 
-from libc.stdint cimport int64_t
+from libc.stdint cimport int64_t, uint64_t
+from libcpp.memory cimport shared_ptr
 from libcpp.unordered_map cimport unordered_map
-from libcpp.unordered_set cimport unordered_set
 from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 from hummingbot.core.PyRef cimport PyRef
 from hummingbot.core.event.event_listener cimport EventListener
 
-ctypedef unordered_set[PyRef] EventListenersCollection
-ctypedef unordered_set[PyRef].iterator EventListenersIterator
-ctypedef unordered_map[int64_t, EventListenersCollection] Events
-ctypedef unordered_map[int64_t, EventListenersCollection].iterator EventsIterator
-ctypedef pair[int64_t, EventListenersCollection] EventsPair
+ctypedef vector[PyRef] EventListenersCollection
+ctypedef shared_ptr[EventListenersCollection] EventListenersPtr
+ctypedef unordered_map[int64_t, EventListenersPtr] Events
+ctypedef unordered_map[int64_t, EventListenersPtr].iterator EventsIterator
+ctypedef pair[int64_t, EventListenersPtr] EventsPair
 
 
 cdef class PubSub:
     cdef:
         Events _events
+        uint64_t _generation
         object __weakref__
 
     cdef c_log_exception(self, int64_t event_tag, object arg)
     cdef c_add_listener(self, int64_t event_tag, EventListener listener)
     cdef c_remove_listener(self, int64_t event_tag, EventListener listener)
     cdef c_remove_dead_listeners(self, int64_t event_tag)
+    cdef c_set_listeners(self, int64_t event_tag, EventListenersCollection &listeners)
     cdef c_get_listeners(self, int64_t event_tag)
     cdef c_trigger_event(self, int64_t event_tag, object arg)
+    cdef c_trigger_events(self, int64_t event_tag, object args)
+    cdef size_t c_dispatch_event(self, int64_t event_tag, EventListenersCollection *listeners, object arg)
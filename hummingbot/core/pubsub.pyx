@@ -6,15 +6,10 @@ from cpython cimport(
     PyWeakref_NewRef,
     PyWeakref_GetObject
 )
-from cython.operator cimport(
-    postincrement as inc,
-    dereference as deref,
-    address
-)
-from libcpp.vector cimport vector
+from cython.operator cimport dereference as deref
+from libcpp.memory cimport make_shared
 from enum import Enum
 import logging
-import random
 from typing import List
 
 from hummingbot.logger import HummingbotLogger
@@ -26,25 +21,24 @@ class_logger = None
 
 cdef class PubSub:
     """
-    PubSub with weak references. This avoids the lapsed listener problem by periodically performing GC on dead
-    event listener.
+    PubSub with weak references. This avoids the lapsed listener problem by removing dead event listeners as they are
+    found.
 
-    Dead listener is done by calling c_remove_dead_listeners(), which checks whether the listener weak references are
-    alive or not, and removes the dead ones. Each call to c_remove_dead_listeners() takes O(n).
+    The listeners of each event tag are kept as a flat array of weak references, in the order they were added. The
+    array is never changed once it is published: adding or removing a listener publishes a new array for the event
+    tag, and bumps the generation counter. So triggering an event only holds a reference to the current array while it
+    calls the listeners, instead of copying the listeners, and listeners are free to add or remove listeners while
+    handling an event.
 
     Here's how the dead listener GC is performed:
 
-    1. c_add_listener():
-       Randomly with ADD_LISTENER_GC_PROBABILITY. This assumes c_add_listener() is called frequently and so it doesn't
-       make sense to do the GC every time.
-    2. c_remove_listener():
-       Every time. This assumes c_remove_listener() is called infrequently.
-    3. c_get_listeners() and c_trigger_event():
-       Every time. Both functions take O(n) already.
+    1. c_add_listener() and c_remove_listener():
+       Every time. Both functions build a new array in O(n) already, and leave the dead listeners out of it.
+    2. c_get_listeners(), c_trigger_event() and c_trigger_events():
+       Only when they come across a dead listener, so there is no extra pass over the listeners when all of them are
+       alive.
     """
 
-    ADD_LISTENER_GC_PROBABILITY = 0.005
-
     @classmethod
     def logger(cls) -> HummingbotLogger:
         global class_logger
@@ -54,6 +48,7 @@ cdef class PubSub:
 
     def __init__(self):
         self._events = Events()
+        self._generation = 0
 
     def add_listener(self, event_tag: Enum, listener: EventListener):
         self.c_add_listener(event_tag.value, listener)
@@ -67,99 +62,164 @@ cdef class PubSub:
     def trigger_event(self, event_tag: Enum, message: any):
         self.c_trigger_event(event_tag.value, message)
 
+    def trigger_events(self, event_tag: Enum, messages: List[any]):
+        self.c_trigger_events(event_tag.value, messages)
+
+    @property
+    def listeners_generation(self) -> int:
+        """
+        Bumped every time the listeners of any event tag change.
+        """
+        return self._generation
+
     cdef c_log_exception(self, int64_t event_tag, object arg):
         self.logger().error(f"Unexpected error while processing event {event_tag}.", exc_info=True)
 
     cdef c_add_listener(self, int64_t event_tag, EventListener listener):
         cdef:
             EventsIterator it = self._events.find(event_tag)
-            EventListenersCollection new_listeners
             EventListenersCollection *listeners_ptr
-            object listener_weakref = PyWeakref_NewRef(listener, None)
-            PyRef listener_wrapper = PyRef(<PyObject *>listener_weakref)
-        if it != self._events.end():
-            listeners_ptr = address(deref(it).second)
-            deref(listeners_ptr).insert(listener_wrapper)
-        else:
-            new_listeners.insert(listener_wrapper)
-            self._events.insert(EventsPair(event_tag, new_listeners))
+            EventListenersCollection new_listeners
+            object listener_weakref
+            PyObject *referent
+            size_t i
 
-        if random.random() < PubSub.ADD_LISTENER_GC_PROBABILITY:
-            self.c_remove_dead_listeners(event_tag)
+        if it != self._events.end():
+            listeners_ptr = deref(it).second.get()
+            new_listeners.reserve(deref(listeners_ptr).size() + 1)
+            for i in range(deref(listeners_ptr).size()):
+                referent = PyWeakref_GetObject(<object>deref(listeners_ptr)[i].get())
+                if referent == <PyObject *>listener:
+                    return
+                if referent != <PyObject *>None:
+                    new_listeners.push_back(deref(listeners_ptr)[i])
+        listener_weakref = PyWeakref_NewRef(listener, None)
+        new_listeners.push_back(PyRef(<PyObject *>listener_weakref))
+        self.c_set_listeners(event_tag, new_listeners)
 
     cdef c_remove_listener(self, int64_t event_tag, EventListener listener):
         cdef:
             EventsIterator it = self._events.find(event_tag)
             EventListenersCollection *listeners_ptr
-            object listener_weakref = PyWeakref_NewRef(listener, None)
-            PyRef listener_wrapper = PyRef(<PyObject *>listener_weakref)
-            EventListenersIterator lit
+            EventListenersCollection new_listeners
+            PyObject *referent
+            size_t i
+
         if it == self._events.end():
             return
-        listeners_ptr = address(deref(it).second)
-        lit = deref(listeners_ptr).find(listener_wrapper)
-        if lit != deref(listeners_ptr).end():
-            deref(listeners_ptr).erase(lit)
-        self.c_remove_dead_listeners(event_tag)
+        listeners_ptr = deref(it).second.get()
+        for i in range(deref(listeners_ptr).size()):
+            referent = PyWeakref_GetObject(<object>deref(listeners_ptr)[i].get())
+            if referent != <PyObject *>listener and referent != <PyObject *>None:
+                new_listeners.push_back(deref(listeners_ptr)[i])
+        if new_listeners.size() != deref(listeners_ptr).size():
+            self.c_set_listeners(event_tag, new_listeners)
 
     cdef c_remove_dead_listeners(self, int64_t event_tag):
         cdef:
             EventsIterator it = self._events.find(event_tag)
             EventListenersCollection *listeners_ptr
-            object listener_weakref
-            EventListenersIterator lit
-            vector[EventListenersIterator] lit_to_remove
+            EventListenersCollection new_listeners
+            size_t i
+
         if it == self._events.end():
             return
-        listeners_ptr = address(deref(it).second)
-        lit = deref(listeners_ptr).begin()
-        while lit != deref(listeners_ptr).end():
-            listener_weakref = <object>(deref(lit).get())
-            if <object>(PyWeakref_GetObject(listener_weakref)) is None:
-                lit_to_remove.push_back(lit)
-            inc(lit)
-        for lit in lit_to_remove:
-            deref(listeners_ptr).erase(lit)
-        if deref(listeners_ptr).size() < 1:
-            self._events.erase(it)
+        listeners_ptr = deref(it).second.get()
+        for i in range(deref(listeners_ptr).size()):
+            if PyWeakref_GetObject(<object>deref(listeners_ptr)[i].get()) != <PyObject *>None:
+                new_listeners.push_back(deref(listeners_ptr)[i])
+        if new_listeners.size() != deref(listeners_ptr).size():
+            self.c_set_listeners(event_tag, new_listeners)
+
+    cdef c_set_listeners(self, int64_t event_tag, EventListenersCollection &listeners):
+        # Publishes a new array rather than changing the current one, which events being triggered may still hold.
+        if listeners.size() < 1:
+            self._events.erase(event_tag)
+        else:
+            self._events[event_tag] = make_shared[EventListenersCollection](listeners)
+        self._generation += 1
 
     cdef c_get_listeners(self, int64_t event_tag):
-        self.c_remove_dead_listeners(event_tag)
-
         cdef:
             EventsIterator it = self._events.find(event_tag)
             EventListenersCollection *listeners_ptr
-            object listener_weafref
-            EventListener typed_listener
+            PyObject *referent
+            size_t i
+            bint found_dead = False
 
         if it == self._events.end():
             return []
 
         retval = []
-        listeners_ptr = address(deref(it).second)
-        for pyref in deref(listeners_ptr):
-            listener_weafref = <object>pyref.get()
-            typed_listener = <object>PyWeakref_GetObject(listener_weafref)
-            retval.append(typed_listener)
+        listeners_ptr = deref(it).second.get()
+        for i in range(deref(listeners_ptr).size()):
+            referent = PyWeakref_GetObject(<object>deref(listeners_ptr)[i].get())
+            if referent == <PyObject *>None:
+                found_dead = True
+            else:
+                retval.append(<object>referent)
+        if found_dead:
+            self.c_remove_dead_listeners(event_tag)
         return retval
 
     cdef c_trigger_event(self, int64_t event_tag, object arg):
-        self.c_remove_dead_listeners(event_tag)
-
         cdef:
             EventsIterator it = self._events.find(event_tag)
-            EventListenersCollection listeners
-            object listener_weafref
-            EventListener typed_listener
+            EventListenersPtr listeners
+
         if it == self._events.end():
             return
 
-        # It is extremely important that this set of listeners is a C++ copy - because listeners are allowed to call
-        # c_remove_listener(), which breaks the iterator if we're using the underlying set.
+        # It is extremely important to hold a reference to the array while the listeners are called - because listeners
+        # are allowed to call c_remove_listener(), which replaces the array of the event tag.
         listeners = deref(it).second
-        for pyref in listeners:
-            listener_weafref = <object>pyref.get()
-            typed_listener = <object>PyWeakref_GetObject(listener_weafref)
+        if self.c_dispatch_event(event_tag, listeners.get(), arg) > 0:
+            self.c_remove_dead_listeners(event_tag)
+
+    cdef c_trigger_events(self, int64_t event_tag, object args):
+        """
+        Triggers one event for each of args, in order, looking up the listeners once for all of them.
+        """
+        cdef:
+            EventsIterator it
+            EventListenersPtr listeners
+            uint64_t generation = self._generation
+            size_t num_dead = 0
+
+        it = self._events.find(event_tag)
+        if it != self._events.end():
+            listeners = deref(it).second
+        for arg in args:
+            # Pick up the changes made by the listeners to the listeners before the next event, the same as separate
+            # c_trigger_event() calls would.
+            if generation != self._generation:
+                generation = self._generation
+                it = self._events.find(event_tag)
+                if it != self._events.end():
+                    listeners = deref(it).second
+                else:
+                    listeners.reset()
+            if listeners.get() != NULL:
+                num_dead += self.c_dispatch_event(event_tag, listeners.get(), arg)
+        if num_dead > 0:
+            self.c_remove_dead_listeners(event_tag)
+
+    cdef size_t c_dispatch_event(self, int64_t event_tag, EventListenersCollection *listeners, object arg):
+        """
+        Calls each live listener in the array with arg, and returns the number of dead listeners found.
+        """
+        cdef:
+            PyObject *referent
+            EventListener typed_listener
+            size_t num_dead = 0
+            size_t i
+
+        for i in range(deref(listeners).size()):
+            referent = PyWeakref_GetObject(<object>deref(listeners)[i].get())
+            if referent == <PyObject *>None:
+                num_dead += 1
+                continue
+            typed_listener = <EventListener><object>referent
             try:
                 typed_listener.c_set_event_info(event_tag, self)
                 typed_listener.c_call(arg)
@@ -167,3 +227,4 @@ cdef class PubSub:
                 self.c_log_exception(event_tag, arg)
             finally:
                 typed_listener.c_set_event_info(0, None)
+        return num_dead
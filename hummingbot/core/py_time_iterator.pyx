@@ -1,10 +1,18 @@
 # distutils: language=c++
 
+NaN = float("nan")
+
 
 cdef class PyTimeIterator(TimeIterator):
     def tick(self, double timestamp):
         raise NotImplementedError
 
+    def next_wakeup_timestamp(self) -> float:
+        return NaN
+
     cdef c_tick(self, double timestamp):
         TimeIterator.c_tick(self, timestamp)
         self.tick(timestamp)
+
+    cdef double c_next_wakeup_timestamp(self):
+        return self.next_wakeup_timestamp()
@@ -22,9 +22,20 @@ cdef class TimeIterator(PubSub):
     cdef c_tick(self, double timestamp):
         self._current_timestamp = timestamp
 
+    cdef double c_next_wakeup_timestamp(self):
+        """
+        The earliest timestamp at which the iterator has work to do, for a clock that fast forwards through backtests.
+        NaN means the iterator cannot tell and has to be ticked on every tick, which is the default. Infinity means it
+        has nothing scheduled at all.
+        """
+        return NaN
+
     def tick(self, timestamp: float):
         self.c_tick(timestamp)
 
+    def next_wakeup_timestamp(self) -> float:
+        return self.c_next_wakeup_timestamp()
+
     @property
     def current_timestamp(self) -> float:
         return self._current_timestamp
@@ -1,16 +1,16 @@
+# distutils: language=c++
+
 import numpy as np
 from libc.stdint cimport int64_t
 cimport numpy as np
 
+from hummingbot.core.data_type.RollingStatistics cimport RollingStatistics
+
 cdef class RingBuffer:
     cdef:
-        np.float64_t[:] _buffer
-        int64_t _delimiter
-        int64_t _length
-        bint _is_full
+        RollingStatistics _statistics
 
-    cdef void c_add_value(self, float val)
-    cdef void c_increment_delimiter(self)
+    cdef void c_add_value(self, double val)
     cdef double c_get_last_value(self)
     cdef bint c_is_full(self)
     cdef bint c_is_empty(self)
@@ -1,3 +1,5 @@
+# distutils: language=c++
+# distutils: sources=['hummingbot/core/cpp/RollingStatistics.cpp']
 import numpy as np
 import logging
 cimport numpy as np
@@ -6,6 +8,10 @@ cimport numpy as np
 pmm_logger = None
 
 cdef class RingBuffer:
+    """
+    A fixed length window over the latest samples of a series. The mean, variance and standard deviation are kept up
+    to date natively as samples are added, so reading them is O(1). Like before, they are NaN until the buffer is full.
+    """
     @classmethod
     def logger(cls):
         global pmm_logger
@@ -14,67 +20,42 @@ cdef class RingBuffer:
         return pmm_logger
 
     def __cinit__(self, int length):
-        self._length = length
-        self._buffer = np.zeros(length, dtype=np.float64)
-        self._delimiter = 0
-        self._is_full = False
+        self._statistics.setCapacity(length)
 
-    def __dealloc__(self):
-        self._buffer = None
-
-    cdef void c_add_value(self, float val):
-        self._buffer[self._delimiter] = val
-        self.c_increment_delimiter()
-
-    cdef void c_increment_delimiter(self):
-        self._delimiter = (self._delimiter + 1) % self._length
-        if not self._is_full and self._delimiter == 0:
-            self._is_full = True
+    cdef void c_add_value(self, double val):
+        self._statistics.add(val)
 
     cdef bint c_is_empty(self):
-        return (not self._is_full) and (0==self._delimiter)
+        return self._statistics.empty()
 
     cdef double c_get_last_value(self):
-        if self.c_is_empty():
-            return np.nan
-        return self._buffer[self._delimiter-1]
+        return self._statistics.getLast()
 
     cdef bint c_is_full(self):
-        return self._is_full
+        return self._statistics.isFull()
 
     cdef double c_mean_value(self):
-        result = np.nan
-        if self._is_full:
-            result=np.mean(self.c_get_as_numpy_array())
-        return result
+        if not self._statistics.isFull():
+            return np.nan
+        return self._statistics.getMean()
 
     cdef double c_variance(self):
-        result = np.nan
-        if self._is_full:
-            result = np.var(self.c_get_as_numpy_array())
-        return result
+        if not self._statistics.isFull():
+            return np.nan
+        return self._statistics.getVariance()
 
     cdef double c_std_dev(self):
-        result = np.nan
-        if self._is_full:
-            result = np.std(self.c_get_as_numpy_array())
-        return result
+        if not self._statistics.isFull():
+            return np.nan
+        return self._statistics.getStdDev()
 
     cdef np.ndarray[np.double_t, ndim=1] c_get_as_numpy_array(self):
-        cdef np.ndarray[np.int16_t, ndim=1] indexes
-
-        if not self._is_full:
-            indexes = np.arange(0, stop=self._delimiter, dtype=np.int16)
-        else:
-            indexes = np.arange(self._delimiter, stop=self._delimiter + self._length,
-                                dtype=np.int16) % self._length
-        return np.asarray(self._buffer)[indexes]
+        cdef:
+            np.ndarray[np.double_t, ndim=1] result = np.empty(self._statistics.size(), dtype=np.double)
 
-    def __init__(self, length):
-        self._length = length
-        self._buffer = np.zeros(length, dtype=np.double)
-        self._delimiter = 0
-        self._is_full = False
+        if result.shape[0] > 0:
+            self._statistics.copyTo(&result[0])
+        return result
 
     def add_value(self, val):
         self.c_add_value(val)
@@ -89,6 +70,10 @@ cdef class RingBuffer:
     def is_full(self):
         return self.c_is_full()
 
+    @property
+    def size(self) -> int:
+        return self._statistics.size()
+
     @property
     def mean_value(self):
         return self.c_mean_value()
@@ -101,18 +86,30 @@ cdef class RingBuffer:
     def variance(self):
         return self.c_variance()
 
+    @property
+    def sum_squared_diffs(self) -> float:
+        """
+        Sum of the squared differences between consecutive samples in the buffer.
+        """
+        return self._statistics.getSumSquaredDiffs()
+
+    @property
+    def log_return_variance(self) -> float:
+        """
+        Variance of the log returns between consecutive samples in the buffer. NaN with fewer than two samples.
+        """
+        return self._statistics.getLogReturnVariance()
+
+    def ema(self, double alpha) -> float:
+        """
+        Exponential moving average of the samples in the buffer, the same as pandas' ewm(alpha=alpha, adjust=True).
+        """
+        return self._statistics.getEma(alpha)
+
     @property
     def length(self) -> int:
-        return self._length
+        return self._statistics.getCapacity()
 
     @length.setter
     def length(self, value):
-        data = self.get_as_numpy_array()
-
-        self._length = value
-        self._buffer = np.zeros(value, dtype=np.float64)
-        self._delimiter = 0
-        self._is_full = False
-
-        for val in data[-value:]:
-            self.add_value(val)
+        self._statistics.setCapacity(value)
@@ -1,5 +1,4 @@
-from base_trailing_indicator import BaseTrailingIndicator
-import pandas as pd
+from .base_trailing_indicator import BaseTrailingIndicator
 
 
 class ExponentialMovingAverageIndicator(BaseTrailingIndicator):
@@ -9,9 +8,8 @@ class ExponentialMovingAverageIndicator(BaseTrailingIndicator):
         super().__init__(sampling_length, processing_length)
 
     def _indicator_calculation(self) -> float:
-        ema = pd.Series(self._sampling_buffer.get_as_numpy_array())\
-            .ewm(span=self._sampling_length, adjust=True).mean()
-        return ema[-1]
+        # The same as pandas' ewm(span=sampling_length, adjust=True) over the sampling buffer.
+        return self._sampling_buffer.ema(2 / (self.sampling_length + 1))
 
     def _processing_calculation(self) -> float:
         return self._processing_buffer.get_last_value()
@@ -642,6 +642,13 @@ cdef class AvellanedaMarketMakingStrategy(StrategyBase):
         finally:
             self._last_timestamp = timestamp
 
+    cdef double c_next_wakeup_timestamp(self):
+        """
+        The volatility and trading intensity indicators take a sample on every tick, so skipping ticks would change
+        the strategy's estimates. The strategy needs every tick.
+        """
+        return NaN
+
     def process_tick(self, timestamp: float):
         proposal = None
         # Trading is allowed
@@ -700,8 +707,8 @@ cdef class AvellanedaMarketMakingStrategy(StrategyBase):
 
         self._alpha, self._kappa = self._trading_intensity.current_value
 
-        self._alpha = Decimal(self._alpha)
-        self._kappa = Decimal(self._kappa)
+        self._alpha = Decimal(str(self._alpha))
+        self._kappa = Decimal(str(self._kappa))
 
         if self._is_debug:
             self.logger().info(f"alpha={self._alpha:.4f} | "
@@ -6,6 +6,8 @@ from typing import Dict, List, Optional
 import numpy as np
 import pandas as pd
 
+from libc.math cimport INFINITY
+
 from hummingbot.connector.exchange_base import ExchangeBase
 from hummingbot.connector.exchange_base cimport ExchangeBase
 from hummingbot.core.clock cimport Clock
@@ -762,6 +764,34 @@ cdef class PureMarketMakingStrategy(StrategyBase):
         finally:
             self._last_timestamp = timestamp
 
+    cdef double c_next_wakeup_timestamp(self):
+        """
+        Wakes for the next order refresh, and for the next active or hanging order to pass the max order age. Everything
+        else the strategy reacts to, prices and fills, only changes when the market or the market data wakes up, and
+        the clock then ticks the strategy too. Timers already due wake it on the next tick. Until the markets are ready,
+        and while cancels are in flight, it needs every tick.
+        """
+        cdef:
+            double next_wakeup = INFINITY
+            list active_orders
+
+        if not self._all_markets_ready or len(self._sb_order_tracker.in_flight_cancels) > 0:
+            return NaN
+        active_orders = self.active_non_hanging_orders
+        if len(active_orders) == 0:
+            # Orders are created on the first tick after the create timestamp.
+            next_wakeup = self._create_timestamp
+        else:
+            if self._cancel_timestamp > self._current_timestamp:
+                next_wakeup = self._cancel_timestamp
+            # order_age() counts whole seconds, so an order is past the max age a second after reaching it.
+            for order in active_orders:
+                next_wakeup = min(next_wakeup, order.creation_timestamp * 1e-6 + self._max_order_age + 1)
+        for hanging_order in self._hanging_orders_tracker.strategy_current_hanging_orders:
+            if hanging_order.creation_timestamp:
+                next_wakeup = min(next_wakeup, hanging_order.creation_timestamp + self._max_order_age)
+        return next_wakeup
+
     cdef object c_create_base_proposal(self):
         cdef:
             ExchangeBase market = self._market_info.market
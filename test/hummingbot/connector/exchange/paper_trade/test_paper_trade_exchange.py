@@ -1,3 +1,5 @@
+import asyncio
+from decimal import Decimal
 from unittest import TestCase
 
 from hummingbot.client.config.client_config_map import ClientConfigMap
@@ -5,7 +7,13 @@ from hummingbot.client.config.config_helpers import ClientConfigAdapter
 from hummingbot.connector.exchange.binance.binance_api_order_book_data_source import BinanceAPIOrderBookDataSource
 from hummingbot.connector.exchange.kucoin.kucoin_api_order_book_data_source import KucoinAPIOrderBookDataSource
 from hummingbot.connector.exchange.paper_trade import create_paper_trade_market, get_order_book_tracker
+from hummingbot.core.clock import Clock, ClockMode
+from hummingbot.core.data_type.common import OrderType, TradeType
+from hummingbot.core.data_type.composite_order_book import CompositeOrderBook
+from hummingbot.core.data_type.order_book_row import OrderBookRow
 from hummingbot.core.data_type.order_book_tracker import OrderBookTracker
+from hummingbot.core.event.event_logger import EventLogger
+from hummingbot.core.event.events import MarketEvent, OrderBookTradeEvent
 
 
 class PaperTradeExchangeTests(TestCase):
@@ -29,3 +37,175 @@ class PaperTradeExchangeTests(TestCase):
             client_config_map=ClientConfigAdapter(ClientConfigMap()),
             trading_pairs=["COINALPHA-HBOT"])
         self.assertEqual(KucoinAPIOrderBookDataSource, type(paper_exchange.order_book_tracker.data_source))
+
+
+class PaperTradeExchangeTickTests(TestCase):
+    trading_pair = "COINALPHA-HBOT"
+
+    def setUp(self):
+        self.ev_loop = asyncio.get_event_loop()
+        self.exchange = create_paper_trade_market(
+            exchange_name="binance",
+            client_config_map=ClientConfigAdapter(ClientConfigMap()),
+            trading_pairs=[self.trading_pair])
+        self.order_book = CompositeOrderBook()
+        self.order_book.apply_snapshot([OrderBookRow(99, 1, 1)], [OrderBookRow(101, 1, 1)], 1)
+        tracker = self.exchange.order_book_tracker
+        tracker._order_books[self.trading_pair] = self.order_book
+        tracker._order_books_initialized.set()
+        self.assertTrue(self.exchange.ready)
+        self.exchange.set_balance("COINALPHA", Decimal(10))
+        self.exchange.set_balance("HBOT", Decimal(1000))
+
+        self.fill_logger = EventLogger()
+        self.exchange.add_listener(MarketEvent.OrderFilled, self.fill_logger)
+        self.expired_logger = EventLogger()
+        self.exchange.add_listener(MarketEvent.OrderExpired, self.expired_logger)
+        self.completed_logger = EventLogger()
+        self.exchange.add_listener(MarketEvent.BuyOrderCompleted, self.completed_logger)
+        self.clock = Clock(ClockMode.BACKTEST, tick_size=1, start_time=1000, end_time=5000)
+        self.clock.add_iterator(self.exchange)
+
+    def test_tick_fills_limit_order_once_book_crosses_it(self):
+        self.clock.backtest_til(1001)
+        order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(100))
+        self.clock.backtest_til(1010)
+        self.assertEqual(len(self.fill_logger.event_log), 0)
+        self.assertEqual(len(self.exchange.limit_orders), 1)
+
+        version = self.order_book.version
+        self.order_book.apply_diffs([], [OrderBookRow(100, 2, 2)], 2)
+        self.assertGreater(self.order_book.version, version)
+        self.clock.backtest_til(1011)
+        self.assertEqual([event.order_id for event in self.fill_logger.event_log], [order_id])
+        self.assertEqual(len(self.exchange.limit_orders), 0)
+
+    def test_order_book_version_counts_updates(self):
+        version = self.order_book.version
+        self.order_book.apply_diffs([OrderBookRow(98, 1, 2)], [], 2)
+        self.order_book.apply_snapshot([OrderBookRow(99, 1, 3)], [OrderBookRow(101, 1, 3)], 3)
+        self.assertEqual(self.order_book.version, version + 2)
+        self.order_book.coalesce_diffs = True
+        self.order_book.apply_diffs([OrderBookRow(98, 1, 4)], [], 4)
+        self.assertEqual(self.order_book.version, version + 3)
+        self.order_book.flush_diffs()
+        self.assertEqual(self.order_book.version, version + 4)
+
+    def trade(self, trade_type: TradeType, price: float, amount: float):
+        self.exchange.match_trade_to_limit_orders(OrderBookTradeEvent(
+            trading_pair=self.trading_pair, timestamp=self.clock.current_timestamp, price=price, amount=amount,
+            type=trade_type))
+
+    def test_dust_trades_do_not_add_up_to_a_fill(self):
+        self.exchange.partial_fills_enabled = True
+        self.clock.backtest_til(1001)
+        self.exchange.buy(self.trading_pair, Decimal("0.000002"), OrderType.LIMIT, Decimal(100))
+        # Each trade rounds down to nothing, so none of them fills any of the order.
+        for _ in range(30):
+            self.trade(TradeType.SELL, 99.5, 1e-7)
+        self.assertEqual(len(self.fill_logger.event_log), 0)
+        self.assertEqual(len(self.exchange.limit_orders), 1)
+
+        self.trade(TradeType.SELL, 99.5, 0.0000015)
+        self.assertEqual([event.amount for event in self.fill_logger.event_log], [Decimal("0.0000015")])
+        self.assertEqual(len(self.exchange.limit_orders), 1)
+
+    def test_trade_fills_only_orders_priced_through_it(self):
+        self.clock.backtest_til(1001)
+        low_order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(100))
+        high_order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal("100.5"))
+        self.trade(TradeType.SELL, 100.25, 1)
+        self.assertEqual([event.order_id for event in self.fill_logger.event_log], [high_order_id])
+        self.assertEqual([order.client_order_id for order in self.exchange.limit_orders], [low_order_id])
+
+    def test_empty_opposite_side_crosses_no_order(self):
+        self.order_book.apply_snapshot([OrderBookRow(99, 1, 2)], [], 2)
+        self.clock.backtest_til(1001)
+        self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(100))
+        self.clock.backtest_til(1010)
+        self.assertEqual(len(self.fill_logger.event_log), 0)
+        self.assertEqual(len(self.exchange.limit_orders), 1)
+
+    def test_orders_expire_at_the_wheel_boundary(self):
+        self.clock.backtest_til(1001)
+        near_order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(90),
+                                          expiration_ts=1010)
+        # One turn of the wheel away, so it shares its slot with the current tick.
+        far_order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(90),
+                                         expiration_ts=1001 + 1024)
+        self.clock.backtest_til(1009)
+        self.assertEqual(len(self.expired_logger.event_log), 0)
+        self.clock.backtest_til(1010)
+        self.assertEqual([event.order_id for event in self.expired_logger.event_log], [near_order_id])
+
+        self.clock.backtest_til(1001 + 1023)
+        self.assertEqual([order.client_order_id for order in self.exchange.limit_orders], [far_order_id])
+        self.clock.backtest_til(1001 + 1024)
+        self.assertEqual([event.order_id for event in self.expired_logger.event_log], [near_order_id, far_order_id])
+        self.assertEqual(len(self.exchange.limit_orders), 0)
+
+    def test_partial_fills_across_price_levels(self):
+        self.exchange.partial_fills_enabled = True
+        self.clock.backtest_til(1001)
+        order_ids = [self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, price)
+                     for price in (Decimal("100.5"), Decimal("100.2"), Decimal(100))]
+
+        # The trade fills the best priced order first, then what is left of it goes to the next level.
+        self.trade(TradeType.SELL, 99.9, 1.5)
+        self.assertEqual([(event.order_id, event.amount) for event in self.fill_logger.event_log],
+                         [(order_ids[0], Decimal(1)), (order_ids[1], Decimal("0.5"))])
+        self.assertEqual([event.order_id for event in self.completed_logger.event_log], [order_ids[0]])
+        self.assertEqual([order.client_order_id for order in self.exchange.limit_orders], order_ids[1:])
+
+    def test_partial_fill_remainders(self):
+        self.exchange.partial_fills_enabled = True
+        self.clock.backtest_til(1001)
+        first_order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal("100.2"))
+        second_order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(100))
+        self.trade(TradeType.SELL, 99.9, 0.5)
+
+        # Only the remaining half of the first order is left to fill, the rest goes to the second order.
+        self.trade(TradeType.SELL, 99.9, 1)
+        self.assertEqual([(event.order_id, event.amount) for event in self.fill_logger.event_log],
+                         [(first_order_id, Decimal("0.5")), (first_order_id, Decimal("0.5")),
+                          (second_order_id, Decimal("0.5"))])
+        self.assertEqual([event.order_id for event in self.completed_logger.event_log], [first_order_id])
+
+        self.trade(TradeType.SELL, 99.9, 1)
+        self.assertEqual([event.order_id for event in self.completed_logger.event_log],
+                         [first_order_id, second_order_id])
+        self.assertEqual(self.fill_logger.event_log[-1].amount, Decimal("0.5"))
+        self.assertEqual(len(self.exchange.limit_orders), 0)
+
+    def place_order_behind_queue(self) -> str:
+        self.exchange.partial_fills_enabled = True
+        self.exchange.queue_positions_enabled = True
+        self.order_book.apply_snapshot([OrderBookRow(99, 4, 2)], [OrderBookRow(101, 1, 2)], 2)
+        self.clock.backtest_til(1001)
+        return self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(99))
+
+    def test_queue_volume_ahead_after_trade(self):
+        order_id = self.place_order_behind_queue()
+        self.trade(TradeType.SELL, 99, 3)
+        self.assertEqual(len(self.fill_logger.event_log), 0)
+        # The level shrinking by the traded volume is not a cancel, so 1 is still queued ahead of the order.
+        self.order_book.apply_diffs([OrderBookRow(99, 1, 3)], [], 3)
+        self.trade(TradeType.SELL, 99, 1.5)
+        self.assertEqual([(event.order_id, event.amount) for event in self.fill_logger.event_log],
+                         [(order_id, Decimal("0.5"))])
+
+    def test_queue_volume_ahead_after_cancel(self):
+        order_id = self.place_order_behind_queue()
+        # Half of the level is cancelled, and so is half of the volume queued ahead of the order.
+        self.order_book.apply_diffs([OrderBookRow(99, 2, 3)], [], 3)
+        self.trade(TradeType.SELL, 99, 2.5)
+        self.assertEqual([(event.order_id, event.amount) for event in self.fill_logger.event_log],
+                         [(order_id, Decimal("0.5"))])
+
+    def test_orders_with_infinite_expiration_never_expire(self):
+        self.clock.backtest_til(1001)
+        order_id = self.exchange.buy(self.trading_pair, Decimal(1), OrderType.LIMIT, Decimal(90),
+                                     expiration_ts=float("inf"))
+        self.clock.backtest_til(5000)
+        self.assertEqual(len(self.expired_logger.event_log), 0)
+        self.assertEqual([order.client_order_id for order in self.exchange.limit_orders], [order_id])
@@ -0,0 +1,75 @@
+import unittest
+from decimal import Decimal
+
+import numpy as np
+
+from hummingbot.core.data_type.common import OrderType, TradeType
+from hummingbot.core.data_type.composite_order_book import CompositeOrderBook
+from hummingbot.core.data_type.order_book_row import OrderBookRow
+from hummingbot.core.data_type.trade_fee import AddedToCostTradeFee
+from hummingbot.core.event.events import OrderFilledEvent
+
+
+class CompositeOrderBookTest(unittest.TestCase):
+    def setUp(self) -> None:
+        self.order_book = CompositeOrderBook()
+        self.order_book.apply_snapshot(
+            [OrderBookRow(99, 1, 1), OrderBookRow(98, 2, 1), OrderBookRow(97, 3, 1)],
+            [OrderBookRow(101, 1, 1), OrderBookRow(102, 2, 1), OrderBookRow(103, 3, 1)],
+            1)
+
+    def record_fill(self, trade_type: TradeType, price: float, amount: float):
+        self.order_book.record_filled_order(OrderFilledEvent(
+            timestamp=1,
+            order_id="order",
+            trading_pair="COINALPHA-HBOT",
+            trade_type=trade_type,
+            order_type=OrderType.LIMIT,
+            price=Decimal(str(price)),
+            amount=Decimal(str(amount)),
+            trade_fee=AddedToCostTradeFee(),
+        ))
+
+    def test_queries_account_for_recorded_fills(self):
+        self.record_fill(TradeType.BUY, 101, 1)
+        self.record_fill(TradeType.BUY, 102, 0.5)
+
+        self.assertEqual([(102, 1.5), (103, 3)], [(row.price, row.amount) for row in self.order_book.ask_entries()])
+        self.assertEqual(102, self.order_book.get_price(True))
+        self.assertEqual(103, self.order_book.get_price_for_volume(True, 2).result_price)
+        self.assertAlmostEqual((102 * 1.5 + 103 * 0.5) / 2, self.order_book.get_vwap_for_volume(True, 2).result_price)
+        self.assertEqual(1.5, self.order_book.get_volume_for_price(True, 102).result_volume)
+        self.assertEqual(102 * 1.5 + 103 * 3, self.order_book.get_quote_volume_for_price(True, 103).result_volume)
+        self.assertEqual(102 * 1.5 + 103 * 0.5,
+                         self.order_book.get_quote_volume_for_base_amount(True, 2).result_volume)
+
+        # The original book is left untouched.
+        self.assertEqual([(101, 1), (102, 2), (103, 3)],
+                         [(row.price, row.amount) for row in self.order_book.original_ask_entries()])
+        self.assertEqual(99, self.order_book.get_price(False))
+
+    def test_fills_at_levels_gone_from_the_book_are_dropped(self):
+        self.record_fill(TradeType.SELL, 99, 1)
+        self.assertEqual(98, self.order_book.get_price(False))
+
+        # The level is traded away on the exchange, then comes back with fresh volume.
+        self.order_book.apply_diffs([OrderBookRow(99, 0, 2)], [], 2)
+        self.assertEqual(98, self.order_book.get_price(False))
+        self.order_book.apply_diffs([OrderBookRow(99, 4, 3)], [], 3)
+        self.assertEqual(99, self.order_book.get_price(False))
+        self.assertEqual(4, self.order_book.get_volume_for_price(False, 99).result_volume)
+
+    def test_snapshot_arrays(self):
+        self.record_fill(TradeType.SELL, 99, 1)
+        self.record_fill(TradeType.SELL, 98, 1)
+        bids, asks = self.order_book.snapshot_arrays()
+        np.testing.assert_array_equal(np.array([[98, 1, 1], [97, 3, 1]], dtype=np.float64), bids)
+        np.testing.assert_array_equal(np.array([[101, 1, 1], [102, 2, 1], [103, 3, 1]], dtype=np.float64), asks)
+
+        bids_out = np.zeros((1, 3), dtype=np.float64)
+        bids, _ = self.order_book.snapshot_arrays(bids_out=bids_out)
+        np.testing.assert_array_equal(np.array([[98, 1, 1]], dtype=np.float64), bids)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,90 @@
+import threading
+import unittest
+
+from hummingbot.core.data_type.consolidated_order_book import ConsolidatedOrderBook
+from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.data_type.order_book_row import OrderBookRow
+from hummingbot.core.data_type.order_book_worker_pool import OrderBookWorkerPool
+
+
+class ConsolidatedOrderBookTest(unittest.TestCase):
+    def setUp(self) -> None:
+        self.book_a = OrderBook()
+        self.book_a.apply_snapshot([OrderBookRow(99, 1, 1), OrderBookRow(98, 2, 1)],
+                                   [OrderBookRow(101, 1, 1), OrderBookRow(103, 2, 1)], 1)
+        self.book_b = OrderBook()
+        self.book_b.apply_snapshot([OrderBookRow(99.5, 1, 1), OrderBookRow(97, 2, 1)],
+                                   [OrderBookRow(101, 2, 1), OrderBookRow(102, 1, 1)], 1)
+        self.consolidated = ConsolidatedOrderBook({"a": self.book_a, "b": self.book_b})
+
+    def test_best_prices(self):
+        self.assertEqual(["a", "b"], self.consolidated.venues)
+        self.assertEqual((99.5, 1, "b"), self.consolidated.get_best(False))
+        # Ties go to the venue added first.
+        self.assertEqual((101, 1, "a"), self.consolidated.get_best(True))
+        self.assertEqual(101, self.consolidated.get_price(True))
+
+    def test_depth_queries(self):
+        self.assertEqual(102, self.consolidated.get_price_for_volume(True, 4).result_price)
+        self.assertAlmostEqual((101 * 3 + 102 * 1) / 4, self.consolidated.get_vwap_for_volume(True, 4).result_price)
+        self.assertEqual(4, self.consolidated.get_volume_for_price(True, 102).result_volume)
+        self.assertEqual({"a": 1, "b": 3}, self.consolidated.get_venue_volumes_for_volume(True, 4))
+        self.assertEqual({"b": 0.5}, self.consolidated.get_venue_volumes_for_volume(False, 0.5))
+
+    def test_follows_book_updates(self):
+        self.book_b.apply_diffs([OrderBookRow(99.5, 0, 2)], [OrderBookRow(100, 1, 2)], 2)
+        self.assertEqual((99, 1, "a"), self.consolidated.get_best(False))
+        self.assertEqual((100, 1, "b"), self.consolidated.get_best(True))
+
+        rows, venues = self.consolidated.ladder_array(True, 3)
+        self.assertEqual([[100, 1, 1], [101, 1, 0], [101, 2, 1]], rows.tolist())
+        self.assertEqual(["a", "b"], venues)
+
+    def test_applies_coalesced_diffs_before_reading(self):
+        self.book_b.coalesce_diffs = True
+        self.book_b.apply_diffs([OrderBookRow(99.5, 0, 2)], [OrderBookRow(100, 1, 2)], 2)
+        self.assertEqual((99, 1, "a"), self.consolidated.get_best(False))
+        self.assertEqual(0, self.book_b.coalesced_diff_count)
+
+        self.book_b.apply_diffs([], [OrderBookRow(100, 0, 3)], 3)
+        self.assertEqual(101, self.consolidated.get_price(True))
+        self.book_b.apply_diffs([], [OrderBookRow(100.5, 3, 4)], 4)
+        self.assertEqual(100.5, self.consolidated.get_price_for_volume(True, 2).result_price)
+        self.book_b.apply_diffs([], [OrderBookRow(100.5, 0, 5)], 5)
+        rows, _ = self.consolidated.ladder_array(True, 1)
+        self.assertEqual([[101, 1, 0]], rows.tolist())
+
+    def test_empty(self):
+        consolidated = ConsolidatedOrderBook()
+        with self.assertRaises(EnvironmentError):
+            consolidated.get_price(True)
+        self.assertEqual({}, consolidated.get_venue_volumes_for_volume(True, 1))
+        with self.assertRaises(ValueError):
+            self.consolidated.add_order_book("a", OrderBook())
+        with self.assertRaises(ValueError):
+            self.consolidated.add_order_book("c", self.book_a)
+        self.assertEqual(["a", "b"], self.consolidated.venues)
+
+    def test_shared_pooled_books_do_not_deadlock(self):
+        # Pooled books take their locks for real. Two consolidated books over them, added in opposite orders, are
+        # queried from two threads at once.
+        pool = OrderBookWorkerPool(1)
+        pool.add_order_book("A-USDT", self.book_a)
+        pool.add_order_book("B-USDT", self.book_b)
+        reversed_consolidated = ConsolidatedOrderBook({"b": self.book_b, "a": self.book_a})
+
+        def query(consolidated: ConsolidatedOrderBook):
+            for _ in range(10000):
+                consolidated.get_price(True)
+
+        threads = [threading.Thread(target=query, args=(consolidated,), daemon=True)
+                   for consolidated in (self.consolidated, reversed_consolidated)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join(10)
+            self.assertFalse(thread.is_alive())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,91 @@
+import math
+import os
+import tempfile
+import unittest
+from decimal import Decimal
+
+import numpy as np
+
+from hummingbot.core.data_type.common import TradeType
+from hummingbot.core.data_type.l2_capture import RECORD_TYPE_DIFF, RECORD_TYPE_TRADE, L2Recorder, L2Replay
+from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.event.events import OrderBookTradeEvent
+
+
+class L2CaptureUnitTest(unittest.TestCase):
+    def setUp(self):
+        temp_dir = tempfile.TemporaryDirectory()
+        self.addCleanup(temp_dir.cleanup)
+        self.path = os.path.join(temp_dir.name, "capture.l2")
+
+    def test_record_and_replay(self):
+        recorder = L2Recorder(self.path, "COINALPHA-HBOT")
+        recorder.write_snapshot(np.array([[3, 1, 1], [2, 2, 1]], dtype=np.float64),
+                                np.array([[4, 1, 1], [5, 2, 1]], dtype=np.float64), 1, 100)
+        recorder.write_diffs(np.array([[3, 0, 2]], dtype=np.float64), np.array([[4.5, 3, 2]], dtype=np.float64), 2, 101)
+        recorder.write_trade(
+            OrderBookTradeEvent("COINALPHA-HBOT", 102, TradeType.SELL, Decimal("2"), Decimal("0.5"), "7"))
+        recorder.write_diffs(np.array([[2, 1, 3]], dtype=np.float64), np.empty((0, 3), dtype=np.float64), 3, 103)
+        self.assertEqual(recorder.record_count, 4)
+        recorder.close()
+
+        replay = L2Replay(self.path)
+        self.assertEqual(replay.trading_pair, "COINALPHA-HBOT")
+        self.assertEqual(replay.next_timestamp, 100)
+        self.assertEqual(replay.last_timestamp, 103)
+        self.assertEqual(replay.next_timestamp, 100)
+        order_book = OrderBook()
+        self.assertEqual(replay.replay(order_book, until_timestamp=102), 3)
+        self.assertEqual(list(order_book.bid_entries()), [(2.0, 2.0, 1)])
+        self.assertEqual(list(order_book.ask_entries()), [(4.0, 1.0, 1), (4.5, 3.0, 2), (5.0, 2.0, 1)])
+        self.assertEqual(order_book.last_trade_price, Decimal("2"))
+        self.assertEqual(order_book.last_diff_uid, 2)
+
+        self.assertEqual(replay.replay(order_book), 1)
+        self.assertTrue(replay.at_end)
+        self.assertTrue(math.isnan(replay.next_timestamp))
+        self.assertEqual(list(order_book.bid_entries()), [(2.0, 1.0, 3)])
+
+        replay.rewind()
+        replay.read_record()
+        record_type, timestamp, update_id, bids, asks, _ = replay.read_record()
+        self.assertEqual((record_type, timestamp, update_id), (RECORD_TYPE_DIFF, 101, 2))
+        self.assertEqual(bids.tolist(), [[3, 0, 2]])
+        self.assertEqual(asks.tolist(), [[4.5, 3, 2]])
+        record_type, _, _, bids, _, _ = replay.read_record()
+        self.assertEqual(record_type, RECORD_TYPE_TRADE)
+        self.assertEqual(bids.tolist(), [[2, 0.5, 7]])
+
+    def test_attach_records_order_book_updates(self):
+        recorder = L2Recorder(self.path, "COINALPHA-HBOT")
+        order_book = OrderBook()
+        recorder.attach(order_book)
+        order_book.apply_numpy_snapshot(np.array([[3, 1, 1]], dtype=np.float64),
+                                        np.array([[4, 1, 1]], dtype=np.float64))
+        order_book.apply_numpy_diffs(np.array([[3.5, 2, 2]], dtype=np.float64), np.empty((0, 3), dtype=np.float64))
+        recorder.detach(order_book)
+        order_book.apply_numpy_diffs(np.array([[3.5, 0, 3]], dtype=np.float64), np.empty((0, 3), dtype=np.float64))
+        self.assertEqual(recorder.record_count, 2)
+        recorder.close()
+
+        # Reopening appends to the same file.
+        recorder = L2Recorder(self.path, "COINALPHA-HBOT")
+        recorder.write_diffs(np.array([[3, 5, 4]], dtype=np.float64), np.empty((0, 3), dtype=np.float64), 4, 200)
+        recorder.close()
+
+        replayed_book = OrderBook()
+        self.assertEqual(L2Replay(self.path).replay(replayed_book), 3)
+        self.assertEqual(list(replayed_book.bid_entries()), [(3.5, 2.0, 2), (3.0, 5.0, 4)])
+        self.assertEqual(list(replayed_book.ask_entries()), [(4.0, 1.0, 1)])
+
+    def test_open_errors(self):
+        with open(self.path, "wb") as f:
+            f.write(b"not a capture file" * 8)
+        with self.assertRaises(IOError):
+            L2Recorder(self.path, "COINALPHA-HBOT")
+        with self.assertRaises(IOError):
+            L2Replay(self.path)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,58 @@
+import unittest
+
+from hummingbot.core.data_type.l3_order_tracker import L3OrderTracker
+from hummingbot.core.data_type.order_book import OrderBook
+
+
+class L3OrderTrackerUnitTest(unittest.TestCase):
+    def setUp(self):
+        self.tracker = L3OrderTracker()
+        self.tracker.load_snapshot([("b1", 10, 1), ("b2", 10, 2), ("b3", 9, 1)], [("a1", 11, 1), ("a2", 12, 3)], 1)
+
+    def test_load_snapshot(self):
+        self.assertEqual(self.tracker.order_count, 5)
+        self.assertEqual(self.tracker.bid_level_count, 2)
+        self.assertEqual(self.tracker.ask_level_count, 2)
+        self.assertEqual(self.tracker.level_amount(True, 10), 3)
+        self.assertEqual(self.tracker.level_order_count(True, 10), 2)
+        self.assertEqual(self.tracker.pending_diff_count, 0)
+        self.assertEqual(self.tracker.get_order("b2"), (True, 10, 2, 1))
+        self.assertIsNone(self.tracker.get_order("missing"))
+
+        order_book = OrderBook()
+        self.tracker.apply_snapshot_to_order_book(order_book, 1)
+        self.assertEqual(list(order_book.bid_entries()), [(10.0, 3.0, 1), (9.0, 1.0, 1)])
+        self.assertEqual(list(order_book.ask_entries()), [(11.0, 1.0, 1), (12.0, 3.0, 1)])
+
+    def test_order_lifecycle(self):
+        self.tracker.open_order("b4", True, 10.5, 2, 2, client_order_id="client-1")
+        self.assertTrue(self.tracker.change_order("b1", 0.5, 3))
+        self.assertTrue(self.tracker.fill_order("a1", 0.25, 4))
+        self.assertTrue(self.tracker.close_order("b3", 5))
+        self.assertFalse(self.tracker.close_order("b3", 6))
+        self.assertFalse(self.tracker.change_order("missing", 1, 6))
+
+        self.assertEqual(self.tracker.get_order_by_client_order_id("client-1"), ("b4", True, 10.5, 2, 2))
+        self.assertIsNone(self.tracker.get_order_by_client_order_id("client-2"))
+        self.assertEqual(self.tracker.level_amount(True, 10), 2.5)
+        self.assertEqual(self.tracker.level_amount(False, 11), 0.75)
+        self.assertEqual(self.tracker.level_order_count(True, 9), 0)
+        self.assertEqual(self.tracker.order_count, 5)
+        self.assertEqual(self.tracker.pending_diff_count, 4)
+
+        order_book = OrderBook()
+        self.tracker.apply_snapshot_to_order_book(order_book, 1)
+        self.tracker.open_order("b5", True, 9, 1, 7)
+        self.tracker.close_order("b5", 8)
+        self.tracker.change_order("a2", 1, 9)
+        self.assertEqual(self.tracker.flush_to_order_book(order_book), 9)
+        self.assertEqual(self.tracker.pending_diff_count, 0)
+        self.assertEqual(self.tracker.flush_to_order_book(order_book), 0)
+        self.assertEqual(list(order_book.bid_entries()), [(10.5, 2.0, 1), (10.0, 2.5, 1)])
+        self.assertEqual(list(order_book.ask_entries()), [(11.0, 0.75, 1), (12.0, 1.0, 9)])
+
+    def test_reopen_replaces_order(self):
+        self.tracker.open_order("b1", False, 13, 4, 2)
+        self.assertEqual(self.tracker.order_count, 5)
+        self.assertEqual(self.tracker.level_amount(True, 10), 2)
+        self.assertEqual(self.tracker.get_order("b1"), (False, 13, 4, 2))
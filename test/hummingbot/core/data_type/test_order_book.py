@@ -1,8 +1,14 @@
 #!/usr/bin/env python
 
 import logging
+import os
+import tempfile
+import time
 import unittest
 from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.data_type.order_book_message import OrderBookMessage, OrderBookMessageType
+from hummingbot.core.data_type.order_book_reconcile_result import OrderBookReconcileStatus
+from hummingbot.core.data_type.order_book_row import OrderBookRow
 import numpy as np
 
 
@@ -50,6 +56,380 @@ class OrderBookUnitTest(unittest.TestCase):
         self.assertEqual(best_bid, [50., 0.01, 6.])
         self.assertEqual(best_ask, 0)
 
+    def test_apply_diffs_keeps_levels_sorted(self):
+        order_book = OrderBook()
+        bids_array = np.array([[1, 1, 1], [3, 1, 1], [2, 1, 1], [3, 5, 1]], dtype=np.float64)
+        asks_array = np.array([[6, 1, 1], [4, 1, 1], [5, 1, 1]], dtype=np.float64)
+        order_book.apply_numpy_snapshot(bids_array, asks_array)
+        # Duplicate prices in a snapshot keep the first entry.
+        self.assertEqual([(row.price, row.amount) for row in order_book.bid_entries()], [(3, 1), (2, 1), (1, 1)])
+        self.assertEqual([row.price for row in order_book.ask_entries()], [4, 5, 6])
+
+        order_book.apply_numpy_diffs(np.array([[3, 0, 2], [2.5, 2, 2], [1, 4, 2]], dtype=np.float64),
+                                     np.array([[4, 0, 2], [5.5, 1, 2]], dtype=np.float64))
+        self.assertEqual([(row.price, row.amount) for row in order_book.bid_entries()], [(2.5, 2), (2, 1), (1, 4)])
+        self.assertEqual([row.price for row in order_book.ask_entries()], [5, 5.5, 6])
+        self.assertEqual(order_book.get_price(False), 2.5)
+        self.assertEqual(order_book.get_price(True), 5)
+        self.assertEqual(order_book.last_diff_uid, 2)
+
+    def test_apply_numpy_diffs_ignores_extra_columns(self):
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[1, 1, 1]], dtype=np.float64), np.array([[2, 1, 1]], dtype=np.float64))
+        order_book.apply_numpy_diffs(np.array([[1.5, 3, 7, 99]], dtype=np.float64), np.empty((0, 4), dtype=np.float64))
+        self.assertEqual(list(order_book.bid_entries())[0], (1.5, 3, 7))
+        self.assertEqual(order_book.last_diff_uid, 7)
+
+    def test_depth_queries(self):
+        for depth_index_enabled in (False, True):
+            order_book = OrderBook()
+            order_book.depth_index_enabled = depth_index_enabled
+            order_book.apply_numpy_snapshot(np.array([[3, 1, 1], [2, 2, 1], [1, 3, 1]], dtype=np.float64),
+                                            np.array([[4, 1, 1], [5, 2, 1], [6, 3, 1]], dtype=np.float64))
+
+            result = order_book.get_price_for_volume(True, 2)
+            self.assertEqual((result.result_price, result.result_volume), (5, 2))
+            result = order_book.get_vwap_for_volume(True, 2)
+            self.assertEqual((result.result_price, result.result_volume), (4.5, 2))
+            result = order_book.get_vwap_for_volume(False, 10)
+            self.assertTrue(np.isnan(result.result_price))
+            self.assertEqual(result.result_volume, 6)
+            result = order_book.get_price_for_quote_volume(False, 7)
+            self.assertEqual((result.result_price, result.result_volume), (2, 7))
+            result = order_book.get_quote_volume_for_base_amount(True, 2)
+            self.assertEqual(result.result_volume, 9)
+            result = order_book.get_volume_for_price(False, 2)
+            self.assertEqual((result.result_price, result.result_volume), (2, 3))
+            result = order_book.get_quote_volume_for_price(True, 5.5)
+            self.assertEqual((result.result_price, result.result_volume), (5, 14))
+
+            # The index is rebuilt after the book changes.
+            order_book.apply_numpy_diffs(np.array([[3, 0, 2]], dtype=np.float64), np.empty((0, 3), dtype=np.float64))
+            result = order_book.get_volume_for_price(False, 2)
+            self.assertEqual((result.result_price, result.result_volume), (2, 2))
+
+    def test_top_levels(self):
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[3, 1, 1], [2, 2, 1], [1, 3, 1]], dtype=np.float64),
+                                        np.array([[4, 1, 1], [5, 2, 1]], dtype=np.float64))
+        bids, asks = order_book.top_levels(2)
+        self.assertEqual(bids.tolist(), [[3, 1, 1], [2, 2, 1]])
+        self.assertEqual(asks.tolist(), [[4, 1, 1], [5, 2, 1]])
+        self.assertFalse(bids.flags.writeable)
+        self.assertEqual(order_book.top_levels_capacity, 2)
+
+        # The views are updated in place by later diffs.
+        order_book.apply_numpy_diffs(np.array([[2.5, 4, 2]], dtype=np.float64), np.array([[4, 0, 2]], dtype=np.float64))
+        self.assertEqual(bids.tolist(), [[3, 1, 1], [2.5, 4, 2]])
+        self.assertEqual(asks[0].tolist(), [5, 2, 1])
+        self.assertTrue(np.isnan(asks[1]).all())
+
+        bids, asks = order_book.top_levels(5)
+        self.assertEqual(len(bids), 4)
+        self.assertEqual(len(asks), 1)
+
+        with self.assertRaises(ValueError):
+            order_book.top_levels(-1)
+        with self.assertRaises(ValueError):
+            order_book.top_levels_capacity = -1
+        self.assertEqual(order_book.top_levels_capacity, 5)
+
+    def test_top_levels_zero_on_fresh_book(self):
+        order_book = OrderBook()
+        bids, asks = order_book.top_levels(0)
+        self.assertEqual(bids.shape, (0, 3))
+        self.assertEqual(asks.shape, (0, 3))
+        self.assertEqual(order_book.top_levels_capacity, 0)
+
+    def test_snapshot_arrays(self):
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[2, 2, 1], [3, 1, 1]], dtype=np.float64),
+                                        np.array([[4, 1, 1], [5, 2, 1], [6, 3, 1]], dtype=np.float64))
+        bids, asks = order_book.snapshot_arrays()
+        self.assertEqual(bids.tolist(), [[3, 1, 1], [2, 2, 1]])
+        self.assertEqual(asks.tolist(), [[4, 1, 1], [5, 2, 1], [6, 3, 1]])
+
+        bids_out = np.zeros((5, 3))
+        asks_out = np.zeros((2, 3))
+        bids, asks = order_book.snapshot_arrays(bids_out, asks_out)
+        self.assertTrue(np.shares_memory(bids, bids_out))
+        self.assertEqual(bids.tolist(), [[3, 1, 1], [2, 2, 1]])
+        self.assertEqual(asks.tolist(), [[4, 1, 1], [5, 2, 1]])
+
+    def test_fixed_point_increments(self):
+        order_book = OrderBook()
+        order_book.set_fixed_point_increments(0.01, 0.001)
+        self.assertEqual(order_book.fixed_point_increments, (0.01, 0.001))
+        order_book.apply_numpy_snapshot(np.array([[0.1 + 0.2, 1.0004, 1]], dtype=np.float64),
+                                        np.array([[0.31, 1, 1]], dtype=np.float64))
+        self.assertEqual(list(order_book.bid_entries()), [(0.3, 1.0, 1)])
+
+        # Float noise in the diff price still matches the existing level.
+        order_book.apply_numpy_diffs(np.array([[0.30000000001, 2, 2]], dtype=np.float64),
+                                     np.empty((0, 3), dtype=np.float64))
+        self.assertEqual(list(order_book.bid_entries()), [(0.3, 2.0, 2)])
+        order_book.apply_numpy_diffs(np.array([[0.29999999999, 0, 3]], dtype=np.float64),
+                                     np.empty((0, 3), dtype=np.float64))
+        self.assertEqual(list(order_book.bid_entries()), [])
+
+    def test_diff_ring(self):
+        order_book = OrderBook()
+        no_rows = np.empty((0, 3), dtype=np.float64)
+        self.assertFalse(order_book.push_diff_rows(np.array([[1, 1, 1]], dtype=np.float64), no_rows))
+        self.assertEqual(order_book.dropped_diff_count, 1)
+
+        order_book.diff_ring_capacity = 4
+        self.assertEqual(order_book.diff_ring_capacity, 4)
+        self.assertTrue(order_book.push_diff_rows(np.array([[1, 1, 1], [0.9, 2, 1]], dtype=np.float64),
+                                                  np.array([[1.1, 1, 1]], dtype=np.float64)))
+        # Messages that do not fit are dropped whole.
+        self.assertFalse(order_book.push_diff_rows(np.array([[1, 0, 2]], dtype=np.float64),
+                                                   np.array([[1.2, 1, 2]], dtype=np.float64)))
+        self.assertTrue(order_book.push_diff_rows(np.array([[1, 3, 3]], dtype=np.float64), no_rows))
+        self.assertEqual(order_book.pending_diff_count, 4)
+        self.assertEqual(list(order_book.bid_entries()), [])
+
+        self.assertEqual(order_book.drain_diffs(), 4)
+        self.assertEqual(order_book.pending_diff_count, 0)
+        self.assertEqual(list(order_book.bid_entries()), [(1.0, 3.0, 3), (0.9, 2.0, 1)])
+        self.assertEqual(list(order_book.ask_entries()), [(1.1, 1.0, 1)])
+        self.assertEqual(order_book.last_diff_uid, 3)
+        self.assertEqual(order_book.drain_diffs(), 0)
+        self.assertEqual(order_book.last_diff_uid, 3)
+
+    def test_drain_diffs_at_message_boundaries(self):
+        order_book = OrderBook()
+        order_book.diff_ring_capacity = 8
+        no_rows = np.empty((0, 3), dtype=np.float64)
+        self.assertTrue(order_book.push_diff_rows(np.array([[1, 1, 1], [0.9, 2, 1]], dtype=np.float64),
+                                                  np.array([[1.1, 1, 1]], dtype=np.float64)))
+        self.assertTrue(order_book.push_diff_rows(np.array([[1, 3, 2]], dtype=np.float64), no_rows))
+        self.assertTrue(order_book.push_diff_rows(np.array([[0.9, 0, 3]], dtype=np.float64),
+                                                  np.array([[1.2, 1, 3]], dtype=np.float64)))
+
+        # A limit smaller than the first message still takes all of it.
+        self.assertEqual(order_book.drain_diffs(2), 3)
+        self.assertEqual(list(order_book.bid_entries()), [(1.0, 1.0, 1), (0.9, 2.0, 1)])
+        self.assertEqual(list(order_book.ask_entries()), [(1.1, 1.0, 1)])
+        self.assertEqual(order_book.last_diff_uid, 1)
+
+        # Otherwise the limit is rounded down to the last message that fits.
+        self.assertEqual(order_book.drain_diffs(2), 1)
+        self.assertEqual(order_book.last_diff_uid, 2)
+        self.assertEqual(order_book.pending_diff_count, 2)
+        self.assertEqual(order_book.drain_diffs(2), 2)
+        self.assertEqual(list(order_book.bid_entries()), [(1.0, 3.0, 2)])
+        self.assertEqual(list(order_book.ask_entries()), [(1.1, 1.0, 1), (1.2, 1.0, 3)])
+        self.assertEqual(order_book.last_diff_uid, 3)
+
+    def test_restore_from_snapshot_and_diffs(self):
+        def diff(update_id, bids, asks, first_update_id=None):
+            content = {"trading_pair": "A-B", "update_id": update_id, "bids": bids, "asks": asks}
+            if first_update_id is not None:
+                content["first_update_id"] = first_update_id
+            return OrderBookMessage(OrderBookMessageType.DIFF, content, timestamp=update_id)
+
+        order_book = OrderBook()
+        snapshot = OrderBookMessage(OrderBookMessageType.SNAPSHOT,
+                                    {"trading_pair": "A-B", "update_id": 10,
+                                     "bids": [["1.0", "1"], ["0.9", "1"]], "asks": [["1.1", "1"]]},
+                                    timestamp=10)
+        diffs = [
+            diff(9, [["1.0", "5"]], [], 8),
+            diff(11, [["1.0", "0"]], [["1.2", "2"]], 10),
+            diff(12, [], [], 12),
+            diff(13, [["0.8", "3"]], [], 13),
+        ]
+        result = order_book.restore_from_snapshot_and_diffs(snapshot, diffs)
+        self.assertTrue(result.in_sync)
+        self.assertEqual(result.last_update_id, 13)
+        self.assertEqual(result.applied_diffs, 3)
+        self.assertEqual(result.skipped_diffs, 1)
+        self.assertEqual(list(order_book.bid_entries()), [(0.9, 1.0, 10), (0.8, 3.0, 13)])
+        self.assertEqual(list(order_book.ask_entries()), [(1.1, 1.0, 10), (1.2, 2.0, 11)])
+        self.assertEqual(order_book.snapshot_uid, 10)
+        self.assertEqual(order_book.last_diff_uid, 13)
+
+        # A hole in the update IDs stops the replay at the last contiguous diff.
+        diffs = [diff(11, [["1.0", "0"]], [], 11), diff(14, [["0.8", "3"]], [], 13)]
+        result = order_book.restore_from_snapshot_and_diffs(snapshot, diffs)
+        self.assertEqual(result.status, OrderBookReconcileStatus.GAP)
+        self.assertEqual(result.last_update_id, 11)
+        self.assertEqual(result.gap_first_update_id, 13)
+        self.assertEqual(list(order_book.bid_entries()), [(0.9, 1.0, 10)])
+
+        # Diffs without a first update ID are not checked for gaps.
+        result = order_book.restore_from_snapshot_and_diffs(snapshot, [diff(20, [["0.8", "3"]], [])])
+        self.assertTrue(result.in_sync)
+        self.assertEqual(list(order_book.bid_entries()), [(1.0, 1.0, 10), (0.9, 1.0, 10), (0.8, 3.0, 20)])
+
+    def test_restore_from_numpy_snapshot_and_diffs(self):
+        order_book = OrderBook()
+        diffs_array = np.array([[1.0, 0, 11, 11, 1], [1.2, 2, 11, 11, 0], [0.8, 3, 12, np.nan, 1]], dtype=np.float64)
+        result = order_book.restore_from_numpy_snapshot_and_diffs(np.array([[1.0, 1, 10]], dtype=np.float64),
+                                                                  np.array([[1.1, 1, 10]], dtype=np.float64),
+                                                                  10,
+                                                                  diffs_array)
+        self.assertTrue(result.in_sync)
+        self.assertEqual(result.applied_diffs, 2)
+        self.assertEqual(list(order_book.bid_entries()), [(0.8, 3.0, 12)])
+        self.assertEqual(list(order_book.ask_entries()), [(1.1, 1.0, 10), (1.2, 2.0, 11)])
+        with self.assertRaises(ValueError):
+            order_book.restore_from_numpy_snapshot_and_diffs(np.empty((0, 3)), np.empty((0, 3)), 1, np.empty((0, 3)))
+
+    def test_stats(self):
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[1, 1, 1], [2, 1, 1]], dtype=np.float64),
+                                        np.array([[3, 1, 1]], dtype=np.float64))
+        order_book.apply_numpy_diffs(np.array([[2, 5, 2], [1, 0, 2], [3.5, 1, 2]], dtype=np.float64),
+                                     np.empty((0, 3), dtype=np.float64))
+        order_book.record_diff_arrival(time.time() - 0.5, 3)
+        order_book.record_diff_arrival(time.time(), 5)
+        stats = order_book.stats
+        self.assertEqual(stats.diff_batches, 1)
+        self.assertEqual(stats.diff_levels, 3)
+        self.assertEqual(stats.levels_inserted, 1)
+        self.assertEqual(stats.levels_updated, 1)
+        self.assertEqual(stats.levels_erased, 1)
+        # The newer bid at 3.5 crosses the ask at 3, which is truncated.
+        self.assertEqual(stats.truncations, 1)
+        self.assertEqual(stats.truncated_levels, 1)
+        self.assertEqual(stats.snapshots, 1)
+        self.assertEqual(stats.update_id_gaps, 1)
+        self.assertEqual(stats.last_update_id, 2)
+        self.assertEqual(stats.diff_apply_time.count, 1)
+        self.assertEqual(stats.diff_batch_levels.max, 3)
+        self.assertEqual(stats.snapshot_apply_time.count, 1)
+        self.assertEqual(stats.exchange_lag.count, 2)
+        self.assertGreaterEqual(stats.exchange_lag.max, 0.5)
+        self.assertLess(stats.exchange_lag.max, 0.6)
+
+        order_book.reset_stats()
+        stats = order_book.stats
+        self.assertEqual(stats.diff_batches, 0)
+        self.assertEqual(stats.levels_inserted, 0)
+        self.assertEqual(stats.exchange_lag.count, 0)
+        self.assertEqual(stats.last_update_id, 2)
+
+    def test_features(self):
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[99, 2, 1], [98, 4, 1], [97, 10, 1]], dtype=np.float64),
+                                        np.array([[101, 1, 1], [102, 3, 1]], dtype=np.float64))
+        self.assertTrue(np.isnan(order_book.features.microprice))
+
+        order_book.configure_features(depth=2, pressure_bps=150)
+        features = order_book.features
+        self.assertAlmostEqual(features.microprice, (99 * 1 + 101 * 2) / 3)
+        self.assertAlmostEqual(features.depth_imbalance, (6 - 4) / 10)
+        self.assertAlmostEqual(features.weighted_mid, 100)
+        # The band is 1.5 around the mid of 100, which only holds the best levels.
+        self.assertEqual(features.bid_pressure_volume, 2)
+        self.assertEqual(features.ask_pressure_volume, 1)
+        self.assertAlmostEqual(features.book_pressure, 1 / 3)
+
+        order_book.apply_numpy_diffs(np.empty((0, 3), dtype=np.float64), np.array([[101, 0, 2]], dtype=np.float64))
+        features = order_book.features
+        self.assertAlmostEqual(features.microprice, (99 * 3 + 102 * 2) / 5)
+        self.assertAlmostEqual(features.depth_imbalance, (6 - 3) / 9)
+        # The asks only have one level left, so only the best depth has a midpoint.
+        self.assertAlmostEqual(features.weighted_mid, 100.5)
+
+        order_book.configure_features(depth=0)
+        self.assertTrue(np.isnan(order_book.features.book_pressure))
+        with self.assertRaises(ValueError):
+            order_book.configure_features(depth=-1)
+
+
+    def test_coalesce_diffs(self):
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[99, 1, 1], [98, 1, 1]], dtype=np.float64),
+                                        np.array([[101, 1, 1]], dtype=np.float64))
+        order_book.coalesce_diffs = True
+        empty = np.empty((0, 3), dtype=np.float64)
+        order_book.apply_numpy_diffs(np.array([[99, 2, 2], [100, 1, 2]], dtype=np.float64), empty)
+        order_book.apply_numpy_diffs(np.array([[99, 3, 3], [100, 0, 3]], dtype=np.float64), empty)
+        # An older row does not replace a newer one pending for the same level.
+        order_book.apply_numpy_diffs(np.array([[99, 9, 1]], dtype=np.float64), empty)
+        self.assertEqual(order_book.coalesced_diff_count, 2)
+        self.assertEqual(order_book.merged_diff_count, 3)
+        self.assertEqual(order_book.last_diff_uid, 3)
+        self.assertEqual(order_book.stats.diff_batches, 0)
+
+        # Reading the book applies the pending levels first.
+        self.assertEqual([(row.price, row.amount) for row in order_book.bid_entries()], [(99, 3), (98, 1)])
+        self.assertEqual(order_book.coalesced_diff_count, 0)
+        self.assertEqual(order_book.stats.diff_batches, 1)
+        self.assertEqual(order_book.stats.diff_levels, 2)
+
+        order_book.apply_numpy_diffs(empty, np.array([[101, 5, 4]], dtype=np.float64))
+        self.assertEqual(order_book.flush_diffs(), 1)
+        self.assertEqual(order_book.flush_diffs(), 0)
+
+        # A snapshot drops the pending levels it covers and keeps the newer ones.
+        order_book.apply_numpy_diffs(np.array([[97, 1, 5]], dtype=np.float64),
+                                     np.array([[102, 1, 7]], dtype=np.float64))
+        order_book.apply_numpy_snapshot(np.array([[99, 1, 6]], dtype=np.float64),
+                                        np.array([[101, 1, 6]], dtype=np.float64))
+        self.assertEqual(order_book.coalesced_diff_count, 1)
+        self.assertEqual(order_book.get_price(False), 99)
+        self.assertEqual([row.price for row in order_book.ask_entries()], [101, 102])
+
+        # So does a restore from a snapshot.
+        order_book.apply_numpy_diffs(empty, np.array([[103, 1, 9]], dtype=np.float64))
+        snapshot = OrderBookMessage(OrderBookMessageType.SNAPSHOT,
+                                    {"trading_pair": "A-B", "update_id": 8, "bids": [["99", "1"]], "asks": [["101", "1"]]},
+                                    timestamp=8)
+        self.assertTrue(order_book.restore_from_snapshot_and_diffs(snapshot, []).in_sync)
+        self.assertEqual(order_book.coalesced_diff_count, 1)
+        self.assertEqual([row.price for row in order_book.ask_entries()], [101, 103])
+
+        order_book.apply_numpy_diffs(np.array([[99, 0, 8]], dtype=np.float64), empty)
+        order_book.coalesce_diffs = False
+        self.assertEqual(order_book.coalesced_diff_count, 0)
+        self.assertEqual(len(list(order_book.bid_entries())), 0)
+
+    def test_coalesce_diffs_truncates_net_result(self):
+        # An ask crosses the best bid for one update only. Applied as it arrives, the cross truncates the older bid.
+        results = []
+        for coalesce in (False, True):
+            order_book = OrderBook()
+            order_book.apply_snapshot([OrderBookRow(99, 1, 1), OrderBookRow(98, 1, 1)], [OrderBookRow(101, 1, 1)], 1)
+            order_book.coalesce_diffs = coalesce
+            order_book.apply_diffs([], [OrderBookRow(98.5, 1, 2)], 2)
+            order_book.apply_diffs([], [OrderBookRow(98.5, 0, 3)], 3)
+            results.append(([row.price for row in order_book.bid_entries()],
+                            [row.price for row in order_book.ask_entries()]))
+        self.assertEqual(results[0], ([98], [101]))
+        # Coalesced, the ask is gone by the time the batch is truncated, so the bid is kept.
+        self.assertEqual(results[1], ([99, 98], [101]))
+
+    def test_save_and_load_cache(self):
+        temp_dir = tempfile.TemporaryDirectory()
+        self.addCleanup(temp_dir.cleanup)
+        path = os.path.join(temp_dir.name, "COINALPHA-HBOT.book")
+        order_book = OrderBook()
+        order_book.apply_numpy_snapshot(np.array([[99, 1, 5], [98, 2, 5]], dtype=np.float64),
+                                        np.array([[101, 1, 5]], dtype=np.float64))
+        order_book.apply_numpy_diffs(np.array([[99, 3, 7]], dtype=np.float64), np.empty((0, 3), dtype=np.float64))
+        order_book.save_cache(path, "COINALPHA-HBOT")
+        self.assertFalse(os.path.exists(path + ".tmp"))
+
+        restored = OrderBook()
+        self.assertFalse(restored.load_cache(path, "COINALPHA-USDT"))
+        self.assertFalse(restored.load_cache(os.path.join(temp_dir.name, "missing.book")))
+        self.assertTrue(restored.load_cache(path, "COINALPHA-HBOT"))
+        self.assertEqual(list(restored.bid_entries()), [(99.0, 3.0, 7), (98.0, 2.0, 5)])
+        self.assertEqual(list(restored.ask_entries()), [(101.0, 1.0, 5)])
+        self.assertEqual(restored.snapshot_uid, 7)
+        self.assertEqual(restored.last_diff_uid, 7)
+
+        time.sleep(0.01)
+        self.assertFalse(OrderBook().load_cache(path, max_age=0))
+        with open(path, "r+b") as cache_file:
+            cache_file.seek(-8, os.SEEK_END)
+            cache_file.write(b"\xff" * 8)
+        self.assertFalse(OrderBook().load_cache(path))
+
 
 def main():
     logging.basicConfig(level=logging.INFO)
@@ -0,0 +1,134 @@
+import asyncio
+import os
+import tempfile
+import unittest
+from unittest.mock import AsyncMock, MagicMock
+
+from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.data_type.order_book_message import OrderBookMessage, OrderBookMessageType
+from hummingbot.core.data_type.order_book_row import OrderBookRow
+from hummingbot.core.data_type.order_book_tracker import OrderBookTracker
+
+
+class OrderBookTrackerCacheTest(unittest.TestCase):
+    trading_pair = "COINALPHA-HBOT"
+
+    @classmethod
+    def setUpClass(cls):
+        super().setUpClass()
+        cls.ev_loop = asyncio.get_event_loop()
+
+    def setUp(self):
+        super().setUp()
+        temp_dir = tempfile.TemporaryDirectory()
+        self.addCleanup(temp_dir.cleanup)
+        self.cache_dir = temp_dir.name
+
+        self.data_source = MagicMock()
+        self.data_source.order_book_create_function = OrderBook
+        self.data_source.get_new_order_book = AsyncMock(side_effect=self.rest_order_book)
+        self.data_source.get_order_book_snapshot = AsyncMock(
+            return_value=self.snapshot_message(20, [["0.95", "4"]], [["1.05", "4"]]))
+        self.tracker = OrderBookTracker(self.data_source, [self.trading_pair], order_book_cache_dir=self.cache_dir)
+        self.tracker._sleep = AsyncMock()
+        self.addCleanup(self.tracker.stop)
+
+    def rest_order_book(self, trading_pair: str) -> OrderBook:
+        order_book = OrderBook()
+        order_book.apply_snapshot([OrderBookRow(0.9, 1, 30)], [OrderBookRow(1.1, 1, 30)], 30)
+        return order_book
+
+    def snapshot_message(self, update_id: int, bids, asks) -> OrderBookMessage:
+        return OrderBookMessage(OrderBookMessageType.SNAPSHOT,
+                                {"trading_pair": self.trading_pair, "update_id": update_id, "bids": bids, "asks": asks},
+                                timestamp=update_id)
+
+    def diff_message(self, first_update_id: int, update_id: int, bids, asks) -> OrderBookMessage:
+        return OrderBookMessage(OrderBookMessageType.DIFF,
+                                {"trading_pair": self.trading_pair, "first_update_id": first_update_id,
+                                 "update_id": update_id, "bids": bids, "asks": asks},
+                                timestamp=update_id)
+
+    def write_cache(self, update_id: int = 10):
+        order_book = OrderBook()
+        order_book.apply_snapshot([OrderBookRow(1.0, 1, update_id)], [OrderBookRow(1.2, 1, update_id)], update_id)
+        order_book.save_cache(self.tracker._order_book_cache_path(self.trading_pair), self.trading_pair)
+
+    def run_init(self, timeout: float = 1):
+        self.ev_loop.run_until_complete(asyncio.wait_for(self.tracker._init_order_books(), timeout))
+
+    def test_cached_book_ready_after_contiguous_diff(self):
+        self.write_cache()
+        # A diff the cache already covers is skipped, and does not tell whether the feed follows on from the cache.
+        self.tracker._saved_message_queues[self.trading_pair].append(self.diff_message(9, 10, [["1.0", "5"]], []))
+        init_task = self.ev_loop.create_task(self.tracker._init_order_books())
+        self.ev_loop.run_until_complete(asyncio.sleep(0.01))
+        self.assertFalse(self.tracker.ready)
+        self.assertNotIn(self.trading_pair, self.tracker.order_books)
+
+        self.tracker._tracking_message_queues[self.trading_pair].put_nowait(
+            self.diff_message(11, 12, [["0.9", "2"]], []))
+        self.ev_loop.run_until_complete(asyncio.wait_for(init_task, 1))
+        self.assertTrue(self.tracker.ready)
+        order_book = self.tracker.order_books[self.trading_pair]
+        self.assertEqual([(row.price, row.amount) for row in order_book.bid_entries()], [(1.0, 1), (0.9, 2)])
+        self.data_source.get_new_order_book.assert_not_awaited()
+        self.data_source.get_order_book_snapshot.assert_not_awaited()
+
+    def test_cached_book_ready_after_diff_from_update_zero(self):
+        self.write_cache(update_id=0)
+        self.tracker._saved_message_queues[self.trading_pair].append(self.diff_message(0, 1, [["0.9", "2"]], []))
+        self.run_init()
+
+        self.assertTrue(self.tracker.ready)
+        self.data_source.get_order_book_snapshot.assert_not_awaited()
+        self.data_source.get_new_order_book.assert_not_awaited()
+
+    def test_cached_book_resynced_after_gap(self):
+        self.write_cache()
+        self.tracker._saved_message_queues[self.trading_pair].append(self.diff_message(15, 16, [["0.9", "2"]], []))
+        self.run_init()
+
+        self.assertTrue(self.tracker.ready)
+        self.data_source.get_order_book_snapshot.assert_awaited_once_with(self.trading_pair)
+        order_book = self.tracker.order_books[self.trading_pair]
+        self.assertEqual(order_book.snapshot_uid, 20)
+        self.assertEqual([row.price for row in order_book.bid_entries()], [0.95])
+        self.data_source.get_new_order_book.assert_not_awaited()
+
+    def test_cached_book_resynced_without_diffs(self):
+        self.write_cache()
+        self.tracker.ORDER_BOOK_CACHE_VERIFY_TIMEOUT = 0.01
+        self.run_init()
+
+        self.assertTrue(self.tracker.ready)
+        self.data_source.get_order_book_snapshot.assert_awaited_once_with(self.trading_pair)
+        self.assertEqual(self.tracker.order_books[self.trading_pair].snapshot_uid, 20)
+
+    def test_cache_rejected_for_age(self):
+        self.write_cache()
+        self.tracker.ORDER_BOOK_CACHE_MAX_AGE = -1
+        self.run_init()
+
+        self.assertTrue(self.tracker.ready)
+        self.data_source.get_new_order_book.assert_awaited_once_with(self.trading_pair)
+        self.assertEqual(self.tracker.order_books[self.trading_pair].snapshot_uid, 30)
+
+    def test_save_order_book_cache_on_stop(self):
+        for method in ("listen_for_order_book_diffs", "listen_for_trades", "listen_for_order_book_snapshots",
+                       "listen_for_subscriptions"):
+            setattr(self.data_source, method, AsyncMock())
+        self.tracker.start()
+        self.tracker._order_books[self.trading_pair] = self.rest_order_book(self.trading_pair)
+        self.tracker.stop()
+
+        path = self.tracker._order_book_cache_path(self.trading_pair)
+        self.assertTrue(os.path.exists(path))
+        order_book = OrderBook()
+        self.assertTrue(order_book.load_cache(path, self.trading_pair))
+        self.assertEqual([row.price for row in order_book.ask_entries()], [1.1])
+        self.assertEqual(order_book.snapshot_uid, 30)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+
+import time
+import unittest
+
+import numpy as np
+
+from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.data_type.order_book_worker_pool import OrderBookWorkerPool
+
+
+class OrderBookWorkerPoolUnitTest(unittest.TestCase):
+    def wait_for_applied(self, pool: OrderBookWorkerPool, count: int):
+        deadline = time.time() + 5
+        while pool.applied_count < count and time.time() < deadline:
+            time.sleep(0.001)
+        self.assertEqual(pool.applied_count, count)
+
+    def test_maintains_books_concurrently(self):
+        pool = OrderBookWorkerPool(2)
+        order_books = {f"PAIR{i}-USDT": OrderBook() for i in range(4)}
+        for trading_pair, order_book in order_books.items():
+            pool.add_order_book(trading_pair, order_book)
+        self.assertEqual(order_books["PAIR0-USDT"].diff_ring_capacity, 1 << 16)
+        with self.assertRaises(ValueError):
+            pool.add_order_book("PAIR0-USDT", OrderBook())
+
+        pool.start()
+        self.assertTrue(pool.running)
+        with self.assertRaises(RuntimeError):
+            pool.add_order_book("PAIR9-USDT", OrderBook())
+        for update_id in range(1, 101):
+            for order_book in order_books.values():
+                order_book.push_diff_rows(np.array([[100 - update_id % 5, update_id, update_id]], dtype=np.float64),
+                                          np.array([[101 + update_id % 5, update_id, update_id]], dtype=np.float64))
+        self.wait_for_applied(pool, 4 * 100 * 2)
+
+        order_book = order_books["PAIR2-USDT"]
+        top = order_book.top_of_book()
+        self.assertEqual((top.bid_price, top.bid_amount, top.ask_price, top.ask_amount), (100, 100, 101, 100))
+        self.assertEqual(top.update_id, 100)
+        self.assertEqual(order_book.get_price(False), 100)
+        self.assertEqual(order_book.get_price(True), 101)
+        self.assertEqual(order_book.get_volume_for_price(False, 99).result_volume, 100 + 96)
+        self.assertEqual(len(list(order_book.bid_entries())), 5)
+        self.assertEqual(order_book.last_diff_uid, 100)
+        self.assertGreater(order_book.version, 0)
+        with self.assertRaises(RuntimeError):
+            order_book.drain_diffs()
+        with self.assertRaises(RuntimeError):
+            order_book.diff_ring_capacity = 16
+
+        pool.stop()
+        self.assertFalse(pool.running)
+        pool.remove_order_book("PAIR2-USDT")
+        self.assertNotIn("PAIR2-USDT", pool.order_books)
+        self.assertEqual(order_book.drain_diffs(), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,83 @@
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+from hummingbot.core.backtest_scenario_runner import BacktestScenario, BacktestScenarioRunner
+from hummingbot.core.data_type.l2_capture import L2Recorder
+from hummingbot.core.data_type.order_book import OrderBook
+from hummingbot.core.py_time_iterator import PyTimeIterator
+
+
+class MidPriceSampler(PyTimeIterator):
+    def __init__(self, order_book: OrderBook, offset: float):
+        super().__init__()
+        self.order_book = order_book
+        self.offset = offset
+        self.samples = []
+
+    def tick(self, timestamp: float):
+        self.samples.append((timestamp, self.order_book.get_price(True) + self.offset))
+
+    def next_wakeup_timestamp(self) -> float:
+        return float("inf")
+
+
+class EveryTickMidPriceSampler(MidPriceSampler):
+    def tick(self, timestamp: float):
+        if self.order_book.snapshot_uid > 0:
+            super().tick(timestamp)
+
+    def next_wakeup_timestamp(self) -> float:
+        return float("nan")
+
+
+def build_scenario(offset: float) -> BacktestScenario:
+    order_book = OrderBook()
+    sampler = MidPriceSampler(order_book, offset)
+    return BacktestScenario([order_book], [sampler], lambda: sampler.samples)
+
+
+def build_every_tick_scenario(offset: float) -> BacktestScenario:
+    order_book = OrderBook()
+    sampler = EveryTickMidPriceSampler(order_book, offset)
+    return BacktestScenario([order_book], [sampler], lambda: sampler.samples)
+
+
+class BacktestScenarioRunnerUnitTest(unittest.TestCase):
+    start_timestamp = 1000.0
+
+    def setUp(self):
+        temp_dir = tempfile.TemporaryDirectory()
+        self.addCleanup(temp_dir.cleanup)
+        self.path = os.path.join(temp_dir.name, "capture.l2")
+        recorder = L2Recorder(self.path, "COINALPHA-HBOT")
+        recorder.write_snapshot(np.array([[99, 1, 1]], dtype=np.float64),
+                                np.array([[101, 1, 1]], dtype=np.float64), 1, self.start_timestamp + 10)
+        recorder.write_diffs(np.empty((0, 3), dtype=np.float64),
+                             np.array([[100.5, 1, 2]], dtype=np.float64), 2, self.start_timestamp + 500)
+        recorder.close()
+
+    def test_run(self):
+        expected = [[(self.start_timestamp + 10, 101 + offset), (self.start_timestamp + 500, 100.5 + offset)]
+                    for offset in range(5)]
+        for num_processes in (1, 2):
+            runner = BacktestScenarioRunner(self.path, build_scenario, self.start_timestamp,
+                                            num_processes=num_processes)
+            self.assertEqual(expected, runner.run(range(5)))
+        self.assertEqual([], runner.run([]))
+
+    def test_run_to_end_of_data_with_every_tick_iterator(self):
+        # An iterator that needs every tick never lets the clock stop by itself, so the run ends at the last record.
+        for fast_forward in (True, False):
+            runner = BacktestScenarioRunner(self.path, build_every_tick_scenario, self.start_timestamp,
+                                            fast_forward=fast_forward, num_processes=1)
+            samples = runner.run([0])[0]
+            self.assertEqual(len(samples), 491)
+            self.assertEqual(samples[0], (self.start_timestamp + 10, 101))
+            self.assertEqual(samples[-1], (self.start_timestamp + 500, 100.5))
+
+
+if __name__ == "__main__":
+    unittest.main()
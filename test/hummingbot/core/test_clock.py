@@ -2,12 +2,37 @@ import unittest
 import asyncio
 import pandas as pd
 import time
+from decimal import Decimal
 
+from hummingbot.client.config.client_config_map import ClientConfigMap
+from hummingbot.client.config.config_helpers import ClientConfigAdapter
+from hummingbot.connector.exchange.paper_trade.paper_trade_exchange import QuantizationParams
+from hummingbot.connector.test_support.mock_paper_exchange import MockPaperExchange
 from hummingbot.core.clock import (
     Clock,
     ClockMode
 )
+from hummingbot.core.event.event_logger import EventLogger
+from hummingbot.core.event.events import MarketEvent
+from hummingbot.core.py_time_iterator import PyTimeIterator
 from hummingbot.core.time_iterator import TimeIterator
+from hummingbot.strategy.market_trading_pair_tuple import MarketTradingPairTuple
+from hummingbot.strategy.pure_market_making.pure_market_making import PureMarketMakingStrategy
+
+
+class ScheduledTimeIterator(PyTimeIterator):
+    def __init__(self, wakeups):
+        super().__init__()
+        self.wakeups = list(wakeups)
+        self.ticks = []
+
+    def tick(self, timestamp: float):
+        self.ticks.append(timestamp)
+        while len(self.wakeups) > 0 and self.wakeups[0] <= timestamp:
+            self.wakeups.pop(0)
+
+    def next_wakeup_timestamp(self) -> float:
+        return self.wakeups[0] if len(self.wakeups) > 0 else float("inf")
 
 
 class ClockUnitTest(unittest.TestCase):
@@ -124,3 +149,64 @@ class ClockUnitTest(unittest.TestCase):
         self.clock_backtest.backtest_til(self.backtest_start_timestamp + self.tick_size)
         self.assertGreater(self.clock_backtest.current_timestamp, self.clock_backtest.start_time)
         self.assertLess(self.clock_backtest.current_timestamp, self.backtest_end_timestamp)
+
+    def test_backtest_fast_forward(self):
+        start = self.backtest_start_timestamp
+        clock = Clock(ClockMode.BACKTEST, self.tick_size, start, self.backtest_end_timestamp, fast_forward=True)
+        iterator = ScheduledTimeIterator([start + 10, start + 10.5, start + 100])
+        clock.add_iterator(iterator)
+        clock.backtest()
+
+        # Wake-ups are rounded up to the tick grid, and the final tick is always run.
+        self.assertEqual([start + 10, start + 11, start + 100, self.backtest_end_timestamp], iterator.ticks)
+        self.assertEqual(self.backtest_end_timestamp, clock.current_timestamp)
+
+        # An iterator without a schedule gets every tick.
+        clock = Clock(ClockMode.BACKTEST, self.tick_size, start, start + 5, fast_forward=True)
+        iterator = ScheduledTimeIterator([])
+        clock.add_iterator(iterator)
+        clock.add_iterator(TimeIterator())
+        clock.backtest()
+        self.assertEqual([start + i for i in range(1, 6)], iterator.ticks)
+
+        # With no end timestamp, the backtest stops once nothing is scheduled.
+        clock = Clock(ClockMode.BACKTEST, self.tick_size, start, float("nan"), fast_forward=True)
+        iterator = ScheduledTimeIterator([start + 3600])
+        clock.add_iterator(iterator)
+        clock.backtest()
+        self.assertEqual([start + 3600], iterator.ticks)
+
+    def run_pure_market_making(self, fast_forward: bool):
+        clock = Clock(ClockMode.BACKTEST, self.tick_size, self.backtest_start_timestamp, self.backtest_end_timestamp,
+                      fast_forward=fast_forward)
+        market = MockPaperExchange(client_config_map=ClientConfigAdapter(ClientConfigMap()))
+        market.set_balanced_order_book(trading_pair="HBOT-ETH", mid_price=100, min_price=1, max_price=200,
+                                       price_step_size=1, volume_step_size=10)
+        market.set_balance("HBOT", 500)
+        market.set_balance("ETH", 5000)
+        market.set_quantization_param(QuantizationParams("HBOT-ETH", 6, 6, 6, 6))
+        cancel_logger = EventLogger()
+        market.add_listener(MarketEvent.OrderCancelled, cancel_logger)
+        strategy = PureMarketMakingStrategy()
+        strategy.init_params(MarketTradingPairTuple(market, "HBOT-ETH", "HBOT", "ETH"),
+                             bid_spread=Decimal("0.01"),
+                             ask_spread=Decimal("0.01"),
+                             order_amount=Decimal("1"),
+                             order_refresh_time=30)
+        recorder = ScheduledTimeIterator([])
+        clock.add_iterator(market)
+        clock.add_iterator(strategy)
+        clock.add_iterator(recorder)
+        clock.backtest()
+        return recorder.ticks, len(cancel_logger.event_log), len(strategy.active_orders)
+
+    def test_backtest_fast_forward_with_strategy(self):
+        # The strategy publishes its order refresh timer, so the clock skips the ticks in between without changing
+        # what the strategy does.
+        ticks, cancel_count, active_order_count = self.run_pure_market_making(fast_forward=True)
+        every_tick, every_tick_cancel_count, every_tick_active_order_count = self.run_pure_market_making(False)
+        self.assertEqual(3600, len(every_tick))
+        self.assertLess(len(ticks), len(every_tick) // 5)
+        self.assertGreater(cancel_count, 0)
+        self.assertEqual(every_tick_cancel_count, cancel_count)
+        self.assertEqual(every_tick_active_order_count, active_order_count)
@@ -3,11 +3,35 @@ import gc
 import weakref
 
 from hummingbot.core.pubsub import PubSub
+from hummingbot.core.event.event_listener import EventListener
 from hummingbot.core.event.event_logger import EventLogger
 
 from test.mock.mock_events import MockEventType, MockEvent
 
 
+class RecordingListener(EventListener):
+    def __init__(self, listener_id: int, calls: list):
+        super().__init__()
+        self.listener_id = listener_id
+        self.calls = calls
+
+    def __call__(self, arg):
+        self.calls.append(self.listener_id)
+
+
+class RemovingListener(EventListener):
+    def __init__(self, pubsub: PubSub, event_tag, listener_to_remove: EventListener):
+        super().__init__()
+        self.pubsub = pubsub
+        self.event_tag = event_tag
+        self.listener_to_remove = listener_to_remove
+        self.event_log = []
+
+    def __call__(self, arg):
+        self.event_log.append(arg)
+        self.pubsub.remove_listener(self.event_tag, self.listener_to_remove)
+
+
 class PubSubTest(unittest.TestCase):
     def setUp(self) -> None:
         self.pubsub = PubSub()
@@ -89,6 +113,66 @@ class PubSubTest(unittest.TestCase):
         listeners = self.pubsub.get_listeners(self.event_tag_zero)
         self.assertEqual(0, len(listeners))
 
+    def test_trigger_event_calls_listeners_in_order_added(self):
+        calls = []
+        listeners = [RecordingListener(i, calls) for i in range(5)]
+        for listener in listeners:
+            self.pubsub.add_listener(self.event_tag_zero, listener)
+        self.assertEqual(listeners, self.pubsub.get_listeners(self.event_tag_zero))
+        self.pubsub.trigger_event(self.event_tag_zero, self.event)
+        self.assertEqual(list(range(5)), calls)
+
+    def test_trigger_events(self):
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_zero)
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_one)
+        events = [MockEvent(payload=i) for i in range(3)]
+        self.pubsub.trigger_events(self.event_tag_zero, events)
+        self.assertEqual(events, self.listener_zero.event_log)
+        self.assertEqual(events, self.listener_one.event_log)
+
+        self.pubsub.trigger_events(self.event_tag_one, events)
+        self.assertEqual(3, len(self.listener_zero.event_log))
+
+    def test_remove_listener_while_triggering(self):
+        remover = RemovingListener(self.pubsub, self.event_tag_zero, self.listener_one)
+        self.pubsub.add_listener(self.event_tag_zero, remover)
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_one)
+
+        # The listeners of the current event are fixed when it is triggered.
+        self.pubsub.trigger_event(self.event_tag_zero, self.event)
+        self.assertEqual([self.event], remover.event_log)
+        self.assertEqual([self.event], self.listener_one.event_log)
+        self.assertEqual([remover], self.pubsub.get_listeners(self.event_tag_zero))
+
+        # Later events of a batch see the listeners removed by earlier ones.
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_one)
+        events = [MockEvent(payload=i) for i in range(3)]
+        self.pubsub.trigger_events(self.event_tag_zero, events)
+        self.assertEqual([self.event] + events, remover.event_log)
+        self.assertEqual([self.event, events[0]], self.listener_one.event_log)
+
+    def test_lapsed_listener_remove_on_trigger_event(self):
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_zero)
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_one)
+        generation = self.pubsub.listeners_generation
+        self.listener_zero = None  # remove strong reference
+        gc.collect()
+        self.pubsub.trigger_event(self.event_tag_zero, self.event)
+        self.assertEqual(1, len(self.listener_one.event_log))
+        self.assertGreater(self.pubsub.listeners_generation, generation)
+        self.assertEqual([self.listener_one], self.pubsub.get_listeners(self.event_tag_zero))
+
+    def test_listeners_generation(self):
+        generation = self.pubsub.listeners_generation
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_zero)
+        self.assertEqual(generation + 1, self.pubsub.listeners_generation)
+        self.pubsub.add_listener(self.event_tag_zero, self.listener_zero)
+        self.pubsub.trigger_event(self.event_tag_zero, self.event)
+        self.assertEqual(generation + 1, self.pubsub.listeners_generation)
+        self.pubsub.remove_listener(self.event_tag_zero, self.listener_zero)
+        self.assertEqual(generation + 2, self.pubsub.listeners_generation)
+        self.assertEqual(0, len(self.pubsub.get_listeners(self.event_tag_zero)))
+
 
 if __name__ == "__main__":
     unittest.main()
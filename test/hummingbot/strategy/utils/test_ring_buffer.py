@@ -107,3 +107,37 @@ class RingBufferTest(unittest.TestCase):
         self.assertTrue(np.array_equal(buffer.get_as_numpy_array(), np.array([0, 1, 2, 3])))
         buffer.add_value(4)
         self.assertTrue(np.array_equal(buffer.get_as_numpy_array(), np.array([1, 2, 3, 4])))
+
+    def test_rolling_statistics_match_window(self):
+        buffer = RingBuffer(50)
+        samples = 30000 + np.random.RandomState(1).normal(0, 5, 500)
+        for sample in samples:
+            buffer.add_value(sample)
+        window = samples[-50:]
+        self.assertAlmostEqual(buffer.mean_value, np.mean(window), 9)
+        self.assertAlmostEqual(buffer.variance, np.var(window), 6)
+        self.assertAlmostEqual(buffer.sum_squared_diffs, np.sum(np.square(np.diff(window))), 6)
+        self.assertAlmostEqual(buffer.log_return_variance, np.var(np.diff(np.log(window))), 12)
+        alpha = 2 / 51
+        weights = (1 - alpha) ** np.arange(49, -1, -1)
+        self.assertAlmostEqual(buffer.ema(alpha), np.sum(weights * window) / np.sum(weights), 9)
+
+    def test_length_change(self):
+        buffer = RingBuffer(4)
+        for i in range(6):
+            buffer.add_value(i)
+        buffer.length = 2
+        self.assertEqual(buffer.get_as_numpy_array().tolist(), [4, 5])
+        self.assertTrue(buffer.is_full)
+        buffer.length = 3
+        self.assertFalse(buffer.is_full)
+        buffer.add_value(6)
+        self.assertEqual(buffer.get_as_numpy_array().tolist(), [4, 5, 6])
+        self.assertEqual(buffer.mean_value, 5)
+
+    def test_long_buffer(self):
+        buffer = RingBuffer(40000)
+        for i in range(40005):
+            buffer.add_value(i)
+        values = buffer.get_as_numpy_array()
+        self.assertEqual((values[0], values[-1], len(values)), (5, 40004, 40000))
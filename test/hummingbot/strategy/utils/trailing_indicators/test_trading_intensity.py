@@ -4,6 +4,7 @@ from decimal import Decimal
 
 import numpy as np
 import pandas as pd
+from scipy.optimize import curve_fit
 
 from hummingbot.client.config.client_config_map import ClientConfigMap
 from hummingbot.client.config.config_helpers import ClientConfigAdapter
@@ -259,3 +260,46 @@ class TradingIntensityTest(unittest.TestCase):
 
         self.assertAlmostEqual(a, alpha, 10)
         self.assertAlmostEqual(b, kappa, 10)
+
+    def test_calculate_trading_intensity_matches_curve_fit(self):
+        def curve_fn(t_, a_, b_):
+            return a_ * np.exp(-b_ * t_)
+
+        last_price = 1
+        trade_price_levels = list(range(2, 22))
+        price_levels = np.array([p - last_price for p in trade_price_levels], dtype=float)
+        amounts = curve_fn(price_levels, 2, 0.1) * np.random.normal(1, 0.1, len(price_levels))
+
+        timestamp = self.start_timestamp
+
+        trading_intensity_indicator = TradingIntensityIndicator(OrderBook(), self.price_delegate, 1)
+        trading_intensity_indicator.last_quotes = [{"timestamp": timestamp, "price": last_price}]
+
+        timestamp += 1
+
+        for p, amount in zip(trade_price_levels, amounts):
+            new_trade = OrderBookTradeEvent(
+                trading_pair="COINALPHAHBOT",
+                timestamp=timestamp,
+                price=p,
+                amount=amount,
+                type=TradeType.SELL,
+            )
+            trading_intensity_indicator.register_trade(new_trade)
+
+        trading_intensity_indicator.calculate(timestamp)
+        alpha, kappa = trading_intensity_indicator.current_value
+
+        # The bounded fit the indicator used to hand to SciPy, run to a tight tolerance
+        params, _ = curve_fit(curve_fn,
+                              price_levels,
+                              amounts,
+                              p0=(1, 1),
+                              method="dogbox",
+                              bounds=([0, 0], [np.inf, np.inf]),
+                              ftol=1e-12,
+                              xtol=1e-12,
+                              gtol=1e-12)
+
+        self.assertAlmostEqual(params[0], alpha, 6)
+        self.assertAlmostEqual(params[1], kappa, 6)